@@ -71,6 +71,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /* core headers */
 #include "core/inc/aos_debug.h"
 #include <core/inc/aos_iostream.h>
+#include "core/inc/aos_profile.h"
 #include "core/inc/aos_shell.h"
 #include "core/inc/aos_system.h"
 #include "core/inc/aos_thread.h"
@@ -0,0 +1,90 @@
+/************************************************************************************//**
+* \file         crc.c
+* \brief        CRC calculation module source file.
+* \ingroup      SerialBoot
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work 
+* that includes OpenBLT without being obliged to provide the source code for any 
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <sb_types.h>                                 /* C types                       */
+#include "crc.h"                                      /* CRC calculation module        */
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Lookup table for the reflected CRC-32 polynomial 0xEDB88320. */
+static sb_uint32 crcTable32[256];
+
+/** \brief Set once crcTable32 is filled. */
+static sb_uint8 crcTable32Ready = SB_FALSE;
+
+
+/************************************************************************************//**
+** \brief     Calculates the CRC-32 of a data block in the same way as the bootloader.
+**            The calculation can be split over several calls by passing the result of
+**            one call to the next one.
+** \param     crc  Result of the previous call, or 0 for the first one.
+** \param     data Pointer to the data.
+** \param     len  Number of bytes.
+** \return    The CRC-32 over all data so far.
+**
+****************************************************************************************/
+sb_uint32 CrcCalculate32(sb_uint32 crc, const sb_uint8 *data, sb_uint32 len)
+{
+  sb_uint32 idx;
+  sb_uint32 value;
+  sb_uint8 bit;
+
+  if (crcTable32Ready == SB_FALSE)
+  {
+    for (idx = 0; idx < 256; idx++)
+    {
+      value = idx;
+      for (bit = 0; bit < 8; bit++)
+      {
+        value = (value & 1) ? ((value >> 1) ^ 0xEDB88320) : (value >> 1);
+      }
+      crcTable32[idx] = value;
+    }
+    crcTable32Ready = SB_TRUE;
+  }
+
+  crc = ~crc;
+  while (len-- > 0)
+  {
+    crc = crcTable32[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+  }
+  return ~crc;
+} /*** end of CrcCalculate32 ***/
+
+
+/*********************************** end of crc.c **************************************/
@@ -0,0 +1,244 @@
+/************************************************************************************//**
+* \file         lz.c
+* \brief        LZ compression module source file.
+* \ingroup      SerialBoot
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work 
+* that includes OpenBLT without being obliged to provide the source code for any 
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+* 
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <sb_types.h>                                 /* C types                       */
+#include <string.h>                                   /* for memset() etc.             */
+#include "lz.h"                                       /* LZ compression module         */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Bit in the first byte of a token that marks a match. */
+#define LZ_TOKEN_MATCH         (0x80)
+/** \brief Length field value of a match that is followed by an extra length byte. */
+#define LZ_MATCH_LEN_EXTENDED  (31)
+/** \brief Shortest match that is encoded. */
+#define LZ_MATCH_LEN_MIN       (3)
+/** \brief Longest match that can be encoded. */
+#define LZ_MATCH_LEN_MAX       (LZ_MATCH_LEN_MIN + LZ_MATCH_LEN_EXTENDED + 255)
+/** \brief Longest literal run that can be encoded. */
+#define LZ_LITERAL_RUN_MAX     (128)
+/** \brief Number of entries in the hash table, must be a power of 2. */
+#define LZ_HASH_SIZE           (4096)
+/** \brief Number of earlier positions that are tried per match search. */
+#define LZ_CHAIN_MAX           (256)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static sb_uint32 LzHash(const sb_uint8 *data);
+static sb_uint32 LzEmitLiterals(const sb_uint8 *in, sb_uint32 len, sb_uint8 *out);
+static sb_uint32 LzEmitMatch(sb_uint32 len, sb_uint32 offset, sb_uint8 *out);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Most recent position for each hash value, -1 if none. */
+static sb_int32 lzHashHead[LZ_HASH_SIZE];
+
+/** \brief Previous position with the same hash value, indexed by position modulo the
+ *         window size.
+ */
+static sb_int32 lzHashPrev[LZ_WINDOW_SIZE];
+
+
+/************************************************************************************//**
+** \brief     Compresses a block of data into a stream for the bootloader's decoder. The
+**            stream does not refer to data outside of the block.
+** \param     in  Data to compress.
+** \param     len Number of bytes to compress.
+** \param     out Destination buffer of at least LZ_COMPRESS_BOUND(len) bytes.
+** \return    Number of bytes written to out.
+**
+****************************************************************************************/
+sb_uint32 LzCompress(const sb_uint8 *in, sb_uint32 len, sb_uint8 *out)
+{
+  sb_uint32 pos = 0;
+  sb_uint32 literalStart = 0;
+  sb_uint32 outLen = 0;
+  sb_uint32 bestLen;
+  sb_uint32 bestOffset;
+  sb_uint32 matchLen;
+  sb_uint32 maxLen;
+  sb_uint32 chain;
+  sb_uint32 hash;
+  sb_int32  candidate;
+  sb_int32  next;
+
+  memset(lzHashHead, 0xff, sizeof(lzHashHead));
+
+  while (pos < len)
+  {
+    bestLen = 0;
+    bestOffset = 0;
+    if ((len - pos) >= LZ_MATCH_LEN_MIN)
+    {
+      /* search the window for the longest match at the current position */
+      maxLen = len - pos;
+      if (maxLen > LZ_MATCH_LEN_MAX)
+      {
+        maxLen = LZ_MATCH_LEN_MAX;
+      }
+      candidate = lzHashHead[LzHash(&in[pos])];
+      for (chain = 0; (chain < LZ_CHAIN_MAX) && (candidate >= 0); chain++)
+      {
+        if ((pos - (sb_uint32)candidate) > LZ_WINDOW_SIZE)
+        {
+          break;
+        }
+        matchLen = 0;
+        while ((matchLen < maxLen) && (in[candidate + matchLen] == in[pos + matchLen]))
+        {
+          matchLen++;
+        }
+        if (matchLen > bestLen)
+        {
+          bestLen = matchLen;
+          bestOffset = pos - (sb_uint32)candidate;
+          if (bestLen == maxLen)
+          {
+            break;
+          }
+        }
+        /* an entry that was overwritten by a newer position ends the chain */
+        next = lzHashPrev[candidate % LZ_WINDOW_SIZE];
+        if (next >= candidate)
+        {
+          break;
+        }
+        candidate = next;
+      }
+    }
+
+    if (bestLen < LZ_MATCH_LEN_MIN)
+    {
+      bestLen = 1;
+    }
+    else
+    {
+      outLen += LzEmitLiterals(&in[literalStart], pos - literalStart, &out[outLen]);
+      outLen += LzEmitMatch(bestLen, bestOffset, &out[outLen]);
+      literalStart = pos + bestLen;
+    }
+
+    /* make the consumed positions available to later searches */
+    while (bestLen > 0)
+    {
+      if ((len - pos) >= LZ_MATCH_LEN_MIN)
+      {
+        hash = LzHash(&in[pos]);
+        lzHashPrev[pos % LZ_WINDOW_SIZE] = lzHashHead[hash];
+        lzHashHead[hash] = (sb_int32)pos;
+      }
+      pos++;
+      bestLen--;
+    }
+  }
+  outLen += LzEmitLiterals(&in[literalStart], pos - literalStart, &out[outLen]);
+  return outLen;
+} /*** end of LzCompress ***/
+
+
+/************************************************************************************//**
+** \brief     Calculates the hash table index of the 3 bytes at a position.
+** \param     data Pointer to the first byte.
+** \return    Hash table index.
+**
+****************************************************************************************/
+static sb_uint32 LzHash(const sb_uint8 *data)
+{
+  sb_uint32 value = ((sb_uint32)data[0] << 16) | ((sb_uint32)data[1] << 8) | data[2];
+
+  return ((value * 2654435761u) >> 20) & (LZ_HASH_SIZE - 1);
+} /*** end of LzHash ***/
+
+
+/************************************************************************************//**
+** \brief     Writes literal run tokens for a number of bytes.
+** \param     in  Bytes to write.
+** \param     len Number of bytes, may be 0.
+** \param     out Destination buffer.
+** \return    Number of bytes written to out.
+**
+****************************************************************************************/
+static sb_uint32 LzEmitLiterals(const sb_uint8 *in, sb_uint32 len, sb_uint8 *out)
+{
+  sb_uint32 outLen = 0;
+  sb_uint32 run;
+
+  while (len > 0)
+  {
+    run = (len > LZ_LITERAL_RUN_MAX) ? LZ_LITERAL_RUN_MAX : len;
+    out[outLen++] = (sb_uint8)(run - 1);
+    memcpy(&out[outLen], in, run);
+    outLen += run;
+    in += run;
+    len -= run;
+  }
+  return outLen;
+} /*** end of LzEmitLiterals ***/
+
+
+/************************************************************************************//**
+** \brief     Writes a match token.
+** \param     len    Match length, LZ_MATCH_LEN_MIN..LZ_MATCH_LEN_MAX.
+** \param     offset Distance to the matched bytes, 1..LZ_WINDOW_SIZE.
+** \param     out    Destination buffer.
+** \return    Number of bytes written to out.
+**
+****************************************************************************************/
+static sb_uint32 LzEmitMatch(sb_uint32 len, sb_uint32 offset, sb_uint8 *out)
+{
+  sb_uint32 lenField = len - LZ_MATCH_LEN_MIN;
+
+  offset--;
+  if (lenField >= LZ_MATCH_LEN_EXTENDED)
+  {
+    out[0] = (sb_uint8)(LZ_TOKEN_MATCH | (LZ_MATCH_LEN_EXTENDED << 2) | (offset >> 8));
+    out[1] = (sb_uint8)(offset & 0xff);
+    out[2] = (sb_uint8)(lenField - LZ_MATCH_LEN_EXTENDED);
+    return 3;
+  }
+  out[0] = (sb_uint8)(LZ_TOKEN_MATCH | (lenField << 2) | (offset >> 8));
+  out[1] = (sb_uint8)(offset & 0xff);
+  return 2;
+} /*** end of LzEmitMatch ***/
+
+
+/*********************************** end of lz.c ***************************************/
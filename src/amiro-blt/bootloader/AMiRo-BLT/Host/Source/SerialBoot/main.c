@@ -41,6 +41,7 @@
 #include <string.h>                                   /* string library                */
 #include "xcpmaster.h"                                /* XCP master protocol module    */
 #include "srecord.h"                                  /* S-record file handling        */
+#include "crc.h"                                      /* CRC calculation module        */
 #include "timeutil.h"                                 /* time utility module           */
 #include "stdlib.h"                                   /* ascii to integral conversion  */
 
@@ -65,6 +66,9 @@ static sb_int32 closeConnection(sb_file *hSrecord);
 static sb_int32 closeConnectionWithReset(sb_file *hSrecord);
 static sb_int32 prepareProgrammingSession(sb_file *hSrecord, tSrecordParseResults *fileParseResults);
 static sb_int32 programCode(sb_file *hSrecord, tSrecordParseResults *fileParseResults, tSrecordLineParseResults *lineParseResults);
+static sb_int32 negotiateBaudrate(void);
+static sb_uint8 programSegment(void);
+static sb_int32 verifyCode(tSrecordParseResults *fileParseResults);
 
 /****************************************************************************************
 * Macro definitions
@@ -91,6 +95,12 @@ static sb_int32 programCode(sb_file *hSrecord, tSrecordParseResults *fileParseRe
 /* maximal space for flashing programs */
 #define MAX_COUNT_FLASHING_PROGRAMS 5
 
+/* number of speeds that are tried when a maximal speed is given with -B */
+#define COUNT_FAST_BAUDRATES       5
+
+/* number of contiguous bytes that are collected for one compressed transfer (-z) */
+#define COMPRESS_SEGMENT_SIZE      (64*1024)
+
 
 /****************************************************************************************
 * Local data declarations
@@ -104,6 +114,29 @@ static sb_char bluetoothID[18];
 /** \brief Serial communication speed in bits per second. */
 static sb_uint32 serialBaudrate;
 
+/** \brief Highest speed to negotiate with the main device, 0 to stay at serialBaudrate. */
+static sb_uint32 serialBaudrateMax = 0;
+
+/** \brief Serial communication speed currently in use in bits per second. */
+static sb_uint32 activeBaudrate;
+
+/* speeds that are tried in descending order when a maximal speed is given */
+static const sb_uint32 fastBaudrates[COUNT_FAST_BAUDRATES] = {2000000, 1000000, 921600, 460800, 230400};
+
+/* index of the fastest speed that has not failed yet */
+static sb_uint8 fastBaudrateIdx = 0;
+
+/** \brief Transfer the program data compressed, enabled with -z. */
+static sb_uint8 compressData = SB_FALSE;
+
+/* contiguous program data that is collected for one compressed transfer */
+static sb_uint8 segmentData[COMPRESS_SEGMENT_SIZE];
+static sb_uint32 segmentAddress;
+static sb_uint32 segmentLength = 0;
+
+/* copy of the image that is being programmed, for the verification */
+static sb_uint8 *imageData = SB_NULL;
+
 /** \brief Name of the S-record file. */
 static sb_char *srecordFileName;
 
@@ -187,6 +220,15 @@ sb_int32 main(sb_int32 argc, sb_char *argv[])
     if (flashProgram() == PROG_RESULT_ERROR) {
       closeSerialPort();
       openSerialPortConnect(0);
+      /* the failure might be caused by a negotiated speed, so retry at a lower one */
+      if (errorDetected != ERROR_FILE && activeBaudrate != serialBaudrate) {
+        fastBaudrateIdx++;
+        negotiateBaudrate();
+        printf("\nFlash %i: Retrying @ %u bits/s\n\n", flashIdx+1, activeBaudrate);
+        flashIdx--;
+        continue;
+      }
+      activeBaudrate = serialBaudrate;
     }
     errors[flashIdx] = errorDetected;
   }
@@ -236,7 +278,7 @@ static void DisplayProgramInfo(void)
 ****************************************************************************************/
 static void DisplayProgramUsage(void)
 {
-  printf("Usage: SerialBoot -d<device> -b<baudrate> <s-record file>/(-T<flash-id> <s-record file>)\n\n");
+  printf("Usage: SerialBoot -d<device> -b<baudrate> [-B<max baudrate>] [-z] <s-record file>/(-T<flash-id> <s-record file>)\n\n");
   printf("Example 1:  SerialBoot -h\n");
 #ifdef PLATFORM_WIN32
   printf("Example 2:  SerialBoot -dCOM4 -b57600 -T3 firmware.srec\n");
@@ -263,6 +305,11 @@ static void DisplayProgramUsage(void)
   printf("     'firmware.srec' will be flashed on device 0x00. It equals the\n");
   printf("     configuration '-T0 firmware.srec'.\n");
   printf("  -> Don't forget that you always have to give the parameters -d and -b.\n");
+  printf("  -> With the optional parameter -B, e.g. -B1000000, the main device is asked\n");
+  printf("     to continue at the highest speed up to the given one that both sides\n");
+  printf("     support. It returns to the speed of -b if the link turns out unreliable.\n");
+  printf("  -> With the optional parameter -z the program data is transferred compressed.\n");
+  printf("     Bootloaders without support for it are programmed uncompressed.\n");
   printf("  -> There is also the parameter -a for giving an address for bluetooth\n");
   printf("     communication, but this part is not functional yet.\n");
   printf("--------------------------------------------------------------------------------\n");
@@ -277,7 +324,14 @@ static void DisplayProgramInput(void) {
   printf("         performance and savety.\n");
   printf("\n--------------------------------------------------------------------------------\n\n");
 #endif
-  printf("\nOpen device at %s @ %u bits/s and RTS=%i\n\n", serialDeviceName, serialBaudrate, registerRTSvalue);
+  printf("\nOpen device at %s @ %u bits/s and RTS=%i\n", serialDeviceName, serialBaudrate, registerRTSvalue);
+  if (serialBaudrateMax > serialBaudrate) {
+    printf("Negotiating up to %u bits/s\n", serialBaudrateMax);
+  }
+  if (compressData == SB_TRUE) {
+    printf("Transferring compressed data\n");
+  }
+  printf("\n");
   printf("Programming will start immediately in following order:\n");
   sb_uint8 idx;
   for (idx=0; idx<countFlashingPrograms; idx++) {
@@ -301,13 +355,15 @@ static sb_uint8 ParseCommandLine(sb_int32 argc, sb_char *argv[])
   sb_uint8 paramAfound = SB_FALSE;
   sb_uint8 paramDfound = SB_FALSE;
   sb_uint8 paramBfound = SB_FALSE;
+  sb_uint8 paramBmaxfound = SB_FALSE;
   sb_uint8 paramTfound = SB_FALSE;
   sb_uint8 paramRTSfound = SB_FALSE;
+  sb_uint8 paramZfound = SB_FALSE;
   sb_uint8 paramXfound = SB_FALSE;
   sb_uint8 srecordfound = SB_FALSE;
 
   /* make sure the right amount of arguments are given */
-  if (argc < 4 || argc > 14)
+  if (argc < 4 || argc > 16)
   {
     return SB_FALSE;
   }
@@ -347,8 +403,24 @@ static sb_uint8 ParseCommandLine(sb_int32 argc, sb_char *argv[])
     {
       /* extract the baudrate and set flag that this parameter was found */
       sscanf(&argv[paramIdx][2], "%u", &serialBaudrate);
+      activeBaudrate = serialBaudrate;
       paramBfound = SB_TRUE;
     }
+    /* is this the maximal baudrate? */
+    else if ( (argv[paramIdx][0] == '-') && (argv[paramIdx][1] == 'B') && (paramBmaxfound == SB_FALSE) && (paramTfound == SB_FALSE) )
+    {
+      /* extract the maximal baudrate and set flag that this parameter was found */
+      unsigned int baudrateMax = 0;
+      sscanf((const char *)&argv[paramIdx][2], "%u", &baudrateMax);
+      serialBaudrateMax = baudrateMax;
+      paramBmaxfound = SB_TRUE;
+    }
+    /* is this the compression flag? */
+    else if ( (argv[paramIdx][0] == '-') && (argv[paramIdx][1] == 'z') && (argv[paramIdx][2] == 0x0) && (paramZfound == SB_FALSE) && (paramTfound == SB_FALSE) )
+    {
+      compressData = SB_TRUE;
+      paramZfound = SB_TRUE;
+    }
     /* is this the RTS flag? */
     else if ( (argv[paramIdx][0] == '-') && (argv[paramIdx][1] == 'R') && (argv[paramIdx][2] == 'T') && (argv[paramIdx][3] == 'S') && (paramRTSfound == SB_FALSE) && (paramTfound == SB_FALSE) )
     {
@@ -501,6 +573,9 @@ static sb_int32 startFlashMode(void) {
     return PROG_RESULT_ERROR;
   }
 
+  /* -------------------- negotiate communication speed ------------------------------ */
+  negotiateBaudrate();
+
   //printf("close...");
 
   /* -------------------- close connection ------------------------------------------- */
@@ -523,7 +598,7 @@ static sb_int32 flashProgram(void) {
 
   /* -------------------- start the firmware update procedure ------------------------ */
   printf("Starting firmware update for \"%s\" on device 0x%08X\n", srecordFileName, flashingTargetID);
-  printf("Using %s @ %u bits/s\n", serialDeviceName, serialBaudrate);
+  printf("Using %s @ %u bits/s\n", serialDeviceName, activeBaudrate);
 
   /* -------------------- prepare programming session -------------------------------- */
   if (prepareProgrammingSession(&hSrecord, &fileParseResults) == PROG_RESULT_ERROR) {
@@ -566,7 +641,7 @@ static sb_int32 flashProgram(void) {
 
 static sb_int32 startUserProgram(void) {
   /* -------------------- start the user program ------------------------------------- */
-  printf("Resetting all using %s @ %u bits/s\n", serialDeviceName, serialBaudrate);
+  printf("Resetting all using %s @ %u bits/s\n", serialDeviceName, activeBaudrate);
 
   /* -------------------- open connection -------------------------------------------- */
   if (buildConnection(0) == PROG_RESULT_ERROR) {
@@ -709,6 +784,28 @@ static sb_int32 openSerialPortConnect(sb_uint8 start) {
 
 
 
+static sb_int32 negotiateBaudrate(void) {
+  /* -------------------- switch the main device to the fastest working speed -------- */
+  activeBaudrate = serialBaudrate;
+  while (fastBaudrateIdx < COUNT_FAST_BAUDRATES) {
+    if (fastBaudrates[fastBaudrateIdx] <= serialBaudrateMax && fastBaudrates[fastBaudrateIdx] > serialBaudrate) {
+      printf("Switching to %u bits/s...", fastBaudrates[fastBaudrateIdx]);
+      if (XcpMasterSetBaudrate(fastBaudrates[fastBaudrateIdx], serialBaudrate) == SB_TRUE) {
+        printf("OK\n");
+        activeBaudrate = fastBaudrates[fastBaudrateIdx];
+        return PROG_RESULT_OK;
+      }
+      printf("not possible\n");
+    }
+    fastBaudrateIdx++;
+  }
+
+  return PROG_RESULT_OK;
+}
+
+
+
+
 static sb_int32 buildConnection(sb_uint8 start) {
   /* -------------------- Connect to XCP slave --------------------------------------- */
 //  printf("Connecting to bootloader...");
@@ -822,6 +919,8 @@ static sb_int32 prepareProgrammingSession(sb_file *hSrecord, tSrecordParseResult
 
 
 static sb_int32 programCode(sb_file *hSrecord, tSrecordParseResults *fileParseResults, tSrecordLineParseResults *lineParseResults) {
+  sb_uint32 imageLength = fileParseResults->address_high - fileParseResults->address_low + 1;
+
   /* -------------------- Prepare the programming session ---------------------------- */
   printf("Initializing programming session...");
   if (XcpMasterStartProgrammingSession() == SB_FALSE)
@@ -847,18 +946,70 @@ static sb_int32 programCode(sb_file *hSrecord, tSrecordParseResults *fileParseRe
   /* -------------------- Program data ----------------------------------------------- */
   printf("Programming data. Please wait...");
   /* loop through all S-records with program data */
+  /* keep a copy of the image, with erased bytes in between the S-records, for the
+   * verification
+   */
+  free(imageData);
+  imageData = (sb_uint8 *)malloc(imageLength);
+  if (imageData != SB_NULL)
+  {
+    memset(imageData, 0xff, imageLength);
+  }
+  segmentLength = 0;
   while (SrecordParseNextDataLine(*hSrecord, lineParseResults) == SB_TRUE)
   {
-    if (XcpMasterProgramData(lineParseResults->address, lineParseResults->length, lineParseResults->data) == SB_FALSE)
+    if (imageData != SB_NULL)
     {
-      printf("ERROR\n");
-      XcpMasterDisconnect();
-      SrecordClose(*hSrecord);
-      return PROG_RESULT_ERROR;
+      memcpy(&imageData[lineParseResults->address - fileParseResults->address_low], lineParseResults->data, lineParseResults->length);
+    }
+    if (compressData == SB_FALSE)
+    {
+      if (XcpMasterProgramData(lineParseResults->address, lineParseResults->length, lineParseResults->data) == SB_FALSE)
+      {
+        printf("ERROR\n");
+        XcpMasterDisconnect();
+        SrecordClose(*hSrecord);
+        return PROG_RESULT_ERROR;
+      }
+      continue;
+    }
+    /* start a new segment if the line does not continue the current one or does not fit */
+    if ( (segmentLength > 0) &&
+         ((lineParseResults->address != (segmentAddress + segmentLength)) ||
+          ((segmentLength + lineParseResults->length) > COMPRESS_SEGMENT_SIZE)) )
+    {
+      if (programSegment() == SB_FALSE)
+      {
+        printf("ERROR\n");
+        XcpMasterDisconnect();
+        SrecordClose(*hSrecord);
+        return PROG_RESULT_ERROR;
+      }
+    }
+    if (segmentLength == 0)
+    {
+      segmentAddress = lineParseResults->address;
     }
+    memcpy(&segmentData[segmentLength], lineParseResults->data, lineParseResults->length);
+    segmentLength += lineParseResults->length;
+  }
+  if (programSegment() == SB_FALSE)
+  {
+    printf("ERROR\n");
+    XcpMasterDisconnect();
+    SrecordClose(*hSrecord);
+    return PROG_RESULT_ERROR;
   }
   printf("OK\n");
 
+  /* -------------------- Verify data ------------------------------------------------ */
+  if (verifyCode(fileParseResults) == PROG_RESULT_ERROR)
+  {
+    XcpMasterDisconnect();
+    SrecordClose(*hSrecord);
+    return PROG_RESULT_ERROR;
+  }
+
   /* -------------------- Stop the programming session ------------------------------- */
   printf("Finishing programming session...");
   if (XcpMasterStopProgrammingSession() == SB_FALSE)
@@ -875,4 +1026,62 @@ static sb_int32 programCode(sb_file *hSrecord, tSrecordParseResults *fileParseRe
 
 
 
+/************************************************************************************//**
+** \brief     Programs the collected contiguous data as one compressed transfer.
+** \return    SB_TRUE on success, SB_FALSE otherwise.
+**
+****************************************************************************************/
+static sb_uint8 programSegment(void) {
+  sb_uint32 length = segmentLength;
+
+  if (length == 0) {
+    return SB_TRUE;
+  }
+  segmentLength = 0;
+  return XcpMasterProgramCompressedData(segmentAddress, length, segmentData);
+} /*** end of programSegment ***/
+
+
+/************************************************************************************//**
+** \brief     Compares the CRC-32 of the programmed image, as calculated by the
+**            bootloader, with that of the S-record file. The bootloader includes the
+**            data that is not yet written to flash, so this is done before the
+**            programming session is stopped and the image is marked as valid.
+** \return    PROG_RESULT_OK if the image is correct or cannot be verified,
+**            PROG_RESULT_ERROR otherwise.
+**
+****************************************************************************************/
+static sb_int32 verifyCode(tSrecordParseResults *fileParseResults) {
+  sb_uint32 imageLength = fileParseResults->address_high - fileParseResults->address_low + 1;
+  sb_uint32 checksum;
+  sb_uint8 type;
+
+  printf("Verifying data...");
+  if (imageData == SB_NULL)
+  {
+    printf("SKIPPED (out of memory)\n");
+    return PROG_RESULT_OK;
+  }
+  if (XcpMasterBuildChecksum(fileParseResults->address_low, imageLength, &type, &checksum) == SB_FALSE)
+  {
+    printf("ERROR\n");
+    return PROG_RESULT_ERROR;
+  }
+  if (type != XCP_MASTER_CS_CRC32)
+  {
+    /* an older bootloader, which only supports a simple checksum */
+    printf("SKIPPED (no CRC-32 support)\n");
+    return PROG_RESULT_OK;
+  }
+  if (checksum != CrcCalculate32(0, imageData, imageLength))
+  {
+    printf("ERROR (CRC-32 mismatch)\n");
+    return PROG_RESULT_ERROR;
+  }
+  printf("OK\n");
+  return PROG_RESULT_OK;
+} /*** end of verifyCode ***/
+
+
+
 /*********************************** end of main.c *************************************/
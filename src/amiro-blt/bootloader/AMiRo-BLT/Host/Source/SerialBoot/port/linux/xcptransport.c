@@ -72,6 +72,11 @@
 /** \brief The smallest time in millisecond that the UART is configured for. */
 #define UART_RX_TIMEOUT_MIN_MS   (100)
 
+/** \brief Time in milliseconds for the slave to answer a packet completed by the
+ *         resynchronization.
+ */
+#define UART_RESYNC_SETTLE_MS    (100)
+
 
 /****************************************************************************************
 * Function prototypes
@@ -218,16 +223,23 @@ sb_uint8 XcpTransportInit(sb_char *device, sb_uint32 baudrate, sb_uint8 comIsUar
   options.c_cc[VMIN]  = 0;
   options.c_cc[VTIME] = UART_RX_TIMEOUT_MIN_MS/100; /* 1/10th of a second */
 
-  /* pull down reset pin */
+  /* pull down reset pin. devices without modem control lines (e.g. a pseudo terminal
+   * served by a target simulator) do not support this, which is not an error.
+   */
   if (ioctl(hUart, TIOCMGET, &status) == -1) {
-    perror("TIOCMGET");
-    return SB_FALSE;
-  }
-  status |= TIOCM_DTR;
-  status &= ~TIOCM_RTS;
-  if (ioctl(hUart, TIOCMSET, &status) == -1) {
-    perror("TIOCMSET");
-    return SB_FALSE;
+    if (errno != ENOTTY && errno != EINVAL) {
+      perror("TIOCMGET");
+      XcpTransportClose();
+      return SB_FALSE;
+    }
+  } else {
+    status |= TIOCM_DTR;
+    status &= ~TIOCM_RTS;
+    if (ioctl(hUart, TIOCMSET, &status) == -1) {
+      perror("TIOCMSET");
+      XcpTransportClose();
+      return SB_FALSE;
+    }
   }
 
   /* set the new options for the port */
@@ -242,6 +254,42 @@ sb_uint8 XcpTransportInit(sb_char *device, sb_uint32 baudrate, sb_uint8 comIsUar
 } /*** end of XcpTransportInit ***/
 
 
+/************************************************************************************//**
+** \brief     Changes the communication speed of the opened serial port. Characters that
+**            are still in the transmit buffer are sent at the old speed first and
+**            characters that were received at the old speed are discarded.
+** \param     baudrate Communication speed in bits/sec.
+** \return    SB_TRUE if successful, SB_FALSE otherwise.
+**
+****************************************************************************************/
+sb_uint8 XcpTransportSetBaudrate(sb_uint32 baudrate)
+{
+  struct termios options;
+
+  /* unsupported speeds map to 9600 bits/sec, which the target would not expect */
+  if ( (hUart == UART_INVALID_HANDLE) ||
+       ((baudrate != 9600) && (XcpTransportGetBaudrateMask(baudrate) == B9600)) )
+  {
+    return SB_FALSE;
+  }
+  if (tcgetattr(hUart, &options) == -1)
+  {
+    return SB_FALSE;
+  }
+  if ( (cfsetispeed(&options, XcpTransportGetBaudrateMask(baudrate)) == -1) ||
+       (cfsetospeed(&options, XcpTransportGetBaudrateMask(baudrate)) == -1) )
+  {
+    return SB_FALSE;
+  }
+  if (tcsetattr(hUart, TCSAFLUSH, &options) == -1)
+  {
+    return SB_FALSE;
+  }
+  tcpBaudrate = baudrate;
+  return SB_TRUE;
+} /*** end of XcpTransportSetBaudrate ***/
+
+
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attemps to receive the
 **            response within the given timeout. The data in the response packet is
@@ -369,6 +417,33 @@ sb_uint8 XcpTransportSendPacket(sb_uint8 *data, sb_uint8 len, sb_uint16 timeOutM
 } /*** end of XcpMasterTpSendPacket ***/
 
 
+/************************************************************************************//**
+** \brief     Brings the packet reception of the slave back to the start of a packet
+**            after a byte got lost or damaged. A damaged length byte makes the slave
+**            wait for up to XCP_MASTER_TX_MAX_DATA more bytes, so that many zero bytes
+**            are sent. Once at the start of a packet, the slave ignores them as empty
+**            packets. Responses that are still underway are discarded.
+** \return    none.
+**
+****************************************************************************************/
+void XcpTransportResync(void)
+{
+  static const sb_uint8 padding[XCP_MASTER_TX_MAX_DATA] = { 0 };
+
+  if (hUart == UART_INVALID_HANDLE)
+  {
+    return;
+  }
+  if (write(hUart, padding, sizeof(padding)) != sizeof(padding))
+  {
+    errorType = errno;
+  }
+  /* wait for the padding to leave at 10 bits per byte and for a late response */
+  TimeUtilDelayMs(UART_RESYNC_SETTLE_MS + (sizeof(padding) * 10 * 1000) / tcpBaudrate);
+  tcflush(hUart, TCIFLUSH);
+} /*** end of XcpTransportResync ***/
+
+
 /************************************************************************************//**
 ** \brief     Reads the data from the response packet. Make sure to not call this
 **            function while XcpTransportSendPacket() is active, because the data won't be
@@ -412,6 +487,36 @@ static speed_t XcpTransportGetBaudrateMask(sb_uint32 baudrate)
 
   switch (baudrate)
   {
+#ifdef B2000000
+    case 2000000:
+      result = B2000000;
+      break;
+#endif
+#ifdef B1000000
+    case 1000000:
+      result = B1000000;
+      break;
+#endif
+#ifdef B921600
+    case 921600:
+      result = B921600;
+      break;
+#endif
+#ifdef B500000
+    case 500000:
+      result = B500000;
+      break;
+#endif
+#ifdef B460800
+    case 460800:
+      result = B460800;
+      break;
+#endif
+#ifdef B230400
+    case 230400:
+      result = B230400;
+      break;
+#endif
     case 115200:
       result = B115200;
       break;
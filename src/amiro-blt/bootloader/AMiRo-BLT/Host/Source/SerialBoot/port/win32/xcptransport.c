@@ -55,12 +55,19 @@
 /** \brief The smallest time in millisecond that the UART is configured for. */
 #define UART_RX_TIMEOUT_MIN_MS   (5)
 
+/** \brief Time in milliseconds for the slave to answer a packet completed by the
+ *         resynchronization.
+ */
+#define UART_RESYNC_SETTLE_MS    (100)
+
 
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
 static tXcpTransportResponsePacket responsePacket;
 static HANDLE hUart = INVALID_HANDLE_VALUE;
+/** \brief Communication speed of the opened serial port in bits/sec. */
+static sb_uint32 uartBaudrate;
 
 
 /************************************************************************************//**
@@ -111,6 +118,7 @@ sb_uint8 XcpTransportInit(sb_char *device, sb_uint32 baudrate, sb_uint8 comIsUar
     XcpTransportClose();
     return SB_FALSE;
   }
+  uartBaudrate = baudrate;
 
   /* set communication timeout parameters */
   timeouts.ReadIntervalTimeout = UART_RX_TIMEOUT_MIN_MS;
@@ -163,6 +171,46 @@ sb_uint8 XcpTransportInit(sb_char *device, sb_uint32 baudrate, sb_uint8 comIsUar
 } /*** end of XcpTransportInit ***/
 
 
+/************************************************************************************//**
+** \brief     Changes the communication speed of the opened serial port. Characters that
+**            are still in the transmit buffer are sent at the old speed first and
+**            characters that were received at the old speed are discarded.
+** \param     baudrate Communication speed in bits/sec.
+** \return    SB_TRUE if successful, SB_FALSE otherwise.
+**
+****************************************************************************************/
+sb_uint8 XcpTransportSetBaudrate(sb_uint32 baudrate)
+{
+  DCB dcbSerialParams = { 0 };
+
+  if (hUart == INVALID_HANDLE_VALUE)
+  {
+    return SB_FALSE;
+  }
+  /* wait for the last characters to leave at the old speed */
+  if (!FlushFileBuffers(hUart))
+  {
+    return SB_FALSE;
+  }
+  dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+  if (!GetCommState(hUart, &dcbSerialParams))
+  {
+    return SB_FALSE;
+  }
+  dcbSerialParams.BaudRate = baudrate;
+  if (!SetCommState(hUart, &dcbSerialParams))
+  {
+    return SB_FALSE;
+  }
+  if (!PurgeComm(hUart, PURGE_RXCLEAR))
+  {
+    return SB_FALSE;
+  }
+  uartBaudrate = baudrate;
+  return SB_TRUE;
+} /*** end of XcpTransportSetBaudrate ***/
+
+
 /************************************************************************************//**
 ** \brief     Transmits an XCP packet on the transport layer and attemps to receive the
 **            response within the given timeout. The data in the response packet is 
@@ -253,6 +301,31 @@ sb_uint8 XcpTransportSendPacket(sb_uint8 *data, sb_uint8 len, sb_uint16 timeOutM
 } /*** end of XcpMasterTpSendPacket ***/
 
 
+/************************************************************************************//**
+** \brief     Brings the packet reception of the slave back to the start of a packet
+**            after a byte got lost or damaged. A damaged length byte makes the slave
+**            wait for up to XCP_MASTER_TX_MAX_DATA more bytes, so that many zero bytes
+**            are sent. Once at the start of a packet, the slave ignores them as empty
+**            packets. Responses that are still underway are discarded.
+** \return    none.
+**
+****************************************************************************************/
+void XcpTransportResync(void)
+{
+  static const sb_uint8 padding[XCP_MASTER_TX_MAX_DATA] = { 0 };
+  DWORD dwWritten = 0;
+
+  if (hUart == INVALID_HANDLE_VALUE)
+  {
+    return;
+  }
+  WriteFile(hUart, padding, sizeof(padding), &dwWritten, SB_NULL);
+  /* wait for the padding to leave at 10 bits per byte and for a late response */
+  TimeUtilDelayMs(UART_RESYNC_SETTLE_MS + (sizeof(padding) * 10 * 1000) / uartBaudrate);
+  PurgeComm(hUart, PURGE_RXCLEAR);
+} /*** end of XcpTransportResync ***/
+
+
 /************************************************************************************//**
 ** \brief     Reads the data from the response packet. Make sure to not call this 
 **            function while XcpTransportSendPacket() is active, because the data won't be
@@ -48,7 +48,9 @@ typedef struct
 ****************************************************************************************/
 sb_uint8 XcpTransportInit(sb_char *device, sb_uint32 baudrate, sb_uint8 comIsUart);
 sb_uint8 XcpTransportSetRtsDtr(sb_char *device);
+sb_uint8 XcpTransportSetBaudrate(sb_uint32 baudrate);
 sb_uint8 XcpTransportSendPacket(sb_uint8 *data, sb_uint8 len, sb_uint16 timeOutMs);
+void XcpTransportResync(void);
 tXcpTransportResponsePacket *XcpTransportReadResponsePacket(void);
 void XcpTransportClose(void);
 
@@ -36,7 +36,10 @@
 ****************************************************************************************/
 #include <assert.h>                                   /* assertion module              */
 #include <sb_types.h>                                 /* C types                       */
+#include <stdlib.h>                                   /* for malloc() etc.             */
 #include "xcpmaster.h"                                /* XCP master protocol module    */
+#include "timeutil.h"                                 /* time utility module           */
+#include "lz.h"                                       /* LZ compression module         */
 
 
 /****************************************************************************************
@@ -45,6 +48,8 @@
 /* XCP command codes as defined by the protocol currently supported by this module */
 #define XCP_MASTER_CMD_CONNECT         (0xFF)
 #define XCP_MASTER_CMD_DISCONNECT      (0xFE)
+#define XCP_MASTER_CMD_SYNCH           (0xFC)
+#define XCP_MASTER_CMD_BUILD_CHECKSUM  (0xF3)
 #define XCP_MASTER_CMD_SET_MTA         (0xF6)
 #define XCP_MASTER_CMD_UPLOAD          (0xF5)
 #define XCP_MASTER_CMD_PROGRAM_START   (0xD2)
@@ -52,9 +57,18 @@
 #define XCP_MASTER_CMD_PROGRAM         (0xD0)
 #define XCP_MASTER_CMD_PROGRAM_RESET   (0xCF)
 #define XCP_MASTER_CMD_PROGRAM_MAX     (0xC9)
+#define XCP_MASTER_CMD_TRANSPORT_LAYER (0xF2)
+#define XCP_MASTER_CMD_USER            (0xF1)
+
+/* transport layer sub-command codes */
+#define XCP_MASTER_TL_SET_BAUDRATE     (0x01)
+
+/* user command sub-command codes */
+#define XCP_MASTER_USER_PROGRAM_COMPRESSED (0x01)
 
 /* XCP response packet IDs as defined by the protocol */
 #define XCP_MASTER_CMD_PID_RES         (0xFF) /* positive response */
+#define XCP_MASTER_CMD_PID_ERR         (0xFE) /* error response */
 
 /* timeout values */
 #define XCP_MASTER_CONNECT_TIMEOUT_MS  (20)
@@ -66,6 +80,15 @@
 #define XCP_MASTER_TIMEOUT_T6_MS       (1000)  /* user specific connect connect timeout */
 #define XCP_MASTER_TIMEOUT_T7_MS       (2000)  /* wait timer timeout */
 
+/** \brief Time for the slave to switch its UART to the new speed. */
+#define XCP_MASTER_BAUDRATE_SETTLE_MS  (10)
+/** \brief Number of connect attempts that confirm a new communication speed. */
+#define XCP_MASTER_BAUDRATE_CONFIRM_RETRIES (3)
+/** \brief Time after which a slave that did not see the new speed being confirmed has
+ *         returned to its default speed.
+ */
+#define XCP_MASTER_BAUDRATE_FALLBACK_MS (600)
+
 /* XCP error codes */
 /** \brief Cmd processor synchronization error code. */
 #define XCP_ERR_CMD_SYNCH           (0x00)
@@ -87,20 +110,38 @@
 /** \brief Number of retries to connect to the XCP slave. */
 #define XCP_MASTER_CONNECT_RETRIES     (5)
 
+/** \brief Number of times the communication is resynchronized for a failed command
+ *         before the command is given up.
+ */
+#define XCP_MASTER_CMD_RETRIES         (3)
+
+/** \brief Number of times the communication is resynchronized during a programming
+ *         session. Errors of program commands that a gateway acknowledged in advance
+ *         surface with a later command, so the retries of a single command do not
+ *         bound a slave that keeps failing.
+ */
+#define XCP_MASTER_SESSION_RESYNCS     (16)
+
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
 static sb_uint8 XcpMasterSendCmdConnect(sb_uint32 flashingTargetID);
+static sb_uint8 XcpMasterSendCmdSynch(void);
+static sb_uint8 XcpMasterResync(sb_uint8 *retries);
 static sb_uint8 XcpMasterSendCmdSetMta(sb_uint32 address);
 static sb_uint8 XcpMasterSendCmdUpload(sb_uint8 data[], sb_uint8 length);
+static sb_uint8 XcpMasterSendCmdBuildChecksum(sb_uint32 length, sb_uint8 *type, sb_uint32 *checksum);
 static sb_uint8 XcpMasterSendCmdProgramStart(void);
 static sb_uint8 XcpMasterSendCmdDisconnect(void);
 static sb_uint8 XcpMasterSendCmdProgramReset(void);
 static sb_uint8 XcpMasterSendCmdProgram(sb_uint8 length, sb_uint8 data[]);
 static sb_uint8 XcpMasterSendCmdProgramMax(sb_uint8 data[]);
 static sb_uint8 XcpMasterSendCmdProgramClear(sb_uint32 length);
+static sb_uint8 XcpMasterSendCmdSetBaudrate(sb_uint32 baudrate, sb_uint8 *rejected);
+static sb_uint8 XcpMasterSendCmdProgramCompressed(sb_uint8 length, sb_uint8 data[], sb_uint8 *unsupported);
 static void     XcpMasterSetOrderedLong(sb_uint32 value, sb_uint8 data[]);
+static sb_uint32 XcpMasterGetOrderedLong(sb_uint8 data[]);
 static void     XcpMasterPrintError(sb_uint8 error);
 
 
@@ -124,6 +165,18 @@ static sb_uint8 xcpMaxDto;
 /** \brief Internal data buffer for storing the data of the XCP response packet. */
 static tXcpTransportResponsePacket responsePacket;
 
+/** \brief Set once the slave rejected a compressed program command. */
+static sb_uint8 xcpSlaveNoCompression = SB_FALSE;
+
+/** \brief Target ID of the last successful connect, to connect again after an error. */
+static sb_uint32 xcpConnectedTargetID = 0;
+
+/** \brief Set while the slave is in a programming session. */
+static sb_uint8 xcpProgramming = SB_FALSE;
+
+/** \brief Number of resynchronizations in the current programming session. */
+static sb_uint8 xcpSessionResyncs = 0;
+
 
 /************************************************************************************//**
 ** \brief     Initializes the XCP master protocol layer.
@@ -169,6 +222,8 @@ sb_uint8 XcpMasterConnect(sb_uint32 flashingTargetID)
     /* send the connect command */
     if (XcpMasterSendCmdConnect(flashingTargetID) == SB_TRUE)
     {
+      /* the slave might be another one, so find out again if it decompresses */
+      xcpSlaveNoCompression = SB_FALSE;
       /* connected so no need to retry */
       return SB_TRUE;
     }
@@ -185,6 +240,7 @@ sb_uint8 XcpMasterConnect(sb_uint32 flashingTargetID)
 ****************************************************************************************/
 sb_uint8 XcpMasterDisconnect(void)
 {
+  xcpProgramming = SB_FALSE;
   /* send reset command instead of the disconnect. this causes the user program on the
    * slave to automatically start again if present.
    */
@@ -215,7 +271,9 @@ sb_uint8 XcpMasterProgramReset(void)
 sb_uint8 XcpMasterStartProgrammingSession(void)
 {
   /* place the slave in programming mode */
-  return XcpMasterSendCmdProgramStart();
+  xcpSessionResyncs = 0;
+  xcpProgramming = XcpMasterSendCmdProgramStart();
+  return xcpProgramming;
 } /*** end of XcpMasterStartProgrammingSession ***/
 
 
@@ -232,12 +290,59 @@ sb_uint8 XcpMasterStopProgrammingSession(void)
   {
     return SB_FALSE;
   }
+  xcpProgramming = SB_FALSE;
   /* request a reset of the slave */
 //  return XcpMasterSendCmdProgramReset();
   return SB_TRUE;
 } /*** end of XcpMasterStopProgrammingSession ***/
 
 
+/************************************************************************************//**
+** \brief     Switches a connected slave and the master to another communication speed.
+**            The new speed is confirmed with a connect command. If that fails, the
+**            master returns to the fallback speed and waits for the slave to do the
+**            same, after which the connection is established again.
+** \param     baudrate The new communication speed in bits/sec.
+** \param     fallback The speed the slave returns to by itself, in bits/sec.
+** \return    SB_TRUE if the new speed is in use, SB_FALSE if the fallback speed is.
+**
+****************************************************************************************/
+sb_uint8 XcpMasterSetBaudrate(sb_uint32 baudrate, sb_uint32 fallback)
+{
+  sb_uint8 rejected;
+  sb_uint8 cnt;
+
+  if (XcpMasterSendCmdSetBaudrate(baudrate, &rejected) == SB_FALSE)
+  {
+    /* a rejected speed leaves the slave at the current one. without a response it is
+     * unknown if the slave switched, so resynchronize as if the switch failed.
+     */
+    if (rejected == SB_TRUE)
+    {
+      return SB_FALSE;
+    }
+  }
+  else if (XcpTransportSetBaudrate(baudrate) == SB_TRUE)
+  {
+    /* give the slave time to finish the response and reconfigure its UART */
+    TimeUtilDelayMs(XCP_MASTER_BAUDRATE_SETTLE_MS);
+    for (cnt=0; cnt<XCP_MASTER_BAUDRATE_CONFIRM_RETRIES; cnt++)
+    {
+      if (XcpMasterSendCmdConnect(0) == SB_TRUE)
+      {
+        return SB_TRUE;
+      }
+    }
+  }
+
+  /* the new speed does not work. wait for the slave to return to the fallback speed */
+  XcpTransportSetBaudrate(fallback);
+  TimeUtilDelayMs(XCP_MASTER_BAUDRATE_FALLBACK_MS);
+  XcpMasterConnect(0);
+  return SB_FALSE;
+} /*** end of XcpMasterSetBaudrate ***/
+
+
 /************************************************************************************//**
 ** \brief     Erases non volatile memory on the slave.
 ** \param     addr Base memory address for the erase operation.
@@ -247,13 +352,18 @@ sb_uint8 XcpMasterStopProgrammingSession(void)
 ****************************************************************************************/
 sb_uint8 XcpMasterClearMemory(sb_uint32 addr, sb_uint32 len)
 {
-  /* first set the MTA pointer */
-  if (XcpMasterSendCmdSetMta(addr) == SB_FALSE)
+  sb_uint8 retries = 0;
+
+  /* set the MTA pointer and perform the erase operation. erasing again does no harm */
+  while ( (XcpMasterSendCmdSetMta(addr) == SB_FALSE) ||
+          (XcpMasterSendCmdProgramClear(len) == SB_FALSE) )
   {
-    return SB_FALSE;
+    if (XcpMasterResync(&retries) == SB_FALSE)
+    {
+      return SB_FALSE;
+    }
   }
-  /* now perform the erase operation */
-  return XcpMasterSendCmdProgramClear(len);
+  return SB_TRUE;
 } /*** end of XcpMasterClearMemory ***/
 
 
@@ -298,6 +408,33 @@ sb_uint8 XcpMasterReadData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[])
 } /*** end of XcpMasterReadData ***/
 
 
+/************************************************************************************//**
+** \brief     Lets the slave calculate a checksum over a memory region. This takes a
+**            single command, whatever the size of the region.
+** \param     addr Base memory address of the region.
+** \param     len Number of bytes in the region.
+** \param     type Receives the checksum type, XCP_MASTER_CS_CRC32 for a CRC-32.
+** \param     checksum Receives the checksum.
+** \return    SB_TRUE is successfull, SB_FALSE otherwise.
+**
+****************************************************************************************/
+sb_uint8 XcpMasterBuildChecksum(sb_uint32 addr, sb_uint32 len, sb_uint8 *type, sb_uint32 *checksum)
+{
+  sb_uint8 retries = 0;
+
+  /* set the MTA pointer and let the slave calculate the checksum */
+  while ( (XcpMasterSendCmdSetMta(addr) == SB_FALSE) ||
+          (XcpMasterSendCmdBuildChecksum(len, type, checksum) == SB_FALSE) )
+  {
+    if (XcpMasterResync(&retries) == SB_FALSE)
+    {
+      return SB_FALSE;
+    }
+  }
+  return SB_TRUE;
+} /*** end of XcpMasterBuildChecksum ***/
+
+
 /************************************************************************************//**
 ** \brief     Programs data to the slave's non volatile memory. Note that it must be
 **            erased first.
@@ -311,15 +448,26 @@ sb_uint8 XcpMasterProgramData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[])
 {
   sb_uint8 currentWriteCnt;
   sb_uint32 bufferOffset = 0;
+  sb_uint8 retries = 0;
+  sb_uint8 result;
 
   /* first set the MTA pointer */
-  if (XcpMasterSendCmdSetMta(addr) == SB_FALSE)
-  {
-    return SB_FALSE;
-  }
+  result = XcpMasterSendCmdSetMta(addr);
   /* perform segmented programming of the data */
-  while (len > 0)
+  while ( (len > 0) || (result == SB_FALSE) )
   {
+    if (result == SB_FALSE)
+    {
+      /* the slave may or may not have executed the failed command. set the MTA pointer
+       * again and repeat it, programming the same data twice does no harm.
+       */
+      if (XcpMasterResync(&retries) == SB_FALSE)
+      {
+        return SB_FALSE;
+      }
+      result = XcpMasterSendCmdSetMta(addr + bufferOffset);
+      continue;
+    }
     /* set the current read length to make optimal use of the available packet data. */
     currentWriteCnt = len % (xcpMaxProgCto - 1);
     if (currentWriteCnt == 0)
@@ -330,28 +478,106 @@ sb_uint8 XcpMasterProgramData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[])
     if (currentWriteCnt < (xcpMaxProgCto - 1))
     {
       /* program data */
-      if (XcpMasterSendCmdProgram(currentWriteCnt, &data[bufferOffset]) == SB_FALSE)
-      {
-        return SB_FALSE;
-      }
+      result = XcpMasterSendCmdProgram(currentWriteCnt, &data[bufferOffset]);
     }
     else
     {
       /* program max data */
-      if (XcpMasterSendCmdProgramMax(&data[bufferOffset]) == SB_FALSE)
-      {
-        return SB_FALSE;
-      }
+      result = XcpMasterSendCmdProgramMax(&data[bufferOffset]);
+    }
+    if (result == SB_TRUE)
+    {
+      /* update loop variables */
+      len -= currentWriteCnt;
+      bufferOffset += currentWriteCnt;
+      retries = 0;
     }
-    /* update loop variables */
-    len -= currentWriteCnt;
-    bufferOffset += currentWriteCnt;
   }
   /* still here so all data successfully programmed */
   return SB_TRUE;
 } /*** end of XcpMasterProgramData ***/
 
 
+/************************************************************************************//**
+** \brief     Programs data to the slave's non volatile memory like
+**            XcpMasterProgramData(), but transfers it LZ compressed. The slave
+**            decompresses while it programs. Data that does not get smaller, and all
+**            data for a slave that does not support compressed programming, is
+**            programmed uncompressed.
+** \param     addr Base memory address for the program operation
+** \param     len Number of bytes to program.
+** \param     data Source buffer with the to be programmed bytes.
+** \return    SB_TRUE is successfull, SB_FALSE otherwise.
+**
+****************************************************************************************/
+sb_uint8 XcpMasterProgramCompressedData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[])
+{
+  sb_uint8 *compressed;
+  sb_uint32 compressedLen;
+  sb_uint8 currentWriteCnt;
+  sb_uint32 bufferOffset = 0;
+  sb_uint8 unsupported = SB_FALSE;
+  sb_uint8 retries = 0;
+  sb_uint8 result;
+
+  if ((xcpSlaveNoCompression == SB_TRUE) || (len == 0))
+  {
+    return XcpMasterProgramData(addr, len, data);
+  }
+  compressed = (sb_uint8 *)malloc(LZ_COMPRESS_BOUND(len));
+  if (compressed == SB_NULL)
+  {
+    return XcpMasterProgramData(addr, len, data);
+  }
+  compressedLen = LzCompress(data, len, compressed);
+  if (compressedLen >= len)
+  {
+    free(compressed);
+    return XcpMasterProgramData(addr, len, data);
+  }
+
+  /* setting the MTA pointer also starts a new compressed stream on the slave */
+  result = XcpMasterSendCmdSetMta(addr);
+  /* perform segmented programming of the compressed stream */
+  while ( (result == SB_TRUE) && (bufferOffset < compressedLen) )
+  {
+    currentWriteCnt = xcpMaxProgCto - 3;
+    if ((compressedLen - bufferOffset) < currentWriteCnt)
+    {
+      currentWriteCnt = (sb_uint8)(compressedLen - bufferOffset);
+    }
+    result = XcpMasterSendCmdProgramCompressed(currentWriteCnt, &compressed[bufferOffset],
+                                               &unsupported);
+    if (result == SB_TRUE)
+    {
+      bufferOffset += currentWriteCnt;
+    }
+  }
+  free(compressed);
+
+  /* a slave without decompression rejects the very first packet, so nothing has been
+   * programmed yet and the data can be sent the regular way.
+   */
+  if ((result == SB_FALSE) && (unsupported == SB_TRUE) && (bufferOffset == 0))
+  {
+    xcpSlaveNoCompression = SB_TRUE;
+    return XcpMasterProgramData(addr, len, data);
+  }
+  /* after an error, the position of the slave in the compressed stream is unknown. the
+   * data is programmed again uncompressed, which can resume after further errors.
+   */
+  if (result == SB_FALSE)
+  {
+    if (XcpMasterResync(&retries) == SB_FALSE)
+    {
+      return SB_FALSE;
+    }
+    return XcpMasterProgramData(addr, len, data);
+  }
+  return SB_TRUE;
+} /*** end of XcpMasterProgramCompressedData ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP Connect command.
 ** \return    SB_TRUE is successfull, SB_FALSE otherwise.
@@ -407,16 +633,95 @@ static sb_uint8 XcpMasterSendCmdConnect(sb_uint32 flashingTargetID)
   {
     xcpMaxDto = responsePacketPtr->data[5] + (responsePacketPtr->data[4] << 8);
   }
-
-  /* double check size configuration of the master */
-  assert(XCP_MASTER_TX_MAX_DATA >= xcpMaxCto);
-  assert(XCP_MASTER_RX_MAX_DATA >= xcpMaxDto);
+  xcpConnectedTargetID = flashingTargetID;
 
   /* still here so all went well */
   return SB_TRUE;
 } /*** end of XcpMasterSendCmdConnect ***/
 
 
+/************************************************************************************//**
+** \brief     Sends the XCP SYNCH command.
+** \return    SB_TRUE if the slave responded with the synchronization error, SB_FALSE
+**            otherwise.
+**
+****************************************************************************************/
+static sb_uint8 XcpMasterSendCmdSynch(void)
+{
+  sb_uint8 packetData[1];
+  tXcpTransportResponsePacket *responsePacketPtr;
+
+  /* prepare the command packet */
+  packetData[0] = XCP_MASTER_CMD_SYNCH;
+
+  /* send the packet */
+  if (XcpTransportSendPacket(packetData, 1, XCP_MASTER_TIMEOUT_T1_MS) == SB_FALSE)
+  {
+    /* cound not set packet or receive response within the specified timeout */
+    return SB_FALSE;
+  }
+  /* still here so a response was received */
+  responsePacketPtr = XcpTransportReadResponsePacket();
+
+  /* the slave always answers a synch command with this error */
+  if ( (responsePacketPtr->len < 2) || (responsePacketPtr->data[0] != XCP_MASTER_CMD_PID_ERR) ||
+       (responsePacketPtr->data[1] != XCP_ERR_CMD_SYNCH) )
+  {
+    return SB_FALSE;
+  }
+
+  /* still here so all went well */
+  return SB_TRUE;
+} /*** end of XcpMasterSendCmdSynch ***/
+
+
+/************************************************************************************//**
+** \brief     Brings the communication back into a known state after a command or its
+**            response got lost or damaged, so that the command can be repeated. The
+**            transport layer realigns the packet reception of the slave, which must
+**            then answer an XCP SYNCH command. A slave that does not answer, because a
+**            damaged command disconnected it for example, is connected again and put
+**            back into the programming session.
+** \param     retries Number of resynchronizations for the current command so far. It
+**            is incremented by this function.
+** \return    SB_TRUE if the command can be repeated, SB_FALSE if the retries are used
+**            up.
+**
+****************************************************************************************/
+static sb_uint8 XcpMasterResync(sb_uint8 *retries)
+{
+  sb_uint8 cnt;
+
+  while ( (*retries < XCP_MASTER_CMD_RETRIES) &&
+          (xcpSessionResyncs < XCP_MASTER_SESSION_RESYNCS) )
+  {
+    (*retries)++;
+    xcpSessionResyncs++;
+    printf("Resynchronizing (%u/%u)...", *retries, XCP_MASTER_CMD_RETRIES);
+    XcpTransportResync();
+    if (XcpMasterSendCmdSynch() == SB_TRUE)
+    {
+      printf("OK\n");
+      return SB_TRUE;
+    }
+    for (cnt=0; cnt<XCP_MASTER_CONNECT_RETRIES; cnt++)
+    {
+      if (XcpMasterSendCmdConnect(xcpConnectedTargetID) == SB_TRUE)
+      {
+        if ( (xcpProgramming == SB_FALSE) || (XcpMasterSendCmdProgramStart() == SB_TRUE) )
+        {
+          printf("reconnected\n");
+          return SB_TRUE;
+        }
+        break;
+      }
+    }
+    printf("ERROR\n");
+  }
+  return SB_FALSE;
+} /*** end of XcpMasterResync ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP Set MTA command.
 ** \param     address New MTA address for the slave.
@@ -519,6 +824,60 @@ static sb_uint8 XcpMasterSendCmdUpload(sb_uint8 data[], sb_uint8 length)
 } /*** end of XcpMasterSendCmdUpload ***/
 
 
+/************************************************************************************//**
+** \brief     Sends the XCP BUILD CHECKSUM command.
+** \param     length Number of bytes, starting at the MTA, to calculate the checksum of.
+** \param     type Receives the checksum type.
+** \param     checksum Receives the checksum.
+** \return    SB_TRUE is successfull, SB_FALSE otherwise.
+**
+****************************************************************************************/
+static sb_uint8 XcpMasterSendCmdBuildChecksum(sb_uint32 length, sb_uint8 *type, sb_uint32 *checksum)
+{
+  sb_uint8 packetData[8];
+  tXcpTransportResponsePacket *responsePacketPtr;
+
+  /* prepare the command packet */
+  packetData[0] = XCP_MASTER_CMD_BUILD_CHECKSUM;
+  packetData[1] = 0; /* reserved */
+  packetData[2] = 0; /* reserved */
+  packetData[3] = 0; /* reserved */
+
+  /* set the block size taking into account byte ordering */
+  XcpMasterSetOrderedLong(length, &packetData[4]);
+
+  /* send the packet */
+  if (XcpTransportSendPacket(packetData, 8, XCP_MASTER_TIMEOUT_T2_MS) == SB_FALSE)
+  {
+    /* cound not set packet or receive response within the specified timeout */
+    printf("\nno response (build checksum)\n");
+    return SB_FALSE;
+  }
+  /* still here so a response was received */
+  responsePacketPtr = XcpTransportReadResponsePacket();
+
+  /* check if the reponse was valid */
+  if ( (responsePacketPtr->len < 8) || (responsePacketPtr->data[0] != XCP_MASTER_CMD_PID_RES) )
+  {
+    /* not a valid or positive response */
+    if (responsePacketPtr->len == 0) {
+      printf("\nmessage length = 0");
+    } else {
+      XcpMasterPrintError(responsePacketPtr->data[1]);
+    }
+    printf(" (build checksum)\n");
+    return SB_FALSE;
+  }
+
+  /* store the checksum type and value */
+  *type = responsePacketPtr->data[1];
+  *checksum = XcpMasterGetOrderedLong(&responsePacketPtr->data[4]);
+
+  /* still here so all went well */
+  return SB_TRUE;
+} /*** end of XcpMasterSendCmdBuildChecksum ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM START command.
 ** \return    SB_TRUE is successfull, SB_FALSE otherwise.
@@ -662,7 +1021,7 @@ static sb_uint8 XcpMasterSendCmdProgram(sb_uint8 length, sb_uint8 data[])
   sb_uint8 cnt;
 
   /* verify that this number of bytes actually first in this command */
-  assert(length <= (xcpMaxProgCto-2) && (xcpMaxProgCto <= XCP_MASTER_TX_MAX_DATA));
+  assert(length <= (xcpMaxProgCto-2));
 
   /* prepare the command packet */
   packetData[0] = XCP_MASTER_CMD_PROGRAM;
@@ -700,6 +1059,68 @@ static sb_uint8 XcpMasterSendCmdProgram(sb_uint8 length, sb_uint8 data[])
 } /*** end of XcpMasterSendCmdProgram ***/
 
 
+/************************************************************************************//**
+** \brief     Sends the user command with the PROGRAM COMPRESSED sub-command.
+** \param     length Number of bytes in the data array.
+** \param     data Array with the next part of the compressed stream.
+** \param     unsupported Set to SB_TRUE if the slave does not know the command.
+** \return    SB_TRUE is successfull, SB_FALSE otherwise.
+**
+****************************************************************************************/
+static sb_uint8 XcpMasterSendCmdProgramCompressed(sb_uint8 length, sb_uint8 data[], sb_uint8 *unsupported)
+{
+  sb_uint8 packetData[XCP_MASTER_TX_MAX_DATA];
+  tXcpTransportResponsePacket *responsePacketPtr;
+  sb_uint8 cnt;
+
+  /* verify that this number of bytes actually fits in this command */
+  assert(length <= (xcpMaxProgCto-3));
+
+  *unsupported = SB_FALSE;
+
+  /* prepare the command packet */
+  packetData[0] = XCP_MASTER_CMD_USER;
+  packetData[1] = XCP_MASTER_USER_PROGRAM_COMPRESSED;
+  packetData[2] = length;
+  for (cnt=0; cnt<length; cnt++)
+  {
+    packetData[cnt+3] = data[cnt];
+  }
+
+  /* send the packet */
+  if (XcpTransportSendPacket(packetData, length+3, XCP_MASTER_TIMEOUT_T4_MS) == SB_FALSE)
+  {
+    /* cound not set packet or receive response within the specified timeout */
+    printf("\nno response (program compressed)\n");
+    return SB_FALSE;
+  }
+  /* still here so a response was received */
+  responsePacketPtr = XcpTransportReadResponsePacket();
+
+  /* check if the reponse was valid */
+  if ( (responsePacketPtr->len == 0) || (responsePacketPtr->data[0] != XCP_MASTER_CMD_PID_RES) )
+  {
+    /* an older slave does not know the command. the caller falls back silently */
+    if ( (responsePacketPtr->len > 1) && (responsePacketPtr->data[1] == XCP_ERR_CMD_UNKNOWN) )
+    {
+      *unsupported = SB_TRUE;
+      return SB_FALSE;
+    }
+    /* not a valid or positive response */
+    if (responsePacketPtr->len == 0) {
+      printf("\nmessage length = 0");
+    } else {
+      XcpMasterPrintError(responsePacketPtr->data[1]);
+    }
+    printf(" (program compressed)\n");
+    return SB_FALSE;
+  }
+
+  /* still here so all went well */
+  return SB_TRUE;
+} /*** end of XcpMasterSendCmdProgramCompressed ***/
+
+
 /************************************************************************************//**
 ** \brief     Sends the XCP PROGRAM MAX command.
 ** \param     data Array with data bytes to program.
@@ -712,9 +1133,6 @@ static sb_uint8 XcpMasterSendCmdProgramMax(sb_uint8 data[])
   tXcpTransportResponsePacket *responsePacketPtr;
   sb_uint8 cnt;
 
-  /* verify that this number of bytes actually first in this command */
-  assert(xcpMaxProgCto <= XCP_MASTER_TX_MAX_DATA);
-
   /* prepare the command packet */
   packetData[0] = XCP_MASTER_CMD_PROGRAM_MAX;
   for (cnt=0; cnt<(xcpMaxProgCto-1); cnt++)
@@ -798,6 +1216,49 @@ static sb_uint8 XcpMasterSendCmdProgramClear(sb_uint32 length)
 } /*** end of XcpMasterSendCmdProgramClear ***/
 
 
+/************************************************************************************//**
+** \brief     Sends the XCP TRANSPORT_LAYER_CMD command with the SET_BAUDRATE sub-command.
+** \param     baudrate The new communication speed in bits/sec.
+** \param     rejected Set to SB_TRUE if the slave responded that it cannot use the speed.
+** \return    SB_TRUE is successfull, SB_FALSE otherwise.
+**
+****************************************************************************************/
+static sb_uint8 XcpMasterSendCmdSetBaudrate(sb_uint32 baudrate, sb_uint8 *rejected)
+{
+  sb_uint8 packetData[8];
+  tXcpTransportResponsePacket *responsePacketPtr;
+
+  *rejected = SB_FALSE;
+
+  /* prepare the command packet */
+  packetData[0] = XCP_MASTER_CMD_TRANSPORT_LAYER;
+  packetData[1] = XCP_MASTER_TL_SET_BAUDRATE;
+  packetData[2] = 0; /* reserved */
+  packetData[3] = 0; /* reserved */
+  XcpMasterSetOrderedLong(baudrate, &packetData[4]);
+
+  /* send the packet */
+  if (XcpTransportSendPacket(packetData, 8, XCP_MASTER_TIMEOUT_T1_MS) == SB_FALSE)
+  {
+    /* cound not set packet or receive response within the specified timeout */
+    return SB_FALSE;
+  }
+  /* still here so a response was received */
+  responsePacketPtr = XcpTransportReadResponsePacket();
+
+  /* check if the reponse was valid */
+  if ( (responsePacketPtr->len == 0) || (responsePacketPtr->data[0] != XCP_MASTER_CMD_PID_RES) )
+  {
+    /* not a valid or positive response */
+    *rejected = SB_TRUE;
+    return SB_FALSE;
+  }
+
+  /* still here so all went well */
+  return SB_TRUE;
+} /*** end of XcpMasterSendCmdSetBaudrate ***/
+
+
 /************************************************************************************//**
 ** \brief     Stores a 32-bit value into a byte buffer taking into account Intel
 **            or Motorola byte ordering.
@@ -825,6 +1286,25 @@ static void XcpMasterSetOrderedLong(sb_uint32 value, sb_uint8 data[])
 } /*** end of XcpMasterSetOrderedLong ***/
 
 
+/************************************************************************************//**
+** \brief     Reads a 32-bit value from a byte buffer taking into account Intel
+**            or Motorola byte ordering.
+** \param     data Array with the 4 bytes of the value.
+** \return    The 32-bit value.
+**
+****************************************************************************************/
+static sb_uint32 XcpMasterGetOrderedLong(sb_uint8 data[])
+{
+  if (xcpSlaveIsIntel == SB_TRUE)
+  {
+    return ((sb_uint32)data[3] << 24) | ((sb_uint32)data[2] << 16) |
+           ((sb_uint32)data[1] <<  8) | (sb_uint32)data[0];
+  }
+  return ((sb_uint32)data[0] << 24) | ((sb_uint32)data[1] << 16) |
+         ((sb_uint32)data[2] <<  8) | (sb_uint32)data[3];
+} /*** end of XcpMasterGetOrderedLong ***/
+
+
 
 
 
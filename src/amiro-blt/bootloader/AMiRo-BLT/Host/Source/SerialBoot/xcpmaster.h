@@ -46,6 +46,11 @@
  */
 #define XCP_MASTER_RX_MAX_DATA         (255)
 
+/** \brief Checksum type of XcpMasterBuildChecksum() for the CRC-32 as calculated by
+ *         CrcCalculate32().
+ */
+#define XCP_MASTER_CS_CRC32            (0x09)
+
 
 /****************************************************************************************
 * Include files
@@ -63,9 +68,12 @@ sb_uint8 XcpMasterDisconnect(void);
 sb_uint8 XcpMasterProgramReset(void);
 sb_uint8 XcpMasterStartProgrammingSession(void);
 sb_uint8 XcpMasterStopProgrammingSession(void);
+sb_uint8 XcpMasterSetBaudrate(sb_uint32 baudrate, sb_uint32 fallback);
 sb_uint8 XcpMasterClearMemory(sb_uint32 addr, sb_uint32 len);
 sb_uint8 XcpMasterReadData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[]);
+sb_uint8 XcpMasterBuildChecksum(sb_uint32 addr, sb_uint32 len, sb_uint8 *type, sb_uint32 *checksum);
 sb_uint8 XcpMasterProgramData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[]);
+sb_uint8 XcpMasterProgramCompressedData(sb_uint32 addr, sb_uint32 len, sb_uint8 data[]);
 
 
 #endif /* XCPMASTER_H */
@@ -0,0 +1,833 @@
+/************************************************************************************//**
+* \file         bench.c
+* \brief        XcpBench program that measures the SerialBoot throughput against XcpSim.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdio.h>                                    /* standard I/O library          */
+#include <stdlib.h>                                   /* standard library              */
+#include <string.h>                                   /* string function definitions   */
+#include <unistd.h>                                   /* UNIX standard functions       */
+#include <fcntl.h>                                    /* file control definitions      */
+#include <signal.h>                                   /* signal handling               */
+#include <time.h>                                     /* monotonic clock               */
+#include <sys/stat.h>                                 /* file status                   */
+#include <sys/wait.h>                                 /* child process handling        */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code if all went ok. */
+#define PROG_RESULT_OK           (0)
+/** \brief Program return code if an error occurred. */
+#define PROG_RESULT_ERROR        (1)
+/** \brief Start address of the user program, behind the bootloader sectors. */
+#define BENCH_IMAGE_BASE         (0x08008000)
+/** \brief Offset of the vector table checksum that the bootloader writes itself. */
+#define BENCH_CHECKSUM_OFFSET    (0x1ac)
+/** \brief Number of vectors covered by the vector table checksum. */
+#define BENCH_CHECKSUM_VECTORS   (7)
+/** \brief Offset of the image length and CRC-32 that the bootloader writes itself. */
+#define BENCH_CRC_OFFSET         (BENCH_CHECKSUM_OFFSET + 4)
+/** \brief Start address of the simulated flash memory. */
+#define BENCH_FLASH_BASE         (0x08000000)
+/** \brief Maximum number of simulated nodes in one benchmark mode. */
+#define BENCH_MAX_NODES          (3)
+/** \brief Maximum length of a path built by the benchmark. */
+#define BENCH_PATH_LEN           (512)
+/** \brief Time to wait for the simulator to create its pseudo terminal in ms. */
+#define BENCH_STARTUP_TIMEOUT_MS (3000)
+
+#ifndef BENCH_SERIALBOOT
+/** \brief Default location of the SerialBoot executable. */
+#define BENCH_SERIALBOOT         "SerialBoot"
+#endif
+#ifndef BENCH_XCPSIM
+/** \brief Default location of the XcpSim executable. */
+#define BENCH_XCPSIM             "XcpSim"
+#endif
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief A node that takes part in a benchmark mode. */
+typedef struct
+{
+  unsigned int deviceId;                         /**< device ID, as used by -T         */
+  const char  *tag;                              /**< short name for file names        */
+} tBenchNode;
+
+/** \brief A benchmark mode, i.e. a SerialBoot use case. */
+typedef struct
+{
+  const char      *name;                         /**< name printed in the results      */
+  unsigned char    flashMain;                    /**< 1 to flash the main device       */
+  unsigned char    nodeCount;                    /**< number of relayed nodes          */
+  tBenchNode       nodes[BENCH_MAX_NODES];       /**< relayed nodes                    */
+} tBenchMode;
+
+/** \brief Statistics of one simulated node, as written by XcpSim -o. */
+typedef struct
+{
+  unsigned long long progRoundTrips;
+  unsigned long long progPayloadBytes;
+  unsigned long long progSessions;
+  unsigned long long progTimeUs;
+  unsigned long long uartRxBytes;
+  unsigned long long uartTxBytes;
+  unsigned long long canFramesTx;
+} tBenchStats;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void     DisplayProgramUsage(void);
+static int      ParseCommandLine(int argc, char *argv[]);
+static void     BenchMakeImage(unsigned char *image, unsigned int size, unsigned int seed);
+static int      BenchWriteSrec(const char *file, const unsigned char *image,
+                               unsigned int size, unsigned int lineLen);
+static int      BenchVerify(const char *flashFile, const unsigned char *image, unsigned int size);
+static unsigned int BenchCrc32(unsigned int crc, const unsigned char *data, unsigned int len);
+static unsigned int BenchGetLong(const unsigned char *data);
+static int      BenchReadStats(const char *file, tBenchStats *stats);
+static pid_t    BenchSpawn(char *const argv[], const char *logFile);
+static int      BenchWait(pid_t pid, unsigned int timeoutMs);
+static double   BenchGetTime(void);
+static int      BenchRunMode(const tBenchMode *mode);
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Main device (PowerManagement), which is flashed without -T. */
+static const tBenchNode benchMain = { 0x01010101, "pm" };
+
+/** \brief The SerialBoot use cases that are benchmarked. */
+static const tBenchMode benchModes[] =
+{
+  /* single firmware on the main device, no CAN traffic */
+  { "direct",  1, 0, { { 0 } } },
+  /* single firmware on a board behind the CAN gateway */
+  { "relayed", 0, 1, { { 0x01000101, "dwd" } } },
+  /* all boards of the robot in one SerialBoot run */
+  { "robot",   1, 2, { { 0x01000101, "dwd" }, { 0x017F0100, "lr" } } }
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+static const char   *benchSerialBoot = BENCH_SERIALBOOT;
+static const char   *benchXcpSim = BENCH_XCPSIM;
+static const char   *benchWorkDir = "/tmp/xcpbench";
+static unsigned int  benchImageKb = 32;
+static unsigned int  benchLineLen = 16;
+static unsigned int  benchBaudrate = 115200;
+static unsigned int  benchBaudrateMax = 0;
+static int           benchCompress = 0;
+static const char   *benchRelayLatency = "20";
+static const char   *benchCorruptPpm = "0";
+static const char   *benchLossPpm = "0";
+static const char   *benchModeFilter;
+static unsigned int  benchTimeoutS = 120;
+
+
+/************************************************************************************//**
+** \brief     Program entry point.
+** \param     argc Number of program parameters.
+** \param     argv array to program parameter strings.
+** \return    0 on success, > 0 on error.
+**
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+  unsigned char idx;
+  int result = PROG_RESULT_OK;
+
+  setbuf(stdout, NULL);
+
+  if (ParseCommandLine(argc, argv) == 0)
+  {
+    DisplayProgramUsage();
+    return PROG_RESULT_ERROR;
+  }
+  if ((mkdir(benchWorkDir, 0755) == -1) && (access(benchWorkDir, W_OK) == -1))
+  {
+    perror(benchWorkDir);
+    return PROG_RESULT_ERROR;
+  }
+
+  printf("XcpBench: %u KB image per device, %u data bytes per S-record, %u bits/s\n",
+         benchImageKb, benchLineLen, benchBaudrate);
+  if (benchBaudrateMax > 0)
+  {
+    printf("XcpBench: negotiating up to %u bits/s\n", benchBaudrateMax);
+  }
+  if (benchCompress != 0)
+  {
+    printf("XcpBench: compressed transfer\n");
+  }
+  printf("XcpBench: CAN relay latency %s us, corruption %s ppm, loss %s ppm\n\n",
+         benchRelayLatency, benchCorruptPpm, benchLossPpm);
+  printf("%-8s %8s %10s %8s %8s %8s %10s %10s %8s %8s\n", "mode", "image", "image", "sent",
+         "round", "trips", "session", "total", "CAN", "verify");
+  printf("%-8s %8s %10s %8s %8s %8s %10s %10s %8s %8s\n", "", "[bytes]", "[bytes/s]", "[bytes]",
+         "trips", "per KB", "[s]", "[s]", "frames", "");
+
+  for (idx = 0; idx < sizeof(benchModes)/sizeof(benchModes[0]); idx++)
+  {
+    if ((benchModeFilter != NULL) && (strcmp(benchModeFilter, benchModes[idx].name) != 0))
+    {
+      continue;
+    }
+    if (BenchRunMode(&benchModes[idx]) == 0)
+    {
+      result = PROG_RESULT_ERROR;
+    }
+  }
+  return result;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about how to use this program.
+** \return    none.
+**
+****************************************************************************************/
+static void DisplayProgramUsage(void)
+{
+  printf("Usage: XcpBench [options]\n\n");
+  printf("Flashes generated firmware images with SerialBoot into XcpSim and reports the\n");
+  printf("throughput of every SerialBoot use case (direct, relayed, robot).\n\n");
+  printf("Options:\n");
+  printf("  -S<file>       SerialBoot executable (default %s)\n", BENCH_SERIALBOOT);
+  printf("  -X<file>       XcpSim executable (default %s)\n", BENCH_XCPSIM);
+  printf("  -w<dir>        working directory (default /tmp/xcpbench)\n");
+  printf("  -m<mode>       run a single mode only\n");
+  printf("  -t<s>          time after which a SerialBoot run fails (default 120)\n");
+  printf("  -k<KB>         image size per device (default 32)\n");
+  printf("  -L<bytes>      data bytes per S-record (default 16)\n");
+  printf("  -b<baudrate>   UART speed in bits/s (default 115200)\n");
+  printf("  -B<baudrate>   highest UART speed SerialBoot negotiates (default off)\n");
+  printf("  -z             let SerialBoot transfer the data compressed\n");
+  printf("  -r<us>         latency per CAN frame and hop (default 20)\n");
+  printf("  -e<ppm>        UART byte corruption rate (default 0)\n");
+  printf("  -x<ppm>        UART byte loss rate (default 0)\n\n");
+  printf("Example:    XcpBench -k64 -L32 -b921600\n");
+} /*** end of DisplayProgramUsage ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the command line arguments.
+** \param     argc Number of program parameters.
+** \param     argv array to program parameter strings.
+** \return    1 on success, 0 otherwise.
+**
+****************************************************************************************/
+static int ParseCommandLine(int argc, char *argv[])
+{
+  int idx;
+
+  for (idx = 1; idx < argc; idx++)
+  {
+    if ((argv[idx][0] != '-') || (argv[idx][1] == '\0'))
+    {
+      return 0;
+    }
+    switch (argv[idx][1])
+    {
+      case 'S':
+        benchSerialBoot = &argv[idx][2];
+        break;
+      case 'X':
+        benchXcpSim = &argv[idx][2];
+        break;
+      case 'w':
+        benchWorkDir = &argv[idx][2];
+        break;
+      case 'm':
+        benchModeFilter = &argv[idx][2];
+        break;
+      case 't':
+        benchTimeoutS = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'k':
+        benchImageKb = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'L':
+        benchLineLen = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'b':
+        benchBaudrate = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'B':
+        benchBaudrateMax = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'z':
+        benchCompress = 1;
+        break;
+      case 'r':
+        benchRelayLatency = &argv[idx][2];
+        break;
+      case 'e':
+        benchCorruptPpm = &argv[idx][2];
+        break;
+      case 'x':
+        benchLossPpm = &argv[idx][2];
+        break;
+      default:
+        return 0;
+    }
+  }
+  /* S3 records carry at most 255-5 bytes, SerialBoot buffers lines of up to 255 chars */
+  if ((benchImageKb == 0) || (benchImageKb > 512) || (benchLineLen == 0) ||
+      (benchLineLen > 112) || (benchBaudrate == 0) || (benchTimeoutS == 0))
+  {
+    return 0;
+  }
+  return 1;
+} /*** end of ParseCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Generates a deterministic image that resembles a firmware: a vector table,
+**            code-like data, constant tables and erased padding.
+** \param     image Buffer for the image.
+** \param     size  Size of the image in bytes, a multiple of 1024.
+** \param     seed  Seed, so that every device gets a different image.
+** \return    none.
+**
+****************************************************************************************/
+static void BenchMakeImage(unsigned char *image, unsigned int size, unsigned int seed)
+{
+  unsigned int state = seed | 1u;
+  unsigned int idx;
+  unsigned int vector;
+
+  /* code-like data from a xorshift generator */
+  for (idx = 0; idx < size; idx++)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    image[idx] = (unsigned char)state;
+  }
+  /* vector table with the stack pointer and thumb addresses inside the image */
+  for (idx = 0; idx < 0x200; idx += 4)
+  {
+    vector = (idx == 0) ? 0x20020000u : (BENCH_IMAGE_BASE + 0x200u + ((idx * 37u) % (size - 0x200u))) | 1u;
+    image[idx+0] = (unsigned char)vector;
+    image[idx+1] = (unsigned char)(vector >> 8);
+    image[idx+2] = (unsigned char)(vector >> 16);
+    image[idx+3] = (unsigned char)(vector >> 24);
+  }
+  /* a repeated constant table in the last quarter, followed by erased padding */
+  for (idx = size - size / 4; idx < size - size / 16; idx++)
+  {
+    image[idx] = (unsigned char)(idx % 64);
+  }
+  memset(&image[size - size / 16], 0xff, size / 16);
+} /*** end of BenchMakeImage ***/
+
+
+/************************************************************************************//**
+** \brief     Writes an image as a Motorola S-record file with S3 data records.
+** \param     file    Name of the S-record file.
+** \param     image   Image data, located at BENCH_IMAGE_BASE.
+** \param     size    Size of the image in bytes.
+** \param     lineLen Number of data bytes per S3 record.
+** \return    1 on success, 0 otherwise.
+**
+****************************************************************************************/
+static int BenchWriteSrec(const char *file, const unsigned char *image,
+                          unsigned int size, unsigned int lineLen)
+{
+  FILE *fp;
+  unsigned int offset;
+  unsigned int count;
+  unsigned int addr;
+  unsigned int idx;
+  unsigned char checksum;
+
+  fp = fopen(file, "w");
+  if (fp == NULL)
+  {
+    perror(file);
+    return 0;
+  }
+  fprintf(fp, "S00F000078637062656E63682E7372656393\n");
+  for (offset = 0; offset < size; offset += count)
+  {
+    count = ((size - offset) < lineLen) ? (size - offset) : lineLen;
+    addr = BENCH_IMAGE_BASE + offset;
+    checksum = (unsigned char)(count + 5);
+    checksum += (unsigned char)(addr >> 24) + (unsigned char)(addr >> 16);
+    checksum += (unsigned char)(addr >> 8) + (unsigned char)addr;
+    fprintf(fp, "S3%02X%08X", count + 5, addr);
+    for (idx = 0; idx < count; idx++)
+    {
+      fprintf(fp, "%02X", image[offset+idx]);
+      checksum += image[offset+idx];
+    }
+    fprintf(fp, "%02X\n", (unsigned char)~checksum);
+  }
+  addr = BENCH_IMAGE_BASE;
+  checksum = (unsigned char)(5 + (unsigned char)(addr >> 24) + (unsigned char)(addr >> 16) +
+                             (unsigned char)(addr >> 8) + (unsigned char)addr);
+  fprintf(fp, "S705%08X%02X\n", addr, (unsigned char)~checksum);
+  fclose(fp);
+  return 1;
+} /*** end of BenchWriteSrec ***/
+
+
+/************************************************************************************//**
+** \brief     Compares the flash file of a simulated node with the programmed image. The
+**            checksum, image length and CRC-32 words, which the bootloader writes
+**            itself, are checked separately.
+** \param     flashFile Name of the flash file.
+** \param     image     Image that was programmed.
+** \param     size      Size of the image in bytes.
+** \return    1 if the flash contents are correct, 0 otherwise.
+**
+****************************************************************************************/
+static int BenchVerify(const char *flashFile, const unsigned char *image, unsigned int size)
+{
+  unsigned char *flash;
+  unsigned int sum = 0;
+  unsigned int crc;
+  unsigned int idx;
+  FILE *fp;
+  int result = 0;
+
+  flash = malloc(size);
+  fp = fopen(flashFile, "rb");
+  if ((flash == NULL) || (fp == NULL) ||
+      (fseek(fp, BENCH_IMAGE_BASE - BENCH_FLASH_BASE, SEEK_SET) != 0) ||
+      (fread(flash, 1, size, fp) != size))
+  {
+    goto done;
+  }
+  for (idx = 0; idx < size; idx++)
+  {
+    if ((idx >= BENCH_CHECKSUM_OFFSET) && (idx < BENCH_CRC_OFFSET + 8))
+    {
+      continue;
+    }
+    if (flash[idx] != image[idx])
+    {
+      goto done;
+    }
+  }
+  /* the two's complement of the sum of the first vectors */
+  for (idx = 0; idx <= BENCH_CHECKSUM_VECTORS; idx++)
+  {
+    sum += BenchGetLong(&flash[(idx < BENCH_CHECKSUM_VECTORS) ? (idx * 4) : BENCH_CHECKSUM_OFFSET]);
+  }
+  if ((sum != 0) || (BenchGetLong(&flash[BENCH_CRC_OFFSET]) != size))
+  {
+    goto done;
+  }
+  /* the CRC-32 of the image without the length and CRC-32 words */
+  crc = BenchCrc32(0, flash, BENCH_CRC_OFFSET);
+  crc = BenchCrc32(crc, &flash[BENCH_CRC_OFFSET + 8], size - (BENCH_CRC_OFFSET + 8));
+  result = (crc == BenchGetLong(&flash[BENCH_CRC_OFFSET + 4])) ? 1 : 0;
+
+done:
+  if (fp != NULL)
+  {
+    fclose(fp);
+  }
+  free(flash);
+  return result;
+} /*** end of BenchVerify ***/
+
+
+/************************************************************************************//**
+** \brief     Continues a CRC-32 calculation as done by the bootloader and zlib.
+** \param     crc  CRC-32 of the preceding data, 0 if there is none.
+** \param     data Data bytes.
+** \param     len  Number of data bytes.
+** \return    The CRC-32 including the data.
+**
+****************************************************************************************/
+static unsigned int BenchCrc32(unsigned int crc, const unsigned char *data, unsigned int len)
+{
+  unsigned int bit;
+
+  crc = ~crc;
+  while (len-- > 0)
+  {
+    crc ^= *data++;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1u) ? ((crc >> 1) ^ 0xedb88320u) : (crc >> 1);
+    }
+  }
+  return ~crc;
+} /*** end of BenchCrc32 ***/
+
+
+/************************************************************************************//**
+** \brief     Reads a little endian 32-bit value.
+** \param     data Pointer to the first byte.
+** \return    The value.
+**
+****************************************************************************************/
+static unsigned int BenchGetLong(const unsigned char *data)
+{
+  return (unsigned int)data[0] | ((unsigned int)data[1] << 8) |
+         ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+} /*** end of BenchGetLong ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the statistics file of a simulated node.
+** \param     file  Name of the statistics file.
+** \param     stats Statistics, zero if the file does not exist.
+** \return    1 if the file was read, 0 otherwise.
+**
+****************************************************************************************/
+static int BenchReadStats(const char *file, tBenchStats *stats)
+{
+  char key[64];
+  unsigned long long value;
+  FILE *fp;
+
+  memset(stats, 0, sizeof(*stats));
+  fp = fopen(file, "r");
+  if (fp == NULL)
+  {
+    return 0;
+  }
+  while (fscanf(fp, " %63[^=]=%llu", key, &value) == 2)
+  {
+    if (strcmp(key, "prog_round_trips") == 0)        stats->progRoundTrips = value;
+    else if (strcmp(key, "prog_payload_bytes") == 0) stats->progPayloadBytes = value;
+    else if (strcmp(key, "prog_sessions") == 0)      stats->progSessions = value;
+    else if (strcmp(key, "prog_time_us") == 0)       stats->progTimeUs = value;
+    else if (strcmp(key, "uart_rx_bytes") == 0)      stats->uartRxBytes = value;
+    else if (strcmp(key, "uart_tx_bytes") == 0)      stats->uartTxBytes = value;
+    else if (strcmp(key, "can_frames_tx") == 0)      stats->canFramesTx = value;
+  }
+  fclose(fp);
+  return 1;
+} /*** end of BenchReadStats ***/
+
+
+/************************************************************************************//**
+** \brief     Starts a program with its output redirected to a log file.
+** \param     argv     Program and its arguments, terminated by NULL.
+** \param     logFile  File that receives stdout and stderr.
+** \return    Process ID, or -1 on error.
+**
+****************************************************************************************/
+static pid_t BenchSpawn(char *const argv[], const char *logFile)
+{
+  pid_t pid;
+  int fd;
+
+  pid = fork();
+  if (pid == 0)
+  {
+    fd = open(logFile, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd != -1)
+    {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    execv(argv[0], argv);
+    perror(argv[0]);
+    _exit(127);
+  }
+  if (pid == -1)
+  {
+    perror("fork");
+  }
+  return pid;
+} /*** end of BenchSpawn ***/
+
+
+/************************************************************************************//**
+** \brief     Waits for a process to terminate.
+** \param     pid       Process ID.
+** \param     timeoutMs Time after which the process is killed.
+** \return    Exit code of the process, or -1 if it did not exit normally.
+**
+****************************************************************************************/
+static int BenchWait(pid_t pid, unsigned int timeoutMs)
+{
+  double deadline = BenchGetTime() + timeoutMs / 1000.0;
+  int status;
+
+  while (waitpid(pid, &status, WNOHANG) == 0)
+  {
+    if (BenchGetTime() > deadline)
+    {
+      kill(pid, SIGKILL);
+      waitpid(pid, &status, 0);
+      return -1;
+    }
+    usleep(1000);
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+} /*** end of BenchWait ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the time of the monotonic clock.
+** \return    Time in seconds.
+**
+****************************************************************************************/
+static double BenchGetTime(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+} /*** end of BenchGetTime ***/
+
+
+/************************************************************************************//**
+** \brief     Runs one benchmark mode and prints its results.
+** \param     mode The benchmark mode.
+** \return    1 if the firmware was flashed and verified, 0 otherwise.
+**
+****************************************************************************************/
+static int BenchRunMode(const tBenchMode *mode)
+{
+  static char paths[4 + 3 * (BENCH_MAX_NODES + 1)][BENCH_PATH_LEN];
+  static char nodeArgs[BENCH_MAX_NODES][BENCH_PATH_LEN];
+  static char targetArgs[BENCH_MAX_NODES][32];
+  static char ptyArg[BENCH_PATH_LEN + 2];
+  static char flashArg[BENCH_PATH_LEN + 2];
+  static char statsArg[BENCH_PATH_LEN + 2];
+  static char deviceArg[BENCH_PATH_LEN + 2];
+  char baudArg[32];
+  char baudMaxArg[32];
+  char simBaudArg[32];
+  char latencyArg[32];
+  char corruptArg[32];
+  char lossArg[32];
+  char *simArgv[16];
+  char *sbArgv[16];
+  const tBenchNode *devices[BENCH_MAX_NODES + 1];
+  unsigned char *images[BENCH_MAX_NODES + 1];
+  char *ptyFile = paths[0];
+  char *statsFile = paths[1];
+  char *simLog = paths[2];
+  char *sbLog = paths[3];
+  char *flashFiles[BENCH_MAX_NODES + 1];
+  char *srecFiles[BENCH_MAX_NODES + 1];
+  char *nodeStats[BENCH_MAX_NODES + 1];
+  unsigned int size = benchImageKb * 1024u;
+  unsigned int deviceCount = 0;
+  unsigned int idx;
+  unsigned int argIdx;
+  unsigned int verified = 1;
+  unsigned long long canFrames = 0;
+  unsigned long long imageBytes = 0;
+  tBenchStats stats;
+  tBenchStats nodeStat;
+  struct stat info;
+  double startTime;
+  double totalTime;
+  pid_t simPid;
+  pid_t sbPid;
+  int sbResult;
+
+  /* the main device is always simulated, because it is the gateway */
+  devices[deviceCount++] = &benchMain;
+  for (idx = 0; idx < mode->nodeCount; idx++)
+  {
+    devices[deviceCount++] = &mode->nodes[idx];
+  }
+  snprintf(ptyFile, BENCH_PATH_LEN, "%s/%s.pty", benchWorkDir, mode->name);
+  snprintf(statsFile, BENCH_PATH_LEN, "%s/%s.stats", benchWorkDir, mode->name);
+  snprintf(simLog, BENCH_PATH_LEN, "%s/%s.xcpsim.log", benchWorkDir, mode->name);
+  snprintf(sbLog, BENCH_PATH_LEN, "%s/%s.serialboot.log", benchWorkDir, mode->name);
+  unlink(simLog);
+  unlink(sbLog);
+  for (idx = 0; idx < deviceCount; idx++)
+  {
+    flashFiles[idx] = paths[4 + 3 * idx];
+    srecFiles[idx] = paths[5 + 3 * idx];
+    nodeStats[idx] = paths[6 + 3 * idx];
+    snprintf(flashFiles[idx], BENCH_PATH_LEN, "%s/%s.%s.bin", benchWorkDir, mode->name, devices[idx]->tag);
+    snprintf(srecFiles[idx], BENCH_PATH_LEN, "%s/%s.%s.srec", benchWorkDir, mode->name, devices[idx]->tag);
+    if (idx == 0)
+    {
+      snprintf(nodeStats[idx], BENCH_PATH_LEN, "%s", statsFile);
+    }
+    else if (snprintf(nodeStats[idx], BENCH_PATH_LEN, "%s.%08X", statsFile,
+                      devices[idx]->deviceId) >= BENCH_PATH_LEN)
+    {
+      /* the work directory path is too long for the per node statistics */
+      return 0;
+    }
+    unlink(flashFiles[idx]);
+    unlink(nodeStats[idx]);
+    images[idx] = malloc(size);
+    if (images[idx] == NULL)
+    {
+      return 0;
+    }
+    BenchMakeImage(images[idx], size, devices[idx]->deviceId);
+    if (BenchWriteSrec(srecFiles[idx], images[idx], size, benchLineLen) == 0)
+    {
+      return 0;
+    }
+  }
+
+  /* start the simulator with the main device and the relayed nodes */
+  snprintf(ptyArg, sizeof(ptyArg), "-l%s", ptyFile);
+  snprintf(flashArg, sizeof(flashArg), "-f%s", flashFiles[0]);
+  snprintf(statsArg, sizeof(statsArg), "-o%s", statsFile);
+  snprintf(simBaudArg, sizeof(simBaudArg), "-b%u", benchBaudrate);
+  snprintf(latencyArg, sizeof(latencyArg), "-r%s", benchRelayLatency);
+  snprintf(corruptArg, sizeof(corruptArg), "-e%s", benchCorruptPpm);
+  snprintf(lossArg, sizeof(lossArg), "-x%s", benchLossPpm);
+  argIdx = 0;
+  simArgv[argIdx++] = (char *)benchXcpSim;
+  simArgv[argIdx++] = ptyArg;
+  simArgv[argIdx++] = flashArg;
+  simArgv[argIdx++] = statsArg;
+  simArgv[argIdx++] = simBaudArg;
+  simArgv[argIdx++] = latencyArg;
+  simArgv[argIdx++] = corruptArg;
+  simArgv[argIdx++] = lossArg;
+  for (idx = 1; idx < deviceCount; idx++)
+  {
+    snprintf(nodeArgs[idx-1], BENCH_PATH_LEN, "-N0x%08X:%s", devices[idx]->deviceId, flashFiles[idx]);
+    simArgv[argIdx++] = nodeArgs[idx-1];
+  }
+  simArgv[argIdx] = NULL;
+  unlink(ptyFile);
+  simPid = BenchSpawn(simArgv, simLog);
+  if (simPid == -1)
+  {
+    return 0;
+  }
+  startTime = BenchGetTime();
+  while (lstat(ptyFile, &info) == -1)
+  {
+    if ((BenchGetTime() - startTime > BENCH_STARTUP_TIMEOUT_MS / 1000.0) ||
+        (waitpid(simPid, NULL, WNOHANG) != 0))
+    {
+      fprintf(stderr, "XcpBench: XcpSim did not start, see %s\n", simLog);
+      kill(simPid, SIGKILL);
+      waitpid(simPid, NULL, 0);
+      return 0;
+    }
+    usleep(1000);
+  }
+
+  /* flash all devices of this mode in a single SerialBoot run */
+  snprintf(deviceArg, sizeof(deviceArg), "-d%s", ptyFile);
+  snprintf(baudArg, sizeof(baudArg), "-b%u", benchBaudrate);
+  argIdx = 0;
+  sbArgv[argIdx++] = (char *)benchSerialBoot;
+  sbArgv[argIdx++] = deviceArg;
+  sbArgv[argIdx++] = baudArg;
+  if (benchBaudrateMax > 0)
+  {
+    snprintf(baudMaxArg, sizeof(baudMaxArg), "-B%u", benchBaudrateMax);
+    sbArgv[argIdx++] = baudMaxArg;
+  }
+  if (benchCompress != 0)
+  {
+    sbArgv[argIdx++] = "-z";
+  }
+  if (mode->flashMain != 0)
+  {
+    sbArgv[argIdx++] = srecFiles[0];
+  }
+  for (idx = 1; idx < deviceCount; idx++)
+  {
+    snprintf(targetArgs[idx-1], sizeof(targetArgs[idx-1]), "-T0x%08X", devices[idx]->deviceId);
+    sbArgv[argIdx++] = targetArgs[idx-1];
+    sbArgv[argIdx++] = srecFiles[idx];
+  }
+  sbArgv[argIdx] = NULL;
+  startTime = BenchGetTime();
+  sbPid = BenchSpawn(sbArgv, sbLog);
+  sbResult = (sbPid == -1) ? -1 : BenchWait(sbPid, benchTimeoutS * 1000u);
+  totalTime = BenchGetTime() - startTime;
+
+  /* the main device exits after the reset. stop it in case it did not get that far. */
+  kill(simPid, SIGTERM);
+  waitpid(simPid, NULL, 0);
+
+  /* the main device observes the XCP traffic of all sessions on its UART */
+  BenchReadStats(statsFile, &stats);
+  for (idx = 0; idx < deviceCount; idx++)
+  {
+    BenchReadStats(nodeStats[idx], &nodeStat);
+    canFrames += nodeStat.canFramesTx;
+    if ((idx != 0) || (mode->flashMain != 0))
+    {
+      imageBytes += size;
+      if (BenchVerify(flashFiles[idx], images[idx], size) == 0)
+      {
+        verified = 0;
+      }
+    }
+    free(images[idx]);
+  }
+  if (sbResult != 0)
+  {
+    verified = 0;
+  }
+
+  /* throughput is based on the image size, so a compressed transfer (-z) is credited
+   * with the data it programs rather than the smaller number of bytes it sends.
+   */
+  printf("%-8s %8llu %10.0f %8llu %8llu %8.1f %10.3f %10.3f %8llu %8s\n", mode->name,
+         imageBytes,
+         (stats.progTimeUs > 0) ? (imageBytes * 1e6 / (double)stats.progTimeUs) : 0.0,
+         stats.progPayloadBytes,
+         stats.progRoundTrips,
+         (imageBytes > 0) ? (stats.progRoundTrips * 1024.0 / (double)imageBytes) : 0.0,
+         stats.progTimeUs / 1e6, totalTime, canFrames, (verified != 0) ? "OK" : "FAILED");
+  if (verified == 0)
+  {
+    fprintf(stderr, "XcpBench: %s failed, see %s and %s\n", mode->name, sbLog, simLog);
+  }
+  return (int)verified;
+} /*** end of BenchRunMode ***/
+
+
+/*********************************** end of bench.c ************************************/
@@ -0,0 +1,920 @@
+/************************************************************************************//**
+* \file         link.c
+* \brief        Model of the UART and CAN links of the simulated nodes.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdio.h>                                    /* standard I/O library          */
+#include <stdlib.h>                                   /* standard library              */
+#include <string.h>                                   /* string function definitions   */
+#include <unistd.h>                                   /* UNIX standard functions       */
+#include <errno.h>                                    /* error number definitions      */
+#include <signal.h>                                   /* signal handling               */
+#include <poll.h>                                     /* descriptor polling            */
+#include <time.h>                                     /* monotonic clock and sleep     */
+#include <termios.h>                                  /* POSIX terminal control        */
+#include <sys/prctl.h>                                /* timer slack control           */
+#include <sys/socket.h>                               /* CAN frame sockets             */
+#include "link.h"                                     /* link model                    */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Size of the UART byte queues in each direction. Must be a power of 2. */
+#define LINK_UART_QUEUE_SIZE      (4096)
+/** \brief Size of the CAN reception queue. Must be a power of 2. */
+#define LINK_CAN_QUEUE_SIZE       (256)
+/** \brief Longest time in microseconds that LinkIdle() sleeps without looking at I/O. */
+#define LINK_IDLE_MAX_US          (1000)
+/** \brief Bits of a standard CAN data frame without payload, including the interframe
+ *         space. Bit stuffing adds approximately another 10 percent on average.
+ */
+#define LINK_CAN_FRAME_OVERHEAD   (47)
+
+/* XCP command codes that the packet observer tracks for the statistics */
+/** \brief PROGRAM_START command code. */
+#define XCP_CMD_PROGRAM_START     (0xd2)
+/** \brief PROGRAM command code. */
+#define XCP_CMD_PROGRAM           (0xd0)
+/** \brief PROGRAM_MAX command code. */
+#define XCP_CMD_PROGRAM_MAX       (0xc9)
+/** \brief User command code. */
+#define XCP_CMD_USER              (0xf1)
+/** \brief PROGRAM_COMPRESSED sub-command code of the user command. */
+#define XCP_USER_PROGRAM_COMPRESSED (0x01)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief A byte on the simulated UART line together with the time it is complete. */
+typedef struct
+{
+  uint64_t timeUs;
+  uint8_t  data;
+  uint8_t  error;                                /**< 1 if received with framing error */
+} tLinkUartByte;
+
+/** \brief Queue of bytes on the simulated UART line. */
+typedef struct
+{
+  tLinkUartByte entries[LINK_UART_QUEUE_SIZE];
+  uint32_t      head;
+  uint32_t      tail;
+  uint64_t      lineFreeUs;                      /**< time the line becomes idle       */
+} tLinkUartQueue;
+
+/** \brief Reassembles the [len][data] UART framing to observe XCP packets. */
+typedef struct
+{
+  uint8_t  data[256];
+  uint16_t len;
+  uint16_t count;
+  uint8_t  inProgress;
+} tLinkPacketObserver;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void     LinkSignalHandler(int sig);
+static void     LinkCheckTerminate(void);
+static void     LinkSleepUntil(uint64_t timeUs);
+static uint32_t LinkRandom(void);
+static uint8_t  LinkInject(uint8_t data, uint8_t *deliver, uint8_t *error);
+static void     LinkUartPump(void);
+static void     LinkUartFlush(void);
+static uint64_t LinkUartByteTimeUs(void);
+static uint32_t LinkUartGetHostBaudrate(void);
+static void     LinkObserve(tLinkPacketObserver *observer, uint8_t data, uint8_t fromHost);
+static void     LinkPacketObserved(const uint8_t *data, uint16_t len, uint8_t fromHost);
+static void     LinkCanPump(void);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+static tLinkConfig         linkConfig;
+static tLinkStats          linkStats;
+static int                 linkUartFd = -1;
+static uint32_t            linkUartBaudrate;
+static tLinkUartQueue      linkUartRx;
+static tLinkUartQueue      linkUartTx;
+static tLinkPacketObserver linkRxObserver;
+static tLinkPacketObserver linkTxObserver;
+static int                 linkCanFds[LINK_MAX_NODES];
+static uint8_t             linkCanFdCount;
+static tLinkCanFrame       linkCanQueue[LINK_CAN_QUEUE_SIZE];
+static uint32_t            linkCanHead;
+static uint32_t            linkCanTail;
+static uint64_t            linkCanBusFreeUs;
+static uint32_t            linkRandomState;
+static volatile sig_atomic_t linkTerminate;
+static tLinkIdleHook       linkIdleHook;
+/* programming session bookkeeping of the packet observer */
+static uint8_t             linkProgPending;
+static uint8_t             linkProgSessionActive;
+static uint8_t             linkProgSessionEnding;
+static uint64_t            linkProgSessionStartUs;
+
+
+/************************************************************************************//**
+** \brief     Initializes the link model.
+** \param     config      Link model parameters.
+** \param     uartFd      Master side of the pseudo terminal the host connects to, or -1
+**                        if this node has no UART.
+** \param     canFds      Sockets to the other nodes on the CAN bus.
+** \param     canFdCount  Number of entries in canFds.
+** \return    none.
+**
+****************************************************************************************/
+void LinkInit(const tLinkConfig *config, int uartFd, int *canFds, uint8_t canFdCount)
+{
+  uint8_t idx;
+
+  linkConfig = *config;
+  memset(&linkStats, 0, sizeof(linkStats));
+  linkUartFd = uartFd;
+  linkUartBaudrate = config->uartBaudrate;
+  linkRandomState = (config->seed != 0) ? config->seed : 1;
+  linkCanFdCount = canFdCount;
+  for (idx = 0; idx < canFdCount; idx++)
+  {
+    linkCanFds[idx] = canFds[idx];
+  }
+  /* byte times at high baudrates are in the order of microseconds, so do not let the
+   * kernel coalesce the wakeups.
+   */
+  prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+  signal(SIGTERM, LinkSignalHandler);
+  signal(SIGINT, LinkSignalHandler);
+} /*** end of LinkInit ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the current time of the simulation.
+** \return    Time in microseconds.
+**
+****************************************************************************************/
+uint64_t LinkGetTimeUs(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+} /*** end of LinkGetTimeUs ***/
+
+
+/************************************************************************************//**
+** \brief     Blocks for the specified time while the UART keeps on transmitting.
+** \param     us Time in microseconds.
+** \return    none.
+**
+****************************************************************************************/
+void LinkDelayUs(uint32_t us)
+{
+  LinkSleepUntil(LinkGetTimeUs() + us);
+} /*** end of LinkDelayUs ***/
+
+
+/************************************************************************************//**
+** \brief     Called by the simulated CPU when it has nothing to do. Sleeps until the
+**            next byte or frame becomes available, but never longer than
+**            LINK_IDLE_MAX_US.
+** \return    none.
+**
+****************************************************************************************/
+void LinkIdle(void)
+{
+  uint64_t now;
+  uint64_t next;
+  struct pollfd fds[LINK_MAX_NODES+1];
+  nfds_t nfds = 0;
+  uint8_t idx;
+
+  LinkCheckTerminate();
+  LinkUartPump();
+  if (linkIdleHook != NULL)
+  {
+    linkIdleHook();
+  }
+  LinkCanPump();
+  LinkUartFlush();
+
+  now = LinkGetTimeUs();
+  next = now + LINK_IDLE_MAX_US;
+  if ((linkUartRx.head != linkUartRx.tail) && (linkUartRx.entries[linkUartRx.tail].timeUs < next))
+  {
+    next = linkUartRx.entries[linkUartRx.tail].timeUs;
+  }
+  if ((linkUartTx.head != linkUartTx.tail) && (linkUartTx.entries[linkUartTx.tail].timeUs < next))
+  {
+    next = linkUartTx.entries[linkUartTx.tail].timeUs;
+  }
+  if ((linkCanHead != linkCanTail) && (linkCanQueue[linkCanTail].timeUs < next))
+  {
+    next = linkCanQueue[linkCanTail].timeUs;
+  }
+  if (next <= now)
+  {
+    return;
+  }
+  /* wait for new input from the host or the bus until the next queued event is due */
+  if (linkUartFd >= 0)
+  {
+    fds[nfds].fd = linkUartFd;
+    fds[nfds].events = POLLIN;
+    nfds++;
+  }
+  for (idx = 0; idx < linkCanFdCount; idx++)
+  {
+    fds[nfds].fd = linkCanFds[idx];
+    fds[nfds].events = POLLIN;
+    nfds++;
+  }
+  if (next - now >= 1000)
+  {
+    poll(fds, nfds, (int)((next - now) / 1000));
+  }
+  else
+  {
+    LinkSleepUntil(next);
+  }
+} /*** end of LinkIdle ***/
+
+
+/************************************************************************************//**
+** \brief     Registers a function that LinkIdle() calls before it decides how long to
+**            sleep. A DMA model uses it to take the received bytes off the line while
+**            the target is busy elsewhere, so that they do not count as pending work.
+** \param     hook The function or NULL.
+** \return    none.
+**
+****************************************************************************************/
+void LinkSetIdleHook(tLinkIdleHook hook)
+{
+  linkIdleHook = hook;
+} /*** end of LinkSetIdleHook ***/
+
+
+/************************************************************************************//**
+** \brief     Changes the speed of the target side of the UART.
+** \param     baudrate Communication speed in bits/sec.
+** \return    none.
+**
+****************************************************************************************/
+void LinkUartSetBaudrate(uint32_t baudrate)
+{
+  /* a real UART finishes the current character before it switches */
+  LinkUartDrain();
+  linkUartBaudrate = baudrate;
+} /*** end of LinkUartSetBaudrate ***/
+
+
+/************************************************************************************//**
+** \brief     Blocks until all bytes written to the UART were handed over to the host.
+** \return    none.
+**
+****************************************************************************************/
+void LinkUartDrain(void)
+{
+  LinkSleepUntil(linkUartTx.lineFreeUs);
+  LinkUartFlush();
+} /*** end of LinkUartDrain ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the speed of the target side of the UART.
+** \return    Communication speed in bits/sec.
+**
+****************************************************************************************/
+uint32_t LinkUartGetBaudrate(void)
+{
+  return linkUartBaudrate;
+} /*** end of LinkUartGetBaudrate ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if a received byte is available (RXNE).
+** \return    1 if a byte can be read, 0 otherwise.
+**
+****************************************************************************************/
+uint8_t LinkUartRxReady(void)
+{
+  LinkUartPump();
+  LinkUartFlush();
+  if (linkUartRx.head == linkUartRx.tail)
+  {
+    return 0;
+  }
+  return (linkUartRx.entries[linkUartRx.tail].timeUs <= LinkGetTimeUs()) ? 1 : 0;
+} /*** end of LinkUartRxReady ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the received byte. Only valid after LinkUartRxReady() returned 1.
+** \return    The received byte.
+**
+****************************************************************************************/
+uint8_t LinkUartRxRead(void)
+{
+  uint8_t data;
+
+  if (linkUartRx.head == linkUartRx.tail)
+  {
+    return 0;
+  }
+  data = linkUartRx.entries[linkUartRx.tail].data;
+  linkUartRx.tail = (linkUartRx.tail + 1) & (LINK_UART_QUEUE_SIZE - 1);
+  return data;
+} /*** end of LinkUartRxRead ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if the byte that LinkUartRxRead() returns next was received with a
+**            framing error (FE).
+** \return    1 if the byte is damaged, 0 otherwise.
+**
+****************************************************************************************/
+uint8_t LinkUartRxError(void)
+{
+  if (linkUartRx.head == linkUartRx.tail)
+  {
+    return 0;
+  }
+  return linkUartRx.entries[linkUartRx.tail].error;
+} /*** end of LinkUartRxError ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if the transmit holding register is empty (TXE). Since callers spin
+**            on this flag, the function sleeps until the flag gets set when it is not.
+** \return    1 if a byte can be written, 0 otherwise.
+**
+****************************************************************************************/
+uint8_t LinkUartTxReady(void)
+{
+  uint64_t byteTime = LinkUartByteTimeUs();
+
+  LinkUartFlush();
+  /* the holding register is empty as soon as the shifter took over the last byte */
+  if (linkUartTx.lineFreeUs <= LinkGetTimeUs() + byteTime)
+  {
+    return 1;
+  }
+  LinkSleepUntil(linkUartTx.lineFreeUs - byteTime);
+  return 0;
+} /*** end of LinkUartTxReady ***/
+
+
+/************************************************************************************//**
+** \brief     Writes a byte to the transmit holding register.
+** \param     data The byte to transmit.
+** \return    none.
+**
+****************************************************************************************/
+void LinkUartTxWrite(uint8_t data)
+{
+  uint64_t now = LinkGetTimeUs();
+  uint8_t deliver;
+  uint8_t error;
+  uint32_t next;
+
+  LinkObserve(&linkTxObserver, data, 0);
+  linkStats.uartTxBytes++;
+  if (linkUartTx.lineFreeUs < now)
+  {
+    linkUartTx.lineFreeUs = now;
+  }
+  linkUartTx.lineFreeUs += LinkUartByteTimeUs();
+  data = LinkInject(data, &deliver, &error);
+  next = (linkUartTx.head + 1) & (LINK_UART_QUEUE_SIZE - 1);
+  if ((deliver == 0) || (next == linkUartTx.tail))
+  {
+    return;
+  }
+  linkUartTx.entries[linkUartTx.head].timeUs = linkUartTx.lineFreeUs;
+  linkUartTx.entries[linkUartTx.head].data = data;
+  linkUartTx.head = next;
+} /*** end of LinkUartTxWrite ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits a CAN frame to all other nodes. Blocks until the frame was
+**            completely transmitted on the bus.
+** \param     id    11-bit message identifier.
+** \param     dlc   Data length code.
+** \param     data  Frame payload of dlc bytes.
+** \return    none.
+**
+****************************************************************************************/
+void LinkCanTransmit(uint32_t id, uint8_t dlc, const uint8_t *data)
+{
+  tLinkCanFrame frame;
+  uint64_t bits;
+  uint64_t now = LinkGetTimeUs();
+  uint8_t idx;
+
+  bits = LINK_CAN_FRAME_OVERHEAD + 8u * dlc;
+  bits += bits / 10;
+  if (linkCanBusFreeUs < now)
+  {
+    linkCanBusFreeUs = now;
+  }
+  linkCanBusFreeUs += (bits * 1000000u + linkConfig.canBaudrate - 1) / linkConfig.canBaudrate;
+
+  memset(&frame, 0, sizeof(frame));
+  frame.timeUs = linkCanBusFreeUs + linkConfig.canRelayLatencyUs;
+  frame.id = id;
+  frame.dlc = dlc;
+  memcpy(frame.data, data, dlc);
+  for (idx = 0; idx < linkCanFdCount; idx++)
+  {
+    while ((send(linkCanFds[idx], &frame, sizeof(frame), 0) == -1) && (errno == EINTR))
+    {
+      LinkCheckTerminate();
+    }
+  }
+  linkStats.canFramesTx++;
+  /* wait for transmit completion */
+  LinkSleepUntil(linkCanBusFreeUs);
+} /*** end of LinkCanTransmit ***/
+
+
+/************************************************************************************//**
+** \brief     Receives the next CAN frame from the bus.
+** \param     frame Where to store the frame.
+** \param     wait  1 to block until a frame is available, 0 to return immediately.
+** \return    1 if a frame was received, 0 otherwise.
+**
+****************************************************************************************/
+uint8_t LinkCanReceive(tLinkCanFrame *frame, uint8_t wait)
+{
+  for (;;)
+  {
+    LinkCanPump();
+    if ((linkCanHead != linkCanTail) && (linkCanQueue[linkCanTail].timeUs <= LinkGetTimeUs()))
+    {
+      *frame = linkCanQueue[linkCanTail];
+      linkCanTail = (linkCanTail + 1) & (LINK_CAN_QUEUE_SIZE - 1);
+      linkStats.canFramesRx++;
+      return 1;
+    }
+    if (wait == 0)
+    {
+      return 0;
+    }
+    LinkIdle();
+  }
+} /*** end of LinkCanReceive ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if erase and program operations should take as long as on the real
+**            flash memory.
+** \return    1 if flash timing is simulated, 0 otherwise.
+**
+****************************************************************************************/
+uint8_t LinkFlashTiming(void)
+{
+  return linkConfig.flashTiming;
+} /*** end of LinkFlashTiming ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the statistics collected so far.
+** \return    Pointer to the statistics.
+**
+****************************************************************************************/
+const tLinkStats *LinkGetStats(void)
+{
+  return &linkStats;
+} /*** end of LinkGetStats ***/
+
+
+/************************************************************************************//**
+** \brief     Writes the statistics as key=value lines to a file.
+** \param     file Name of the file.
+** \return    none.
+**
+****************************************************************************************/
+void LinkWriteStats(const char *file)
+{
+  FILE *fp;
+
+  fp = fopen(file, "w");
+  if (fp == NULL)
+  {
+    return;
+  }
+  fprintf(fp, "uart_baudrate=%u\n", linkUartBaudrate);
+  fprintf(fp, "uart_rx_packets=%u\n", linkStats.uartRxPackets);
+  fprintf(fp, "uart_tx_packets=%u\n", linkStats.uartTxPackets);
+  fprintf(fp, "uart_rx_bytes=%u\n", linkStats.uartRxBytes);
+  fprintf(fp, "uart_tx_bytes=%u\n", linkStats.uartTxBytes);
+  fprintf(fp, "uart_bytes_corrupted=%u\n", linkStats.uartBytesCorrupted);
+  fprintf(fp, "uart_bytes_lost=%u\n", linkStats.uartBytesLost);
+  fprintf(fp, "uart_baud_mismatches=%u\n", linkStats.uartBaudMismatches);
+  fprintf(fp, "can_frames_tx=%u\n", linkStats.canFramesTx);
+  fprintf(fp, "can_frames_rx=%u\n", linkStats.canFramesRx);
+  fprintf(fp, "prog_round_trips=%u\n", linkStats.progRoundTrips);
+  fprintf(fp, "prog_payload_bytes=%u\n", linkStats.progPayloadBytes);
+  fprintf(fp, "prog_sessions=%u\n", linkStats.progSessions);
+  fprintf(fp, "prog_time_us=%llu\n", (unsigned long long)linkStats.progTimeUs);
+  fclose(fp);
+} /*** end of LinkWriteStats ***/
+
+
+/************************************************************************************//**
+** \brief     Signal handler that requests the simulation to terminate.
+** \param     sig Signal number.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkSignalHandler(int sig)
+{
+  (void)sig;
+  linkTerminate = 1;
+} /*** end of LinkSignalHandler ***/
+
+
+/************************************************************************************//**
+** \brief     Terminates the process in an orderly fashion when this was requested, so
+**            that the exit handlers get to write the statistics.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkCheckTerminate(void)
+{
+  if (linkTerminate != 0)
+  {
+    exit(0);
+  }
+} /*** end of LinkCheckTerminate ***/
+
+
+/************************************************************************************//**
+** \brief     Sleeps until the specified time, while transmitting UART bytes as they
+**            become due.
+** \param     timeUs Absolute time in microseconds.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkSleepUntil(uint64_t timeUs)
+{
+  struct timespec wake;
+  uint64_t next;
+
+  while (LinkGetTimeUs() < timeUs)
+  {
+    LinkCheckTerminate();
+    next = timeUs;
+    if ((linkUartTx.head != linkUartTx.tail) && (linkUartTx.entries[linkUartTx.tail].timeUs < next))
+    {
+      next = linkUartTx.entries[linkUartTx.tail].timeUs;
+    }
+    wake.tv_sec = (time_t)(next / 1000000u);
+    wake.tv_nsec = (long)(next % 1000000u) * 1000;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    LinkUartFlush();
+  }
+} /*** end of LinkSleepUntil ***/
+
+
+/************************************************************************************//**
+** \brief     Deterministic pseudo random number generator (xorshift32) for the error
+**            injection, so that a run can be reproduced with the same seed.
+** \return    Pseudo random number.
+**
+****************************************************************************************/
+static uint32_t LinkRandom(void)
+{
+  linkRandomState ^= linkRandomState << 13;
+  linkRandomState ^= linkRandomState >> 17;
+  linkRandomState ^= linkRandomState << 5;
+  return linkRandomState;
+} /*** end of LinkRandom ***/
+
+
+/************************************************************************************//**
+** \brief     Applies the configured line errors to a byte on the UART.
+** \param     data    The byte as it was sent.
+** \param     deliver Set to 0 if the byte got lost, 1 otherwise.
+** \param     error   Set to 1 if the receiver detects a framing error, 0 otherwise.
+** \return    The byte as it is received.
+**
+****************************************************************************************/
+static uint8_t LinkInject(uint8_t data, uint8_t *deliver, uint8_t *error)
+{
+  *deliver = 1;
+  *error = 0;
+  /* both ends must run at the same speed, otherwise only garbage arrives. the stop bit
+   * is sampled at the wrong time, which the receiver reports as a framing error.
+   */
+  if (LinkUartGetHostBaudrate() != linkUartBaudrate)
+  {
+    linkStats.uartBaudMismatches++;
+    *error = 1;
+    return (uint8_t)LinkRandom();
+  }
+  if ((linkConfig.errorLossPpm > 0) && ((LinkRandom() % 1000000u) < linkConfig.errorLossPpm))
+  {
+    linkStats.uartBytesLost++;
+    *deliver = 0;
+    return data;
+  }
+  if ((linkConfig.errorCorruptPpm > 0) && ((LinkRandom() % 1000000u) < linkConfig.errorCorruptPpm))
+  {
+    linkStats.uartBytesCorrupted++;
+    data ^= (uint8_t)(1u << (LinkRandom() % 8));
+  }
+  return data;
+} /*** end of LinkInject ***/
+
+
+/************************************************************************************//**
+** \brief     Moves the bytes written by the host into the reception queue, where each
+**            byte becomes available one character time after the previous one.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkUartPump(void)
+{
+  uint8_t buffer[256];
+  ssize_t result;
+  ssize_t idx;
+  uint64_t now;
+  uint8_t deliver;
+  uint8_t error;
+  uint8_t data;
+  uint32_t next;
+
+  if (linkUartFd < 0)
+  {
+    return;
+  }
+  result = read(linkUartFd, buffer, sizeof(buffer));
+  if (result <= 0)
+  {
+    return;
+  }
+  now = LinkGetTimeUs();
+  for (idx = 0; idx < result; idx++)
+  {
+    LinkObserve(&linkRxObserver, buffer[idx], 1);
+    linkStats.uartRxBytes++;
+    if (linkUartRx.lineFreeUs < now)
+    {
+      linkUartRx.lineFreeUs = now;
+    }
+    linkUartRx.lineFreeUs += LinkUartByteTimeUs();
+    data = LinkInject(buffer[idx], &deliver, &error);
+    next = (linkUartRx.head + 1) & (LINK_UART_QUEUE_SIZE - 1);
+    if ((deliver == 0) || (next == linkUartRx.tail))
+    {
+      continue;
+    }
+    linkUartRx.entries[linkUartRx.head].timeUs = linkUartRx.lineFreeUs;
+    linkUartRx.entries[linkUartRx.head].data = data;
+    linkUartRx.entries[linkUartRx.head].error = error;
+    linkUartRx.head = next;
+  }
+} /*** end of LinkUartPump ***/
+
+
+/************************************************************************************//**
+** \brief     Hands the bytes that completed transmission over to the host.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkUartFlush(void)
+{
+  uint8_t buffer[256];
+  size_t len = 0;
+  uint64_t now;
+
+  if (linkUartFd < 0)
+  {
+    return;
+  }
+  now = LinkGetTimeUs();
+  while ((linkUartTx.head != linkUartTx.tail) && (linkUartTx.entries[linkUartTx.tail].timeUs <= now) &&
+         (len < sizeof(buffer)))
+  {
+    buffer[len++] = linkUartTx.entries[linkUartTx.tail].data;
+    linkUartTx.tail = (linkUartTx.tail + 1) & (LINK_UART_QUEUE_SIZE - 1);
+  }
+  if (len > 0)
+  {
+    if (write(linkUartFd, buffer, len) != (ssize_t)len)
+    {
+      /* the host is not reading. the bytes are lost, just like on a real line */
+    }
+  }
+} /*** end of LinkUartFlush ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the time it takes to transfer one character on the UART.
+** \return    Character time in microseconds (at least 1).
+**
+****************************************************************************************/
+static uint64_t LinkUartByteTimeUs(void)
+{
+  uint64_t result;
+
+  result = (LINK_UART_BITS_PER_BYTE * 1000000ull) / linkUartBaudrate;
+  return (result > 0) ? result : 1;
+} /*** end of LinkUartByteTimeUs ***/
+
+
+/************************************************************************************//**
+** \brief     Determines the speed the host configured on its side of the pseudo
+**            terminal. The master side reports the termios settings of the slave side.
+** \return    Communication speed in bits/sec, or the target speed if unknown.
+**
+****************************************************************************************/
+static uint32_t LinkUartGetHostBaudrate(void)
+{
+  struct termios options;
+
+  if ((linkUartFd < 0) || (tcgetattr(linkUartFd, &options) == -1))
+  {
+    return linkUartBaudrate;
+  }
+  switch (cfgetospeed(&options))
+  {
+    case B9600:    return 9600;
+    case B19200:   return 19200;
+    case B38400:   return 38400;
+    case B57600:   return 57600;
+    case B115200:  return 115200;
+    case B230400:  return 230400;
+    case B460800:  return 460800;
+    case B500000:  return 500000;
+    case B921600:  return 921600;
+    case B1000000: return 1000000;
+    case B2000000: return 2000000;
+    default:       return linkUartBaudrate;
+  }
+} /*** end of LinkUartGetHostBaudrate ***/
+
+
+/************************************************************************************//**
+** \brief     Feeds a byte of the UART stream into a packet observer.
+** \param     observer Observer of the stream.
+** \param     data     The byte.
+** \param     fromHost 1 for the host->target direction, 0 otherwise.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkObserve(tLinkPacketObserver *observer, uint8_t data, uint8_t fromHost)
+{
+  if (observer->inProgress == 0)
+  {
+    if (data > 0)
+    {
+      observer->len = data;
+      observer->count = 0;
+      observer->inProgress = 1;
+    }
+    return;
+  }
+  observer->data[observer->count++] = data;
+  if (observer->count == observer->len)
+  {
+    observer->inProgress = 0;
+    LinkPacketObserved(observer->data, observer->len, fromHost);
+  }
+} /*** end of LinkObserve ***/
+
+
+/************************************************************************************//**
+** \brief     Updates the statistics for a complete XCP packet on the UART.
+** \param     data     Packet data.
+** \param     len      Packet length.
+** \param     fromHost 1 for a command from the host, 0 for a response.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkPacketObserved(const uint8_t *data, uint16_t len, uint8_t fromHost)
+{
+  uint64_t now = LinkGetTimeUs();
+
+  if (fromHost == 0)
+  {
+    linkStats.uartTxPackets++;
+    if (linkProgPending != 0)
+    {
+      linkStats.progRoundTrips++;
+      linkProgPending = 0;
+    }
+    if (linkProgSessionEnding != 0)
+    {
+      linkStats.progTimeUs += now - linkProgSessionStartUs;
+      linkStats.progSessions++;
+      linkProgSessionEnding = 0;
+      linkProgSessionActive = 0;
+    }
+    return;
+  }
+
+  linkStats.uartRxPackets++;
+  switch (data[0])
+  {
+    case XCP_CMD_PROGRAM_START:
+      if (linkProgSessionActive == 0)
+      {
+        linkProgSessionActive = 1;
+        linkProgSessionStartUs = now;
+      }
+      break;
+    case XCP_CMD_PROGRAM:
+      if ((len > 1) && (data[1] == 0))
+      {
+        /* a program command without data ends the session */
+        linkProgSessionEnding = linkProgSessionActive;
+      }
+      else if (len > 1)
+      {
+        linkStats.progPayloadBytes += data[1];
+        linkProgPending = 1;
+      }
+      break;
+    case XCP_CMD_PROGRAM_MAX:
+      linkStats.progPayloadBytes += len - 1;
+      linkProgPending = 1;
+      break;
+    case XCP_CMD_USER:
+      if ((len > 2) && (data[1] == XCP_USER_PROGRAM_COMPRESSED))
+      {
+        linkStats.progPayloadBytes += data[2];
+        linkProgPending = 1;
+      }
+      break;
+    default:
+      break;
+  }
+} /*** end of LinkPacketObserved ***/
+
+
+/************************************************************************************//**
+** \brief     Moves the frames that other nodes sent into the reception queue.
+** \return    none.
+**
+****************************************************************************************/
+static void LinkCanPump(void)
+{
+  tLinkCanFrame frame;
+  uint8_t idx;
+  uint32_t next;
+
+  for (idx = 0; idx < linkCanFdCount; idx++)
+  {
+    while (recv(linkCanFds[idx], &frame, sizeof(frame), MSG_DONTWAIT) == (ssize_t)sizeof(frame))
+    {
+      next = (linkCanHead + 1) & (LINK_CAN_QUEUE_SIZE - 1);
+      if (next == linkCanTail)
+      {
+        /* reception FIFO overrun */
+        continue;
+      }
+      linkCanQueue[linkCanHead] = frame;
+      linkCanHead = next;
+    }
+  }
+} /*** end of LinkCanPump ***/
+
+
+/*********************************** end of link.c *************************************/
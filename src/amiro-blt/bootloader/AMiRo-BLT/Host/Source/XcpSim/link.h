@@ -0,0 +1,121 @@
+/************************************************************************************//**
+* \file         link.h
+* \brief        Model of the UART and CAN links header file.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#ifndef LINK_H
+#define LINK_H
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                                   /* fixed width integer types     */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Maximum number of nodes on the simulated CAN bus, including the main device. */
+#define LINK_MAX_NODES                 (8)
+/** \brief Number of bits per UART character in 8-n-1 framing (start, data, stop). */
+#define LINK_UART_BITS_PER_BYTE        (10)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Link model parameters, set once from the command line before BootInit(). */
+typedef struct
+{
+  uint32_t uartBaudrate;                         /**< target UART speed in bits/sec    */
+  uint32_t canBaudrate;                          /**< CAN bus speed in bits/sec        */
+  uint32_t canRelayLatencyUs;                    /**< per frame latency of a CAN hop   */
+  uint32_t errorCorruptPpm;                      /**< UART byte corruption rate        */
+  uint32_t errorLossPpm;                         /**< UART byte loss rate              */
+  uint32_t seed;                                 /**< seed of the error generator      */
+  uint8_t  flashTiming;                          /**< 1 to simulate flash timing       */
+} tLinkConfig;
+
+/** \brief A CAN frame as it is exchanged between the simulated nodes. */
+typedef struct
+{
+  uint64_t timeUs;                               /**< time the frame is on the bus     */
+  uint32_t id;                                   /**< 11-bit standard identifier       */
+  uint8_t  dlc;                                  /**< data length code                 */
+  uint8_t  data[8];                              /**< frame payload                    */
+} tLinkCanFrame;
+
+/** \brief Counters collected over the lifetime of a simulated node. */
+typedef struct
+{
+  uint32_t uartRxPackets;                        /**< XCP packets host -> target       */
+  uint32_t uartTxPackets;                        /**< XCP packets target -> host       */
+  uint32_t uartRxBytes;                          /**< UART bytes host -> target        */
+  uint32_t uartTxBytes;                          /**< UART bytes target -> host        */
+  uint32_t uartBytesCorrupted;                   /**< injected byte corruptions        */
+  uint32_t uartBytesLost;                        /**< injected byte losses             */
+  uint32_t uartBaudMismatches;                   /**< bytes garbled by a baud mismatch */
+  uint32_t canFramesTx;                          /**< CAN frames sent by this node     */
+  uint32_t canFramesRx;                          /**< CAN frames received by this node */
+  uint32_t progRoundTrips;                       /**< program request/responses        */
+  uint32_t progPayloadBytes;                     /**< bytes carried by program commands*/
+  uint32_t progSessions;                         /**< completed programming sessions   */
+  uint64_t progTimeUs;                           /**< time spent in sessions           */
+} tLinkStats;
+
+/** \brief Called whenever the link model runs, to let peripherals work in the background. */
+typedef void (*tLinkIdleHook)(void);
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+void     LinkInit(const tLinkConfig *config, int uartFd, int *canFds, uint8_t canFdCount);
+uint64_t LinkGetTimeUs(void);
+void     LinkDelayUs(uint32_t us);
+void     LinkIdle(void);
+void     LinkSetIdleHook(tLinkIdleHook hook);
+void     LinkUartSetBaudrate(uint32_t baudrate);
+void     LinkUartDrain(void);
+uint32_t LinkUartGetBaudrate(void);
+uint8_t  LinkUartRxReady(void);
+uint8_t  LinkUartRxRead(void);
+uint8_t  LinkUartRxError(void);
+uint8_t  LinkUartTxReady(void);
+void     LinkUartTxWrite(uint8_t data);
+void     LinkCanTransmit(uint32_t id, uint8_t dlc, const uint8_t *data);
+uint8_t  LinkCanReceive(tLinkCanFrame *frame, uint8_t wait);
+uint8_t  LinkFlashTiming(void);
+const tLinkStats *LinkGetStats(void);
+void     LinkWriteStats(const char *file);
+
+
+#endif /* LINK_H */
+/*********************************** end of link.h *************************************/
@@ -0,0 +1,576 @@
+/************************************************************************************//**
+* \file         main.c
+* \brief        XcpSim program that simulates AMiRo bootloader nodes for SerialBoot.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#define _GNU_SOURCE                                   /* posix_openpt, MAP_FIXED_...   */
+#include <stdio.h>                                    /* standard I/O library          */
+#include <stdlib.h>                                   /* standard library              */
+#include <string.h>                                   /* string function definitions   */
+#include <unistd.h>                                   /* UNIX standard functions       */
+#include <fcntl.h>                                    /* file control definitions      */
+#include <signal.h>                                   /* signal handling               */
+#include <termios.h>                                  /* POSIX terminal control        */
+#include <sys/ioctl.h>                                /* pending pty input             */
+#include <sys/mman.h>                                 /* memory mapped flash           */
+#include <sys/prctl.h>                                /* parent death signal           */
+#include <sys/socket.h>                               /* CAN bus sockets               */
+#include <sys/stat.h>                                 /* file status                   */
+#include <sys/wait.h>                                 /* child process handling        */
+#include "boot.h"                                     /* bootloader generic header     */
+#include "stm32f4xx.h"                                /* FLASH_BASE                    */
+#include "link.h"                                     /* link model                    */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Program return code if all went ok. */
+#define PROG_RESULT_OK           (0)
+/** \brief Program return code if an error occurred. */
+#define PROG_RESULT_ERROR        (1)
+/** \brief Size of the simulated flash memory in bytes. */
+#define SIM_FLASH_SIZE           ((size_t)BOOT_NVM_SIZE_KB * 1024u)
+/** \brief Device ID of the main device, the only one with a UART connection. */
+#define SIM_MAIN_DEVICE_ID       (0x01010101)
+/** \brief Default speed of the UART, as configured for the real main device. */
+#define SIM_UART_BAUDRATE        (115200)
+/** \brief Maximum time the host gets to read the last bytes before the pty closes. */
+#define SIM_HANDOVER_TIMEOUT_MS  (1000)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Known AMiRo boards, to look up the legacy ID of a simulated node. */
+typedef struct
+{
+  unsigned int deviceId;
+  unsigned int legacyId;
+  const char  *name;
+} tSimBoard;
+
+/** \brief A simulated node that is only reachable via the CAN gateway. */
+typedef struct
+{
+  unsigned int deviceId;
+  const char  *flashFile;
+  pid_t        pid;
+} tSimNode;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void     DisplayProgramUsage(void);
+static int      ParseCommandLine(int argc, char *argv[]);
+static unsigned int SimLookupLegacyId(unsigned int deviceId);
+static speed_t  SimGetBaudrateMask(unsigned int baudrate);
+static int      SimMapFlash(const char *file);
+static int      SimOpenPty(const char *link);
+static void     SimExit(void);
+static void     SimRun(int uartFd, int *canFds, unsigned char canFdCount);
+
+
+/****************************************************************************************
+* Global data declarations
+****************************************************************************************/
+/** \brief Device ID of this node, referenced by BOOT_COM_DEVICE_ID. */
+unsigned int simDeviceId = SIM_MAIN_DEVICE_ID;
+/** \brief Legacy device ID of this node, referenced by BOOT_COM_DEVICE_LEGACY_ID. */
+unsigned int simDeviceLegacyId;
+/** \brief UART speed of this node, referenced by BOOT_COM_UART_BAUDRATE. */
+unsigned int simUartBaudrate = SIM_UART_BAUDRATE;
+
+
+/****************************************************************************************
+* Local constant declarations
+****************************************************************************************/
+/** \brief Boards of the AMiRo base version (see Target/Modules/moduleids.mk). */
+static const tSimBoard simBoards[] =
+{
+  { 0x01010101, 0x2, "PowerManagement" },
+  { 0x01000101, 0x1, "DiWheelDrive"    },
+  { 0x017F0100, 0x3, "LightRing"       }
+};
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+static tLinkConfig simConfig =
+{
+  SIM_UART_BAUDRATE,                             /* uartBaudrate                       */
+  BOOT_COM_CAN_BAUDRATE,                         /* canBaudrate                        */
+  20,                                            /* canRelayLatencyUs                  */
+  0,                                             /* errorCorruptPpm                    */
+  0,                                             /* errorLossPpm                       */
+  1,                                             /* seed                               */
+  1                                              /* flashTiming                        */
+};
+static const char *simPtyLink;
+static const char *simFlashFile;
+static const char *simStatsFile;
+static tSimNode    simNodes[LINK_MAX_NODES-1];
+static unsigned char simNodeCount;
+static unsigned char simIsMain = 1;
+static int         simPtySlave = -1;
+
+
+/************************************************************************************//**
+** \brief     Program entry point.
+** \param     argc Number of program parameters.
+** \param     argv array to program parameter strings.
+** \return    0 on success, > 0 on error.
+**
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+  int canFds[LINK_MAX_NODES];
+  int pair[2];
+  int uartFd;
+  unsigned char idx;
+  unsigned char closeIdx;
+
+  setbuf(stdout, NULL);
+
+  if (ParseCommandLine(argc, argv) == 0)
+  {
+    DisplayProgramUsage();
+    return PROG_RESULT_ERROR;
+  }
+  if (SimMapFlash(simFlashFile) == 0)
+  {
+    return PROG_RESULT_ERROR;
+  }
+  uartFd = SimOpenPty(simPtyLink);
+  if (uartFd < 0)
+  {
+    return PROG_RESULT_ERROR;
+  }
+
+  /* start the nodes behind the gateway. each one is a process of its own that runs the
+   * same bootloader image with its own device ID and flash file.
+   */
+  for (idx = 0; idx < simNodeCount; idx++)
+  {
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, pair) == -1)
+    {
+      perror("socketpair");
+      return PROG_RESULT_ERROR;
+    }
+    simNodes[idx].pid = fork();
+    if (simNodes[idx].pid == -1)
+    {
+      perror("fork");
+      return PROG_RESULT_ERROR;
+    }
+    if (simNodes[idx].pid == 0)
+    {
+      prctl(PR_SET_PDEATHSIG, SIGTERM);
+      close(pair[0]);
+      close(uartFd);
+      for (closeIdx = 0; closeIdx < idx; closeIdx++)
+      {
+        close(canFds[closeIdx]);
+      }
+      simIsMain = 0;
+      simNodeCount = 0;
+      simDeviceId = simNodes[idx].deviceId;
+      simDeviceLegacyId = SimLookupLegacyId(simDeviceId);
+      if (simStatsFile != NULL)
+      {
+        static char nodeStatsFile[512];
+        snprintf(nodeStatsFile, sizeof(nodeStatsFile), "%s.%08X", simStatsFile, simDeviceId);
+        simStatsFile = nodeStatsFile;
+      }
+      munmap((void *)(blt_addr)FLASH_BASE, SIM_FLASH_SIZE);
+      if (SimMapFlash(simNodes[idx].flashFile) == 0)
+      {
+        _exit(PROG_RESULT_ERROR);
+      }
+      SimRun(-1, &pair[1], 1);
+    }
+    close(pair[1]);
+    canFds[idx] = pair[0];
+  }
+
+  simDeviceLegacyId = SimLookupLegacyId(simDeviceId);
+  SimRun(uartFd, canFds, simNodeCount);
+  return PROG_RESULT_OK;
+} /*** end of main ***/
+
+
+/************************************************************************************//**
+** \brief     Called by the simulated CPU instead of jumping to the user program. A node
+**            with a UART sends a single byte, standing in for the first output of the
+**            user program, so that the host does not have to wait for a response
+**            timeout of the reset command.
+** \return    none.
+**
+****************************************************************************************/
+void SimUserProgramStarted(void)
+{
+  unsigned int waitMs;
+  int pending;
+
+  printf("XcpSim: device 0x%08X starts its user program\n", simDeviceId);
+  if (simIsMain != 0)
+  {
+    LinkUartTxWrite(0);
+    LinkUartDrain();
+    /* closing the master side discards what the host did not read yet */
+    for (waitMs = 0; waitMs < SIM_HANDOVER_TIMEOUT_MS; waitMs++)
+    {
+      if ((ioctl(simPtySlave, FIONREAD, &pending) == -1) || (pending == 0))
+      {
+        break;
+      }
+      usleep(1000);
+    }
+  }
+  exit(PROG_RESULT_OK);
+} /*** end of SimUserProgramStarted ***/
+
+
+/************************************************************************************//**
+** \brief     Called by the simulated CPU for a software reset.
+** \return    none.
+**
+****************************************************************************************/
+void SimReset(void)
+{
+  BootInit();
+} /*** end of SimReset ***/
+
+
+/************************************************************************************//**
+** \brief     Outputs information to the user about how to use this program.
+** \return    none.
+**
+****************************************************************************************/
+static void DisplayProgramUsage(void)
+{
+  printf("Usage: XcpSim -l<pty link> -f<flash file> [options]\n\n");
+  printf("Simulates the AMiRo bootloader of the main device (0x%08X) on a pseudo\n", SIM_MAIN_DEVICE_ID);
+  printf("terminal, so that SerialBoot can connect to <pty link>. The flash memory is\n");
+  printf("backed by <flash file>, which is created if it does not exist.\n\n");
+  printf("Options:\n");
+  printf("  -N<id>:<file>  add a node behind the CAN gateway (up to %u)\n", LINK_MAX_NODES-1);
+  printf("  -b<baudrate>   UART speed in bits/s (default %u)\n", SIM_UART_BAUDRATE);
+  printf("  -c<baudrate>   CAN speed in bits/s (default %u)\n", BOOT_COM_CAN_BAUDRATE);
+  printf("  -r<us>         latency per CAN frame and hop (default 20)\n");
+  printf("  -e<ppm>        UART byte corruption rate (default 0)\n");
+  printf("  -x<ppm>        UART byte loss rate (default 0)\n");
+  printf("  -s<seed>       seed of the error generator (default 1)\n");
+  printf("  -F<0|1>        simulate flash erase/program timing (default 1)\n");
+  printf("  -o<file>       write statistics on exit, nodes append .<id>\n\n");
+  printf("Example:    XcpSim -l/tmp/amiro -fpm.bin -N0x01000101:dwd.bin -o/tmp/stats\n");
+  printf("            SerialBoot -d/tmp/amiro pm.srec -T0x01000101 dwd.srec\n");
+} /*** end of DisplayProgramUsage ***/
+
+
+/************************************************************************************//**
+** \brief     Parses the command line arguments.
+** \param     argc Number of program parameters.
+** \param     argv array to program parameter strings.
+** \return    1 on success, 0 otherwise.
+**
+****************************************************************************************/
+static int ParseCommandLine(int argc, char *argv[])
+{
+  int idx;
+  char *sep;
+
+  for (idx = 1; idx < argc; idx++)
+  {
+    if ((argv[idx][0] != '-') || (argv[idx][1] == '\0'))
+    {
+      return 0;
+    }
+    switch (argv[idx][1])
+    {
+      case 'l':
+        simPtyLink = &argv[idx][2];
+        break;
+      case 'f':
+        simFlashFile = &argv[idx][2];
+        break;
+      case 'N':
+        sep = strchr(&argv[idx][2], ':');
+        if ((sep == NULL) || (simNodeCount >= LINK_MAX_NODES-1))
+        {
+          return 0;
+        }
+        *sep = '\0';
+        simNodes[simNodeCount].deviceId = (unsigned int)strtoul(&argv[idx][2], NULL, 0);
+        simNodes[simNodeCount].flashFile = sep + 1;
+        if ((simNodes[simNodeCount].deviceId == 0) ||
+            (simNodes[simNodeCount].deviceId == SIM_MAIN_DEVICE_ID))
+        {
+          return 0;
+        }
+        simNodeCount++;
+        break;
+      case 'b':
+        simConfig.uartBaudrate = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'c':
+        simConfig.canBaudrate = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'r':
+        simConfig.canRelayLatencyUs = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'e':
+        simConfig.errorCorruptPpm = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'x':
+        simConfig.errorLossPpm = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 's':
+        simConfig.seed = (uint32_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'F':
+        simConfig.flashTiming = (uint8_t)strtoul(&argv[idx][2], NULL, 0);
+        break;
+      case 'o':
+        simStatsFile = &argv[idx][2];
+        break;
+      default:
+        return 0;
+    }
+  }
+  if ((simPtyLink == NULL) || (simFlashFile == NULL) ||
+      (SimGetBaudrateMask(simConfig.uartBaudrate) == B0) || (simConfig.canBaudrate == 0))
+  {
+    return 0;
+  }
+  simUartBaudrate = simConfig.uartBaudrate;
+  return 1;
+} /*** end of ParseCommandLine ***/
+
+
+/************************************************************************************//**
+** \brief     Looks up the legacy device ID of a board.
+** \param     deviceId Device ID of the board.
+** \return    Legacy device ID, or 0 if the board has none.
+**
+****************************************************************************************/
+static unsigned int SimLookupLegacyId(unsigned int deviceId)
+{
+  unsigned char idx;
+
+  for (idx = 0; idx < sizeof(simBoards)/sizeof(simBoards[0]); idx++)
+  {
+    if (simBoards[idx].deviceId == deviceId)
+    {
+      return simBoards[idx].legacyId;
+    }
+  }
+  return 0;
+} /*** end of SimLookupLegacyId ***/
+
+
+/************************************************************************************//**
+** \brief     Converts the baudrate value to a bitmask value used by termios.
+** \param     baudrate Communication speed in bits/sec.
+** \return    The termios speed, or B0 if the baudrate is not supported.
+**
+****************************************************************************************/
+static speed_t SimGetBaudrateMask(unsigned int baudrate)
+{
+  switch (baudrate)
+  {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 500000:  return B500000;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    default:      return B0;
+  }
+} /*** end of SimGetBaudrateMask ***/
+
+
+/************************************************************************************//**
+** \brief     Maps a flash file at the flash address of the STM32, so that the flash
+**            driver can access it through plain pointers. A new file is initialized
+**            to the erased state.
+** \param     file Name of the flash file.
+** \return    1 on success, 0 otherwise.
+**
+****************************************************************************************/
+static int SimMapFlash(const char *file)
+{
+  struct stat info;
+  unsigned char erased[4096];
+  size_t written;
+  void *flash;
+  int fd;
+
+  fd = open(file, O_RDWR | O_CREAT, 0644);
+  if ((fd == -1) || (fstat(fd, &info) == -1))
+  {
+    perror(file);
+    return 0;
+  }
+  if ((size_t)info.st_size < SIM_FLASH_SIZE)
+  {
+    memset(erased, 0xff, sizeof(erased));
+    lseek(fd, info.st_size, SEEK_SET);
+    for (written = (size_t)info.st_size; written < SIM_FLASH_SIZE; written += sizeof(erased))
+    {
+      if (write(fd, erased, sizeof(erased)) != (ssize_t)sizeof(erased))
+      {
+        perror(file);
+        close(fd);
+        return 0;
+      }
+    }
+  }
+  flash = mmap((void *)(blt_addr)FLASH_BASE, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_FIXED_NOREPLACE, fd, 0);
+  close(fd);
+  if (flash != (void *)(blt_addr)FLASH_BASE)
+  {
+    fprintf(stderr, "XcpSim: cannot map flash at 0x%08X\n", (unsigned int)FLASH_BASE);
+    return 0;
+  }
+  return 1;
+} /*** end of SimMapFlash ***/
+
+
+/************************************************************************************//**
+** \brief     Creates the pseudo terminal that SerialBoot connects to and makes it
+**            available under the given name.
+** \param     link Name of the symbolic link to the pseudo terminal.
+** \return    File descriptor of the master side, or -1 on error.
+**
+****************************************************************************************/
+static int SimOpenPty(const char *link)
+{
+  struct termios options;
+  const char *slaveName;
+  int master;
+  int slave;
+
+  master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master == -1) || (grantpt(master) == -1) || (unlockpt(master) == -1) ||
+      ((slaveName = ptsname(master)) == NULL))
+  {
+    perror("posix_openpt");
+    return -1;
+  }
+  /* keep the slave side open, so that the master does not see a hangup every time
+   * SerialBoot closes the port. configure it for the speed of the target.
+   */
+  slave = open(slaveName, O_RDWR | O_NOCTTY);
+  if ((slave == -1) || (tcgetattr(slave, &options) == -1))
+  {
+    perror(slaveName);
+    return -1;
+  }
+  cfmakeraw(&options);
+  cfsetispeed(&options, SimGetBaudrateMask(simConfig.uartBaudrate));
+  cfsetospeed(&options, SimGetBaudrateMask(simConfig.uartBaudrate));
+  tcsetattr(slave, TCSANOW, &options);
+  simPtySlave = slave;
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+  unlink(link);
+  if (symlink(slaveName, link) == -1)
+  {
+    perror(link);
+    return -1;
+  }
+  printf("XcpSim: device 0x%08X listening on %s (%s)\n", simDeviceId, link, slaveName);
+  return master;
+} /*** end of SimOpenPty ***/
+
+
+/************************************************************************************//**
+** \brief     Exit handler that writes the statistics and stops the other nodes.
+** \return    none.
+**
+****************************************************************************************/
+static void SimExit(void)
+{
+  unsigned char idx;
+
+  if (simStatsFile != NULL)
+  {
+    LinkWriteStats(simStatsFile);
+  }
+  if (simIsMain == 0)
+  {
+    return;
+  }
+  for (idx = 0; idx < simNodeCount; idx++)
+  {
+    kill(simNodes[idx].pid, SIGTERM);
+    waitpid(simNodes[idx].pid, NULL, 0);
+  }
+  unlink(simPtyLink);
+} /*** end of SimExit ***/
+
+
+/************************************************************************************//**
+** \brief     Runs the bootloader of this node. Does not return.
+** \param     uartFd      Master side of the pseudo terminal, or -1.
+** \param     canFds      Sockets to the other nodes on the CAN bus.
+** \param     canFdCount  Number of entries in canFds.
+** \return    none.
+**
+****************************************************************************************/
+static void SimRun(int uartFd, int *canFds, unsigned char canFdCount)
+{
+  LinkInit(&simConfig, uartFd, canFds, canFdCount);
+  atexit(SimExit);
+
+  /* the same main loop as the target's, with the idle time given back to the host */
+  BootInit();
+  while (1)
+  {
+    BootTask();
+    LinkIdle();
+  }
+} /*** end of SimRun ***/
+
+
+/*********************************** end of main.c *************************************/
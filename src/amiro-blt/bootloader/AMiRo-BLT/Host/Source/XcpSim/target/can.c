@@ -0,0 +1,237 @@
+/************************************************************************************//**
+* \file         target\can.c
+* \brief        Bootloader CAN communication interface source file for the simulator.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "boot.h"                                /* bootloader generic header          */
+#include "link.h"                                /* simulated link model               */
+
+
+#if (BOOT_COM_CAN_ENABLE > 0 || BOOT_GATE_CAN_ENABLE > 0)
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+#if (BOOT_GATE_CAN_ENABLE > 0)
+/** \brief Set while this node waits for the response of a node it sent a command to. */
+blt_bool commandSend;
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+
+
+/************************************************************************************//**
+** \brief     Initializes the CAN controller. The simulated bus needs no bit timing.
+** \return    none.
+**
+****************************************************************************************/
+void CanInit(void)
+{
+#if (BOOT_GATE_CAN_ENABLE > 0)
+  commandSend = BLT_FALSE;
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+} /*** end of CanInit ***/
+
+
+/************************************************************************************//**
+** \brief     Transmits a packet formatted for the communication interface. The framing
+**            is identical to the ARMCM4_STM32 driver: the first frame holds the device
+**            ID, the packet length and up to 3 bytes, every subsequent frame the
+**            remaining length and up to 7 bytes. Each frame is acknowledged by the
+**            receiver before the next one is sent.
+** \param     data     Pointer to byte array with data that it to be transmitted.
+** \param     len      Number of bytes that are to be transmitted.
+** \param     deviceID ID of the receiving device, or 0 to respond to the main device.
+** \return    none.
+**
+****************************************************************************************/
+void CanTransmitPacket(blt_int8u *data, blt_int8u len, blt_int32u deviceID)
+{
+  blt_int32u address;
+  blt_int8u canData[8];
+  blt_int8u canDlc;
+  blt_int8u restLen = len;
+  blt_int8u canIdx = 0;
+  tLinkCanFrame ack;
+
+#if (BOOT_GATE_CAN_ENABLE > 0)
+  if (deviceID == 0) {
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+    address = (blt_int32u)BOOT_COM_CAN_TX_MSG_ID;
+#if (BOOT_GATE_CAN_ENABLE > 0)
+    commandSend = BLT_FALSE;
+  } else {
+    address = (blt_int32u)BOOT_COM_CAN_RX_MSG_ID;
+    commandSend = BLT_TRUE;
+  }
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+
+  /* send the given package in 8 byte packages */
+  while (restLen > 0) {
+    /* if this is the first transmission of this packet */
+    if (restLen == len) {
+      canDlc = (restLen > 4) ? 8 : restLen+1+4;
+      /* store the device ID */
+      canData[0] = (blt_int8u)(0xFF & (deviceID >> 0));
+      canData[1] = (blt_int8u)(0xFF & (deviceID >> 8));
+      canData[2] = (blt_int8u)(0xFF & (deviceID >> 16));
+      canData[3] = (blt_int8u)(0xFF & (deviceID >> 24));
+      /* store the remaining packet length */
+      canData[4] = restLen;
+      canIdx = 5;
+    }
+    /* if this is a succeeding transmission of this packet */
+    else {
+      canDlc = (restLen > 7) ? 8 : restLen+1;
+      /* store the remaining packet length */
+      canData[0] = restLen;
+      canIdx = 1;
+    }
+
+    /* store the packet payload */
+    while (restLen > 0 && canIdx < 8) {
+      canData[canIdx] = data[len-restLen];
+      canIdx++;
+      restLen--;
+    }
+    /* fill rest with nulls */
+    while (canIdx < 8) {
+      canData[canIdx] = 0;
+      canIdx++;
+    }
+
+    /* transmit and wait for the acknowledgement */
+    LinkCanTransmit(address, canDlc, canData);
+    LinkCanReceive(&ack, BLT_TRUE);
+
+    /* modify address so that receivers can filter */
+    address |= (blt_int32u)BOOT_COM_CAN_MSG_SUBSEQUENT;
+  }
+} /*** end of CanTransmitPacket ***/
+
+
+/************************************************************************************//**
+** \brief     Receives a communication interface packet if one is present. Once the
+**            first frame of a packet for this node was received, the function blocks
+**            until the entire packet arrived.
+** \param     data Pointer to byte array where the data is to be stored.
+** \return    Length of message (if the message is invalid, the length will be 0).
+**
+****************************************************************************************/
+blt_int8u CanReceivePacket(blt_int8u *data)
+{
+  static blt_int8u readData[BOOT_COM_RX_MAX_DATA];
+  static blt_int8u receivedLen = 0;
+  static blt_int8u toReceive = 0;
+  tLinkCanFrame frame;
+  blt_int8u length = 0;
+  blt_int8u ackData[8] = { 0 };
+  blt_int8u idx;
+  blt_int32u compID;
+
+#if (BOOT_GATE_CAN_ENABLE > 0)
+  if (commandSend == BLT_TRUE) {
+    compID = (blt_int32u)BOOT_COM_CAN_TX_MSG_ID;
+  } else {
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+    compID = (blt_int32u)BOOT_COM_CAN_RX_MSG_ID;
+#if (BOOT_GATE_CAN_ENABLE > 0)
+  }
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+
+  /* check if a new message was received or is more to come */
+  while (LinkCanReceive(&frame, (receivedLen < toReceive) ? BLT_TRUE : BLT_FALSE) == BLT_TRUE)
+  {
+    /* is this the packet identifier */
+    if (frame.id != compID)
+    {
+      continue;
+    }
+
+    /* if this is the first transmission of this packet */
+    if (receivedLen == 0) {
+      /* abort if the message was meant for someone else */
+      blt_int32u deviceID = (((blt_int32u)frame.data[3]) << 24) | \
+                            (((blt_int32u)frame.data[2]) << 16) | \
+                            (((blt_int32u)frame.data[1]) <<  8) | \
+                            (((blt_int32u)frame.data[0]));
+#if (BOOT_GATE_ENABLE > 0)
+      if ((commandSend == BLT_TRUE && deviceID == 0) ||
+          ((commandSend != BLT_TRUE && deviceID == (blt_int32u)BOOT_COM_DEVICE_ID) || deviceID == (blt_int32u)BOOT_COM_DEVICE_LEGACY_ID)) {
+#else
+      if (deviceID == (blt_int32u)BOOT_COM_DEVICE_ID) {
+#endif
+        /* store length of the packet */
+        toReceive = frame.data[4];
+        idx = 5;
+        /* modify the listening address for filtering of subsequent transmissions */
+        compID |= (blt_int32u)BOOT_COM_CAN_MSG_SUBSEQUENT;
+      } else {
+        break;
+      }
+    }
+    /* if this is a subsequent transmission of a packet */
+    else {
+      idx = 1;
+    }
+
+    /* store the payload */
+    for (; idx < frame.dlc; idx++) {
+      readData[receivedLen] = frame.data[idx];
+      receivedLen++;
+    }
+
+    /* send acknowledgement */
+    ackData[0] = toReceive-receivedLen;
+    LinkCanTransmit(frame.id | (blt_int32u)BOOT_COM_CAN_MSG_ACK, 1, ackData);
+
+    /* check if full package has been received */
+    if (receivedLen == toReceive) {
+#if (BOOT_GATE_CAN_ENABLE > 0)
+      commandSend = BLT_FALSE;
+#endif /* BOOT_GATE_CAN_ENABLE > 0 */
+      for (idx = 0; idx < toReceive; idx++) {
+        data[idx] = readData[idx];
+      }
+      length = toReceive;
+      /* reset static variables */
+      receivedLen = 0;
+      toReceive = 0;
+      break;
+    }
+  }
+
+  return length;
+} /*** end of CanReceivePacket ***/
+#endif /* BOOT_COM_CAN_ENABLE > 0 || BOOT_GATE_CAN_ENABLE > 0 */
+
+
+/*********************************** end of can.c **************************************/
@@ -0,0 +1,128 @@
+/************************************************************************************//**
+* \file         target\cpu.c
+* \brief        Bootloader cpu module source file for the simulator.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "boot.h"                                /* bootloader generic header          */
+
+
+/****************************************************************************************
+* Hook functions
+****************************************************************************************/
+#if (BOOT_CPU_USER_PROGRAM_START_HOOK > 0)
+extern blt_bool CpuUserProgramStartHook(void);
+#endif
+
+
+/****************************************************************************************
+* External functions
+****************************************************************************************/
+extern void SimUserProgramStarted(void);              /* implemented in main.c         */
+extern void SimReset(void);                           /* implemented in main.c         */
+
+
+/************************************************************************************//**
+** \brief     Starts the user program, if one is present. In this case this function
+**            does not return. The simulator cannot execute the user program, so it
+**            hands over to SimUserProgramStarted() instead of jumping to the reset
+**            vector.
+** \return    none.
+**
+****************************************************************************************/
+void CpuStartUserProgram(void)
+{
+  /* check if a user program is present by verifying the checksum */
+  if (NvmVerifyChecksum() == BLT_FALSE)
+  {
+    /* not a valid user program so it cannot be started */
+    return;
+  }
+  #if (BOOT_CPU_USER_PROGRAM_START_HOOK > 0)
+  /* invoke callback */
+  if (CpuUserProgramStartHook() == BLT_FALSE)
+  {
+    /* callback requests the user program to not be started */
+    return;
+  }
+  #endif
+  #if (BOOT_COM_ENABLE > 0)
+  /* release the communication interface */
+  ComFree();
+  #endif
+  /* reset the timer */
+  TimerReset();
+  /* the user program takes over */
+  SimUserProgramStarted();
+} /*** end of CpuStartUserProgram ***/
+
+
+/************************************************************************************//**
+** \brief     Copies data from the source to the destination address.
+** \param     dest Destination address for the data.
+** \param     src  Source address of the data.
+** \param     len  length of the data in bytes. 
+** \return    none.
+**
+****************************************************************************************/
+void CpuMemCopy(blt_addr dest, blt_addr src, blt_int16u len)
+{
+  blt_int8u *from, *to;
+
+  /* set casted pointers */
+  from = (blt_int8u *)src;
+  to = (blt_int8u *)dest;
+
+  /* copy all bytes from source address to destination address */
+  while(len-- > 0)
+  {
+    /* store byte value from source to destination */
+    *to++ = *from++;
+    /* keep the watchdog happy */
+    CopService();
+  }
+} /*** end of CpuMemCopy ***/
+
+
+/************************************************************************************//**
+** \brief     Perform a soft reset of the simulated microcontroller.
+** \return    none.
+**
+****************************************************************************************/
+void CpuReset(void)
+{
+  SimReset();
+} /*** end of CpuReset ***/
+
+
+/*********************************** end of cpu.c **************************************/
@@ -0,0 +1,82 @@
+/************************************************************************************//**
+* \file         target\helper.c
+* \brief        Helper functions of the AMiRo bootloaders for the simulator.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#include "helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "link.h"
+
+/*
+ * State of the simulated LED.
+ */
+static uint8_t ledState = 0;
+
+/*
+ * Actively waits until the specified time has passed.
+ */
+void msleep(uint32_t ms)
+{
+  LinkDelayUs(ms * 1000);
+
+  return;
+}
+
+/*
+ * Sets the state of the simulated LED.
+ */
+void setLed(uint8_t on)
+{
+  ledState = on;
+
+  return;
+}
+
+/*
+ * Reports an SOS signal, which the real target blinks on its LED.
+ */
+void blinkSOS(uint32_t loops)
+{
+  fprintf(stderr, "XcpSim: SOS (%u loops)\n", loops);
+
+  return;
+}
+
+/*
+ * The real target blinks SOS forever. Since nobody watches the simulated LED, the
+ * simulation is aborted instead.
+ */
+void blinkSOSinf(void)
+{
+  fprintf(stderr, "XcpSim: SOS, target halted (led %u)\n", ledState);
+  abort();
+}
@@ -0,0 +1,54 @@
+/************************************************************************************//**
+* \file         target\helper.h
+* \brief        Helper functions of the AMiRo bootloaders header file.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#ifndef HELPER_H
+#define HELPER_H
+
+#include <stdint.h>
+
+/****************************************************************************************
+* Helper functions that implement a actively polling loop until a specific event occurs.
+* The simulated target has no GPIOs, so the signal functions are not available.
+****************************************************************************************/
+void msleep(uint32_t ms);
+/***************************************************************************************/
+
+/****************************************************************************************
+* Helper functions that use the LED to signal some states or visualize data.
+* The simulated LED state is kept in memory only.
+****************************************************************************************/
+void setLed(uint8_t on);
+void blinkSOS(uint32_t loops);
+void blinkSOSinf(void);
+/***************************************************************************************/
+
+#endif // HELPER_H
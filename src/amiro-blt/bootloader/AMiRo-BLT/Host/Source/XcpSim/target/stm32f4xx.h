@@ -0,0 +1,121 @@
+/************************************************************************************//**
+* \file         target\stm32f4xx.h
+* \brief        Minimal STM32F4xx device header for the simulator.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#ifndef STM32F4XX_H
+#define STM32F4XX_H
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include <stdint.h>                                   /* fixed width integer types     */
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Status of a peripheral flag. */
+typedef enum
+{
+  RESET = 0,
+  SET = !RESET
+} FlagStatus;
+
+/** \brief Enable state of a peripheral. */
+typedef enum
+{
+  DISABLE = 0,
+  ENABLE = !DISABLE
+} FunctionalState;
+
+/** \brief Simulated USART peripheral. Only the configured speed and the enable state
+ *         are kept, the data itself is handled by the link model.
+ */
+typedef struct
+{
+  uint16_t DR;                                   /**< only its address is used         */
+  uint32_t baudrate;
+  uint8_t  enabled;
+  uint8_t  dmaRx;                                /**< 1 if the receiver requests DMA   */
+  uint8_t  dmaRxError;                           /**< framing error seen by the DMA    */
+} USART_TypeDef;
+
+/** \brief Simulated DMA stream. Only peripheral to memory transfers from a USART are
+ *         supported. The transfers take place when the counter is read.
+ */
+typedef struct
+{
+  uint32_t peripheral;                           /**< address of the USART data reg.   */
+  uint8_t  *memory;                              /**< start of the memory buffer       */
+  uint32_t size;                                 /**< number of bytes in the buffer    */
+  uint32_t NDTR;                                 /**< remaining bytes in this round    */
+  uint8_t  circular;                             /**< 1 to restart at the buffer start */
+  uint8_t  enabled;
+} DMA_Stream_TypeDef;
+
+
+/****************************************************************************************
+* Peripheral declarations
+****************************************************************************************/
+/** \brief Start of the flash memory, where the simulator maps the flash file. */
+#define FLASH_BASE            ((uint32_t)0x08000000)
+
+extern USART_TypeDef simUsart[6];
+/** \brief USART1 peripheral. */
+#define USART1                (&simUsart[0])
+/** \brief USART2 peripheral. */
+#define USART2                (&simUsart[1])
+/** \brief USART3 peripheral. */
+#define USART3                (&simUsart[2])
+/** \brief USART4 peripheral. */
+#define USART4                (&simUsart[3])
+/** \brief USART5 peripheral. */
+#define USART5                (&simUsart[4])
+/** \brief USART6 peripheral. */
+#define USART6                (&simUsart[5])
+
+extern DMA_Stream_TypeDef simDmaStream[16];
+/** \brief DMA1 stream 0 (UART5 RX). */
+#define DMA1_Stream0          (&simDmaStream[0])
+/** \brief DMA1 stream 1 (USART3 RX). */
+#define DMA1_Stream1          (&simDmaStream[1])
+/** \brief DMA1 stream 2 (UART4 RX). */
+#define DMA1_Stream2          (&simDmaStream[2])
+/** \brief DMA1 stream 5 (USART2 RX). */
+#define DMA1_Stream5          (&simDmaStream[5])
+/** \brief DMA2 stream 1 (USART6 RX). */
+#define DMA2_Stream1          (&simDmaStream[9])
+/** \brief DMA2 stream 2 (USART1 RX). */
+#define DMA2_Stream2          (&simDmaStream[10])
+
+
+#endif /* STM32F4XX_H */
+/*********************************** end of stm32f4xx.h ********************************/
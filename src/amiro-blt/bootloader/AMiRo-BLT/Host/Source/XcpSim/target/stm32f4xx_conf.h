@@ -0,0 +1,205 @@
+/************************************************************************************//**
+* \file         target\stm32f4xx_conf.h
+* \brief        Simulated STM32F4xx standard peripheral library header file.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#ifndef STM32F4XX_CONF_H
+#define STM32F4XX_CONF_H
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "stm32f4xx.h"                           /* STM32 registers                    */
+
+
+/****************************************************************************************
+* FLASH driver
+****************************************************************************************/
+/** \brief Result of a flash operation. */
+typedef enum
+{
+  FLASH_BUSY = 1,
+  FLASH_ERROR_PGS,
+  FLASH_ERROR_PGP,
+  FLASH_ERROR_PGA,
+  FLASH_ERROR_WRP,
+  FLASH_ERROR_PROGRAM,
+  FLASH_ERROR_OPERATION,
+  FLASH_COMPLETE
+} FLASH_Status;
+
+#define FLASH_Sector_0        ((uint16_t)0x0000)
+#define FLASH_Sector_1        ((uint16_t)0x0008)
+#define FLASH_Sector_2        ((uint16_t)0x0010)
+#define FLASH_Sector_3        ((uint16_t)0x0018)
+#define FLASH_Sector_4        ((uint16_t)0x0020)
+#define FLASH_Sector_5        ((uint16_t)0x0028)
+#define FLASH_Sector_6        ((uint16_t)0x0030)
+#define FLASH_Sector_7        ((uint16_t)0x0038)
+#define FLASH_Sector_8        ((uint16_t)0x0040)
+#define FLASH_Sector_9        ((uint16_t)0x0048)
+#define FLASH_Sector_10       ((uint16_t)0x0050)
+#define FLASH_Sector_11       ((uint16_t)0x0058)
+#define FLASH_Sector_12       ((uint16_t)0x0080)
+#define FLASH_Sector_13       ((uint16_t)0x0088)
+#define FLASH_Sector_14       ((uint16_t)0x0090)
+#define FLASH_Sector_15       ((uint16_t)0x0098)
+#define FLASH_Sector_16       ((uint16_t)0x00A0)
+#define FLASH_Sector_17       ((uint16_t)0x00A8)
+#define FLASH_Sector_18       ((uint16_t)0x00B0)
+#define FLASH_Sector_19       ((uint16_t)0x00B8)
+#define FLASH_Sector_20       ((uint16_t)0x00C0)
+#define FLASH_Sector_21       ((uint16_t)0x00C8)
+#define FLASH_Sector_22       ((uint16_t)0x00D0)
+#define FLASH_Sector_23       ((uint16_t)0x00D8)
+
+#define VoltageRange_1        ((uint8_t)0x00)
+#define VoltageRange_2        ((uint8_t)0x01)
+#define VoltageRange_3        ((uint8_t)0x02)
+#define VoltageRange_4        ((uint8_t)0x03)
+
+#define FLASH_FLAG_EOP        ((uint32_t)0x00000001)
+#define FLASH_FLAG_OPERR      ((uint32_t)0x00000002)
+#define FLASH_FLAG_WRPERR     ((uint32_t)0x00000010)
+#define FLASH_FLAG_PGAERR     ((uint32_t)0x00000020)
+#define FLASH_FLAG_PGPERR     ((uint32_t)0x00000040)
+#define FLASH_FLAG_PGSERR     ((uint32_t)0x00000080)
+#define FLASH_FLAG_BSY        ((uint32_t)0x00010000)
+
+void         FLASH_Unlock(void);
+void         FLASH_Lock(void);
+void         FLASH_ClearFlag(uint32_t FLASH_FLAG);
+FLASH_Status FLASH_GetStatus(void);
+FLASH_Status FLASH_EraseSector(uint32_t FLASH_Sector, uint8_t VoltageRange);
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data);
+
+
+/****************************************************************************************
+* RCC driver
+****************************************************************************************/
+/** \brief Frequencies of the system and bus clocks in Hz. */
+typedef struct
+{
+  uint32_t SYSCLK_Frequency;
+  uint32_t HCLK_Frequency;
+  uint32_t PCLK1_Frequency;
+  uint32_t PCLK2_Frequency;
+} RCC_ClocksTypeDef;
+
+#define RCC_AHB1Periph_DMA1                  ((uint32_t)0x00200000)
+#define RCC_AHB1Periph_DMA2                  ((uint32_t)0x00400000)
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks);
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState);
+
+
+/****************************************************************************************
+* DMA driver
+****************************************************************************************/
+/** \brief DMA stream initialization parameters. */
+typedef struct
+{
+  uint32_t DMA_Channel;
+  uint32_t DMA_PeripheralBaseAddr;
+  uint32_t DMA_Memory0BaseAddr;
+  uint32_t DMA_DIR;
+  uint32_t DMA_BufferSize;
+  uint32_t DMA_PeripheralInc;
+  uint32_t DMA_MemoryInc;
+  uint32_t DMA_PeripheralDataSize;
+  uint32_t DMA_MemoryDataSize;
+  uint32_t DMA_Mode;
+  uint32_t DMA_Priority;
+  uint32_t DMA_FIFOMode;
+  uint32_t DMA_FIFOThreshold;
+  uint32_t DMA_MemoryBurst;
+  uint32_t DMA_PeripheralBurst;
+} DMA_InitTypeDef;
+
+#define DMA_Channel_4                        ((uint32_t)0x08000000)
+#define DMA_Channel_5                        ((uint32_t)0x0A000000)
+#define DMA_DIR_PeripheralToMemory           ((uint32_t)0x00000000)
+#define DMA_PeripheralInc_Disable            ((uint32_t)0x00000000)
+#define DMA_MemoryInc_Enable                 ((uint32_t)0x00000400)
+#define DMA_PeripheralDataSize_Byte          ((uint32_t)0x00000000)
+#define DMA_MemoryDataSize_Byte              ((uint32_t)0x00000000)
+#define DMA_Mode_Normal                      ((uint32_t)0x00000000)
+#define DMA_Mode_Circular                    ((uint32_t)0x00000100)
+#define DMA_Priority_High                    ((uint32_t)0x00020000)
+#define DMA_FIFOMode_Disable                 ((uint32_t)0x00000000)
+#define DMA_FIFOThreshold_Full               ((uint32_t)0x00000003)
+#define DMA_MemoryBurst_Single               ((uint32_t)0x00000000)
+#define DMA_PeripheralBurst_Single           ((uint32_t)0x00000000)
+
+void     DMA_DeInit(DMA_Stream_TypeDef* DMAy_Streamx);
+void     DMA_Init(DMA_Stream_TypeDef* DMAy_Streamx, DMA_InitTypeDef* DMA_InitStruct);
+void     DMA_Cmd(DMA_Stream_TypeDef* DMAy_Streamx, FunctionalState NewState);
+uint16_t DMA_GetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx);
+
+
+/****************************************************************************************
+* USART driver
+****************************************************************************************/
+/** \brief USART initialization parameters. */
+typedef struct
+{
+  uint32_t USART_BaudRate;
+  uint16_t USART_WordLength;
+  uint16_t USART_StopBits;
+  uint16_t USART_Parity;
+  uint16_t USART_Mode;
+  uint16_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+#define USART_WordLength_8b                  ((uint16_t)0x0000)
+#define USART_StopBits_1                     ((uint16_t)0x0000)
+#define USART_Parity_No                      ((uint16_t)0x0000)
+#define USART_Mode_Rx                        ((uint16_t)0x0004)
+#define USART_Mode_Tx                        ((uint16_t)0x0008)
+#define USART_HardwareFlowControl_None       ((uint16_t)0x0000)
+
+#define USART_FLAG_TC                        ((uint16_t)0x0040)
+#define USART_FLAG_TXE                       ((uint16_t)0x0080)
+#define USART_FLAG_RXNE                      ((uint16_t)0x0020)
+#define USART_FLAG_NE                        ((uint16_t)0x0004)
+#define USART_FLAG_FE                        ((uint16_t)0x0002)
+
+#define USART_DMAReq_Rx                      ((uint16_t)0x0040)
+
+void       USART_Init(USART_TypeDef* USARTx, USART_InitTypeDef* USART_InitStruct);
+void       USART_Cmd(USART_TypeDef* USARTx, FunctionalState NewState);
+FlagStatus USART_GetFlagStatus(USART_TypeDef* USARTx, uint16_t USART_FLAG);
+void       USART_SendData(USART_TypeDef* USARTx, uint16_t Data);
+uint16_t   USART_ReceiveData(USART_TypeDef* USARTx);
+void       USART_DMACmd(USART_TypeDef* USARTx, uint16_t USART_DMAReq, FunctionalState NewState);
+
+
+#endif /* STM32F4XX_CONF_H */
+/*********************************** end of stm32f4xx_conf.h ***************************/
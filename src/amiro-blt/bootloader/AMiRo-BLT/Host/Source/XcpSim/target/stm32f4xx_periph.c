@@ -0,0 +1,475 @@
+/************************************************************************************//**
+* \file         target\stm32f4xx_periph.c
+* \brief        Simulated STM32F4xx flash and USART peripheral drivers.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "boot.h"                                /* bootloader generic header          */
+#include "stm32f4xx.h"                           /* STM32 registers                    */
+#include "stm32f4xx_conf.h"                      /* STM32 peripheral drivers           */
+#include <string.h>                              /* for memset()                       */
+#include "link.h"                                /* simulated link model               */
+
+
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Size of the simulated flash memory in bytes. */
+#define SIM_FLASH_SIZE                  ((blt_int32u)BOOT_NVM_SIZE_KB * 1024u)
+/** \brief Typical time to program a word with x32 parallelism (VoltageRange_3). */
+#define SIM_FLASH_PROGRAM_WORD_US       (16)
+/** \brief Typical time to erase a 16 KB sector with x32 parallelism. */
+#define SIM_FLASH_ERASE_16K_US          (250000)
+/** \brief Typical time to erase a 64 KB sector with x32 parallelism. */
+#define SIM_FLASH_ERASE_64K_US          (550000)
+/** \brief Typical time to erase a 128 KB sector with x32 parallelism. */
+#define SIM_FLASH_ERASE_128K_US         (1000000)
+
+
+/****************************************************************************************
+* Global data declarations
+****************************************************************************************/
+/** \brief The simulated USART peripherals. */
+USART_TypeDef simUsart[6];
+/** \brief The simulated DMA streams, DMA1 stream 0..7 followed by DMA2 stream 0..7. */
+DMA_Stream_TypeDef simDmaStream[16];
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static void SimDmaTransfer(DMA_Stream_TypeDef* DMAy_Streamx);
+static void SimDmaIdle(void);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Lock state of the flash control register. */
+static blt_bool flashLocked = BLT_TRUE;
+
+
+/************************************************************************************//**
+** \brief     Unlocks the flash control register access.
+** \return    none.
+**
+****************************************************************************************/
+void FLASH_Unlock(void)
+{
+  flashLocked = BLT_FALSE;
+} /*** end of FLASH_Unlock ***/
+
+
+/************************************************************************************//**
+** \brief     Locks the flash control register access.
+** \return    none.
+**
+****************************************************************************************/
+void FLASH_Lock(void)
+{
+  flashLocked = BLT_TRUE;
+} /*** end of FLASH_Lock ***/
+
+
+/************************************************************************************//**
+** \brief     Clears the flash pending flags. Operations complete synchronously in the
+**            simulation, so no flags are ever pending.
+** \param     FLASH_FLAG Flags to clear.
+** \return    none.
+**
+****************************************************************************************/
+void FLASH_ClearFlag(uint32_t FLASH_FLAG)
+{
+  (void)FLASH_FLAG;
+} /*** end of FLASH_ClearFlag ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the flash status.
+** \return    FLASH_COMPLETE, since operations complete synchronously.
+**
+****************************************************************************************/
+FLASH_Status FLASH_GetStatus(void)
+{
+  return FLASH_COMPLETE;
+} /*** end of FLASH_GetStatus ***/
+
+
+/************************************************************************************//**
+** \brief     Erases a flash sector, which sets all its bits. The STM32F4 sector layout
+**            is used: 4 x 16 KB, 1 x 64 KB and 7 x 128 KB per bank.
+** \param     FLASH_Sector  Sector mask FLASH_Sector_0..23.
+** \param     VoltageRange  Program/erase parallelism (ignored).
+** \return    FLASH_COMPLETE if successful, an error code otherwise.
+**
+****************************************************************************************/
+FLASH_Status FLASH_EraseSector(uint32_t FLASH_Sector, uint8_t VoltageRange)
+{
+  blt_int32u sector = FLASH_Sector >> 3;
+  blt_int32u offset;
+  blt_int32u size;
+  blt_int32u bank = 0;
+  blt_int32u timeUs;
+
+  (void)VoltageRange;
+  if (flashLocked == BLT_TRUE)
+  {
+    return FLASH_ERROR_WRP;
+  }
+  /* sectors of the second bank start at mask index 16 */
+  if (sector >= 16)
+  {
+    bank = 0x100000;
+    sector -= 16;
+  }
+  if (sector < 4)
+  {
+    offset = sector * 0x4000;
+    size = 0x4000;
+    timeUs = SIM_FLASH_ERASE_16K_US;
+  }
+  else if (sector == 4)
+  {
+    offset = 0x10000;
+    size = 0x10000;
+    timeUs = SIM_FLASH_ERASE_64K_US;
+  }
+  else if (sector < 12)
+  {
+    offset = 0x20000 + (sector - 5) * 0x20000;
+    size = 0x20000;
+    timeUs = SIM_FLASH_ERASE_128K_US;
+  }
+  else
+  {
+    return FLASH_ERROR_PROGRAM;
+  }
+  offset += bank;
+  if (offset + size > SIM_FLASH_SIZE)
+  {
+    return FLASH_ERROR_PROGRAM;
+  }
+  if (LinkFlashTiming() != 0)
+  {
+    LinkDelayUs(timeUs);
+  }
+  memset((void *)(blt_addr)(FLASH_BASE + offset), 0xff, size);
+  return FLASH_COMPLETE;
+} /*** end of FLASH_EraseSector ***/
+
+
+/************************************************************************************//**
+** \brief     Programs a word. Like NOR flash, programming can only clear bits, so
+**            writing to a location that was not erased leaves the AND of both values.
+** \param     Address Word aligned address in flash.
+** \param     Data    Value to program.
+** \return    FLASH_COMPLETE if successful, an error code otherwise.
+**
+****************************************************************************************/
+FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data)
+{
+  if (flashLocked == BLT_TRUE)
+  {
+    return FLASH_ERROR_WRP;
+  }
+  if ((Address < FLASH_BASE) || (Address + 4 > FLASH_BASE + SIM_FLASH_SIZE) || ((Address & 3) != 0))
+  {
+    return FLASH_ERROR_PGA;
+  }
+  if (LinkFlashTiming() != 0)
+  {
+    LinkDelayUs(SIM_FLASH_PROGRAM_WORD_US);
+  }
+  *(volatile uint32_t *)(blt_addr)Address &= Data;
+  return FLASH_COMPLETE;
+} /*** end of FLASH_ProgramWord ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the clock frequencies. The simulator reports the clock tree of the
+**            PowerManagement board: 168 MHz system clock, APB1 at /4 and APB2 at /2.
+** \param     RCC_Clocks Structure that receives the frequencies.
+** \return    none.
+**
+****************************************************************************************/
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* RCC_Clocks)
+{
+  RCC_Clocks->SYSCLK_Frequency = 168000000u;
+  RCC_Clocks->HCLK_Frequency = 168000000u;
+  RCC_Clocks->PCLK1_Frequency = 42000000u;
+  RCC_Clocks->PCLK2_Frequency = 84000000u;
+} /*** end of RCC_GetClocksFreq ***/
+
+
+/************************************************************************************//**
+** \brief     Enables or disables the clock of AHB1 peripherals. Simulated peripherals
+**            need no clock.
+** \param     RCC_AHB1Periph Peripherals.
+** \param     NewState       ENABLE or DISABLE.
+** \return    none.
+**
+****************************************************************************************/
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState)
+{
+  (void)RCC_AHB1Periph;
+  (void)NewState;
+} /*** end of RCC_AHB1PeriphClockCmd ***/
+
+
+/************************************************************************************//**
+** \brief     Resets a DMA stream to its disabled default state.
+** \param     DMAy_Streamx The DMA stream.
+** \return    none.
+**
+****************************************************************************************/
+void DMA_DeInit(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+  memset(DMAy_Streamx, 0, sizeof(*DMAy_Streamx));
+} /*** end of DMA_DeInit ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes a DMA stream.
+** \param     DMAy_Streamx   The DMA stream.
+** \param     DMA_InitStruct Initialization parameters.
+** \return    none.
+**
+****************************************************************************************/
+void DMA_Init(DMA_Stream_TypeDef* DMAy_Streamx, DMA_InitTypeDef* DMA_InitStruct)
+{
+  DMAy_Streamx->peripheral = DMA_InitStruct->DMA_PeripheralBaseAddr;
+  DMAy_Streamx->memory = (uint8_t *)(blt_addr)DMA_InitStruct->DMA_Memory0BaseAddr;
+  DMAy_Streamx->size = DMA_InitStruct->DMA_BufferSize;
+  DMAy_Streamx->NDTR = DMA_InitStruct->DMA_BufferSize;
+  DMAy_Streamx->circular = (DMA_InitStruct->DMA_Mode == DMA_Mode_Circular) ? 1 : 0;
+} /*** end of DMA_Init ***/
+
+
+/************************************************************************************//**
+** \brief     Enables or disables a DMA stream.
+** \param     DMAy_Streamx The DMA stream.
+** \param     NewState     ENABLE or DISABLE.
+** \return    none.
+**
+****************************************************************************************/
+void DMA_Cmd(DMA_Stream_TypeDef* DMAy_Streamx, FunctionalState NewState)
+{
+  DMAy_Streamx->enabled = (NewState == ENABLE) ? 1 : 0;
+} /*** end of DMA_Cmd ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the number of remaining transfers. First moves all bytes that the
+**            USART received in the meantime to memory, as the DMA would have done.
+** \param     DMAy_Streamx The DMA stream.
+** \return    Number of bytes until the end of the buffer.
+**
+****************************************************************************************/
+uint16_t DMA_GetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+  SimDmaTransfer(DMAy_Streamx);
+  return (uint16_t)DMAy_Streamx->NDTR;
+} /*** end of DMA_GetCurrDataCounter ***/
+
+
+/************************************************************************************//**
+** \brief     Moves the bytes that the USART received to memory, if the stream serves
+**            the receive requests of a USART.
+** \param     DMAy_Streamx The DMA stream.
+** \return    none.
+**
+****************************************************************************************/
+static void SimDmaTransfer(DMA_Stream_TypeDef* DMAy_Streamx)
+{
+  USART_TypeDef *usart = NULL;
+  uint8_t idx;
+
+  for (idx = 0; idx < sizeof(simUsart)/sizeof(simUsart[0]); idx++)
+  {
+    if (DMAy_Streamx->peripheral == (uint32_t)(blt_addr)&simUsart[idx].DR)
+    {
+      usart = &simUsart[idx];
+    }
+  }
+  if ((usart == NULL) || (usart->enabled == 0) || (usart->dmaRx == 0))
+  {
+    return;
+  }
+  while ((DMAy_Streamx->enabled != 0) && (LinkUartRxReady() != 0))
+  {
+    if (LinkUartRxError() != 0)
+    {
+      usart->dmaRxError = 1;
+    }
+    DMAy_Streamx->memory[DMAy_Streamx->size - DMAy_Streamx->NDTR] = LinkUartRxRead();
+    DMAy_Streamx->NDTR--;
+    if (DMAy_Streamx->NDTR == 0)
+    {
+      DMAy_Streamx->NDTR = DMAy_Streamx->size;
+      DMAy_Streamx->enabled = DMAy_Streamx->circular;
+    }
+  }
+} /*** end of SimDmaTransfer ***/
+
+
+/************************************************************************************//**
+** \brief     Lets the DMA streams work while the target waits for something else, e.g.
+**            for the acknowledgement of a CAN frame. Registered with the link model.
+** \return    none.
+**
+****************************************************************************************/
+static void SimDmaIdle(void)
+{
+  uint8_t idx;
+
+  for (idx = 0; idx < sizeof(simDmaStream)/sizeof(simDmaStream[0]); idx++)
+  {
+    if (simDmaStream[idx].enabled != 0)
+    {
+      SimDmaTransfer(&simDmaStream[idx]);
+    }
+  }
+} /*** end of SimDmaIdle ***/
+
+
+/************************************************************************************//**
+** \brief     Initializes a USART.
+** \param     USARTx          The USART peripheral.
+** \param     USART_InitStruct Initialization parameters.
+** \return    none.
+**
+****************************************************************************************/
+void USART_Init(USART_TypeDef* USARTx, USART_InitTypeDef* USART_InitStruct)
+{
+  USARTx->baudrate = USART_InitStruct->USART_BaudRate;
+  LinkUartSetBaudrate(USARTx->baudrate);
+} /*** end of USART_Init ***/
+
+
+/************************************************************************************//**
+** \brief     Enables or disables a USART.
+** \param     USARTx   The USART peripheral.
+** \param     NewState ENABLE or DISABLE.
+** \return    none.
+**
+****************************************************************************************/
+void USART_Cmd(USART_TypeDef* USARTx, FunctionalState NewState)
+{
+  USARTx->enabled = (NewState == ENABLE) ? 1 : 0;
+} /*** end of USART_Cmd ***/
+
+
+/************************************************************************************//**
+** \brief     Checks a USART status flag. All USARTs share the simulated link.
+** \param     USARTx     The USART peripheral.
+** \param     USART_FLAG USART_FLAG_RXNE, USART_FLAG_FE, USART_FLAG_NE, USART_FLAG_TXE or
+**                       USART_FLAG_TC.
+** \return    SET or RESET.
+**
+****************************************************************************************/
+FlagStatus USART_GetFlagStatus(USART_TypeDef* USARTx, uint16_t USART_FLAG)
+{
+  FlagStatus flag;
+
+  if (USARTx->enabled == 0)
+  {
+    return RESET;
+  }
+  switch (USART_FLAG)
+  {
+    case USART_FLAG_RXNE:
+      return (LinkUartRxReady() != 0) ? SET : RESET;
+    case USART_FLAG_FE:
+      if (USARTx->dmaRx != 0)
+      {
+        /* a damaged byte that the DMA transferred. reading clears the flag */
+        flag = (USARTx->dmaRxError != 0) ? SET : RESET;
+        USARTx->dmaRxError = 0;
+        return flag;
+      }
+      return (LinkUartRxError() != 0) ? SET : RESET;
+    case USART_FLAG_TXE:
+    case USART_FLAG_TC:
+      return (LinkUartTxReady() != 0) ? SET : RESET;
+    default:
+      return RESET;
+  }
+} /*** end of USART_GetFlagStatus ***/
+
+
+/************************************************************************************//**
+** \brief     Writes a byte to the transmit data register.
+** \param     USARTx The USART peripheral.
+** \param     Data   The byte to transmit.
+** \return    none.
+**
+****************************************************************************************/
+void USART_SendData(USART_TypeDef* USARTx, uint16_t Data)
+{
+  (void)USARTx;
+  LinkUartTxWrite((uint8_t)Data);
+} /*** end of USART_SendData ***/
+
+
+/************************************************************************************//**
+** \brief     Reads the receive data register.
+** \param     USARTx The USART peripheral.
+** \return    The received byte.
+**
+****************************************************************************************/
+uint16_t USART_ReceiveData(USART_TypeDef* USARTx)
+{
+  (void)USARTx;
+  return LinkUartRxRead();
+} /*** end of USART_ReceiveData ***/
+
+
+/************************************************************************************//**
+** \brief     Enables or disables the DMA requests of a USART.
+** \param     USARTx       The USART peripheral.
+** \param     USART_DMAReq USART_DMAReq_Rx.
+** \param     NewState     ENABLE or DISABLE.
+** \return    none.
+**
+****************************************************************************************/
+void USART_DMACmd(USART_TypeDef* USARTx, uint16_t USART_DMAReq, FunctionalState NewState)
+{
+  if (USART_DMAReq == USART_DMAReq_Rx)
+  {
+    USARTx->dmaRx = (NewState == ENABLE) ? 1 : 0;
+    LinkSetIdleHook((NewState == ENABLE) ? SimDmaIdle : NULL);
+  }
+} /*** end of USART_DMACmd ***/
+
+
+/*********************************** end of stm32f4xx_periph.c *************************/
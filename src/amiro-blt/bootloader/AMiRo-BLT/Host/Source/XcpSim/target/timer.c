@@ -0,0 +1,93 @@
+/************************************************************************************//**
+* \file         target\timer.c
+* \brief        Bootloader timer driver source file for the simulator.
+* \ingroup      XcpSim
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2014  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "boot.h"                                /* bootloader generic header          */
+#include "link.h"                                /* simulated link model               */
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Time in microseconds at which the millisecond timer was started. */
+static uint64_t timerStartUs;
+
+
+/************************************************************************************//**
+** \brief     Initializes the polling based millisecond timer driver.
+** \return    none.
+**
+****************************************************************************************/
+void TimerInit(void)
+{
+  TimerReset();
+} /*** end of TimerInit ***/
+
+
+/************************************************************************************//**
+** \brief     Reset the timer by placing the timer back into it's default reset
+**            configuration.
+** \return    none.
+**
+****************************************************************************************/
+void TimerReset(void)
+{
+  timerStartUs = LinkGetTimeUs();
+} /* end of TimerReset */
+
+
+/************************************************************************************//**
+** \brief     Updates the millisecond timer. The simulated timer is derived from the
+**            host's monotonic clock, so there is nothing to do.
+** \return    none.
+**
+****************************************************************************************/
+void TimerUpdate(void)
+{
+} /*** end of TimerUpdate ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the counter value of the millisecond timer.
+** \return    Current value of the millisecond timer.
+**
+****************************************************************************************/
+blt_int32u TimerGet(void)
+{
+  return (blt_int32u)((LinkGetTimeUs() - timerStartUs) / 1000u);
+} /*** end of TimerGet ***/
+
+
+/*********************************** end of timer.c ************************************/
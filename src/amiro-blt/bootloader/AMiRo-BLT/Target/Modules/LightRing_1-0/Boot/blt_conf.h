@@ -200,6 +200,13 @@
  * BOOT_NVM_SIZE_KB. If desired the internal checksum writing and verification method can
  * be overridden with a application specific method by enabling configuration switch
  * BOOT_NVM_CHECKSUM_HOOKS_ENABLE.
+ * With BOOT_NVM_CRC32_CHECK_ENABLE the internal method additionally stores the length
+ * and CRC-32 of the image after the checksum, and checks them before each start of the
+ * user program. The user program's vector table must then reserve three dummy entries
+ * instead of one: AMiRo-OS reserves them in its linker scripts, in AMiRo-OS 2 they are
+ * unused interrupt vectors. An update that does not include the vector table leaves
+ * the stored CRC-32 outdated, so the user program is only started again after a complete
+ * update.
  */
 /** \brief Enable/disable the NVM hook function for supporting additional memory devices. */
 #define BOOT_NVM_HOOKS_ENABLE           (0)
@@ -207,6 +214,8 @@
 #define BOOT_NVM_SIZE_KB                (512)
 /** \brief Enable/disable hooks functions to override the user program checksum handling. */
 #define BOOT_NVM_CHECKSUM_HOOKS_ENABLE  (0)
+/** \brief Enable/disable the CRC-32 check of the complete user program. */
+#define BOOT_NVM_CRC32_CHECK_ENABLE     (1)
 
 
 /****************************************************************************************
@@ -243,6 +252,18 @@
 #define BOOT_XCP_SEED_KEY_ENABLE        (0)
 
 
+/****************************************************************************************
+*   C O M P R E S S E D   P R O G R A M M I N G   C O N F I G U R A T I O N
+****************************************************************************************/
+/* Firmware can be transferred LZ compressed, which is enabled by setting configurable
+ * BOOT_XCP_PROGRAM_COMPRESSED_ENABLE to 1. The data is decompressed while it arrives,
+ * through a history window of LZ_WINDOW_SIZE bytes of RAM, and passed on to NvmWrite().
+ * SerialBoot uses this when started with -z and falls back to plain PROGRAM commands
+ * if the bootloader does not support it.
+ */
+#define BOOT_XCP_PROGRAM_COMPRESSED_ENABLE (1)
+
+
 
 
 
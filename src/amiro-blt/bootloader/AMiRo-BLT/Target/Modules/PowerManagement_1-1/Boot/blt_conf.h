@@ -140,6 +140,31 @@
 /** \brief Select the desired BLUETOOTH UART peripheral as a zero based index. */
 #define BOOT_COM_BLUETOOTH_UART_CHANNEL_INDEX (2)
 
+/* The host can request a higher UART speed for the rest of a programming session with
+ * the TRANSPORT_LAYER_CMD SET_BAUDRATE command, if BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE
+ * is set to 1. BOOT_COM_UART_BAUDRATE_MAX limits the speed to what the cabling and level
+ * shifters reliably carry. The UART returns to BOOT_COM_UART_BAUDRATE by itself when
+ * the host does not confirm the new speed, falls silent or sends damaged characters.
+ */
+/** \brief Enable/disable switching to a higher UART speed on request of the host. */
+#define BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE (1)
+/** \brief Configure the highest communication speed the host may request. */
+#define BOOT_COM_UART_BAUDRATE_MAX      (1000000)
+
+/* The gateway acknowledges the commands that program data on a device behind it right
+ * away and forwards them while the host already sends the next one, if
+ * BOOT_GATE_STORE_FORWARD_ENABLE is set to 1. Up to BOOT_GATE_STORE_FORWARD_PACKETS
+ * packets wait in the gateway. An error of the device is reported with the response to
+ * a later command. Because the gateway is busy while the host sends, the UART has to
+ * receive by DMA, which BOOT_COM_UART_RX_DMA_ENABLE selects (ARMCM4_STM32 only).
+ */
+/** \brief Enable/disable UART reception into a ring buffer by DMA. */
+#define BOOT_COM_UART_RX_DMA_ENABLE     (1)
+/** \brief Enable/disable store-and-forward of program commands in the gateway. */
+#define BOOT_GATE_STORE_FORWARD_ENABLE  (1)
+/** \brief Configure the number of packets the gateway stores. */
+#define BOOT_GATE_STORE_FORWARD_PACKETS (4)
+
 
 /* The NET communication interface for firmware updates via TCP/IP is selected by setting
  * the BOOT_COM_NET_ENABLE configurable to 1. The maximum amount of data bytes in a
@@ -278,6 +303,13 @@
  * BOOT_NVM_SIZE_KB. If desired the internal checksum writing and verification method can
  * be overridden with a application specific method by enabling configuration switch
  * BOOT_NVM_CHECKSUM_HOOKS_ENABLE.
+ * With BOOT_NVM_CRC32_CHECK_ENABLE the internal method additionally stores the length
+ * and CRC-32 of the image after the checksum, and checks them before each start of the
+ * user program. The user program's vector table must then reserve three dummy entries
+ * instead of one: AMiRo-OS reserves them in its linker scripts, in AMiRo-OS 2 they are
+ * unused interrupt vectors. An update that does not include the vector table leaves
+ * the stored CRC-32 outdated, so the user program is only started again after a complete
+ * update.
  */
 /** \brief Enable/disable the NVM hook function for supporting additional memory devices. */
 #define BOOT_NVM_HOOKS_ENABLE           (0)
@@ -285,6 +317,8 @@
 #define BOOT_NVM_SIZE_KB                (1024)
 /** \brief Enable/disable hooks functions to override the user program checksum handling. */
 #define BOOT_NVM_CHECKSUM_HOOKS_ENABLE  (0)
+/** \brief Enable/disable the CRC-32 check of the complete user program. */
+#define BOOT_NVM_CRC32_CHECK_ENABLE     (1)
 
 
 /****************************************************************************************
@@ -321,5 +355,17 @@
 #define BOOT_XCP_SEED_KEY_ENABLE        (0)
 
 
+/****************************************************************************************
+*   C O M P R E S S E D   P R O G R A M M I N G   C O N F I G U R A T I O N
+****************************************************************************************/
+/* Firmware can be transferred LZ compressed, which is enabled by setting configurable
+ * BOOT_XCP_PROGRAM_COMPRESSED_ENABLE to 1. The data is decompressed while it arrives,
+ * through a history window of LZ_WINDOW_SIZE bytes of RAM, and passed on to NvmWrite().
+ * SerialBoot uses this when started with -z and falls back to plain PROGRAM commands
+ * if the bootloader does not support it.
+ */
+#define BOOT_XCP_PROGRAM_COMPRESSED_ENABLE (1)
+
+
 #endif /* BLT_CONF_H */
 /*********************************** end of blt_conf.h *********************************/
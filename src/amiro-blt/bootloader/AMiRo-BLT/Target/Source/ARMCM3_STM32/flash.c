@@ -59,6 +59,10 @@
 #define FLASH                           ((tFlashRegs *) (blt_int32u)0x40022000)
 /** \brief Offset into the user program's vector table where the checksum is located. */
 #define FLASH_VECTOR_TABLE_CS_OFFSET    (0x150)
+/** \brief Offset into the user program's vector table where the image length and its
+ *         CRC-32 are located.
+ */
+#define FLASH_VECTOR_TABLE_CRC_OFFSET   (FLASH_VECTOR_TABLE_CS_OFFSET + 4)
 #define FLASH_KEY1                      ((blt_int32u)0x45670123)
 #define FLASH_KEY2                      ((blt_int32u)0xCDEF89AB)
 #define FLASH_LOCK_BIT                  ((blt_int32u)0x00000080)
@@ -124,6 +128,10 @@ static void      FlashLock(void);
 static blt_int8u FlashGetSector(blt_addr address);
 static blt_addr  FlashGetSectorBaseAddr(blt_int8u sector);
 static blt_addr  FlashGetSectorSize(blt_int8u sector);
+static blt_int32u FlashUpdateCrc32(blt_int32u crc, blt_addr addr, blt_int32u len);
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+static blt_int32u FlashCalculateImageCrc32(blt_int32u len);
+#endif
 
 
 /****************************************************************************************
@@ -221,6 +229,13 @@ static tFlashBlockInfo blockInfo;
  */
 static tFlashBlockInfo bootBlockInfo;
 
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+/** \brief End address of the data that was programmed, which determines the length of
+ *         the image that the CRC-32 covers.
+ */
+static blt_addr flashImageEnd;
+#endif
+
 
 /************************************************************************************//**
 ** \brief     Initializes the flash driver. 
@@ -232,6 +247,9 @@ void FlashInit(void)
   /* init the flash block info structs by setting the address to an invalid address */
   blockInfo.base_addr = FLASH_INVALID_ADDRESS;
   bootBlockInfo.base_addr = FLASH_INVALID_ADDRESS;
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  flashImageEnd = 0;
+#endif
 } /*** end of FlashInit ***/
 
 
@@ -256,6 +274,14 @@ blt_bool FlashWrite(blt_addr addr, blt_int32u len, blt_int8u *data)
     return BLT_FALSE;       
   }
 
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  /* keep track of where the image ends */
+  if ((addr + len) > flashImageEnd)
+  {
+    flashImageEnd = addr + len;
+  }
+#endif
+
   /* if this is the bootblock, then let the boot block manager handle it */
   base_addr = (addr/FLASH_WRITE_BLOCK_SIZE)*FLASH_WRITE_BLOCK_SIZE;
   if (base_addr == flashLayout[0].sector_start)
@@ -307,6 +333,9 @@ blt_bool FlashErase(blt_addr addr, blt_int32u len)
 blt_bool FlashWriteChecksum(void)
 {
   blt_int32u signature_checksum = 0;
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  blt_int32u image_crc[2];
+#endif
   
   /* for the STM32 target we defined the checksum as the Two's complement value of the
    * sum of the first 7 exception addresses.
@@ -351,8 +380,28 @@ blt_bool FlashWriteChecksum(void)
   signature_checksum += 1; /* two's complement */
 
   /* write the checksum */
-  return FlashWrite(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CS_OFFSET, 
-                    sizeof(blt_addr), (blt_int8u*)&signature_checksum);
+  if (FlashWrite(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CS_OFFSET, 
+                 sizeof(blt_addr), (blt_int8u*)&signature_checksum) == BLT_FALSE)
+  {
+    return BLT_FALSE;
+  }
+
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  /* the image length and its CRC-32 follow the checksum. two more dummy entries must be
+   * added at the end of the user program's vector table to reserve storage space for
+   * them. the image includes at least the complete vector table.
+   */
+  if (flashImageEnd < (flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET+8))
+  {
+    flashImageEnd = flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET+8;
+  }
+  image_crc[0] = flashImageEnd - flashLayout[0].sector_start;
+  image_crc[1] = FlashCalculateImageCrc32(image_crc[0]);
+  return FlashWrite(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET,
+                    sizeof(image_crc), (blt_int8u*)image_crc);
+#else
+  return BLT_TRUE;
+#endif
 } /*** end of FlashWriteChecksum ***/
 
 
@@ -365,6 +414,9 @@ blt_bool FlashWriteChecksum(void)
 blt_bool FlashVerifyChecksum(void)
 {
   blt_int32u signature_checksum = 0;
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  blt_int32u image_len;
+#endif
   
   /* verify the checksum based on how it was written by CpuWriteChecksum() */
   signature_checksum += *((blt_int32u*)(flashLayout[0].sector_start));
@@ -376,13 +428,32 @@ blt_bool FlashVerifyChecksum(void)
   signature_checksum += *((blt_int32u*)(flashLayout[0].sector_start+0x18));
   signature_checksum += *((blt_int32u*)(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CS_OFFSET));
   /* sum should add up to an unsigned 32-bit value of 0 */
-  if (signature_checksum == 0)
+  if (signature_checksum != 0)
   {
-    /* checksum okay */
-    return BLT_TRUE;
+    /* checksum incorrect */
+    return BLT_FALSE;
   }
-  /* checksum incorrect */
-  return BLT_FALSE;
+
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  /* verify the CRC-32 of the image as it was written by FlashWriteChecksum() */
+  image_len = *((blt_int32u*)(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET));
+  if ( (image_len < (FLASH_VECTOR_TABLE_CRC_OFFSET+8)) ||
+       (image_len > (flashLayout[FLASH_TOTAL_SECTORS-1].sector_start +
+                     flashLayout[FLASH_TOTAL_SECTORS-1].sector_size -
+                     flashLayout[0].sector_start)) )
+  {
+    /* length is not plausible, so the image is incomplete */
+    return BLT_FALSE;
+  }
+  if (FlashCalculateImageCrc32(image_len) !=
+      *((blt_int32u*)(flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET+4)))
+  {
+    /* image was corrupted */
+    return BLT_FALSE;
+  }
+#endif
+  /* checksum okay */
+  return BLT_TRUE;
 } /*** end of FlashVerifyChecksum ***/
 
 
@@ -411,6 +482,10 @@ blt_bool FlashDone(void)
       return BLT_FALSE;
     }
   }
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+  /* the next programming session starts a new image */
+  flashImageEnd = 0;
+#endif
   /* still here so all is okay */  
   return BLT_TRUE;
 } /*** end of FlashDone ***/
@@ -428,6 +503,21 @@ blt_addr FlashGetUserProgBaseAddress(void)
 } /*** end of FlashGetUserProgBaseAddress ***/
 
 
+/************************************************************************************//**
+** \brief     Calculates the CRC-32 of a memory region. Data that is still waiting in a
+**            block buffer to be programmed is taken from there, so the result matches
+**            the flash contents after FlashDone().
+** \param     addr Start address.
+** \param     len  Length in bytes.
+** \return    The CRC-32 of the region.
+**
+****************************************************************************************/
+blt_int32u FlashCalculateCrc32(blt_addr addr, blt_int32u len)
+{
+  return FlashUpdateCrc32(0, addr, len);
+} /*** end of FlashCalculateCrc32 ***/
+
+
 /************************************************************************************//**
 ** \brief     Copies data currently in flash to the block->data and sets the 
 **            base address.
@@ -824,4 +914,67 @@ static blt_addr FlashGetSectorSize(blt_int8u sector)
 } /*** end of FlashGetSectorSize ***/
 
 
+/************************************************************************************//**
+** \brief     Continues a CRC-32 calculation over a memory region, block by block so
+**            that buffered blocks can be taken into account.
+** \param     crc  CRC-32 of the preceding data, 0 if there is none.
+** \param     addr Start address.
+** \param     len  Length in bytes.
+** \return    The CRC-32 including the region.
+**
+****************************************************************************************/
+static blt_int32u FlashUpdateCrc32(blt_int32u crc, blt_addr addr, blt_int32u len)
+{
+  blt_addr   base_addr;
+  blt_int32u chunk;
+  blt_int8u  *data;
+
+  while (len > 0)
+  {
+    base_addr = (addr/FLASH_WRITE_BLOCK_SIZE)*FLASH_WRITE_BLOCK_SIZE;
+    chunk = FLASH_WRITE_BLOCK_SIZE - (addr - base_addr);
+    if (chunk > len)
+    {
+      chunk = len;
+    }
+    if (base_addr == bootBlockInfo.base_addr)
+    {
+      data = &bootBlockInfo.data[addr - base_addr];
+    }
+    else if (base_addr == blockInfo.base_addr)
+    {
+      data = &blockInfo.data[addr - base_addr];
+    }
+    else
+    {
+      data = (blt_int8u*)addr;
+    }
+    crc = CrcCalculate32(crc, data, chunk);
+    addr += chunk;
+    len -= chunk;
+  }
+  return crc;
+} /*** end of FlashUpdateCrc32 ***/
+
+
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Calculates the CRC-32 of the user program image. The image length and
+**            CRC-32 entries in the vector table are left out, because they are written
+**            after the calculation.
+** \param     len Length of the image in bytes.
+** \return    The CRC-32 of the image.
+**
+****************************************************************************************/
+static blt_int32u FlashCalculateImageCrc32(blt_int32u len)
+{
+  blt_int32u crc;
+
+  crc = FlashUpdateCrc32(0, flashLayout[0].sector_start, FLASH_VECTOR_TABLE_CRC_OFFSET);
+  return FlashUpdateCrc32(crc, flashLayout[0].sector_start+FLASH_VECTOR_TABLE_CRC_OFFSET+8,
+                          len - (FLASH_VECTOR_TABLE_CRC_OFFSET+8));
+} /*** end of FlashCalculateImageCrc32 ***/
+#endif
+
+
 /*********************************** end of flash.c ************************************/
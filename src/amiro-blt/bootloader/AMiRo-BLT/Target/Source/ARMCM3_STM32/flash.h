@@ -41,6 +41,7 @@ blt_bool FlashWrite(blt_addr addr, blt_int32u len, blt_int8u *data);
 blt_bool FlashErase(blt_addr addr, blt_int32u len);
 blt_bool FlashWriteChecksum(void);
 blt_bool FlashVerifyChecksum(void);
+blt_int32u FlashCalculateCrc32(blt_addr addr, blt_int32u len);
 blt_bool FlashDone(void);
 blt_addr FlashGetUserProgBaseAddress(void);
 
@@ -46,6 +46,7 @@ void     NvmInit(void);
 blt_bool NvmWrite(blt_addr addr, blt_int32u len, blt_int8u *data);
 blt_bool NvmErase(blt_addr addr, blt_int32u len);
 blt_bool NvmVerifyChecksum(void);
+blt_int32u NvmCalculateCrc32(blt_addr addr, blt_int32u len);
 blt_bool NvmDone(void);
 
 
@@ -174,6 +174,21 @@ blt_bool NvmVerifyChecksum(void)
 } /*** end of NvmVerifyChecksum ***/
 
 
+/************************************************************************************//**
+** \brief     Calculates the CRC-32 of a memory region. Data that was written but is
+**            still buffered by the flash driver is taken into account, so the result
+**            matches the programmed data before NvmDone() is called.
+** \param     addr Start address.
+** \param     len  Length in bytes.
+** \return    The CRC-32 of the region.
+**
+****************************************************************************************/
+blt_int32u NvmCalculateCrc32(blt_addr addr, blt_int32u len)
+{
+  return FlashCalculateCrc32(addr, len);
+} /*** end of NvmCalculateCrc32 ***/
+
+
 /************************************************************************************//**
 ** \brief     Once all erase and programming operations are completed, this 
 **            function is called, so at the end of the programming session and 
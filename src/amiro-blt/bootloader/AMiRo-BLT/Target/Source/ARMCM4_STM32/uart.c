@@ -64,12 +64,112 @@
 #define USART_CHANNEL   USART6
 #endif
 
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/* USART1 and USART6 are clocked by APB2, the others by APB1 */
+#if (BOOT_COM_UART_CHANNEL_INDEX == 0) || (BOOT_COM_UART_CHANNEL_INDEX == 5)
+/** \brief Peripheral clock of the configured USART. */
+#define USART_CHANNEL_PCLK(clocks)       ((clocks).PCLK2_Frequency)
+#else
+/** \brief Peripheral clock of the configured USART. */
+#define USART_CHANNEL_PCLK(clocks)       ((clocks).PCLK1_Frequency)
+#endif
+/** \brief Maximum deviation of the generated from the requested speed in 1/1000. Both
+ *         ends together must stay well below the 3.75% an 8-n-1 character tolerates.
+ */
+#define UART_BAUDRATE_TOLERANCE_PERMILLE (20)
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+/** \brief Size of the reception ring buffer. The host sends at most one packet before
+ *         it waits for the response, so this only has to hold a packet and its length.
+ */
+#define UART_RX_RING_SIZE    (512)
+/* map the configured UART channel index to the DMA stream that serves its receiver */
+#if (BOOT_COM_UART_CHANNEL_INDEX == 0)
+/** \brief DMA stream of the USART1 receiver. */
+#define UART_RX_DMA_STREAM   DMA2_Stream2
+/** \brief DMA channel of the USART1 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_4
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA2
+#elif (BOOT_COM_UART_CHANNEL_INDEX == 1)
+/** \brief DMA stream of the USART2 receiver. */
+#define UART_RX_DMA_STREAM   DMA1_Stream5
+/** \brief DMA channel of the USART2 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_4
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA1
+#elif (BOOT_COM_UART_CHANNEL_INDEX == 2)
+/** \brief DMA stream of the USART3 receiver. */
+#define UART_RX_DMA_STREAM   DMA1_Stream1
+/** \brief DMA channel of the USART3 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_4
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA1
+#elif (BOOT_COM_UART_CHANNEL_INDEX == 3)
+/** \brief DMA stream of the UART4 receiver. */
+#define UART_RX_DMA_STREAM   DMA1_Stream2
+/** \brief DMA channel of the UART4 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_4
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA1
+#elif (BOOT_COM_UART_CHANNEL_INDEX == 4)
+/** \brief DMA stream of the UART5 receiver. */
+#define UART_RX_DMA_STREAM   DMA1_Stream0
+/** \brief DMA channel of the UART5 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_4
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA1
+#elif (BOOT_COM_UART_CHANNEL_INDEX == 5)
+/** \brief DMA stream of the USART6 receiver. */
+#define UART_RX_DMA_STREAM   DMA2_Stream1
+/** \brief DMA channel of the USART6 receiver. */
+#define UART_RX_DMA_CHANNEL  DMA_Channel_5
+/** \brief Clock of the DMA controller. */
+#define UART_RX_DMA_CLOCK    RCC_AHB1Periph_DMA2
+#endif
+#endif /* BOOT_COM_UART_RX_DMA_ENABLE > 0 */
+
 
 /****************************************************************************************
 * Function prototypes
 ****************************************************************************************/
+static void     UartConfigure(blt_int32u baudrate);
 static blt_bool UartReceiveByte(blt_int8u *data);
 static blt_bool UartTransmitByte(blt_int8u data);
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+static void     UartSwitchBaudrate(blt_int32u baudrate);
+static void     UartCheckBaudrate(void);
+#endif
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+static void     UartStartRxDma(void);
+static blt_int16u UartGetRxDmaHead(void);
+#endif
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Set while the bytes of a packet are being received. */
+static blt_bool   uartRxInProgress = BLT_FALSE;
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/** \brief Speed the UART currently runs at. */
+static blt_int32u uartBaudrate;
+/** \brief Speed to switch to after the current response, or 0. */
+static blt_int32u uartBaudratePending;
+/** \brief Set once a valid packet was received at the current speed. */
+static blt_bool   uartBaudrateConfirmed;
+/** \brief Time of the last packet that was received or transmitted. */
+static blt_int32u uartActivityTime;
+/** \brief Framing and noise errors since the last valid packet. */
+static blt_int8u  uartRxErrors;
+#endif
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+/** \brief Ring buffer that the DMA stores the received bytes in. */
+static blt_int8u  uartRxRing[UART_RX_RING_SIZE];
+/** \brief Index of the next byte in the ring buffer that was not yet read. */
+static blt_int16u uartRxRingTail;
+#endif
 
 
 /************************************************************************************//**
@@ -79,8 +179,6 @@ static blt_bool UartTransmitByte(blt_int8u data);
 ****************************************************************************************/
 void UartInit(void)
 {
-  USART_InitTypeDef USART_InitStructure;
-
   /* the current implementation supports USART1 - USART6. throw an assertion error in 
    * case a different UART channel is configured.  
    */
@@ -91,18 +189,75 @@ void UartInit(void)
             (BOOT_COM_UART_CHANNEL_INDEX == 4) ||
             (BOOT_COM_UART_CHANNEL_INDEX == 5)); 
   /* initialize the uart for the specified communication speed */
-  USART_InitStructure.USART_BaudRate = BOOT_COM_UART_BAUDRATE;
-  USART_InitStructure.USART_WordLength = USART_WordLength_8b;
-  USART_InitStructure.USART_StopBits = USART_StopBits_1;
-  USART_InitStructure.USART_Parity = USART_Parity_No;
-  USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
-  USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
-  USART_Init(USART_CHANNEL, &USART_InitStructure);
-  /* enable UART */
-  USART_Cmd(USART_CHANNEL, ENABLE);
+  UartConfigure(BOOT_COM_UART_BAUDRATE);
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+  UartStartRxDma();
+#endif
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+  uartBaudrate = BOOT_COM_UART_BAUDRATE;
+  uartBaudratePending = 0;
+  uartBaudrateConfirmed = BLT_TRUE;
+  uartRxErrors = 0;
+#endif
 } /*** end of UartInit ***/
 
 
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Stops the reception DMA, so that it does not write into the memory of
+**            the user program.
+** \return    none.
+**
+****************************************************************************************/
+void UartFree(void)
+{
+  USART_DMACmd(USART_CHANNEL, USART_DMAReq_Rx, DISABLE);
+  DMA_Cmd(UART_RX_DMA_STREAM, DISABLE);
+} /*** end of UartFree ***/
+#endif /* BOOT_COM_UART_RX_DMA_ENABLE > 0 */
+
+
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Requests the UART to continue at another speed. The switch takes place
+**            after the next transmitted packet, which is the response to the request.
+**            If no valid packet is received at the new speed within
+**            BOOT_COM_UART_BAUDRATE_CONFIRM_MS, the UART returns to the default speed.
+** \param     baudrate The new communication speed in bits/sec.
+** \return    BLT_TRUE if the speed can be generated, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+blt_bool UartSetBaudrate(blt_int32u baudrate)
+{
+  RCC_ClocksTypeDef clocks;
+  blt_int32u divider;
+  blt_int32u deviation;
+
+  if ((baudrate < BOOT_COM_UART_BAUDRATE) || (baudrate > BOOT_COM_UART_BAUDRATE_MAX))
+  {
+    return BLT_FALSE;
+  }
+  /* with 16 times oversampling the divider has 4 fractional bits, so the USART runs at
+   * the peripheral clock divided by an integer of at least 16.
+   */
+  RCC_GetClocksFreq(&clocks);
+  divider = (USART_CHANNEL_PCLK(clocks) + (baudrate / 2)) / baudrate;
+  if (divider < 16)
+  {
+    return BLT_FALSE;
+  }
+  deviation = USART_CHANNEL_PCLK(clocks) / divider;
+  deviation = (deviation > baudrate) ? (deviation - baudrate) : (baudrate - deviation);
+  if (deviation > (baudrate / 1000) * UART_BAUDRATE_TOLERANCE_PERMILLE)
+  {
+    return BLT_FALSE;
+  }
+  uartBaudratePending = baudrate;
+  return BLT_TRUE;
+} /*** end of UartSetBaudrate ***/
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+
 /************************************************************************************//**
 ** \brief     Transmits a packet formatted for the communication interface.
 ** \param     data Pointer to byte array with data that it to be transmitted.
@@ -131,6 +286,15 @@ void UartTransmitPacket(blt_int8u *data, blt_int8u len)
     result = UartTransmitByte(data[data_index]);
     ASSERT_RT(result == BLT_TRUE);  
   }
+
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+  uartActivityTime = TimerGet();
+  /* a requested speed switch takes place once its response was transmitted */
+  if (uartBaudratePending != 0)
+  {
+    UartSwitchBaudrate(uartBaudratePending);
+  }
+#endif
 } /*** end of UartTransmitPacket ***/
 
 
@@ -145,10 +309,14 @@ blt_int8u UartReceivePacket(blt_int8u *data)
   static blt_int8u xcpCtoReqPacket[BOOT_COM_UART_RX_MAX_DATA+1];  /* one extra for length */
   static blt_int8u xcpCtoRxLength;
   static blt_int8u xcpUartDataLength;
-  static blt_bool  xcpCtoRxInProgress = BLT_FALSE;
+
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+  /* return to the default speed if the host lost track of the current one */
+  UartCheckBaudrate();
+#endif
 
   /* start of cto packet received? */
-  if (xcpCtoRxInProgress == BLT_FALSE)
+  if (uartRxInProgress == BLT_FALSE)
   {
     /* store the message length when received */
     if (UartReceiveByte(&xcpCtoReqPacket[0]) == BLT_TRUE)
@@ -158,16 +326,18 @@ blt_int8u UartReceivePacket(blt_int8u *data)
       if (xcpCtoReqPacket[0] > 0)
       {
         /* indicate that a cto packet is being received */
-        xcpCtoRxInProgress = BLT_TRUE;
+        uartRxInProgress = BLT_TRUE;
         /* reset packet data count */
         xcpCtoRxLength = 0;
       }
     }
   }
-  else
+  if (uartRxInProgress == BLT_TRUE)
   {
-    /* store the next packet byte */
-    if (UartReceiveByte(&xcpCtoReqPacket[xcpCtoRxLength+1]) == BLT_TRUE)
+    /* store the packet bytes that are already available, which is more than one when
+     * they arrived while the bootloader was busy
+     */
+    while (UartReceiveByte(&xcpCtoReqPacket[xcpCtoRxLength+1]) == BLT_TRUE)
     {
       /* increment the packet data count */
       xcpCtoRxLength++;
@@ -178,7 +348,13 @@ blt_int8u UartReceivePacket(blt_int8u *data)
         /* copy the packet data */
         CpuMemCopy((blt_int32u)data, (blt_int32u)&xcpCtoReqPacket[1], xcpCtoRxLength);        
         /* done with cto packet reception */
-        xcpCtoRxInProgress = BLT_FALSE;
+        uartRxInProgress = BLT_FALSE;
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+        /* the host talks at the current speed */
+        uartActivityTime = TimerGet();
+        uartBaudrateConfirmed = BLT_TRUE;
+        uartRxErrors = 0;
+#endif
 
         /* packet reception complete */
         return xcpUartDataLength;
@@ -198,14 +374,50 @@ blt_int8u UartReceivePacket(blt_int8u *data)
 ****************************************************************************************/
 static blt_bool UartReceiveByte(blt_int8u *data)
 {
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+  /* check the ring buffer to see if a byte was received */
+  if (UartGetRxDmaHead() != uartRxRingTail)
+  {
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+    /* count damaged characters. the flags are cleared once the DMA reads the data
+     * register after this status register read
+     */
+    if ((USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_FE) == SET) ||
+        (USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_NE) == SET))
+    {
+      if (uartRxErrors < 0xff)
+      {
+        uartRxErrors++;
+      }
+    }
+#endif
+    /* retrieve and store the newly received byte */
+    *data = uartRxRing[uartRxRingTail];
+    uartRxRingTail = (uartRxRingTail + 1) % UART_RX_RING_SIZE;
+    /* all done */
+    return BLT_TRUE;
+  }
+#else
   /* check flag to see if a byte was received */
   if (USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_RXNE) == SET)
   {
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+    /* count damaged characters. reading the data register clears the flags */
+    if ((USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_FE) == SET) ||
+        (USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_NE) == SET))
+    {
+      if (uartRxErrors < 0xff)
+      {
+        uartRxErrors++;
+      }
+    }
+#endif
     /* retrieve and store the newly received byte */
     *data = (unsigned char)USART_ReceiveData(USART_CHANNEL);
     /* all done */
     return BLT_TRUE;
   }
+#endif /* BOOT_COM_UART_RX_DMA_ENABLE > 0 */
   /* still here to no new byte received */
   return BLT_FALSE;
 } /*** end of UartReceiveByte ***/
@@ -235,6 +447,134 @@ static blt_bool UartTransmitByte(blt_int8u data)
   /* byte transmitted */
   return BLT_TRUE;
 } /*** end of UartTransmitByte ***/
+
+
+/************************************************************************************//**
+** \brief     Configures the UART for 8-n-1 at the specified speed and enables it.
+** \param     baudrate Communication speed in bits/sec.
+** \return    none.
+**
+****************************************************************************************/
+static void UartConfigure(blt_int32u baudrate)
+{
+  USART_InitTypeDef USART_InitStructure;
+
+  USART_Cmd(USART_CHANNEL, DISABLE);
+  USART_InitStructure.USART_BaudRate = baudrate;
+  USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+  USART_InitStructure.USART_StopBits = USART_StopBits_1;
+  USART_InitStructure.USART_Parity = USART_Parity_No;
+  USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+  USART_InitStructure.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
+  USART_Init(USART_CHANNEL, &USART_InitStructure);
+  /* enable UART */
+  USART_Cmd(USART_CHANNEL, ENABLE);
+} /*** end of UartConfigure ***/
+
+
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Switches the UART to another speed once the last character was sent.
+** \param     baudrate The new communication speed in bits/sec.
+** \return    none.
+**
+****************************************************************************************/
+static void UartSwitchBaudrate(blt_int32u baudrate)
+{
+  /* TXE is already set while the last character is still being shifted out */
+  while (USART_GetFlagStatus(USART_CHANNEL, USART_FLAG_TC) == RESET)
+  {
+    CopService();
+  }
+  UartConfigure(baudrate);
+  uartBaudrate = baudrate;
+  uartBaudratePending = 0;
+  uartBaudrateConfirmed = (baudrate == BOOT_COM_UART_BAUDRATE) ? BLT_TRUE : BLT_FALSE;
+  uartRxErrors = 0;
+  uartActivityTime = TimerGet();
+  /* a partially received packet was sent at the old speed */
+  uartRxInProgress = BLT_FALSE;
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+  uartRxRingTail = UartGetRxDmaHead();
+#endif
+} /*** end of UartSwitchBaudrate ***/
+
+
+/************************************************************************************//**
+** \brief     Returns to the default speed when the host did not confirm the new speed
+**            in time, when it only sends damaged characters or when it remained silent
+**            for longer than any command takes. The host falls back to the default
+**            speed on errors and can then connect again.
+** \return    none.
+**
+****************************************************************************************/
+static void UartCheckBaudrate(void)
+{
+  blt_int32u timeout;
+
+  if (uartBaudrate == BOOT_COM_UART_BAUDRATE)
+  {
+    return;
+  }
+  timeout = (uartBaudrateConfirmed == BLT_TRUE) ? BOOT_COM_UART_BAUDRATE_IDLE_MS :
+                                                  BOOT_COM_UART_BAUDRATE_CONFIRM_MS;
+  if (((TimerGet() - uartActivityTime) > timeout) ||
+      (uartRxErrors >= BOOT_COM_UART_BAUDRATE_MAX_ERRORS))
+  {
+    UartSwitchBaudrate(BOOT_COM_UART_BAUDRATE);
+  }
+} /*** end of UartCheckBaudrate ***/
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Lets a DMA stream store the received bytes in a ring buffer, so that no
+**            byte gets lost while the bootloader is busy, e.g. while the gateway
+**            forwards a packet. No interrupt is needed, the buffer is polled.
+** \return    none.
+**
+****************************************************************************************/
+static void UartStartRxDma(void)
+{
+  DMA_InitTypeDef DMA_InitStructure;
+
+  RCC_AHB1PeriphClockCmd(UART_RX_DMA_CLOCK, ENABLE);
+  DMA_DeInit(UART_RX_DMA_STREAM);
+  DMA_InitStructure.DMA_Channel = UART_RX_DMA_CHANNEL;
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (blt_int32u)&USART_CHANNEL->DR;
+  DMA_InitStructure.DMA_Memory0BaseAddr = (blt_int32u)uartRxRing;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+  DMA_InitStructure.DMA_BufferSize = UART_RX_RING_SIZE;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+  DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+  DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+  DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+  DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+  DMA_Init(UART_RX_DMA_STREAM, &DMA_InitStructure);
+  DMA_Cmd(UART_RX_DMA_STREAM, ENABLE);
+  USART_DMACmd(USART_CHANNEL, USART_DMAReq_Rx, ENABLE);
+  uartRxRingTail = 0;
+} /*** end of UartStartRxDma ***/
+
+
+/************************************************************************************//**
+** \brief     Obtains the position in the ring buffer the DMA stores the next byte at.
+** \return    Index into the ring buffer.
+**
+****************************************************************************************/
+static blt_int16u UartGetRxDmaHead(void)
+{
+  /* the counter runs down from the buffer size and is reloaded when it reaches 0 */
+  return (blt_int16u)((UART_RX_RING_SIZE - DMA_GetCurrDataCounter(UART_RX_DMA_STREAM)) %
+                      UART_RX_RING_SIZE);
+} /*** end of UartGetRxDmaHead ***/
+#endif /* BOOT_COM_UART_RX_DMA_ENABLE > 0 */
 #endif /* BOOT_COM_UART_ENABLE > 0 || BOOT_GATE_UART_ENABLE > 0 */
 
 
@@ -38,6 +38,12 @@
 * Function prototypes
 ****************************************************************************************/
 void      UartInit(void);
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+void      UartFree(void);
+#endif
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+blt_bool  UartSetBaudrate(blt_int32u baudrate);
+#endif
 void      UartTransmitPacket(blt_int8u *data, blt_int8u len);
 blt_int8u UartReceivePacket(blt_int8u *data);
 #endif /* BOOT_COM_UART_ENABLE > 0 || BOOT_GATE_UART_ENABLE > 0 */
@@ -70,6 +70,8 @@
 #include "com.h"                                      /* communication interface       */
 #include "gateway.h"                                  /* gateway interface             */
 #include "xcp.h"                                      /* xcp communication layer       */
+#include "lz.h"                                       /* lz decompression module       */
+#include "crc.h"                                      /* crc calculation module        */
 
 
 /****************************************************************************************
@@ -225,6 +225,10 @@ void ComTask(void)
 ****************************************************************************************/
 void ComFree(void)
 {
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0)
+  /* stop the reception DMA of the uart */
+  UartFree();
+#endif
 #if (BOOT_COM_USB_ENABLE > 0)
   /* disconnect the usb device from the usb host */
   UsbFree();
@@ -373,6 +377,25 @@ blt_int16u ComGetActiveInterfaceMaxTxLen(void)
 } /*** end of ComGetActiveInterfaceMaxTxLen ***/
 
 
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Requests the active communication interface to continue at another speed.
+**            Only the UART supports this.
+** \param     baudrate The new communication speed in bits/sec.
+** \return    BLT_TRUE if the switch was accepted, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+blt_bool ComSetBaudrate(blt_int32u baudrate)
+{
+  if (comActiveInterface != COM_IF_UART)
+  {
+    return BLT_FALSE;
+  }
+  return UartSetBaudrate(baudrate);
+} /*** end of ComSetBaudrate ***/
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+
 /************************************************************************************//**
 ** \brief     This function obtains the XCP connection state.
 ** \return    BLT_TRUE when an XCP connection is established, BLT_FALSE otherwise.
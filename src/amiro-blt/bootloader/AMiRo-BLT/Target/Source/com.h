@@ -135,6 +135,9 @@ blt_int16u      ComGetActiveInterfaceMaxRxLen(void);
 blt_int16u      ComGetActiveInterfaceMaxTxLen(void);
 void            ComTransmitPacket(blt_int8u *data, blt_int16u len);
 blt_bool        ComIsConnected(void);
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+blt_bool        ComSetBaudrate(blt_int32u baudrate);
+#endif
 #if (BOOTLOADER_OF_MAIN_DEVICE > 0)
 blt_bool        ComWasConnectedToMain(void);
 void            ComTransmitPacketDirect(blt_int8u *data, blt_int8u len);
@@ -50,13 +50,50 @@
 
 
 #if (BOOT_GATE_ENABLE > 0)
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief A packet that waits in the gateway until it is forwarded. */
+typedef struct
+{
+  blt_int8u  data[BOOT_COM_RX_MAX_DATA];         /**< packet data                      */
+  blt_int8u  len;                                /**< number of packet bytes           */
+} tGateStoredPacket;
+
+/** \brief Packets that were acknowledged to the host, but not yet to the device. */
+typedef struct
+{
+  tGateStoredPacket packets[BOOT_GATE_STORE_FORWARD_PACKETS];
+  blt_int8u  head;                               /**< next free entry                  */
+  blt_int8u  tail;                               /**< next entry to forward            */
+  blt_int8u  count;                              /**< number of waiting packets        */
+  blt_int32u deviceID;                           /**< device the packets are meant for */
+  blt_bool   inFlight;                           /**< waiting for the device response  */
+  blt_int32u sendTime;                           /**< time the last packet was sent    */
+} tGateStoreInfo;
+#endif /* BOOT_GATE_STORE_FORWARD_ENABLE > 0 */
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+#if (BOOT_DEBUGGING_UART2_ENABLE > 0)
+static void InitDebugData(void);
+#endif
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+static blt_bool GateStoreTask(void);
+#endif
+
+
 /****************************************************************************************
 * Local data declarations
 ****************************************************************************************/
 /** \brief Holds the gateway interface of the currently active interface. */
 static tGateInterfaceId gateActiveInterface = GATE_IF_OTHER;
-#if (BOOT_DEBUGGING_UART2_ENABLE > 0)
-static void InitDebugData(void);
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+/** \brief Local variable for the store-and-forward window. */
+static tGateStoreInfo gateStore;
 #endif
 
 blt_bool forwarded;
@@ -70,6 +107,12 @@ blt_bool forwarded;
 void GateInit(void)
 {
   forwarded = BLT_FALSE;
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  gateStore.head = 0;
+  gateStore.tail = 0;
+  gateStore.count = 0;
+  gateStore.inFlight = BLT_FALSE;
+#endif
 #if (BOOT_DEBUGGING_UART2_ENABLE > 0)
   InitDebugData();
 #endif
@@ -147,7 +190,17 @@ void GateTask(void)
   static unsigned char xcpCtoReqPacket[BOOT_COM_RX_MAX_DATA];
 
 #if (BOOT_GATE_CAN_ENABLE > 0)
-  messageLength = (blt_int16s)CanReceivePacket(&xcpCtoReqPacket[0]);
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  /* the responses to stored packets are not passed on to the host */
+  if (GateStoreTask() == BLT_TRUE)
+  {
+    messageLength = 0;
+  }
+  else
+#endif
+  {
+    messageLength = (blt_int16s)CanReceivePacket(&xcpCtoReqPacket[0]);
+  }
   if (messageLength > 0)
   {
     /* make this the active interface */
@@ -364,6 +417,103 @@ void GateTransmitPacketDirect(blt_int8u *data, blt_int8u len, blt_int32u deviceI
   XcpPacketTransmitted();
 } /*** end of GateTransmitPacketDirect ***/
 
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Stores a packet that the host already got the response for. GateTask()
+**            forwards it once the device responded to the previous one, while the
+**            host sends the next packet. Blocks while the window is full.
+** \param     data     Pointer to the byte buffer with packet data.
+** \param     len      Number of data bytes.
+** \param     deviceID ID of the device the packet has to be sent to.
+** \return    none.
+**
+****************************************************************************************/
+void GateStorePacket(blt_int8u *data, blt_int8u len, blt_int32u deviceID) {
+  /* make room by forwarding the oldest packet */
+  while (gateStore.count == BOOT_GATE_STORE_FORWARD_PACKETS) {
+    GateStoreTask();
+    CopService();
+  }
+  CpuMemCopy((blt_int32u)gateStore.packets[gateStore.head].data, (blt_int32u)data, len);
+  gateStore.packets[gateStore.head].len = len;
+  gateStore.head = (gateStore.head + 1) % BOOT_GATE_STORE_FORWARD_PACKETS;
+  gateStore.count++;
+  gateStore.deviceID = deviceID;
+} /*** end of GateStorePacket ***/
+
+
+/************************************************************************************//**
+** \brief     Forwards all stored packets and waits for the device to respond to the
+**            last one. Called before a command that depends on their effect.
+** \return    none.
+**
+****************************************************************************************/
+void GateStoreFlush(void) {
+  while (GateStoreTask() == BLT_TRUE) {
+    CopService();
+  }
+} /*** end of GateStoreFlush ***/
+
+
+/************************************************************************************//**
+** \brief     Drops the stored packets, e.g. when the host starts over with a new
+**            connection. A packet that was already sent is still waited for, so that
+**            its response is not taken for the response to the next command.
+** \return    none.
+**
+****************************************************************************************/
+void GateStoreDiscard(void) {
+  gateStore.count = 0;
+  gateStore.tail = gateStore.head;
+  GateStoreFlush();
+} /*** end of GateStoreDiscard ***/
+
+
+/************************************************************************************//**
+** \brief     Forwards the next stored packet once the response to the previous one
+**            arrived. The responses go to XcpGatewayStoredPacketResponse(), which
+**            decides whether the remaining packets are still forwarded.
+** \return    BLT_TRUE while stored packets are pending, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+static blt_bool GateStoreTask(void) {
+  static blt_int8u response[BOOT_COM_RX_MAX_DATA];
+  blt_int16s responseLength;
+  tGateStoredPacket *packet;
+
+  if (gateStore.inFlight == BLT_TRUE) {
+    responseLength = (blt_int16s)CanReceivePacket(&response[0]);
+    if (responseLength == 0) {
+      if ((TimerGet() - gateStore.sendTime) <= BOOT_GATE_STORE_FORWARD_TIMEOUT_MS) {
+        return BLT_TRUE;
+      }
+    }
+    gateStore.inFlight = BLT_FALSE;
+    forwarded = BLT_FALSE;
+    if (XcpGatewayStoredPacketResponse(&response[0], responseLength) == BLT_FALSE) {
+      /* the host learns about the error with its next command */
+      gateStore.count = 0;
+      gateStore.tail = gateStore.head;
+    }
+  }
+  if (gateStore.count == 0) {
+    return BLT_FALSE;
+  }
+  packet = &gateStore.packets[gateStore.tail];
+  gateStore.tail = (gateStore.tail + 1) % BOOT_GATE_STORE_FORWARD_PACKETS;
+  gateStore.count--;
+#if (BOOT_DEBUGGING_UART2_ENABLE > 0)
+  /* send debugging information */
+  BuildData(&debugDataTCan, packet->data, packet->len);
+#endif
+  forwarded = BLT_TRUE;
+  CanTransmitPacket(packet->data, packet->len, gateStore.deviceID);
+  gateStore.inFlight = BLT_TRUE;
+  gateStore.sendTime = TimerGet();
+  return BLT_TRUE;
+} /*** end of GateStoreTask ***/
+#endif /* BOOT_GATE_STORE_FORWARD_ENABLE > 0 */
+
 #if (BOOT_DEBUGGING_UART2_ENABLE > 0)
 /************************************************************************************//**
 ** \brief     This function transmitts debugging data with UART2.
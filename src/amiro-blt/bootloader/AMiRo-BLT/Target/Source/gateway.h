@@ -140,6 +140,11 @@ void            GateTransmitPacket(blt_int8u *data, blt_int16u len);
 #if (BOOT_GATE_CAN_ENABLE > 0)
 void            GateTransmitPacketDirect(blt_int8u *data, blt_int8u len, blt_int32u deviceID);
 #endif
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+void            GateStorePacket(blt_int8u *data, blt_int8u len, blt_int32u deviceID);
+void            GateStoreFlush(void);
+void            GateStoreDiscard(void);
+#endif
 blt_bool        GateIsConnected(void);
 #if (BOOT_DEBUGGING_UART2_ENABLE > 0)
 void            BuildData(blt_int8u *debugData, blt_int8u *data, blt_int8u len);
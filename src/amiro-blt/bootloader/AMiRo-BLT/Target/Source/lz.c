@@ -0,0 +1,269 @@
+/************************************************************************************//**
+* \file         Source\lz.c
+* \brief        Bootloader LZ decompression module source file.
+* \ingroup      Core
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2011  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+
+/****************************************************************************************
+* Include files
+****************************************************************************************/
+#include "boot.h"                                /* bootloader generic header          */
+
+
+#if (BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 0)
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/** \brief Bit in the first byte of a token that marks a match. */
+#define LZ_TOKEN_MATCH         (0x80)
+/** \brief Length field value of a match that is followed by an extra length byte. */
+#define LZ_MATCH_LEN_EXTENDED  (31)
+/** \brief Shortest match that is encoded. */
+#define LZ_MATCH_LEN_MIN       (3)
+
+
+/****************************************************************************************
+* Type definitions
+****************************************************************************************/
+/** \brief Position of the decoder inside a token. */
+typedef enum
+{
+  LZ_STATE_TOKEN,                                /**< expects the first byte of a token */
+  LZ_STATE_LITERAL,                              /**< copies literal bytes              */
+  LZ_STATE_OFFSET,                               /**< expects the low byte of an offset */
+  LZ_STATE_LENGTH                                /**< expects the extra length byte     */
+} tLzState;
+
+/** \brief Decoder state, kept between packets because tokens may be split. */
+typedef struct
+{
+  blt_int8u  window[LZ_WINDOW_SIZE];             /**< history and output buffer         */
+  blt_int16u head;                               /**< next write position in window     */
+  blt_int16u flushed;                            /**< first position not yet in NVM     */
+  blt_int32u produced;                           /**< bytes output since LzInit()       */
+  blt_addr   addr;                               /**< NVM address of window[flushed]    */
+  tLzState   state;                              /**< position inside the token         */
+  blt_int16u count;                              /**< remaining literal bytes           */
+  blt_int16u offset;                             /**< distance of the current match     */
+  blt_int8u  token;                              /**< first byte of the current match   */
+} tLzInfo;
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+static blt_bool LzOutput(blt_int8u data);
+static blt_bool LzCopyMatch(blt_int16u len);
+static blt_bool LzFlush(void);
+
+
+/****************************************************************************************
+* Local data declarations
+****************************************************************************************/
+/** \brief Local variable for storing the decoder state. */
+static tLzInfo lzInfo;
+
+
+/************************************************************************************//**
+** \brief     Starts a new compressed stream. The history of the previous stream is
+**            discarded, so the first match of the new stream cannot refer to it.
+** \param     addr NVM address where the decompressed data is written to.
+** \return    none
+**
+****************************************************************************************/
+void LzInit(blt_addr addr)
+{
+  lzInfo.head = 0;
+  lzInfo.flushed = 0;
+  lzInfo.produced = 0;
+  lzInfo.addr = addr;
+  lzInfo.state = LZ_STATE_TOKEN;
+} /*** end of LzInit ***/
+
+
+/************************************************************************************//**
+** \brief     Decompresses the next part of the stream and programs the result. All
+**            output of the part is passed on to NvmWrite() before the function returns,
+**            only the history stays in the window.
+** \param     data Pointer to the compressed data.
+** \param     len  Number of compressed bytes.
+** \param     addr Receives the NVM address that follows the last programmed byte.
+** \return    BLT_TRUE if successful, BLT_FALSE for a corrupt stream or an NVM error.
+**
+****************************************************************************************/
+blt_bool LzDecompress(blt_int8u *data, blt_int16u len, blt_addr *addr)
+{
+  blt_int16u idx;
+  blt_int8u  byte;
+  blt_bool   result = BLT_TRUE;
+
+  for (idx = 0; (idx < len) && (result == BLT_TRUE); idx++)
+  {
+    byte = data[idx];
+    switch (lzInfo.state)
+    {
+      case LZ_STATE_TOKEN:
+        if ((byte & LZ_TOKEN_MATCH) == 0)
+        {
+          lzInfo.count = (blt_int16u)(byte & 0x7f) + 1;
+          lzInfo.state = LZ_STATE_LITERAL;
+        }
+        else
+        {
+          lzInfo.token = byte;
+          lzInfo.state = LZ_STATE_OFFSET;
+        }
+        break;
+
+      case LZ_STATE_LITERAL:
+        result = LzOutput(byte);
+        lzInfo.count--;
+        if (lzInfo.count == 0)
+        {
+          lzInfo.state = LZ_STATE_TOKEN;
+        }
+        break;
+
+      case LZ_STATE_OFFSET:
+        lzInfo.offset = (blt_int16u)((((blt_int16u)lzInfo.token & 0x03) << 8) | byte) + 1;
+        if (((lzInfo.token >> 2) & 0x1f) == LZ_MATCH_LEN_EXTENDED)
+        {
+          lzInfo.state = LZ_STATE_LENGTH;
+        }
+        else
+        {
+          result = LzCopyMatch(((lzInfo.token >> 2) & 0x1f) + LZ_MATCH_LEN_MIN);
+          lzInfo.state = LZ_STATE_TOKEN;
+        }
+        break;
+
+      case LZ_STATE_LENGTH:
+        result = LzCopyMatch(LZ_MATCH_LEN_EXTENDED + LZ_MATCH_LEN_MIN + (blt_int16u)byte);
+        lzInfo.state = LZ_STATE_TOKEN;
+        break;
+
+      default:
+        result = BLT_FALSE;
+        break;
+    }
+  }
+
+  /* program what this part produced, so that the data is in NVM when the host gets
+   * the response.
+   */
+  if (result == BLT_TRUE)
+  {
+    result = LzFlush();
+  }
+  *addr = lzInfo.addr;
+  return result;
+} /*** end of LzDecompress ***/
+
+
+/************************************************************************************//**
+** \brief     Appends a decompressed byte to the window. The part of the window that
+**            is about to be overwritten is programmed first.
+** \param     data The decompressed byte.
+** \return    BLT_TRUE if successful, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+static blt_bool LzOutput(blt_int8u data)
+{
+  lzInfo.window[lzInfo.head] = data;
+  lzInfo.head++;
+  lzInfo.produced++;
+  if (lzInfo.head == LZ_WINDOW_SIZE)
+  {
+    if (LzFlush() == BLT_FALSE)
+    {
+      return BLT_FALSE;
+    }
+    lzInfo.head = 0;
+    lzInfo.flushed = 0;
+  }
+  return BLT_TRUE;
+} /*** end of LzOutput ***/
+
+
+/************************************************************************************//**
+** \brief     Repeats bytes from the history at the current match offset.
+** \param     len Number of bytes to repeat.
+** \return    BLT_TRUE if successful, BLT_FALSE if the match reaches before the start
+**            of the stream.
+**
+****************************************************************************************/
+static blt_bool LzCopyMatch(blt_int16u len)
+{
+  blt_int16u src;
+
+  if (lzInfo.offset > lzInfo.produced)
+  {
+    return BLT_FALSE;
+  }
+  src = (blt_int16u)((lzInfo.head + LZ_WINDOW_SIZE - lzInfo.offset) % LZ_WINDOW_SIZE);
+  while (len > 0)
+  {
+    /* byte by byte, because the match may overlap the bytes it produces */
+    if (LzOutput(lzInfo.window[src]) == BLT_FALSE)
+    {
+      return BLT_FALSE;
+    }
+    src = (src + 1) % LZ_WINDOW_SIZE;
+    len--;
+  }
+  return BLT_TRUE;
+} /*** end of LzCopyMatch ***/
+
+
+/************************************************************************************//**
+** \brief     Programs the decompressed bytes that were not yet passed on to NVM.
+** \return    BLT_TRUE if successful, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+static blt_bool LzFlush(void)
+{
+  blt_int16u len = lzInfo.head - lzInfo.flushed;
+
+  if (len == 0)
+  {
+    return BLT_TRUE;
+  }
+  if (NvmWrite(lzInfo.addr, len, &lzInfo.window[lzInfo.flushed]) == BLT_FALSE)
+  {
+    return BLT_FALSE;
+  }
+  lzInfo.addr += len;
+  lzInfo.flushed = lzInfo.head;
+  return BLT_TRUE;
+} /*** end of LzFlush ***/
+#endif /* BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 0 */
+
+
+/*********************************** end of lz.c ***************************************/
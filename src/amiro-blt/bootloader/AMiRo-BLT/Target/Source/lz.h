@@ -0,0 +1,62 @@
+/************************************************************************************//**
+* \file         Source\lz.h
+* \brief        Bootloader LZ decompression module header file.
+* \ingroup      Core
+* \internal
+*----------------------------------------------------------------------------------------
+*                          C O P Y R I G H T
+*----------------------------------------------------------------------------------------
+*   Copyright (c) 2011  by Feaser    http://www.feaser.com    All rights reserved
+*
+*----------------------------------------------------------------------------------------
+*                            L I C E N S E
+*----------------------------------------------------------------------------------------
+* This file is part of OpenBLT. OpenBLT is free software: you can redistribute it and/or
+* modify it under the terms of the GNU General Public License as published by the Free
+* Software Foundation, either version 3 of the License, or (at your option) any later
+* version.
+*
+* OpenBLT is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+* without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+* PURPOSE. See the GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License along with OpenBLT.
+* If not, see <http://www.gnu.org/licenses/>.
+*
+* A special exception to the GPL is included to allow you to distribute a combined work
+* that includes OpenBLT without being obliged to provide the source code for any
+* proprietary components. The exception text is included at the bottom of the license
+* file <license.html>.
+*
+* \endinternal
+****************************************************************************************/
+#ifndef LZ_H
+#define LZ_H
+
+#if (BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 0)
+/****************************************************************************************
+* Macro definitions
+****************************************************************************************/
+/* The compressed stream is a sequence of tokens. The first byte of a token selects its
+ * type:
+ *   0LLLLLLL                    literal run: the next L+1 bytes (1..128) are copied.
+ *   1LLLLLOO OOOOOOOO [E]       match: copies L+3 bytes (3..33) that were output
+ *                               O+1 bytes (1..1024) before. If L is 31, the extra byte
+ *                               E follows and the length is 34+E (34..289).
+ * Matches may overlap the bytes they produce, which encodes runs of a repeated pattern.
+ * A token may be split over several packets. SerialBoot's lz.c holds the compressor.
+ */
+/** \brief Size of the history window in bytes. Fixed by the 10-bit match offset. */
+#define LZ_WINDOW_SIZE         (1024)
+
+
+/****************************************************************************************
+* Function prototypes
+****************************************************************************************/
+void     LzInit(blt_addr addr);
+blt_bool LzDecompress(blt_int8u *data, blt_int16u len, blt_addr *addr);
+#endif /* BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 0 */
+
+
+#endif /* LZ_H */
+/*********************************** end of lz.h ***************************************/
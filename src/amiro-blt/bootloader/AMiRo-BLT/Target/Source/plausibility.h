@@ -274,6 +274,48 @@
   #endif
 #endif /* BOOT_COM_UART_ENABLE > 0 */
 
+#ifndef BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE
+#define BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE (0)
+#endif
+
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+  #if (BOOT_COM_UART_ENABLE == 0)
+  #error "BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE requires BOOT_COM_UART_ENABLE"
+  #endif
+
+  #ifndef BOOT_COM_UART_BAUDRATE_MAX
+  #error "BOOT_COM_UART_BAUDRATE_MAX is missing in blt_conf.h"
+  #endif
+
+  #if (BOOT_COM_UART_BAUDRATE_MAX < BOOT_COM_UART_BAUDRATE)
+  #error "BOOT_COM_UART_BAUDRATE_MAX must be >= BOOT_COM_UART_BAUDRATE"
+  #endif
+
+  #ifndef BOOT_COM_UART_BAUDRATE_CONFIRM_MS
+  #define BOOT_COM_UART_BAUDRATE_CONFIRM_MS   (500)
+  #endif
+
+  #ifndef BOOT_COM_UART_BAUDRATE_IDLE_MS
+  #define BOOT_COM_UART_BAUDRATE_IDLE_MS      (12000)
+  #endif
+
+  #ifndef BOOT_COM_UART_BAUDRATE_MAX_ERRORS
+  #define BOOT_COM_UART_BAUDRATE_MAX_ERRORS   (4)
+  #endif
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+#ifndef BOOT_COM_UART_RX_DMA_ENABLE
+#define BOOT_COM_UART_RX_DMA_ENABLE     (0)
+#endif
+
+#if (BOOT_COM_UART_RX_DMA_ENABLE < 0) || (BOOT_COM_UART_RX_DMA_ENABLE > 1)
+#error "BOOT_COM_UART_RX_DMA_ENABLE must be 0 or 1"
+#endif
+
+#if (BOOT_COM_UART_RX_DMA_ENABLE > 0) && (BOOT_COM_UART_ENABLE == 0)
+#error "BOOT_COM_UART_RX_DMA_ENABLE requires BOOT_COM_UART_ENABLE"
+#endif
+
 #ifndef BOOT_COM_USB_ENABLE
 #define BOOT_COM_USB_ENABLE             (0)
 #endif
@@ -503,6 +545,43 @@
 #if (BOOTLOADER_OF_MAIN_DEVICE == 1) && (BOOT_GATE_ENABLE == 0)
 #error "If BOOT_GATE_ENABLE=1 then one communication interface has to be configured as gateway!"
 #endif
+
+#ifndef BOOT_GATE_STORE_FORWARD_ENABLE
+#define BOOT_GATE_STORE_FORWARD_ENABLE  (0)
+#endif
+
+#if (BOOT_GATE_STORE_FORWARD_ENABLE < 0) || (BOOT_GATE_STORE_FORWARD_ENABLE > 1)
+#error "BOOT_GATE_STORE_FORWARD_ENABLE must be 0 or 1"
+#endif
+
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  #if (BOOT_GATE_CAN_ENABLE == 0)
+  #error "BOOT_GATE_STORE_FORWARD_ENABLE requires BOOT_GATE_CAN_ENABLE"
+  #endif
+
+  /* the host sends the next packet while the gateway forwards the previous one, which a
+   * polled UART would lose
+   */
+  #if (BOOT_COM_UART_ENABLE > 0) && (BOOT_COM_UART_RX_DMA_ENABLE == 0)
+  #error "BOOT_GATE_STORE_FORWARD_ENABLE requires BOOT_COM_UART_RX_DMA_ENABLE"
+  #endif
+
+  #if (BOOT_COM_BLUETOOTH_UART_ENABLE > 0)
+  #error "BOOT_GATE_STORE_FORWARD_ENABLE is not supported with BOOT_COM_BLUETOOTH_UART_ENABLE"
+  #endif
+
+  #ifndef BOOT_GATE_STORE_FORWARD_PACKETS
+  #define BOOT_GATE_STORE_FORWARD_PACKETS     (4)
+  #endif
+
+  #if (BOOT_GATE_STORE_FORWARD_PACKETS < 1) || (BOOT_GATE_STORE_FORWARD_PACKETS > 16)
+  #error "BOOT_GATE_STORE_FORWARD_PACKETS must be 1..16"
+  #endif
+
+  #ifndef BOOT_GATE_STORE_FORWARD_TIMEOUT_MS
+  #define BOOT_GATE_STORE_FORWARD_TIMEOUT_MS  (500)
+  #endif
+#endif /* BOOT_GATE_STORE_FORWARD_ENABLE > 0 */
         
 
 /****************************************************************************************
@@ -544,6 +623,18 @@
 #error "BOOT_NVM_CHECKSUM_HOOKS_ENABLE must be 0 or 1"
 #endif
 
+#ifndef BOOT_NVM_CRC32_CHECK_ENABLE
+#define BOOT_NVM_CRC32_CHECK_ENABLE     (0)
+#endif
+
+#if (BOOT_NVM_CRC32_CHECK_ENABLE < 0) || (BOOT_NVM_CRC32_CHECK_ENABLE > 1)
+#error "BOOT_NVM_CRC32_CHECK_ENABLE must be 0 or 1"
+#endif
+
+#if (BOOT_NVM_CRC32_CHECK_ENABLE > 0) && (BOOT_NVM_CHECKSUM_HOOKS_ENABLE > 0)
+#error "BOOT_NVM_CRC32_CHECK_ENABLE requires the internal checksum method"
+#endif
+
 
 /****************************************************************************************
 *   W A T C H D O G   D R I V E R   C O N F I G U R A T I O N   C H E C K
@@ -569,5 +660,17 @@
 #endif
 
 
+/****************************************************************************************
+*   C O M P R E S S E D   P R O G R A M M I N G   C O N F I G U R A T I O N
+****************************************************************************************/
+#ifndef BOOT_XCP_PROGRAM_COMPRESSED_ENABLE
+#define BOOT_XCP_PROGRAM_COMPRESSED_ENABLE (0)
+#endif
+
+#if (BOOT_XCP_PROGRAM_COMPRESSED_ENABLE < 0) || (BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 1)
+#error "BOOT_XCP_PROGRAM_COMPRESSED_ENABLE must be 0 or 1"
+#endif
+
+
 #endif /* PLAUSIBILITY_H */
 /*********************************** end of plausibility.h *****************************/
@@ -94,6 +94,10 @@
 #define XCP_CMD_SHORT_UPLOAD        (0xf4)
 /** \brief BUILD_CHECKSUM command code. */
 #define XCP_CMD_BUILD_CHECKSUM      (0xf3)
+/** \brief TRANSPORT_LAYER_CMD command code. */
+#define XCP_CMD_TRANSPORT_LAYER_CMD (0xf2)
+/** \brief USER_CMD command code. */
+#define XCP_CMD_USER                (0xf1)
 /** \brief DOWNLOAD command code. */
 #define XCP_CMD_DOWNLOAD            (0xf0)
 /** \brief DOWNLOAD_MAX command code. */
@@ -115,6 +119,14 @@
 /** \brief PROGRAM_MAX command code. */
 #define XCP_CMD_PROGRAM_MAX         (0xc9)
 
+/* XCP transport layer sub-command codes */
+/** \brief SET_BAUDRATE sub-command code, switches the UART to another speed. */
+#define XCP_TL_CMD_SET_BAUDRATE     (0x01)
+
+/* XCP user command sub-command codes */
+/** \brief PROGRAM_COMPRESSED sub-command code, programs LZ compressed data. */
+#define XCP_USER_CMD_PROGRAM_COMPRESSED (0x01)
+
 
 /****************************************************************************************
 * Type definitions
@@ -126,6 +138,10 @@ typedef struct
 #if (BOOT_GATE_ENABLE > 0)
   blt_int32u  other_connection;                      /**< connection to other device established      */
 #endif
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  blt_int8u  gateError;                             /**< first error of the stored packets, or 0     */
+  blt_bool   gateCompressing;                       /**< device accepted compressed data             */
+#endif
 #if (BOOTLOADER_OF_MAIN_DEVICE > 0)
   blt_bool   wasMainConnection;                     /**< connection to serialboot (0x00) established */
 #endif
@@ -161,6 +177,10 @@ static blt_int8u XcpVerifyKey(blt_int8u resource, blt_int8u *key, blt_int8u len)
 /* general utility functions */
 static void XcpProtectResources(void);
 static void XcpSetCtoError(blt_int8u error);
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+static blt_bool XcpGatePacketStorable(blt_int8u *data);
+static void XcpGateTransmitResponse(blt_int8u error);
+#endif
 
 /* XCP command processors */
 static void XcpCmdConnect(blt_int8u *data, blt_int16s dataLength);
@@ -172,6 +192,9 @@ static void XcpCmdSetMta(blt_int8u *data);
 static void XcpCmdUpload(blt_int8u *data);
 static void XcpCmdShortUpload(blt_int8u *data);
 static void XcpCmdBuildCheckSum(blt_int8u *data);
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+static void XcpCmdTransportLayerCmd(blt_int8u *data);
+#endif
 #if (XCP_SEED_KEY_PROTECTION_EN == 1)
 static void XcpCmdGetSeed(blt_int8u *data);
 static void XcpCmdUnlock(blt_int8u *data);
@@ -191,6 +214,9 @@ static void XcpCmdProgramStart(blt_int8u *data);
 static void XcpCmdProgramClear(blt_int8u *data);
 static void XcpCmdProgramReset(blt_int8u *data);
 static void XcpCmdProgramPrepare(blt_int8u *data);
+#if (XCP_PROGRAM_COMPRESSED_EN == 1)
+static void XcpCmdUser(blt_int8u *data);
+#endif
 #endif
 static void portedTransmission(blt_int8u *data);
 
@@ -253,6 +279,10 @@ void XcpInit(void)
 #if (BOOT_GATE_ENABLE > 0)
   xcpInfo.other_connection = 0;
 #endif
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  xcpInfo.gateError = 0;
+  xcpInfo.gateCompressing = BLT_FALSE;
+#endif
 #if (BOOTLOADER_OF_MAIN_DEVICE > 0)
   xcpInfo.wasMainConnection = BLT_FALSE;
 #endif
@@ -357,6 +387,11 @@ void XcpPacketReceived(blt_int8u *data, blt_int16s dataLength)
       case XCP_CMD_DISCONNECT:
         XcpCmdDisconnect(data);
         break;
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+      case XCP_CMD_TRANSPORT_LAYER_CMD:
+        XcpCmdTransportLayerCmd(data);
+        break;
+#endif
 #if (XCP_RES_CALIBRATION_EN == 1)
       case XCP_CMD_DOWNLOAD:
         XcpCmdDownload(data);
@@ -384,6 +419,11 @@ void XcpPacketReceived(blt_int8u *data, blt_int16s dataLength)
       case XCP_CMD_PROGRAM_PREPARE:
         XcpCmdProgramPrepare(data);
         break;
+#if (XCP_PROGRAM_COMPRESSED_EN == 1)
+      case XCP_CMD_USER:
+        XcpCmdUser(data);
+        break;
+#endif
 #endif
 #if (XCP_SEED_KEY_PROTECTION_EN == 1)
       case XCP_CMD_GET_SEED:
@@ -457,6 +497,40 @@ void XcpPacketReceivedForwarding(blt_int8u *data, blt_int16s dataLength) {
   /* save id of connected device */
   blt_int32u connectionTo = xcpInfo.other_connection;
 
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  /* program commands are acknowledged right away and forwarded while the host already
+   * sends the next one. an error of the device is reported with a later response.
+   */
+  if (XcpGatePacketStorable(data) == BLT_TRUE)
+  {
+    if (xcpInfo.gateError == 0)
+    {
+      GateStorePacket(data, (blt_int8u)dataLength, connectionTo);
+    }
+    XcpGateTransmitResponse(xcpInfo.gateError);
+    xcpInfo.gateError = 0;
+    return;
+  }
+  /* every other command may depend on the effect of the stored ones */
+  GateStoreFlush();
+  xcpInfo.gateCompressing = BLT_FALSE;
+  if ((xcpInfo.gateError != 0) && (data[0] != XCP_CMD_CONNECT) &&
+      (data[0] != XCP_CMD_DISCONNECT) && (data[0] != XCP_CMD_PROGRAM_RESET))
+  {
+    XcpGateTransmitResponse(xcpInfo.gateError);
+    xcpInfo.gateError = 0;
+    return;
+  }
+  xcpInfo.gateError = 0;
+  /* the first compressed packet is forwarded as is, so that the host learns whether
+   * the device supports compression. the following ones can be stored.
+   */
+  if ((data[0] == XCP_CMD_USER) && (data[1] == XCP_USER_CMD_PROGRAM_COMPRESSED))
+  {
+    xcpInfo.gateCompressing = BLT_TRUE;
+  }
+#endif
+
   /* proof commands */
   switch (data[0]) {
     /* if there is a disconnection command, everything else in xcp info
@@ -508,6 +582,76 @@ void XcpGatewayPacketReceived(blt_int8u *data, blt_int16s dataLength) {
   ComTransmitPacketDirect(data, (blt_int8u)dataLength);
 } /*** end of XcpGatewayPacketReceived ***/
 
+
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+/************************************************************************************//**
+** \brief     Checks the response of the device to a stored packet. Only the first
+**            error is kept, the host is told with the response to its next command.
+** \param     data       Pointer to the byte buffer with the response.
+** \param     dataLength Number of response bytes, or 0 if the device did not respond.
+** \return    BLT_TRUE to continue forwarding, BLT_FALSE to drop the stored packets.
+**
+****************************************************************************************/
+blt_bool XcpGatewayStoredPacketResponse(blt_int8u *data, blt_int16s dataLength) {
+  if ((dataLength > 0) && (data[0] == XCP_PID_RES))
+  {
+    return BLT_TRUE;
+  }
+  if (xcpInfo.gateError == 0)
+  {
+    xcpInfo.gateError = ((dataLength > 1) && (data[0] == XCP_PID_ERR)) ? data[1] : XCP_ERR_GENERIC;
+  }
+  return BLT_FALSE;
+} /*** end of XcpGatewayStoredPacketResponse ***/
+
+
+/************************************************************************************//**
+** \brief     Checks if a packet for the device behind the gateway can be acknowledged
+**            before the device processed it. This holds for the commands that program
+**            data, whose positive response carries no information.
+** \param     data Pointer to the byte buffer with the packet data.
+** \return    BLT_TRUE if the packet can be stored, BLT_FALSE otherwise.
+**
+****************************************************************************************/
+static blt_bool XcpGatePacketStorable(blt_int8u *data)
+{
+  switch (data[0])
+  {
+    case XCP_CMD_PROGRAM:
+      /* zero bytes end the programming, which the host has to wait for */
+      return (data[1] > 0) ? BLT_TRUE : BLT_FALSE;
+    case XCP_CMD_PROGRAM_MAX:
+      return BLT_TRUE;
+    case XCP_CMD_USER:
+      return ((data[1] == XCP_USER_CMD_PROGRAM_COMPRESSED) &&
+              (xcpInfo.gateCompressing == BLT_TRUE)) ? BLT_TRUE : BLT_FALSE;
+    default:
+      return BLT_FALSE;
+  }
+} /*** end of XcpGatePacketStorable ***/
+
+
+/************************************************************************************//**
+** \brief     Responds to the host on behalf of the device behind the gateway.
+** \param     error XCP error code (XCP_ERR_XXX), or 0 for a positive response.
+** \return    none
+**
+****************************************************************************************/
+static void XcpGateTransmitResponse(blt_int8u error)
+{
+  if (error == 0)
+  {
+    xcpInfo.ctoData[0] = XCP_PID_RES;
+    xcpInfo.ctoLen = 1;
+  }
+  else
+  {
+    XcpSetCtoError(error);
+  }
+  XcpGatewayPacketReceived(xcpInfo.ctoData, xcpInfo.ctoLen);
+} /*** end of XcpGateTransmitResponse ***/
+#endif /* BOOT_GATE_STORE_FORWARD_ENABLE > 0 */
+
 #endif /* (BOOT_GATE_ENABLE > 0) */
 
 
@@ -544,7 +688,9 @@ static void XcpTransmitPacket(blt_int8u *data, blt_int16s len)
 
 /************************************************************************************//**
 ** \brief     Called by the BUILD_CHECKSUM command to perform a checksum calculation
-**            over the specified memory region.
+**            over the specified memory region. During a programming session the
+**            result includes the data that the NVM driver has not yet programmed, so
+**            the host can verify an image before the session is stopped.
 ** \param     address   The start address of the memory region.
 ** \param     length    Length of the memory region in bytes.
 ** \param     checksum  Pointer to where the calculated checksum is to be stored.
@@ -554,18 +700,9 @@ static void XcpTransmitPacket(blt_int8u *data, blt_int16s len)
 static blt_int8u XcpComputeChecksum(blt_int32u address, blt_int32u length,
                                     blt_int32u *checksum)
 {
-  blt_int8u cs = 0;
-
-  /* this example computes the checksum using the add byte to byte algorithm */
-  while (length-- > 0)
-  {
-    cs += *((blt_int8u*)(blt_addr)address);
-    address++;
-  }
+  *checksum = NvmCalculateCrc32((blt_addr)address, length);
 
-  *checksum = cs;
-
-  return XCP_CS_ADD11;
+  return XCP_CS_CRC32;
 } /*** end of XcpComputeChecksum ***/
 
 
@@ -693,6 +830,13 @@ static void XcpCmdConnect(blt_int8u *data, blt_int16s dataLength)
   /* enable resource protection */
   XcpProtectResources();
 
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+  /* the host starts over, so the packets for the previous connection are obsolete */
+  GateStoreDiscard();
+  xcpInfo.gateError = 0;
+  xcpInfo.gateCompressing = BLT_FALSE;
+#endif
+
   /* extract the device ID.
    * NOTE: For legacy support the following code depends on the data length.
    *       If two bytes were received the system switches to legacy mode.
@@ -925,6 +1069,11 @@ static void XcpCmdSetMta(blt_int8u *data)
   /* update mta. current implementation ignores address extension */
   xcpInfo.mta = *(blt_int32u*)&data[4];
 
+#if (XCP_RES_PROGRAMMING_EN == 1) && (XCP_PROGRAM_COMPRESSED_EN == 1)
+  /* a compressed stream always starts at a new mta */
+  LzInit((blt_addr)xcpInfo.mta);
+#endif
+
   /* set packet length */
   xcpInfo.ctoLen = 1;
 } /*** end of XcpCmdSetMta ***/
@@ -1533,8 +1682,104 @@ static void XcpCmdProgramPrepare(blt_int8u *data)
   XcpSetCtoError(XCP_ERR_GENERIC);
   return;
 } /*** end of XcpCmdProgramPrepare ***/
+
+
+#if (XCP_PROGRAM_COMPRESSED_EN == 1)
+/************************************************************************************//**
+** \brief     XCP command processor function which handles the USER_CMD command. The
+**            only supported sub-command is PROGRAM_COMPRESSED, which works like PROGRAM
+**            with LZ compressed data: data[2] holds the number of compressed bytes that
+**            start at data[3]. The mta advances by the decompressed size.
+** \param     data Pointer to a byte buffer with the packet data.
+** \return    none
+**
+****************************************************************************************/
+static void XcpCmdUser(blt_int8u *data)
+{
+  blt_addr addr;
+
+  /* check the sub-command code */
+  if (data[1] != XCP_USER_CMD_PROGRAM_COMPRESSED)
+  {
+    XcpSetCtoError(XCP_ERR_CMD_UNKNOWN);
+    return;
+  }
+
+#if (XCP_SEED_KEY_PROTECTION_EN == 1)
+  /* check if PGM resource is unlocked */
+  if ((xcpInfo.protection & XCP_RES_PGM) == XCP_RES_PGM)
+  {
+    /* resource is locked. use seed/key sequence to unlock */
+    XcpSetCtoError(XCP_ERR_ACCESS_LOCKED);
+    return;
+  }
+#endif
+
+  /* validate length of download request */
+  if (data[2] > (XCP_CTO_PACKET_LEN-3))
+  {
+    /* requested data length is too long */
+    XcpSetCtoError(XCP_ERR_OUT_OF_RANGE);
+    return;
+  }
+
+  /* decompress and program the data */
+  if (LzDecompress(&data[3], data[2], &addr) == BLT_FALSE)
+  {
+    /* corrupt stream or error occurred during programming */
+    XcpSetCtoError(XCP_ERR_GENERIC);
+    return;
+  }
+
+  /* post increment the mta */
+  xcpInfo.mta = (blt_int32u)addr;
+
+  /* set packet id to command response packet */
+  xcpInfo.ctoData[0] = XCP_PID_RES;
+
+  /* set packet length */
+  xcpInfo.ctoLen = 1;
+} /*** end of XcpCmdUser ***/
+#endif /* XCP_PROGRAM_COMPRESSED_EN == 1 */
 #endif /* XCP_RES_PROGRAMMING_EN == 1 */
 
 
+#if (BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0)
+/************************************************************************************//**
+** \brief     XCP command processor function which handles the TRANSPORT_LAYER_CMD
+**            command. The only supported sub-command is SET_BAUDRATE, which requests
+**            the UART to continue at the speed in data[4..7]. The positive response is
+**            still sent at the current speed, the switch takes place right after it.
+** \param     data Pointer to a byte buffer with the packet data.
+** \return    none
+**
+****************************************************************************************/
+static void XcpCmdTransportLayerCmd(blt_int8u *data)
+{
+  /* check the sub-command code */
+  if (data[1] != XCP_TL_CMD_SET_BAUDRATE)
+  {
+    XcpSetCtoError(XCP_ERR_CMD_UNKNOWN);
+    return;
+  }
+
+  /* request the new speed. this fails for interfaces other than the UART and for
+   * speeds the UART cannot generate accurately enough.
+   */
+  if (ComSetBaudrate(*(blt_int32u*)&data[4]) == BLT_FALSE)
+  {
+    XcpSetCtoError(XCP_ERR_OUT_OF_RANGE);
+    return;
+  }
+
+  /* set packet id to command response packet */
+  xcpInfo.ctoData[0] = XCP_PID_RES;
+
+  /* set packet length */
+  xcpInfo.ctoLen = 1;
+} /*** end of XcpCmdTransportLayerCmd ***/
+#endif /* BOOT_COM_UART_BAUDRATE_SWITCH_ENABLE > 0 */
+
+
 
 /******************************** end of xcp.c *****************************************/
@@ -104,6 +104,16 @@
 #define XCP_SEED_KEY_PROTECTION_EN     (0)
 #endif
 
+/** \brief Enable (=1) or disable (=0) support for programming LZ compressed data with
+ *         the PROGRAM_COMPRESSED sub-command of USER_CMD. Requires the programming
+ *         resource.
+ */
+#if (BOOT_XCP_PROGRAM_COMPRESSED_ENABLE > 0)
+#define XCP_PROGRAM_COMPRESSED_EN      (1)
+#else
+#define XCP_PROGRAM_COMPRESSED_EN      (0)
+#endif
+
 
 /****************************************************************************************
 * Defines
@@ -159,6 +169,9 @@ void     XcpPacketReceived(blt_int8u *data, blt_int16s dataLength);
 void     XcpPacketReceivedForwarding(blt_int8u *data, blt_int16s dataLength);
 void     XcpGatewayPacketReceived(blt_int8u *data, blt_int16s dataLength);
 #endif
+#if (BOOT_GATE_STORE_FORWARD_ENABLE > 0)
+blt_bool XcpGatewayStoredPacketResponse(blt_int8u *data, blt_int16s dataLength);
+#endif
 
 
 /****************************************************************************************
@@ -243,5 +256,18 @@ void     XcpGatewayPacketReceived(blt_int8u *data, blt_int16s dataLength);
 #endif
 
 
+#ifndef XCP_PROGRAM_COMPRESSED_EN
+#error  "XCP.H, Configuration macro XCP_PROGRAM_COMPRESSED_EN is missing."
+#endif
+
+#if     (XCP_PROGRAM_COMPRESSED_EN < 0) || (XCP_PROGRAM_COMPRESSED_EN > 1)
+#error  "XCP.H, XCP_PROGRAM_COMPRESSED_EN must be 0 or 1."
+#endif
+
+#if     (XCP_PROGRAM_COMPRESSED_EN == 1) && (XCP_RES_PROGRAMMING_EN == 0)
+#error  "XCP.H, XCP_PROGRAM_COMPRESSED_EN requires XCP_RES_PROGRAMMING_EN."
+#endif
+
+
 #endif /* XCP_H */
 /******************************** end of xcp.h *~~~~~***********************************/
@@ -32,6 +32,7 @@ AMIROOSCOREINC = $(AMIROOS_CORE_DIR)inc
 # C source files
 AMIROOSCORECSRC = $(AMIROOS_CORE_DIR)src/aos_debug.c \
                   $(AMIROOS_CORE_DIR)src/aos_iostream.c \
+                  $(AMIROOS_CORE_DIR)src/aos_profile.c \
                   $(AMIROOS_CORE_DIR)src/aos_shell.c \
                   $(AMIROOS_CORE_DIR)src/aos_system.c \
                   $(AMIROOS_CORE_DIR)src/aos_thread.c \
@@ -0,0 +1,198 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    aos_profile.h
+ * @brief   Thread profiler macros and structures.
+ * @details The profiler is fed by the kernel hooks (see aos_chconf.h) and
+ *          measures per-thread CPU time over a sliding window, stack peak
+ *          utilization, wakeup-to-run latencies, the time spent in ISRs and
+ *          how often and how long the system idles.
+ *
+ * @addtogroup aos_profile
+ * @{
+ */
+
+#ifndef _AMIROOS_PROFILE_H_
+#define _AMIROOS_PROFILE_H_
+
+#include <ch.h>
+#include <hal.h>
+
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+
+/**
+ * @brief   Maximum number of threads that can be profiled.
+ * @details Further threads are accumulated as a single "other" entry.
+ */
+#if !defined(AOS_PROFILE_MAXTHREADS) || defined(__DOXYGEN__)
+#define AOS_PROFILE_MAXTHREADS                  16
+#endif
+
+/**
+ * @brief   Number of slots of the sliding CPU time window.
+ */
+#if !defined(AOS_PROFILE_WINDOWSLOTS) || defined(__DOXYGEN__)
+#define AOS_PROFILE_WINDOWSLOTS                 8
+#endif
+
+/**
+ * @brief   Duration of a single window slot in microseconds.
+ * @details The sliding window covers AOS_PROFILE_WINDOWSLOTS times this period.
+ *          Note that the profiler itself wakes the system once per period.
+ */
+#if !defined(AOS_PROFILE_SLOTPERIOD) || defined(__DOXYGEN__)
+#define AOS_PROFILE_SLOTPERIOD                  125000
+#endif
+
+/**
+ * @brief   Number of bins of the latency histograms.
+ * @details Bin 0 counts latencies below 1us, bin i counts latencies in [2^(i-1), 2^i) us and the last bin counts all longer latencies.
+ */
+#if !defined(AOS_PROFILE_LATENCYBINS) || defined(__DOXYGEN__)
+#define AOS_PROFILE_LATENCYBINS                 16
+#endif
+
+/**
+ * @brief   Frequency of the realtime counter (DWT cycle counter) in Hz.
+ */
+#if !defined(AOS_PROFILE_RTFREQUENCY) || defined(__DOXYGEN__)
+#define AOS_PROFILE_RTFREQUENCY                 STM32_HCLK
+#endif
+
+/**
+ * @brief   Magic number to identify a binary profile dump ("AOSP").
+ */
+#define AOS_PROFILE_DUMP_MAGIC                  0x50534F41U
+
+/**
+ * @brief   Version of the binary profile dump format.
+ */
+#define AOS_PROFILE_DUMP_VERSION                2
+
+/**
+ * @brief   Maximum length of a thread name in a binary profile dump.
+ */
+#define AOS_PROFILE_DUMP_NAMELENGTH             16
+
+/**
+ * @brief   Sliding window of accumulated realtime counter cycles.
+ */
+typedef struct aos_profile_window {
+  /**
+   * @brief   Accumulated cycles per slot.
+   */
+  uint32_t cycles[AOS_PROFILE_WINDOWSLOTS];
+
+  /**
+   * @brief   Slot counter value of the last update.
+   */
+  uint32_t slot;
+} aos_profile_window_t;
+
+/**
+ * @brief   Profiling data of a single thread.
+ */
+typedef struct aos_profile_thread {
+  /**
+   * @brief   Profiled thread or NULL if the entry is unused.
+   */
+  thread_t* thread;
+
+  /**
+   * @brief   CPU time window.
+   */
+  aos_profile_window_t cpu;
+
+  /**
+   * @brief   Realtime counter value when the thread became ready.
+   */
+  rtcnt_t readytime;
+
+  /**
+   * @brief   Maximum wakeup-to-run latency in realtime counter cycles.
+   */
+  rtcnt_t latencymax;
+
+  /**
+   * @brief   Histogram of wakeup-to-run latencies.
+   */
+  uint16_t latency[AOS_PROFILE_LATENCYBINS];
+
+  /**
+   * @brief   Scheduling state as seen by the profiler.
+   */
+  uint8_t state;
+} aos_profile_thread_t;
+
+/**
+ * @brief   Header of a binary profile dump.
+ * @details The header is followed by @p nthreads records of type @p aos_profile_dumprecord_t.
+ *          All values are written in the native (little endian) byte order.
+ */
+typedef struct __attribute__((packed)) aos_profile_dumpheader {
+  uint32_t magic;         /**< Always AOS_PROFILE_DUMP_MAGIC. */
+  uint8_t version;        /**< Always AOS_PROFILE_DUMP_VERSION. */
+  uint8_t nthreads;       /**< Number of thread records that follow. */
+  uint8_t nbins;          /**< Number of latency histogram bins per record. */
+  uint8_t reserved;       /**< Reserved (0). */
+  uint32_t rtfrequency;   /**< Frequency of the realtime counter in Hz. */
+  uint32_t window;        /**< Total cycles accounted in the window. */
+  uint32_t isr;           /**< Cycles spent in ISRs within the window. */
+  uint32_t windowus;      /**< Duration of the window in microseconds. */
+  uint32_t idleus;        /**< Microseconds spent in the idle thread within the window. */
+  uint32_t wakeups;       /**< Interrupts that woke the idle thread within the window. */
+} aos_profile_dumpheader_t;
+
+/**
+ * @brief   Per-thread record of a binary profile dump.
+ */
+typedef struct __attribute__((packed)) aos_profile_dumprecord {
+  char name[AOS_PROFILE_DUMP_NAMELENGTH];         /**< Zero padded thread name. */
+  uint8_t prio;                                   /**< Thread priority. */
+  uint8_t reserved[3];                            /**< Reserved (0). */
+  uint32_t cpu;                                   /**< Cycles spent within the window. */
+  uint32_t stacksize;                             /**< Stack size in bytes (0 if unknown). */
+  uint32_t stackpeak;                             /**< Peak stack utilization in bytes (0 if unknown). */
+  uint32_t latencymax;                            /**< Maximum wakeup-to-run latency in cycles. */
+  uint16_t latency[AOS_PROFILE_LATENCYBINS];      /**< Latency histogram. */
+} aos_profile_dumprecord_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void aosProfileInit(void);
+  void aosProfileReset(void);
+  void aosProfilePrint(BaseSequentialStream* stream, bool histogram);
+  size_t aosProfileDump(BaseSequentialStream* stream);
+  void aosProfileThreadInitHook(thread_t* tp);
+  void aosProfileThreadExitHook(thread_t* tp);
+  void aosProfileContextSwitchHook(thread_t* ntp, thread_t* otp);
+  void aosProfileIrqPrologueHook(void);
+  void aosProfileIrqEpilogueHook(void);
+  void aosProfileIdleEnterHook(void);
+  void aosProfileIdleLeaveHook(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMIROOS_CFG_PROFILE == true */
+
+#endif /* _AMIROOS_PROFILE_H_ */
+
+/** @} */
@@ -98,6 +98,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #define AOS_SHELLCHANNEL_OUTPUT_ENABLED           (1 << 2)
 
+/**
+ * @brief   Number of buckets of the command index.
+ * @details Must be a power of two.
+ */
+#define AOS_SHELL_INDEXSIZE                       16
+
 /*
  * forward definitions
  */
@@ -202,6 +208,11 @@ typedef struct aos_shellcommand {
    */
   struct aos_shellcommand* next;
 
+  /**
+   * @brief   Pointer to the next command in the same bucket of the command index.
+   */
+  struct aos_shellcommand* bucketnext;
+
 } aos_shellcommand_t;
 
 /**
@@ -285,6 +296,12 @@ typedef struct aos_shell {
    */
   aos_shellcommand_t* commands;
 
+  /**
+   * @brief   Hash index of the commands.
+   * @details Each bucket is a singly linked list of all commands whose name hashes to that bucket.
+   */
+  aos_shellcommand_t* index[AOS_SHELL_INDEXSIZE];
+
   /**
    * @brief   Execution status of the most recent command.
    */
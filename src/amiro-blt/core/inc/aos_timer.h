@@ -50,14 +50,38 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #define AOS_TIMER_MAX_INTERVAL_US     (chTimeI2US(AOS_TIMER_MAX_INTERVAL_ST) - 1)
 
+/**
+ * @brief   Number of bits of the wakeup time that select a slot within one level of the timer wheel.
+ * @details Each level hence consists of 2^AOS_TIMER_WHEEL_SLOTBITS slots.
+ *          Must not exceed 5.
+ */
+#if !defined(AOS_TIMER_WHEEL_SLOTBITS) || defined(__DOXYGEN__)
+#define AOS_TIMER_WHEEL_SLOTBITS      4
+#endif
+
+/**
+ * @brief   Number of levels of the timer wheel.
+ * @details The wheel covers 2^(AOS_TIMER_WHEEL_SLOTBITS * AOS_TIMER_WHEEL_LEVELS) microseconds.
+ *          Timers further in the future are held in an overflow list.
+ */
+#if !defined(AOS_TIMER_WHEEL_LEVELS) || defined(__DOXYGEN__)
+#define AOS_TIMER_WHEEL_LEVELS        8
+#endif
+
 /**
  * @brief   Timer stucture.
  */
 typedef struct aos_timer {
   /**
-   * @brief   ChibiOS virtual timer.
+   * @brief   Pointer to the next timer in the same slot of the timer wheel.
+   */
+  struct aos_timer* next;
+
+  /**
+   * @brief   Pointer to the pointer that points to this timer.
+   * @details NULL if the timer is not armed.
    */
-  virtual_timer_t vt;
+  struct aos_timer** pprev;
 
   /**
    * @brief   Time to wake up.
@@ -103,6 +127,7 @@ typedef struct aos_periodictimer {
 #ifdef __cplusplus
 extern "C" {
 #endif
+  void aosTimerWheelInit(void);
   void aosTimerInit(aos_timer_t* timer);
   void aosTimerSetAbsoluteI(aos_timer_t* timer, aos_timestamp_t* uptime, vtfunc_t cb, void* par);
   void aosTimerSetIntervalI(aos_timer_t* timer, aos_interval_t offset, vtfunc_t cb, void* par);
@@ -110,6 +135,7 @@ extern "C" {
   void aosPeriodicTimerInit(aos_periodictimer_t* ptimer);
   void aosPeriodicTimerSetI(aos_periodictimer_t* ptimer, aos_interval_t interval, vtfunc_t cb, void* par);
   void aosPeriodicTimerSetLongI(aos_periodictimer_t* ptimer, aos_longinterval_t* interval, vtfunc_t cb, void* par);
+  void aosTimerResetI(aos_timer_t* timer);
 #ifdef __cplusplus
 }
 #endif
@@ -161,18 +187,6 @@ static inline void aosTimerSetLongInterval(aos_timer_t* timer, aos_longinterval_
   chSysUnlock();
 }
 
-/**
- * @brief   Reset a timer.
- *
- * @param[in] timer   Pointer to the timer to reset.
- */
-static inline void aosTimerResetI(aos_timer_t* timer)
-{
-  chVTResetI(&(timer->vt));
-
-  return;
-}
-
 /**
  * @brief   Reset a timer.
  *
@@ -196,7 +210,7 @@ static inline void aosTimerReset(aos_timer_t* timer)
  */
 static inline bool aosTimerIsArmedI(aos_timer_t* timer)
 {
-  return chVTIsArmedI(&(timer->vt));
+  return (timer->pprev != NULL);
 }
 
 /**
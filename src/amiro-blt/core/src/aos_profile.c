@@ -0,0 +1,610 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    aos_profile.c
+ * @brief   Thread profiler code.
+ * @details All CPU time measurements are based on the realtime counter, so
+ *          the results are valid in tickless mode as well.
+ *          The realtime counter may stop while the core sleeps in the idle
+ *          thread, hence idle time is measured with the system timer.
+ *
+ * @addtogroup aos_profile
+ * @{
+ */
+
+#include <aos_profile.h>
+
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+
+#include <aos_debug.h>
+#include <aos_thread.h>
+#include <string.h>
+
+#if (PORT_SUPPORTS_RT != TRUE)
+#error "AMIROOS_CFG_PROFILE requires a port with realtime counter support"
+#endif
+
+#if (CH_CFG_USE_REGISTRY != TRUE)
+#error "AMIROOS_CFG_PROFILE requires CH_CFG_USE_REGISTRY"
+#endif
+
+/**
+ * @brief   Profiler state of a thread that is currently running.
+ */
+#define PROFILE_STATE_RUNNING                   0
+
+/**
+ * @brief   Profiler state of a thread that was preempted or not started yet.
+ */
+#define PROFILE_STATE_PREEMPTED                 1
+
+/**
+ * @brief   Profiler state of a thread that is waiting for an event, a timeout etc.
+ */
+#define PROFILE_STATE_BLOCKED                   2
+
+/**
+ * @brief   Profiler state of a blocked thread that became ready again.
+ */
+#define PROFILE_STATE_WOKEN                     3
+
+/**
+ * @brief   Number of realtime counter cycles per microsecond.
+ */
+#define PROFILE_CYCLES_PER_US                   (AOS_PROFILE_RTFREQUENCY / 1000000)
+
+/**
+ * @brief   Duration of the whole sliding window in microseconds.
+ */
+#define PROFILE_WINDOW_US                       (AOS_PROFILE_WINDOWSLOTS * AOS_PROFILE_SLOTPERIOD)
+
+/**
+ * @brief   Profiler data.
+ */
+static struct {
+  /**
+   * @brief   Per-thread profiling data.
+   */
+  aos_profile_thread_t threads[AOS_PROFILE_MAXTHREADS];
+
+  /**
+   * @brief   CPU time of threads that did not fit into the @p threads array.
+   */
+  aos_profile_window_t other;
+
+  /**
+   * @brief   CPU time spent in ISRs.
+   */
+  aos_profile_window_t isr;
+
+  /**
+   * @brief   Time spent in the idle thread in microseconds.
+   */
+  aos_profile_window_t idle;
+
+  /**
+   * @brief   Number of interrupts that woke the idle thread.
+   */
+  aos_profile_window_t wakeups;
+
+  /**
+   * @brief   System time when the idle time started to be accounted.
+   */
+  systime_t idlestart;
+
+  /**
+   * @brief   Flag whether the idle thread is running.
+   */
+  bool idling;
+
+  /**
+   * @brief   Realtime counter value when the currently running context started to be accounted.
+   */
+  rtcnt_t runstart;
+
+  /**
+   * @brief   Counter of elapsed window slots.
+   */
+  uint32_t slot;
+
+  /**
+   * @brief   Nesting level of ISRs.
+   */
+  cnt_t isrnesting;
+
+  /**
+   * @brief   Timer to advance the window slots.
+   */
+  virtual_timer_t slottimer;
+} _profile;
+
+/**
+ * @brief   Moves a window to the current slot and clears all slots that elapsed in between.
+ *
+ * @param[in] window  The window to update.
+ */
+static inline void _windowUpdate(aos_profile_window_t* window)
+{
+  const uint32_t elapsed = _profile.slot - window->slot;
+
+  for (uint32_t s = 1; s <= elapsed && s <= AOS_PROFILE_WINDOWSLOTS; ++s) {
+    window->cycles[(window->slot + s) % AOS_PROFILE_WINDOWSLOTS] = 0;
+  }
+  window->slot = _profile.slot;
+
+  return;
+}
+
+/**
+ * @brief   Accounts the time since the last accounting to a window.
+ *
+ * @param[in] window  The window to account the time to.
+ * @param[in] now     Current realtime counter value.
+ */
+static inline void _account(aos_profile_window_t* window, const rtcnt_t now)
+{
+  _windowUpdate(window);
+  window->cycles[_profile.slot % AOS_PROFILE_WINDOWSLOTS] += now - _profile.runstart;
+  _profile.runstart = now;
+
+  return;
+}
+
+/**
+ * @brief   Accounts the idle time since the last accounting.
+ *
+ * @param[in] now     Current system time.
+ */
+static inline void _accountIdle(const systime_t now)
+{
+  _windowUpdate(&_profile.idle);
+  _profile.idle.cycles[_profile.slot % AOS_PROFILE_WINDOWSLOTS] += chTimeI2US(chTimeDiffX(_profile.idlestart, now));
+  _profile.idlestart = now;
+
+  return;
+}
+
+/**
+ * @brief   Sums up all slots of a window.
+ *
+ * @param[in] window  The window to sum up.
+ *
+ * @return  Cycles accounted within the window.
+ */
+static uint32_t _windowSum(aos_profile_window_t* window)
+{
+  uint32_t sum = 0;
+
+  _windowUpdate(window);
+  for (size_t s = 0; s < AOS_PROFILE_WINDOWSLOTS; ++s) {
+    sum += window->cycles[s];
+  }
+
+  return sum;
+}
+
+/**
+ * @brief   Retrieves the CPU time window of a thread.
+ *
+ * @param[in] tp    The thread.
+ *
+ * @return  The window of the thread or the shared window if the thread is not profiled.
+ */
+static inline aos_profile_window_t* _threadWindow(thread_t* tp)
+{
+  return (tp->profile != NULL) ? &tp->profile->cpu : &_profile.other;
+}
+
+/**
+ * @brief   Adds a wakeup-to-run latency to the histogram of a thread.
+ *
+ * @param[in] entry   Profiling data of the thread.
+ * @param[in] cycles  Latency in realtime counter cycles.
+ */
+static inline void _recordLatency(aos_profile_thread_t* entry, const rtcnt_t cycles)
+{
+  const uint32_t us = cycles / PROFILE_CYCLES_PER_US;
+  size_t bin = (us == 0) ? 0 : (size_t)(32 - __builtin_clz(us));
+
+  if (bin >= AOS_PROFILE_LATENCYBINS) {
+    bin = AOS_PROFILE_LATENCYBINS - 1;
+  }
+  if (entry->latency[bin] < UINT16_MAX) {
+    ++entry->latency[bin];
+  }
+  if (cycles > entry->latencymax) {
+    entry->latencymax = cycles;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Marks all blocked threads in the ready list as woken.
+ * @note    There is no kernel hook when a thread becomes ready, so this function is called on every context switch and when leaving an ISR.
+ *          Threads which are readied by another thread without a reschedule are hence detected late and their latency is underestimated.
+ *
+ * @param[in] now     Current realtime counter value.
+ */
+static inline void _scanReadyList(const rtcnt_t now)
+{
+  for (thread_t* tp = ch.rlist.queue.next; tp != (thread_t*)&ch.rlist.queue; tp = tp->queue.next) {
+    if (tp->profile != NULL && tp->profile->state == PROFILE_STATE_BLOCKED) {
+      tp->profile->state = PROFILE_STATE_WOKEN;
+      tp->profile->readytime = now;
+    }
+  }
+
+  return;
+}
+
+/**
+ * @brief   Callback function of the slot timer.
+ *
+ * @param[in] par   Generic parameter.
+ */
+static void _slotCallback(void* par)
+{
+  (void)par;
+
+  chSysLockFromISR();
+  // idle time must not spill over into the next slot
+  if (_profile.idling) {
+    _accountIdle(chVTGetSystemTimeX());
+  }
+  ++_profile.slot;
+  chVTSetI(&_profile.slottimer, chTimeUS2I(AOS_PROFILE_SLOTPERIOD), &_slotCallback, NULL);
+  chSysUnlockFromISR();
+
+  return;
+}
+
+/**
+ * @brief   Fills a dump record with the data of a profiled thread.
+ *
+ * @param[in]  idx      Index of the thread in the profiler data.
+ * @param[out] record   Record to fill.
+ *
+ * @return  Flag whether the entry is in use.
+ */
+static bool _getRecord(const size_t idx, aos_profile_dumprecord_t* record)
+{
+  aos_profile_thread_t* entry = &_profile.threads[idx];
+  thread_t* tp;
+
+  memset(record, 0, sizeof(*record));
+
+  chSysLock();
+  tp = entry->thread;
+  if (tp != NULL) {
+    strncpy(record->name, (tp == &ch.mainthread) ? "main" : ((tp->name != NULL) ? tp->name : "?"), AOS_PROFILE_DUMP_NAMELENGTH);
+    record->prio = (uint8_t)tp->prio;
+    record->cpu = _windowSum(&entry->cpu);
+    record->latencymax = entry->latencymax;
+    memcpy(record->latency, entry->latency, sizeof(record->latency));
+  }
+  chSysUnlock();
+
+  // the stack of the main thread is not part of its working area
+  if (tp != NULL && tp != &ch.mainthread && tp->wabase != NULL) {
+    record->stacksize = aosThdGetStacksize(tp);
+    record->stackpeak = aosThdGetStackPeakUtilization(tp);
+  }
+
+  return (tp != NULL);
+}
+
+/**
+ * @brief   Initializes the profiler and starts the sliding window.
+ * @details Data that was accumulated during system startup is discarded.
+ */
+void aosProfileInit(void)
+{
+  chVTObjectInit(&_profile.slottimer);
+
+  chSysLock();
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    memset(&_profile.threads[t].cpu, 0, sizeof(aos_profile_window_t));
+    _profile.threads[t].latencymax = 0;
+    memset(_profile.threads[t].latency, 0, sizeof(_profile.threads[t].latency));
+  }
+  memset(&_profile.other, 0, sizeof(aos_profile_window_t));
+  memset(&_profile.isr, 0, sizeof(aos_profile_window_t));
+  memset(&_profile.idle, 0, sizeof(aos_profile_window_t));
+  memset(&_profile.wakeups, 0, sizeof(aos_profile_window_t));
+  _profile.idlestart = chVTGetSystemTimeX();
+  _profile.slot = 0;
+  _profile.runstart = chSysGetRealtimeCounterX();
+  chVTSetI(&_profile.slottimer, chTimeUS2I(AOS_PROFILE_SLOTPERIOD), &_slotCallback, NULL);
+  chSysUnlock();
+
+  return;
+}
+
+/**
+ * @brief   Resets the latency histograms of all threads.
+ */
+void aosProfileReset(void)
+{
+  chSysLock();
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    _profile.threads[t].latencymax = 0;
+    memset(_profile.threads[t].latency, 0, sizeof(_profile.threads[t].latency));
+  }
+  chSysUnlock();
+
+  return;
+}
+
+/**
+ * @brief   Prints the profiling results as a table.
+ *
+ * @param[in] stream      The stream to print to.
+ * @param[in] histogram   Flag whether to print the latency histograms as well.
+ */
+void aosProfilePrint(BaseSequentialStream* stream, bool histogram)
+{
+  aosDbgCheck(stream != NULL);
+
+  aos_profile_dumprecord_t record;
+  uint32_t total, isr, other, idle, wakeups;
+
+  chSysLock();
+  if (_profile.idling) {
+    _accountIdle(chVTGetSystemTimeX());
+  }
+  idle = _windowSum(&_profile.idle);
+  wakeups = _windowSum(&_profile.wakeups);
+  isr = _windowSum(&_profile.isr);
+  other = _windowSum(&_profile.other);
+  total = isr + other;
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    if (_profile.threads[t].thread != NULL) {
+      total += _windowSum(&_profile.threads[t].cpu);
+    }
+  }
+  chSysUnlock();
+  if (total == 0) {
+    total = 1;
+  }
+
+  chprintf(stream, "window: %uus\n", total / PROFILE_CYCLES_PER_US);
+  chprintf(stream, "idle: %.2f%%, %.1f wakeups/s\n",
+           (float)idle / (float)PROFILE_WINDOW_US * 100.0f, (float)wakeups * 1000000.0f / (float)PROFILE_WINDOW_US);
+  chprintf(stream, "%-16s %4s %7s %10s %15s %8s %11s\n", "thread", "prio", "cpu[%]", "cpu[us]", "stack[B]", "wakeups", "latmax[us]");
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    if (_getRecord(t, &record)) {
+      uint32_t wakeups = 0;
+      for (size_t b = 0; b < AOS_PROFILE_LATENCYBINS; ++b) {
+        wakeups += record.latency[b];
+      }
+      chprintf(stream, "%-16.16s %4u %7.2f %10u %7u/%-7u %8u %11u\n",
+               record.name, record.prio,
+               (float)record.cpu / (float)total * 100.0f, record.cpu / PROFILE_CYCLES_PER_US,
+               record.stackpeak, record.stacksize,
+               wakeups, record.latencymax / PROFILE_CYCLES_PER_US);
+      if (histogram && wakeups > 0) {
+        chprintf(stream, "  latency[us]:");
+        for (size_t b = 0; b < AOS_PROFILE_LATENCYBINS; ++b) {
+          if (record.latency[b] > 0) {
+            if (b == 0) {
+              chprintf(stream, " <1:%u", record.latency[b]);
+            } else {
+              chprintf(stream, " %u%s:%u", (uint32_t)1 << (b - 1), (b == AOS_PROFILE_LATENCYBINS - 1) ? "+" : "", record.latency[b]);
+            }
+          }
+        }
+        chprintf(stream, "\n");
+      }
+    }
+  }
+  chprintf(stream, "%-16s %4s %7.2f %10u\n", "(other)", "", (float)other / (float)total * 100.0f, other / PROFILE_CYCLES_PER_US);
+  chprintf(stream, "%-16s %4s %7.2f %10u\n", "(ISR)", "", (float)isr / (float)total * 100.0f, isr / PROFILE_CYCLES_PER_US);
+
+  return;
+}
+
+/**
+ * @brief   Writes the profiling results as binary dump.
+ * @details The dump consists of an @p aos_profile_dumpheader_t followed by one @p aos_profile_dumprecord_t per profiled thread.
+ *
+ * @param[in] stream  The stream to write to.
+ *
+ * @return  Number of bytes written.
+ */
+size_t aosProfileDump(BaseSequentialStream* stream)
+{
+  aosDbgCheck(stream != NULL);
+
+  aos_profile_dumpheader_t header;
+  aos_profile_dumprecord_t record;
+  size_t bytes = 0;
+
+  memset(&header, 0, sizeof(header));
+  header.magic = AOS_PROFILE_DUMP_MAGIC;
+  header.version = AOS_PROFILE_DUMP_VERSION;
+  header.nbins = AOS_PROFILE_LATENCYBINS;
+  header.rtfrequency = AOS_PROFILE_RTFREQUENCY;
+  header.windowus = PROFILE_WINDOW_US;
+  chSysLock();
+  if (_profile.idling) {
+    _accountIdle(chVTGetSystemTimeX());
+  }
+  header.idleus = _windowSum(&_profile.idle);
+  header.wakeups = _windowSum(&_profile.wakeups);
+  header.isr = _windowSum(&_profile.isr);
+  header.window = header.isr + _windowSum(&_profile.other);
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    if (_profile.threads[t].thread != NULL) {
+      header.window += _windowSum(&_profile.threads[t].cpu);
+      ++header.nthreads;
+    }
+  }
+  chSysUnlock();
+  bytes += streamWrite(stream, (const uint8_t*)&header, sizeof(header));
+
+  // threads that were created or terminated meanwhile are padded or skipped to match the header
+  size_t written = 0;
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS && written < header.nthreads; ++t) {
+    if (_getRecord(t, &record)) {
+      bytes += streamWrite(stream, (const uint8_t*)&record, sizeof(record));
+      ++written;
+    }
+  }
+  memset(&record, 0, sizeof(record));
+  for (; written < header.nthreads; ++written) {
+    bytes += streamWrite(stream, (const uint8_t*)&record, sizeof(record));
+  }
+
+  return bytes;
+}
+
+/**
+ * @brief   Assigns profiling data to a new thread.
+ * @note    Called by the kernel (CH_CFG_THREAD_INIT_HOOK) in locked state.
+ *
+ * @param[in] tp    The new thread.
+ */
+void aosProfileThreadInitHook(thread_t* tp)
+{
+  tp->profile = NULL;
+  for (size_t t = 0; t < AOS_PROFILE_MAXTHREADS; ++t) {
+    if (_profile.threads[t].thread == NULL) {
+      memset(&_profile.threads[t], 0, sizeof(aos_profile_thread_t));
+      _profile.threads[t].thread = tp;
+      _profile.threads[t].cpu.slot = _profile.slot;
+      _profile.threads[t].state = PROFILE_STATE_PREEMPTED;
+      tp->profile = &_profile.threads[t];
+      break;
+    }
+  }
+
+  return;
+}
+
+/**
+ * @brief   Releases the profiling data of a terminating thread.
+ * @note    Called by the kernel (CH_CFG_THREAD_EXIT_HOOK) in locked state.
+ *
+ * @param[in] tp    The terminating thread.
+ */
+void aosProfileThreadExitHook(thread_t* tp)
+{
+  if (tp->profile != NULL) {
+    tp->profile->thread = NULL;
+    tp->profile = NULL;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Accounts the CPU time of the outgoing thread and the wakeup latency of the incoming one.
+ * @note    Called by the kernel (CH_CFG_CONTEXT_SWITCH_HOOK) in locked state.
+ *
+ * @param[in] ntp   The thread to be switched in.
+ * @param[in] otp   The thread to be switched out.
+ */
+void aosProfileContextSwitchHook(thread_t* ntp, thread_t* otp)
+{
+  const rtcnt_t now = chSysGetRealtimeCounterX();
+
+  _account(_threadWindow(otp), now);
+  if (otp->profile != NULL) {
+    otp->profile->state = (otp->state == CH_STATE_READY) ? PROFILE_STATE_PREEMPTED : PROFILE_STATE_BLOCKED;
+  }
+
+  _scanReadyList(now);
+
+  if (ntp->profile != NULL) {
+    // a blocked thread that was not seen in the ready list was woken up right before the switch
+    if (ntp->profile->state == PROFILE_STATE_WOKEN) {
+      _recordLatency(ntp->profile, now - ntp->profile->readytime);
+    } else if (ntp->profile->state == PROFILE_STATE_BLOCKED) {
+      _recordLatency(ntp->profile, 0);
+    }
+    ntp->profile->state = PROFILE_STATE_RUNNING;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Accounts the CPU time of the interrupted thread.
+ * @note    Called by the kernel (CH_CFG_IRQ_PROLOGUE_HOOK).
+ */
+void aosProfileIrqPrologueHook(void)
+{
+  port_lock_from_isr();
+  if (_profile.isrnesting++ == 0) {
+    _account(_threadWindow(currp), chSysGetRealtimeCounterX());
+    if (_profile.idling) {
+      _windowUpdate(&_profile.wakeups);
+      ++_profile.wakeups.cycles[_profile.slot % AOS_PROFILE_WINDOWSLOTS];
+    }
+  }
+  port_unlock_from_isr();
+
+  return;
+}
+
+/**
+ * @brief   Accounts the ISR time and detects threads woken by the ISR.
+ * @note    Called by the kernel (CH_CFG_IRQ_EPILOGUE_HOOK).
+ */
+void aosProfileIrqEpilogueHook(void)
+{
+  port_lock_from_isr();
+  if (--_profile.isrnesting == 0) {
+    const rtcnt_t now = chSysGetRealtimeCounterX();
+    _account(&_profile.isr, now);
+    _scanReadyList(now);
+  }
+  port_unlock_from_isr();
+
+  return;
+}
+
+/**
+ * @brief   Starts accounting the idle time.
+ * @note    Called by the kernel (CH_CFG_IDLE_ENTER_HOOK) in locked state.
+ */
+void aosProfileIdleEnterHook(void)
+{
+  _profile.idlestart = chVTGetSystemTimeX();
+  _profile.idling = true;
+
+  return;
+}
+
+/**
+ * @brief   Stops accounting the idle time.
+ * @note    Called by the kernel (CH_CFG_IDLE_LEAVE_HOOK) in locked state.
+ */
+void aosProfileIdleLeaveHook(void)
+{
+  _accountIdle(chVTGetSystemTimeX());
+  _profile.idling = false;
+
+  return;
+}
+
+#endif /* AMIROOS_CFG_PROFILE == true */
+
+/** @} */
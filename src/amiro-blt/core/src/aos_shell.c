@@ -585,6 +585,69 @@ static int _strccmp(const char *str1, const char *str2, bool cs, size_t* n, char
   return _mapAscii2Custom(str1[i]) - _mapAscii2Custom(str2[i]);
 }
 
+/**
+ * @brief   Calculates the command index bucket for a command name.
+ * @details The name is hashed using the 32 bit FNV-1a algorithm.
+ *
+ * @param[in] name    Command name to hash.
+ *
+ * @return    Index of the bucket.
+ */
+static inline size_t _indexBucket(const char* name)
+{
+  aosDbgCheck(name != NULL);
+
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0') {
+    hash ^= (uint8_t)*name;
+    hash *= 16777619u;
+    ++name;
+  }
+
+  return hash & (AOS_SHELL_INDEXSIZE - 1);
+}
+
+/**
+ * @brief   Searches the command index for a command.
+ *
+ * @param[in] shell   Pointer to the shell object.
+ * @param[in] name    Name of the command (case sensitive).
+ *
+ * @return    Pointer to the command or NULL if no such command exists.
+ */
+static aos_shellcommand_t* _findCommand(aos_shell_t* shell, const char* name)
+{
+  aosDbgCheck(shell != NULL);
+  aosDbgCheck(name != NULL);
+
+  aos_shellcommand_t* cmd = shell->index[_indexBucket(name)];
+
+  while (cmd != NULL && strcmp(name, cmd->name) != 0) {
+    cmd = cmd->bucketnext;
+  }
+
+  return cmd;
+}
+
+/**
+ * @brief   Checks whether a command is sorted behind all commands starting with a specific character.
+ * @details Since the list of commands is sorted, completion can stop as soon as this is true.
+ *          Upper and lower case letters are considered equal, so the check is valid for case insensitive matching as well.
+ *
+ * @param[in] name    Name of the command to check.
+ * @param[in] c       First character of the input.
+ *
+ * @return    True if the command and all further commands in the list do not start with the character.
+ */
+static inline bool _isBehindPrefix(const char* name, const char c)
+{
+  // the upper case letter is sorted behind its lower case counterpart
+  const char last = (c >= 'a' && c <= 'z') ? (c - 'a' + 'A') : c;
+
+  return _mapAscii2Custom(name[0]) > _mapAscii2Custom(last);
+}
+
 static aos_status_t _readChannel(aos_shell_t* shell, AosShellChannel* channel, size_t* n)
 {
   aosDbgCheck(shell != NULL);
@@ -772,6 +835,10 @@ static aos_status_t _readChannel(aos_shell_t* shell, AosShellChannel* channel, s
         size_t n;
         // iterate through command list
         for (aos_shellcommand_t* cmd = shell->commands; cmd != NULL; cmd = cmd->next) {
+          // no further command can match
+          if (shell->inputdata.cursorpos > 0 && _isBehindPrefix(cmd->name, shell->line[0])) {
+            break;
+          }
           // compare current match with command
           n = cmatch;
           charmatch_t mlvl = CHAR_MATCH_NOT;
@@ -845,6 +912,10 @@ static aos_status_t _readChannel(aos_shell_t* shell, AosShellChannel* channel, s
         unsigned int matches = 0;
         // iterate through command list
         for (aos_shellcommand_t* cmd = shell->commands; cmd != NULL; cmd = cmd->next) {
+          // no further command can match
+          if (shell->inputdata.cursorpos > 0 && _isBehindPrefix(cmd->name, shell->line[0])) {
+            break;
+          }
           // compare line content with command, excpet if cursorpos=0
           size_t i = shell->inputdata.cursorpos;
           if (shell->inputdata.cursorpos > 0) {
@@ -1025,12 +1096,15 @@ static aos_status_t _readChannel(aos_shell_t* shell, AosShellChannel* channel, s
 
 /**
  * @brief   Parses the content of the input buffer (line) to separate arguments.
+ * @details The arguments are not copied but point into the input buffer.
+ *          Only the first space after each argument is replaced by a NUL byte to terminate it.
  *
  * @param[in] shell   Pointer to the shell object.
+ * @param[in] length  Length of the input in the buffer.
  *
  * @return            Number of arguments found.
  */
-static size_t _parseArguments(aos_shell_t* shell)
+static size_t _parseArguments(aos_shell_t* shell, const size_t length)
 {
   aosDbgCheck(shell != NULL);
 
@@ -1049,15 +1123,17 @@ static size_t _parseArguments(aos_shell_t* shell)
   size_t arg = 0;
 
   // iterate through the line
-  for (char* c = shell->line; c < shell->line + shell->linesize; ++c) {
+  for (char* c = shell->line; c < shell->line + length; ++c) {
     // terminate at first NUL byte
     if (*c == '\0') {
       state = END;
       break;
     }
-    // spaces become NUL bytes
+    // the first space after an argument terminates it
     else if (*c == ' ') {
-      *c = '\0';
+      if (state == TEXT) {
+        *c = '\0';
+      }
       state = SPACE;
     }
     // handle non-NUL bytes
@@ -1113,6 +1189,9 @@ void aosShellInit(aos_shell_t* shell, event_source_t* oseventsource,  const char
   aosShellStreamInit(&shell->stream);
   shell->prompt = prompt;
   shell->commands = NULL;
+  for (size_t b = 0; b < AOS_SHELL_INDEXSIZE; ++b) {
+    shell->index[b] = NULL;
+  }
   shell->execstatus.command = NULL;
   shell->execstatus.retval = 0;
   shell->line = line;
@@ -1191,6 +1270,16 @@ aos_status_t aosShellAddCommand(aos_shell_t *shell, aos_shellcommand_t *cmd)
 
   aos_shellcommand_t* prev = NULL;
   aos_shellcommand_t** curr = &(shell->commands);
+  const size_t bucket = _indexBucket(cmd->name);
+
+  // error if the command already exists
+  if (_findCommand(shell, cmd->name) != NULL) {
+    return AOS_ERROR;
+  }
+
+  // add the command to the index
+  cmd->bucketnext = shell->index[bucket];
+  shell->index[bucket] = cmd;
 
   // insert the command to the list wrt lexographical order (exception: lower case characters preceed upper their uppercase counterparts)
   while (*curr != NULL) {
@@ -1201,10 +1290,6 @@ aos_status_t aosShellAddCommand(aos_shell_t *shell, aos_shellcommand_t *cmd)
       curr = &((*curr)->next);
       continue;
     }
-    // error if the command already exists
-    else if (cmp == 0) {
-      return AOS_ERROR;
-    }
     // insert the command as soon as a 'larger' name was found
     else /* if (cmpval > 0) */ {
       cmd->next = *curr;
@@ -1243,9 +1328,19 @@ aos_status_t aosShellRemoveCommand(aos_shell_t *shell, char *cmd, aos_shellcomma
   aos_shellcommand_t* prev = NULL;
   aos_shellcommand_t** curr = &(shell->commands);
 
+  // remove the command from the index
+  for (aos_shellcommand_t** entry = &(shell->index[_indexBucket(cmd)]); *entry != NULL; entry = &((*entry)->bucketnext)) {
+    if (strcmp((*entry)->name, cmd) == 0) {
+      aos_shellcommand_t* found = *entry;
+      *entry = found->bucketnext;
+      found->bucketnext = NULL;
+      break;
+    }
+  }
+
   // iterate through the list and seach for the specified command name
-  while (curr != NULL) {
-    const int cmpval = strcmp((*curr)->name, cmd);
+  while (*curr != NULL) {
+    const int cmpval = _strccmp((*curr)->name, cmd, true, NULL, NULL);
     // iterate through the list as long as the command names are 'smaller'
     if (cmpval < 0) {
       prev = *curr;
@@ -1489,31 +1584,26 @@ void aosShellThread(void* shell)
             // read input from channel
             readeval = _readChannel((aos_shell_t*)shell, channel, &nchars);
             // parse input line to argument list only if the input shall be executed
-            nargs = (readeval == AOS_SUCCESS && nchars > 0) ? _parseArguments((aos_shell_t*)shell) : 0;
+            nargs = (readeval == AOS_SUCCESS && nchars > 0) ? _parseArguments((aos_shell_t*)shell, ((aos_shell_t*)shell)->inputdata.lineend) : 0;
             // check number of arguments
             if (nargs > ((aos_shell_t*)shell)->arglistsize) {
               // error too many arguments
               chprintf((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, "\ttoo many arguments\n");
             } else if (nargs > 0) {
-              // search command list for arg[0] and execute callback
-              cmd = ((aos_shell_t*)shell)->commands;
-              while (cmd != NULL) {
-                if (strcmp(((aos_shell_t*)shell)->arglist[0], cmd->name) == 0) {
-                  ((aos_shell_t*)shell)->execstatus.command = cmd;
-                  chEvtBroadcastFlags(&(((aos_shell_t*)shell)->eventSource), AOS_SHELL_EVTFLAG_EXEC);
-                  ((aos_shell_t*)shell)->execstatus.retval = cmd->callback((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, nargs, ((aos_shell_t*)shell)->arglist);
-                  chEvtBroadcastFlags(&(((aos_shell_t*)shell)->eventSource), AOS_SHELL_EVTFLAG_DONE);
-                  // notify if the command was not successful
-                  if (((aos_shell_t*)shell)->execstatus.retval != 0) {
-                    chprintf((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, "command returned exit status %d\n", ((aos_shell_t*)shell)->execstatus.retval);
-                  }
-                  break;
+              // search command index for arg[0] and execute callback
+              cmd = _findCommand((aos_shell_t*)shell, ((aos_shell_t*)shell)->arglist[0]);
+              if (cmd != NULL) {
+                ((aos_shell_t*)shell)->execstatus.command = cmd;
+                chEvtBroadcastFlags(&(((aos_shell_t*)shell)->eventSource), AOS_SHELL_EVTFLAG_EXEC);
+                ((aos_shell_t*)shell)->execstatus.retval = cmd->callback((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, nargs, ((aos_shell_t*)shell)->arglist);
+                chEvtBroadcastFlags(&(((aos_shell_t*)shell)->eventSource), AOS_SHELL_EVTFLAG_DONE);
+                // notify if the command was not successful
+                if (((aos_shell_t*)shell)->execstatus.retval != 0) {
+                  chprintf((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, "command returned exit status %d\n", ((aos_shell_t*)shell)->execstatus.retval);
                 }
-                cmd = cmd->next;
-              } /* end of while */
-
+              }
               // if no matching command was found, print an error
-              if (cmd == NULL) {
+              else {
                 chprintf((BaseSequentialStream*)&((aos_shell_t*)shell)->stream, "%s: command not found\n", ((aos_shell_t*)shell)->arglist[0]);
               }
             }
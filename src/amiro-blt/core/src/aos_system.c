@@ -59,6 +59,9 @@ static void _printSystemInfo(BaseSequentialStream* stream);
 static int _shellcmd_configcb(BaseSequentialStream* stream, int argc, char* argv[]);
 static int _shellcmd_infocb(BaseSequentialStream* stream, int argc, char* argv[]);
 static int _shellcmd_shutdowncb(BaseSequentialStream* stream, int argc, char* argv[]);
+#if (AMIROOS_CFG_PROFILE == true)
+static int _shellcmd_profilecb(BaseSequentialStream* stream, int argc, char* argv[]);
+#endif
 #if (AMIROOS_CFG_TESTS_ENABLE == true)
 static int _shellcmd_kerneltestcb(BaseSequentialStream* stream, int argc, char* argv[]);
 #endif /* AMIROOS_CFG_TESTS_ENABLE == true */
@@ -149,6 +152,17 @@ static aos_shellcommand_t _shellcmd_shutdown = {
   /* callback */ _shellcmd_shutdowncb,
   /* next     */ NULL,
 };
+
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+/**
+ * @brief   Shell command to retrieve profiling information.
+ */
+static aos_shellcommand_t _shellcmd_profile = {
+  /* name     */ "aos:profile",
+  /* callback */ _shellcmd_profilecb,
+  /* next     */ NULL,
+};
+#endif /* AMIROOS_CFG_PROFILE == true */
 #endif /* AMIROOS_CFG_SHELL_ENABLE == true */
 
 #if (AMIROOS_CFG_TESTS_ENABLE == true) || defined(__DOXYGEN__)
@@ -606,6 +620,57 @@ static int _shellcmd_shutdowncb(BaseSequentialStream* stream, int argc, char* ar
 #endif /* AMIROOS_CFG_SSSP_ENABLE */
 }
 
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+/**
+ * @brief   Callback function for the aos:profile shell command.
+ *
+ * @param[in] stream    The I/O stream to use.
+ * @param[in] argc      Number of arguments.
+ * @param[in] argv      List of pointers to the arguments.
+ *
+ * @return              An exit status.
+ * @retval  AOS_OK                  The command was executed successfully.
+ * @retval  AOS_INVALID_ARGUMENTS   There was an issue with the arguments.
+ */
+static int _shellcmd_profilecb(BaseSequentialStream* stream, int argc, char* argv[])
+{
+  aosDbgCheck(stream != NULL);
+
+  if (argc == 1) {
+    aosProfilePrint(stream, false);
+    return AOS_OK;
+  }
+  else if (argc == 2 && (strcmp(argv[1], "-l") == 0 || strcmp(argv[1], "--latency") == 0)) {
+    aosProfilePrint(stream, true);
+    return AOS_OK;
+  }
+  else if (argc == 2 && (strcmp(argv[1], "-b") == 0 || strcmp(argv[1], "--binary") == 0)) {
+    aosProfileDump(stream);
+    return AOS_OK;
+  }
+  else if (argc == 2 && (strcmp(argv[1], "-r") == 0 || strcmp(argv[1], "--reset") == 0)) {
+    aosProfileReset();
+    return AOS_OK;
+  }
+  // print help text
+  else {
+    chprintf(stream, "Usage: %s [OPTION]\n", argv[0]);
+    chprintf(stream, "Prints CPU time within the last %ums, stack peak utilization and wakeup latency of all threads as well as idle time and wakeups of the system.\n", AOS_PROFILE_WINDOWSLOTS * AOS_PROFILE_SLOTPERIOD / MICROSECONDS_PER_MILLISECOND);
+    chprintf(stream, "Options:\n");
+    chprintf(stream, "  --help\n");
+    chprintf(stream, "    Print this help text.\n");
+    chprintf(stream, "  --latency, -l\n");
+    chprintf(stream, "    Print the wakeup latency histograms as well.\n");
+    chprintf(stream, "  --binary, -b\n");
+    chprintf(stream, "    Write a binary dump (see aos_profile.h) instead of text.\n");
+    chprintf(stream, "  --reset, -r\n");
+    chprintf(stream, "    Reset the wakeup latency statistics.\n");
+
+    return (strcmp(argv[1], "--help") == 0) ? AOS_OK : AOS_INVALID_ARGUMENTS;
+  }
+}
+#endif /* AMIROOS_CFG_PROFILE == true */
+
 #if (AMIROOS_CFG_TESTS_ENABLE == true) || defined(__DOXYGEN__)
 /**
  * @brief   Callback function for the kernel:test shell command.
@@ -769,6 +834,7 @@ void aosSysInit(void)
 
   /* set local variables */
   chVTObjectInit(&_systimer);
+  aosTimerWheelInit();
 #if (AMIROOS_CFG_SSSP_ENABLE == true)
   _synctime = 0;
   _uptime = 0;
@@ -796,6 +862,9 @@ void aosSysInit(void)
   aosIOStreamInit(&aos.iostream);
   chEvtObjectInit(&aos.events.io);
   chEvtObjectInit(&aos.events.os);
+#if (AMIROOS_CFG_PROFILE == true)
+  aosProfileInit();
+#endif
 
   /* interrupt setup */
 #if (AMIROOS_CFG_SSSP_ENABLE == true)
@@ -838,6 +907,9 @@ void aosSysInit(void)
   aosShellAddCommand(&aos.shell, &_shellcmd_config);
   aosShellAddCommand(&aos.shell, &_shellcmd_info);
   aosShellAddCommand(&aos.shell, &_shellcmd_shutdown);
+#if (AMIROOS_CFG_PROFILE == true)
+  aosShellAddCommand(&aos.shell, &_shellcmd_profile);
+#endif
 #if (AMIROOS_CFG_TESTS_ENABLE == true)
   aosShellAddCommand(&aos.shell, &_shellcmd_kerneltest);
 #endif
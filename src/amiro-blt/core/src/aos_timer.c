@@ -29,15 +29,264 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <aos_system.h>
 
+/**
+ * @brief   Number of slots per level of the timer wheel.
+ */
+#define AOS_TIMER_WHEEL_SLOTS         (1 << AOS_TIMER_WHEEL_SLOTBITS)
+
+/**
+ * @brief   Bit mask to extract a slot index.
+ */
+#define AOS_TIMER_WHEEL_SLOTMASK      (AOS_TIMER_WHEEL_SLOTS - 1)
+
+/**
+ * @brief   Number of wakeup time bits covered by the wheel levels.
+ */
+#define AOS_TIMER_WHEEL_SPANBITS      (AOS_TIMER_WHEEL_SLOTBITS * AOS_TIMER_WHEEL_LEVELS)
+
+#if (AOS_TIMER_WHEEL_SLOTBITS < 1) || (AOS_TIMER_WHEEL_SLOTBITS > 5)
+#error "AOS_TIMER_WHEEL_SLOTBITS must be in the range [1, 5]"
+#endif
+#if (AOS_TIMER_WHEEL_LEVELS < 1) || (AOS_TIMER_WHEEL_SPANBITS >= 64)
+#error "AOS_TIMER_WHEEL_LEVELS must be at least 1 and cover less than 64 bits"
+#endif
+
+/**
+ * @brief   Hierarchical timer wheel.
+ * @details All timers share a single kernel virtual timer.
+ *          A timer is stored at the level of the most significant group of AOS_TIMER_WHEEL_SLOTBITS bits in which its wakeup time differs from @p now, in the slot selected by that group.
+ *          Hence, all timers of the lowest occupied level expire before any timer of a higher level and the earliest slot of that level is found via its bitmap.
+ *          When the time of a slot is reached, its timers either fire or cascade down to a lower level.
+ *          Inserting and cancelling a timer are O(1), regardless of how many timers are armed.
+ */
+static struct {
+  /**
+   * @brief   Kernel virtual timer that drives the wheel.
+   */
+  virtual_timer_t vt;
+
+  /**
+   * @brief   Time the wheel has been advanced to.
+   * @details Never exceeds the system uptime.
+   */
+  aos_timestamp_t now;
+
+  /**
+   * @brief   Time of the event the virtual timer is armed for.
+   */
+  aos_timestamp_t event;
+
+  /**
+   * @brief   Lists of timers per level and slot.
+   */
+  aos_timer_t* slots[AOS_TIMER_WHEEL_LEVELS][AOS_TIMER_WHEEL_SLOTS];
+
+  /**
+   * @brief   Bitmaps of the occupied slots per level.
+   */
+  uint32_t bitmap[AOS_TIMER_WHEEL_LEVELS];
+
+  /**
+   * @brief   List of timers that are too far in the future for the wheel.
+   */
+  aos_timer_t* overflow;
+
+  /**
+   * @brief   Flag whether the wheel is being processed.
+   * @details The virtual timer is not rearmed while this flag is set.
+   */
+  bool processing;
+} _wheel;
+
 /*
  * Forward declarations.
  */
 static inline void _setupTimer(aos_timer_t* timer);
 static inline void _setupPeriodicTimer(aos_periodictimer_t* ptimer);
-static void _intermediateCb(void* timer);
-static void _fireCb(void* timer);
+static void _wheelCb(void* par);
 static void _periodicCb(void* ptimer);
 
+/**
+ * @brief   Check whether the timer wheel holds any timers.
+ *
+ * @return  True if no timer is armed.
+ */
+static inline bool _wheelIsEmpty(void)
+{
+  for (size_t level = 0; level < AOS_TIMER_WHEEL_LEVELS; ++level) {
+    if (_wheel.bitmap[level] != 0) {
+      return false;
+    }
+  }
+  return (_wheel.overflow == NULL);
+}
+
+/**
+ * @brief   Push a timer to the front of a list.
+ *
+ * @param[in] head    Pointer to the head of the list.
+ * @param[in] timer   Pointer to the timer to push.
+ */
+static inline void _listPush(aos_timer_t** head, aos_timer_t* timer)
+{
+  timer->next = *head;
+  if (timer->next != NULL) {
+    timer->next->pprev = &(timer->next);
+  }
+  timer->pprev = head;
+  *head = timer;
+
+  return;
+}
+
+/**
+ * @brief   Remove a timer from whatever list it is in.
+ * @details If the timer was the last one in a slot of the wheel, the according bitmap bit is cleared.
+ *
+ * @param[in] timer   Pointer to the timer to remove.
+ */
+static inline void _listRemove(aos_timer_t* timer)
+{
+  aos_timer_t** const pprev = timer->pprev;
+
+  *pprev = timer->next;
+  if (timer->next != NULL) {
+    timer->next->pprev = pprev;
+  }
+  // the timer was the last one of a slot
+  if (*pprev == NULL &&
+      pprev >= &(_wheel.slots[0][0]) &&
+      pprev <= &(_wheel.slots[AOS_TIMER_WHEEL_LEVELS-1][AOS_TIMER_WHEEL_SLOTMASK])) {
+    const size_t idx = (size_t)(pprev - &(_wheel.slots[0][0]));
+    _wheel.bitmap[idx / AOS_TIMER_WHEEL_SLOTS] &= ~((uint32_t)1 << (idx % AOS_TIMER_WHEEL_SLOTS));
+  }
+  timer->next = NULL;
+  timer->pprev = NULL;
+
+  return;
+}
+
+/**
+ * @brief   Insert a timer into the wheel.
+ * @note    The wakeup time of the timer must be later than the current wheel time.
+ *
+ * @param[in] timer   Pointer to the timer to insert.
+ */
+static inline void _wheelInsert(aos_timer_t* timer)
+{
+  const aos_timestamp_t diff = timer->wkuptime ^ _wheel.now;
+  const unsigned int level = (unsigned int)(63 - __builtin_clzll(diff)) / AOS_TIMER_WHEEL_SLOTBITS;
+
+  if (level < AOS_TIMER_WHEEL_LEVELS) {
+    const unsigned int slot = (unsigned int)(timer->wkuptime >> (AOS_TIMER_WHEEL_SLOTBITS * level)) & AOS_TIMER_WHEEL_SLOTMASK;
+    _listPush(&(_wheel.slots[level][slot]), timer);
+    _wheel.bitmap[level] |= (uint32_t)1 << slot;
+  } else {
+    _listPush(&(_wheel.overflow), timer);
+  }
+
+  return;
+}
+
+/**
+ * @brief   Retrieve the time of the next wheel event.
+ * @details This is either the time of the earliest occupied slot or, if only the overflow list holds timers, the next time the whole wheel wraps around.
+ *
+ * @param[out] event  Time of the next event.
+ * @param[out] level  Level of the next event (AOS_TIMER_WHEEL_LEVELS for the overflow list).
+ * @param[out] slot   Slot of the next event.
+ *
+ * @return  False if no timer is armed.
+ */
+static inline bool _wheelNextEvent(aos_timestamp_t* event, unsigned int* level, unsigned int* slot)
+{
+  for (unsigned int l = 0; l < AOS_TIMER_WHEEL_LEVELS; ++l) {
+    if (_wheel.bitmap[l] != 0) {
+      const unsigned int shift = AOS_TIMER_WHEEL_SLOTBITS * l;
+      *level = l;
+      *slot = (unsigned int)__builtin_ctz(_wheel.bitmap[l]);
+      *event = (_wheel.now & ~(((aos_timestamp_t)1 << (shift + AOS_TIMER_WHEEL_SLOTBITS)) - 1)) | ((aos_timestamp_t)*slot << shift);
+      return true;
+    }
+  }
+  if (_wheel.overflow != NULL) {
+    *level = AOS_TIMER_WHEEL_LEVELS;
+    *slot = 0;
+    *event = (_wheel.now | (((aos_timestamp_t)1 << AOS_TIMER_WHEEL_SPANBITS) - 1)) + 1;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief   Retrieve the earliest wakeup time of the timers in a slot of the wheel.
+ *
+ * @param[in] level   Level of the slot.
+ * @param[in] slot    Index of the slot.
+ *
+ * @return  Earliest wakeup time.
+ */
+static inline aos_timestamp_t _wheelSlotMin(unsigned int level, unsigned int slot)
+{
+  aos_timer_t* timer = _wheel.slots[level][slot];
+  aos_timestamp_t min = timer->wkuptime;
+
+  for (timer = timer->next; timer != NULL; timer = timer->next) {
+    if (timer->wkuptime < min) {
+      min = timer->wkuptime;
+    }
+  }
+
+  return min;
+}
+
+/**
+ * @brief   Arm the virtual timer of the wheel for the next event.
+ * @details The timer is armed for the earliest wakeup time in the next slot rather than for the start of the slot.
+ *          Above level 0 the start of a slot would mostly just cascade its timers and wake up the system for nothing.
+ *          Since the earliest slot of the lowest occupied level holds the earliest timer, no other timer is missed.
+ *          Intervals that exceed the range of the virtual timer are split.
+ *
+ * @param[in] uptime  Current system uptime.
+ */
+static inline void _wheelArm(aos_timestamp_t uptime)
+{
+  aos_timestamp_t event;
+  unsigned int level, slot;
+
+  if (!_wheelNextEvent(&event, &level, &slot)) {
+    if (chVTIsArmedI(&(_wheel.vt))) {
+      chVTResetI(&(_wheel.vt));
+    }
+    return;
+  }
+
+  // the virtual timer will fire early enough already, no timer of the slot wakes up before its start
+  if (chVTIsArmedI(&(_wheel.vt)) && _wheel.event <= event) {
+    return;
+  }
+  if (level > 0 && level < AOS_TIMER_WHEEL_LEVELS) {
+    event = _wheelSlotMin(level, slot);
+  }
+  if (chVTIsArmedI(&(_wheel.vt))) {
+    if (_wheel.event <= event) {
+      return;
+    }
+    chVTResetI(&(_wheel.vt));
+  }
+
+  _wheel.event = event;
+  if (event <= uptime) {
+    chVTSetI(&(_wheel.vt), TIME_IMMEDIATE + 1, _wheelCb, NULL);
+  } else if ((event - uptime) > AOS_TIMER_MAX_INTERVAL_US) {
+    chVTSetI(&(_wheel.vt), chTimeUS2I(AOS_TIMER_MAX_INTERVAL_US), _wheelCb, NULL);
+  } else {
+    chVTSetI(&(_wheel.vt), chTimeUS2I(event - uptime), _wheelCb, NULL);
+  }
+
+  return;
+}
+
 /**
  * @brief   Setup a timer according to its configuration.
  *
@@ -47,16 +296,23 @@ static inline void _setupTimer(aos_timer_t* timer)
 {
   aos_timestamp_t uptime;
 
+  // a timer that is set again is moved
+  if (timer->pprev != NULL) {
+    _listRemove(timer);
+  }
+
   // get current system uptime
   aosSysGetUptimeX(&uptime);
 
   // if the wakeup time is more than TIME_IMMEDIATE in the future
   if ( (timer->wkuptime > uptime) && ((timer->wkuptime - uptime) > TIME_IMMEDIATE) ) {
-    // split the time delta if necessary
-    if ((timer->wkuptime - uptime) > AOS_TIMER_MAX_INTERVAL_US) {
-      chVTSetI(&(timer->vt), chTimeUS2I(AOS_TIMER_MAX_INTERVAL_US), _intermediateCb, timer);
-    } else {
-      chVTSetI(&(timer->vt), chTimeUS2I(timer->wkuptime - uptime), _fireCb, timer);
+    // an empty wheel can be advanced freely
+    if (_wheelIsEmpty()) {
+      _wheel.now = uptime;
+    }
+    _wheelInsert(timer);
+    if (!_wheel.processing) {
+      _wheelArm(uptime);
     }
   } else {
     vtfunc_t fn = timer->callback;
@@ -98,28 +354,61 @@ static inline void _setupPeriodicTimer(aos_periodictimer_t *ptimer)
 }
 
 /**
- * @brief   Callback function for intermediate interrupts.
- * @details This is required if the desired time to fire is too far in the future so that the interval must be split.
+ * @brief   Callback function of the virtual timer that drives the wheel.
+ * @details All slots whose time has been reached are processed.
+ *          Timers that are due fire, all others cascade down to a lower level.
  *
- * @param[in] timer   Pointer to a aos_timer_t to reactivate.
+ * @param[in] par     Unused.
  */
-static void _intermediateCb(void* timer)
+static void _wheelCb(void* par)
 {
-  chSysLockFromISR();
-  _setupTimer((aos_timer_t*)timer);
-  chSysUnlockFromISR();
-}
+  (void)par;
+
+  aos_timestamp_t uptime;
+  aos_timestamp_t event;
+  unsigned int level, slot;
+  aos_timer_t* list;
+  aos_timer_t* timer;
 
-/**
- * @brief   Callback function for the final fire event of the timer.
- *
- * @param[in] timer   Pointer to a aos_timer_t to call its callback.
- */
-static void _fireCb(void *timer)
-{
   chSysLockFromISR();
-  ((aos_timer_t*)timer)->callback(((aos_timer_t*)timer)->cbparam);
+  _wheel.processing = true;
+  aosSysGetUptimeX(&uptime);
+
+  while (_wheelNextEvent(&event, &level, &slot) && event <= uptime) {
+    // advance the wheel and detach the list of the slot
+    _wheel.now = event;
+    if (level < AOS_TIMER_WHEEL_LEVELS) {
+      list = _wheel.slots[level][slot];
+      _wheel.slots[level][slot] = NULL;
+      _wheel.bitmap[level] &= ~((uint32_t)1 << slot);
+    } else {
+      list = _wheel.overflow;
+      _wheel.overflow = NULL;
+    }
+    // the detached list may be modified by the callbacks
+    if (list != NULL) {
+      list->pprev = &list;
+    }
+
+    while (list != NULL) {
+      timer = list;
+      _listRemove(timer);
+      if (timer->wkuptime <= _wheel.now) {
+        timer->callback(timer->cbparam);
+      } else {
+        _wheelInsert(timer);
+      }
+    }
+
+    // callbacks may take a while
+    aosSysGetUptimeX(&uptime);
+  }
+
+  _wheel.processing = false;
+  _wheelArm(uptime);
   chSysUnlockFromISR();
+
+  return;
 }
 
 /**
@@ -134,6 +423,27 @@ static void _periodicCb(void* ptimer)
   _setupPeriodicTimer((aos_periodictimer_t*)ptimer);
 }
 
+/**
+ * @brief   Initialize the timer wheel.
+ * @note    Must be called once before any timer is set.
+ */
+void aosTimerWheelInit(void)
+{
+  chVTObjectInit(&(_wheel.vt));
+  _wheel.now = 0;
+  _wheel.event = 0;
+  for (size_t level = 0; level < AOS_TIMER_WHEEL_LEVELS; ++level) {
+    for (size_t slot = 0; slot < AOS_TIMER_WHEEL_SLOTS; ++slot) {
+      _wheel.slots[level][slot] = NULL;
+    }
+    _wheel.bitmap[level] = 0;
+  }
+  _wheel.overflow = NULL;
+  _wheel.processing = false;
+
+  return;
+}
+
 /**
  * @brief   Initialize a aos_timer_t object.
  *
@@ -143,7 +453,8 @@ void aosTimerInit(aos_timer_t* timer)
 {
   aosDbgAssert(timer != NULL);
 
-  chVTObjectInit(&(timer->vt));
+  timer->next = NULL;
+  timer->pprev = NULL;
   timer->wkuptime = 0;
   timer->callback = NULL;
   timer->cbparam = NULL;
@@ -293,4 +604,21 @@ void aosPeriodicTimerSetLongI(aos_periodictimer_t* ptimer, aos_longinterval_t* i
   return;
 }
 
+/**
+ * @brief   Reset a timer.
+ * @details The timer is removed from the wheel in constant time.
+ *
+ * @param[in] timer   Pointer to the timer to reset.
+ */
+void aosTimerResetI(aos_timer_t* timer)
+{
+  aosDbgCheck(timer != NULL);
+
+  if (timer->pprev != NULL) {
+    _listRemove(timer);
+  }
+
+  return;
+}
+
 /** @} */
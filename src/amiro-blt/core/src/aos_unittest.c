@@ -116,6 +116,7 @@ void aosUtObjectInit(aos_unittest_t* ut, char* name, char* info, aos_utfunction_
   ut->shellcmd.name = shellname;
   ut->shellcmd.callback = shellcb;
   ut->shellcmd.next = NULL;
+  ut->shellcmd.bucketnext = NULL;
   ut->data = data;
 
   return;
@@ -132,6 +132,12 @@
  */
 #define CORTEX_VTOR_INIT 0x00006000U
 
+/**
+ * @brief   Enables the use of the WFI instruction in the idle thread loop.
+ * @note    See the port specific settings in aos_chconf.h.
+ */
+#define CORTEX_ENABLE_WFI_IDLE              TRUE
+
 /** @} */
 
 /*===========================================================================*/
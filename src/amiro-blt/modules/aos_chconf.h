@@ -164,8 +164,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * @details If enabled then the registry APIs are included in the kernel.
  *
  * @note    The default is @p TRUE.
+ * @note    The registry is required for thread names in the profiler output.
  */
-#define CH_CFG_USE_REGISTRY                 FALSE
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+  #define CH_CFG_USE_REGISTRY               TRUE
+#else
+  #define CH_CFG_USE_REGISTRY               FALSE
+#endif
 
 /**
  * @brief   Thread hierarchy APIs.
@@ -436,12 +441,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          at runtime.
  *
  * @note    The default is @p FALSE.
+ * @note    Projects may define it before including this file.
  */
+#if !defined(CH_DBG_SYSTEM_STATE_CHECK)
 #if (AMIROOS_CFG_DBG == true) || defined(__DOXYGEN__)
   #define CH_DBG_SYSTEM_STATE_CHECK         TRUE
 #else
   #define CH_DBG_SYSTEM_STATE_CHECK         FALSE
 #endif
+#endif
 
 /**
  * @brief   Debug option, parameters checks.
@@ -449,12 +457,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          parameters are activated.
  *
  * @note    The default is @p FALSE.
+ * @note    Projects may define it before including this file.
  */
+#if !defined(CH_DBG_ENABLE_CHECKS)
 #if (AMIROOS_CFG_DBG == true) || defined(__DOXYGEN__)
   #define CH_DBG_ENABLE_CHECKS              TRUE
 #else
   #define CH_DBG_ENABLE_CHECKS              FALSE
 #endif
+#endif
 
 /**
  * @brief   Debug option, consistency checks.
@@ -463,12 +474,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          runtime anomalies and port-defined checks.
  *
  * @note    The default is @p FALSE.
+ * @note    Projects may define it before including this file.
  */
+#if !defined(CH_DBG_ENABLE_ASSERTS)
 #if (AMIROOS_CFG_DBG == true) || defined(__DOXYGEN__)
   #define CH_DBG_ENABLE_ASSERTS             TRUE
 #else
   #define CH_DBG_ENABLE_ASSERTS             FALSE
 #endif
+#endif
 
 /**
  * @brief   Debug option, trace buffer.
@@ -521,14 +535,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          counts the system ticks occurred while executing the thread.
  *
  * @note    The default is @p FALSE.
- * @note    This debug option is not currently compatible with the
- *          tickless mode.
+ * @note    This debug option is not compatible with the tickless mode.
+ *          AMiRo-OS uses the cycle counter based accounting of aos_profile.c
+ *          instead, which works with and without a periodic tick.
  */
-#if ((CH_CFG_ST_TIMEDELTA == 0) && (AMIROOS_CFG_PROFILE == true)) || defined(__DOXYGEN__)
-  #define CH_DBG_THREADS_PROFILING          TRUE
-#else
-  #define CH_DBG_THREADS_PROFILING          FALSE
-#endif
+#define CH_DBG_THREADS_PROFILING            FALSE
 
 /** @} */
 
@@ -559,8 +570,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * @brief   Threads descriptor structure extension.
  * @details User fields added to the end of the @p thread_t structure.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_THREAD_EXTRA_FIELDS                                          \
+  /* Profiling data (see aos_profile.h).*/                                  \
+  struct aos_profile_thread* profile;
+#else
 #define CH_CFG_THREAD_EXTRA_FIELDS                                          \
   /* Add threads custom fields here.*/
+#endif
 
 /**
  * @brief   Threads initialization hook.
@@ -569,39 +586,74 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * @note    It is invoked from within @p _thread_init() and implicitly from all
  *          the threads creation APIs.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_THREAD_INIT_HOOK(tp) {                                       \
+  extern void aosProfileThreadInitHook(thread_t* tp);                       \
+  aosProfileThreadInitHook(tp);                                             \
+}
+#else
 #define CH_CFG_THREAD_INIT_HOOK(tp) {                                       \
   /* Add threads initialization code here.*/                                \
 }
+#endif
 
 /**
  * @brief   Threads finalization hook.
  * @details User finalization code added to the @p chThdExit() API.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_THREAD_EXIT_HOOK(tp) {                                       \
+  extern void aosProfileThreadExitHook(thread_t* tp);                       \
+  aosProfileThreadExitHook(tp);                                             \
+}
+#else
 #define CH_CFG_THREAD_EXIT_HOOK(tp) {                                       \
   /* Add threads finalization code here.*/                                  \
 }
+#endif
 
 /**
  * @brief   Context switch hook.
  * @details This hook is invoked just before switching between threads.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
+  extern void aosProfileContextSwitchHook(thread_t* ntp, thread_t* otp);    \
+  aosProfileContextSwitchHook(ntp, otp);                                    \
+}
+#else
 #define CH_CFG_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
   /* Context switch code here.*/                                            \
 }
+#endif
 
 /**
  * @brief   ISR enter hook.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_IRQ_PROLOGUE_HOOK() {                                        \
+  extern void aosProfileIrqPrologueHook(void);                              \
+  aosProfileIrqPrologueHook();                                              \
+}
+#else
 #define CH_CFG_IRQ_PROLOGUE_HOOK() {                                        \
   /* IRQ prologue code here.*/                                              \
 }
+#endif
 
 /**
  * @brief   ISR exit hook.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_IRQ_EPILOGUE_HOOK() {                                        \
+  extern void aosProfileIrqEpilogueHook(void);                              \
+  aosProfileIrqEpilogueHook();                                              \
+}
+#else
 #define CH_CFG_IRQ_EPILOGUE_HOOK() {                                        \
   /* IRQ epilogue code here.*/                                              \
 }
+#endif
 
 /**
  * @brief   Idle thread enter hook.
@@ -609,9 +661,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          should be invoked from here.
  * @note    This macro can be used to activate a power saving mode.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_IDLE_ENTER_HOOK() {                                          \
+  extern void aosProfileIdleEnterHook(void);                                \
+  aosProfileIdleEnterHook();                                                \
+}
+#else
 #define CH_CFG_IDLE_ENTER_HOOK() {                                          \
   /* Idle-enter code here.*/                                                \
 }
+#endif
 
 /**
  * @brief   Idle thread leave hook.
@@ -619,9 +678,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *          should be invoked from here.
  * @note    This macro can be used to deactivate a power saving mode.
  */
+#if (AMIROOS_CFG_PROFILE == true) || defined(__DOXYGEN__)
+#define CH_CFG_IDLE_LEAVE_HOOK() {                                          \
+  extern void aosProfileIdleLeaveHook(void);                                \
+  aosProfileIdleLeaveHook();                                                \
+}
+#else
 #define CH_CFG_IDLE_LEAVE_HOOK() {                                          \
   /* Idle-leave code here.*/                                                \
 }
+#endif
 
 /**
  * @brief   Idle Loop hook.
@@ -668,6 +734,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 /*===========================================================================*/
 
 // These settings are specific to each module.
+// All modules enable CORTEX_ENABLE_WFI_IDLE: with the tick-less system timer (CH_CFG_ST_TIMEDELTA) the core then
+// sleeps until the next interrupt instead of spinning in the idle thread.
 
 /*===========================================================================*/
 /**
@@ -0,0 +1,47 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    aos_system.h
+ * @brief   Minimal replacement of the system module for the timer benchmark.
+ * @details The benchmark links aos_timer.c without the rest of AMiRo-OS.
+ *          The uptime is the simulated time of the host port.
+ */
+
+#ifndef _AMIROOS_SYSTEM_H_
+#define _AMIROOS_SYSTEM_H_
+
+#include <ch.h>
+#include <aos_time.h>
+
+#define aosDbgCheck(c)        chDbgCheck(c)
+#define aosDbgAssert(c)       chDbgAssert(c, __func__)
+
+/**
+ * @brief   Retrieves the system uptime.
+ *
+ * @param[out] ut   Pointer to the system uptime.
+ */
+static inline void aosSysGetUptimeX(aos_timestamp_t* ut)
+{
+  *ut = (aos_timestamp_t)port_sim_get_time() * MICROSECONDS_PER_SECOND / CH_CFG_ST_FREQUENCY;
+
+  return;
+}
+
+#endif /* _AMIROOS_SYSTEM_H_ */
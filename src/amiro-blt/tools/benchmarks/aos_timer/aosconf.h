@@ -0,0 +1,37 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/**
+ * @file    aosconf.h
+ * @brief   AMiRo-OS configuration of the timer benchmark.
+ * @details Only the settings used by the kernel configuration (aos_chconf.h) are required.
+ */
+
+#ifndef _AOSCONF_H_
+#define _AOSCONF_H_
+
+#define _AMIRO_OS_CFG_
+
+#include <stdbool.h>
+
+#define AMIROOS_CFG_DBG                         false
+
+#define AMIROOS_CFG_PROFILE                     false
+
+#endif /* _AOSCONF_H_ */
@@ -0,0 +1,194 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    main.c
+ * @brief   Benchmark of aos_timer.c on the host port with simulated time.
+ * @details Only the public API of aos_timer is used, so the benchmark is built for the current implementation (timer
+ *          wheel) as well as for a former one, which armed one kernel virtual timer per aos timer (see readme.txt).
+ *          For an increasing number of timers the benchmark measures
+ *            - the average time to arm and to cancel a timer with a long interval and
+ *            - the CPU time and the number of system timer interrupts while periodic timers with random periods run
+ *              for two seconds of simulated time.
+ */
+
+#include <ch.h>
+#include <aos_timer.h>
+#include <aos_system.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief   Maximum number of timers per run.
+ */
+#define BENCH_MAXTIMERS               1024
+
+/**
+ * @brief   Number of repetitions of the arm and cancel measurement.
+ */
+#define BENCH_ARMROUNDS               64
+
+/**
+ * @brief   Duration of a periodic run in milliseconds of simulated time.
+ */
+#define BENCH_RUNTIME                 2000
+
+static aos_timer_t _timers[BENCH_MAXTIMERS];
+static aos_periodictimer_t _ptimers[BENCH_MAXTIMERS];
+static aos_longinterval_t _intervals[BENCH_MAXTIMERS];
+static volatile uint32_t _fired;
+static volatile uint32_t _late;
+static volatile aos_interval_t _maxLateness;
+
+/**
+ * @brief   Callback of the timers.
+ * @details Counts the events that did not fire exactly at their wakeup time and tracks the maximum delay.
+ *
+ * @param[in] par   Pointer to the periodic timer, NULL for one-shot timers.
+ */
+static void _aosCb(void* par)
+{
+  aos_timestamp_t uptime;
+
+  ++_fired;
+  if (par != NULL) {
+    aosSysGetUptimeX(&uptime);
+    const aos_interval_t lateness = (aos_interval_t)(uptime - ((aos_periodictimer_t*)par)->timer.wkuptime);
+    if (lateness > 0) {
+      ++_late;
+      if (lateness > _maxLateness) {
+        _maxLateness = lateness;
+      }
+    }
+  }
+
+  return;
+}
+
+/**
+ * @brief   Current time of the given clock in nanoseconds.
+ */
+static uint64_t _nanoseconds(clockid_t clock)
+{
+  struct timespec ts;
+
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Measure arming and cancelling of n timers with long intervals.
+ * @details The simulated time does not advance meanwhile, so no timer fires.
+ */
+static void _benchArm(size_t n)
+{
+  uint64_t armTime = 0;
+  uint64_t cancelTime = 0;
+
+  // intervals between one second and two hours
+  for (size_t i = 0; i < n; ++i) {
+    _intervals[i] = 1000000 + ((aos_longinterval_t)rand() % 7199000000ULL);
+  }
+
+  chSysLock();
+  for (size_t round = 0; round < BENCH_ARMROUNDS; ++round) {
+    const uint64_t t0 = _nanoseconds(CLOCK_MONOTONIC);
+    for (size_t i = 0; i < n; ++i) {
+      aosTimerSetLongIntervalI(&_timers[i], &_intervals[i], _aosCb, NULL);
+    }
+    const uint64_t t1 = _nanoseconds(CLOCK_MONOTONIC);
+    for (size_t i = 0; i < n; ++i) {
+      aosTimerResetI(&_timers[i]);
+    }
+    const uint64_t t2 = _nanoseconds(CLOCK_MONOTONIC);
+    armTime += t1 - t0;
+    cancelTime += t2 - t1;
+  }
+  chSysUnlock();
+
+  printf("%5u timers | arm: %8.1f ns | cancel: %8.1f ns\n",
+         (unsigned int)n,
+         (double)armTime / (n * BENCH_ARMROUNDS),
+         (double)cancelTime / (n * BENCH_ARMROUNDS));
+
+  return;
+}
+
+/**
+ * @brief   Measure the CPU time and the interrupts while n periodic timers run.
+ */
+static void _benchRun(size_t n)
+{
+  // periods between 5ms and 500ms
+  for (size_t i = 0; i < n; ++i) {
+    _intervals[i] = 5000 + ((aos_longinterval_t)rand() % 495000);
+  }
+
+  _fired = 0;
+  _late = 0;
+  _maxLateness = 0;
+  const uint64_t irq0 = port_sim_get_interrupts();
+  const uint64_t t0 = _nanoseconds(CLOCK_PROCESS_CPUTIME_ID);
+  chSysLock();
+  for (size_t i = 0; i < n; ++i) {
+    aosPeriodicTimerSetLongI(&_ptimers[i], &_intervals[i], _aosCb, &_ptimers[i]);
+  }
+  chSysUnlock();
+  chThdSleepMilliseconds(BENCH_RUNTIME);
+  chSysLock();
+  for (size_t i = 0; i < n; ++i) {
+    aosTimerResetI(&(_ptimers[i].timer));
+  }
+  chSysUnlock();
+  const uint64_t t1 = _nanoseconds(CLOCK_PROCESS_CPUTIME_ID);
+  const uint64_t irqs = port_sim_get_interrupts() - irq0;
+
+  printf("%5u timers | run: %8.3f ms CPU | %6u events (%5u late, max %3u us) | %6u interrupts | %8.1f ns/event\n",
+         (unsigned int)n,
+         (double)(t1 - t0) / 1000000, (unsigned int)_fired, (unsigned int)_late, (unsigned int)_maxLateness, (unsigned int)irqs,
+         (double)(t1 - t0) / _fired);
+
+  return;
+}
+
+/**
+ * @brief   Application entry point.
+ */
+int main(void)
+{
+  chSysInit();
+
+#if !defined(BENCH_LEGACY)
+  aosTimerWheelInit();
+#endif
+  for (size_t i = 0; i < BENCH_MAXTIMERS; ++i) {
+    aosTimerInit(&_timers[i]);
+    aosPeriodicTimerInit(&_ptimers[i]);
+  }
+  srand(1);
+
+  for (size_t n = 16; n <= BENCH_MAXTIMERS; n *= 4) {
+    _benchArm(n);
+  }
+  for (size_t n = 16; n <= BENCH_MAXTIMERS; n *= 4) {
+    _benchRun(n);
+  }
+
+  return 0;
+}
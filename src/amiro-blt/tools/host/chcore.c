@@ -0,0 +1,267 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chcore.c
+ * @brief   ChibiOS/RT port for x86-64 Linux hosts with simulated time.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+bool port_isr_context_flag;
+syssts_t port_irq_sts;
+
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Base of the main thread stack for the stack check.
+ * @details The main thread runs on the stack of the process, which is guarded by the host. Since the stack lies above
+ *          any static data, the check never fails for the main thread.
+ */
+stkalign_t __main_thread_stack_base__;
+#endif
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated time in system ticks.
+ */
+static uint64_t _time;
+
+/**
+ * @brief   Simulated time of the alarm, valid if @p _alarmArmed is set.
+ */
+static uint64_t _alarm;
+
+static bool _alarmArmed;
+
+/**
+ * @brief   Number of handled system timer interrupts.
+ */
+static uint64_t _interrupts;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * void _port_switch(struct port_intctx** nsp, struct port_intctx** osp)
+ * Saves the callee-saved registers on the stack of the old thread and restores them from the stack of the new one.
+ *
+ * void _port_thread_trampoline(void)
+ * Entry of a new thread, see PORT_SETUP_CONTEXT().
+ */
+__asm__ (
+    ".text                                              \n\t"
+    ".globl _port_switch                                \n\t"
+    ".type  _port_switch, @function                     \n\t"
+    "_port_switch:                                      \n\t"
+    "push   %rbp                                        \n\t"
+    "push   %rbx                                        \n\t"
+    "push   %r12                                        \n\t"
+    "push   %r13                                        \n\t"
+    "push   %r14                                        \n\t"
+    "push   %r15                                        \n\t"
+    "mov    %rsp, (%rsi)                                \n\t"
+    "mov    (%rdi), %rsp                                \n\t"
+    "pop    %r15                                        \n\t"
+    "pop    %r14                                        \n\t"
+    "pop    %r13                                        \n\t"
+    "pop    %r12                                        \n\t"
+    "pop    %rbx                                        \n\t"
+    "pop    %rbp                                        \n\t"
+    "ret                                                \n\t"
+    ".globl _port_thread_trampoline                     \n\t"
+    ".type  _port_thread_trampoline, @function          \n\t"
+    "_port_thread_trampoline:                           \n\t"
+    "mov    %r12, %rdi                                  \n\t"
+    "mov    %r13, %rsi                                  \n\t"
+    "call   _port_thread_start                          \n\t"
+    "hlt                                                \n\t"
+);
+
+void _port_switch(struct port_intctx** nsp, struct port_intctx** osp);
+
+/**
+ * @brief   Converts a system time to the simulated time.
+ * @details The system time is the lower part of the simulated time, so the result is the next point in time with the
+ *          given system time.
+ */
+static uint64_t _toSimTime(systime_t time)
+{
+  return _time + (systime_t)(time - (systime_t)_time);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Performs a context switch between two threads.
+ *
+ * @param[in] ntp   The thread to be switched in.
+ * @param[in] otp   The thread to be switched out.
+ */
+void port_switch(thread_t* ntp, thread_t* otp)
+{
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE)
+  // the context of the old thread is pushed below the current frame
+  if ((stkalign_t*)((struct port_intctx*)__builtin_frame_address(0) - 1) < otp->wabase) {
+    chSysHalt("stack overflow");
+  }
+#endif
+
+  _port_switch(&ntp->ctx.sp, &otp->ctx.sp);
+}
+
+/**
+ * @brief   Start a thread by invoking its work function.
+ * @details If the work function returns @p chThdExit() is automatically invoked.
+ */
+void _port_thread_start(msg_t (*pf)(void*), void* p)
+{
+  chSysUnlock();
+  pf(p);
+  chThdExit(0);
+  while (true);
+}
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @details The counter runs in real time with a resolution of one nanosecond, so it measures computation times.
+ */
+rtcnt_t port_rt_get_counter_value(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (rtcnt_t)((uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec);
+}
+
+/**
+ * @brief   Called by the idle thread, i.e. when all other threads sleep.
+ * @details Advances the simulated time to the alarm and handles it as an interrupt of the system timer.
+ *          Without an alarm no thread can ever run again and the process is terminated.
+ */
+void port_wait_for_interrupt(void)
+{
+  if (!_alarmArmed) {
+    fprintf(stderr, "all threads sleep forever at %llu ticks\n", (unsigned long long)_time);
+    exit(EXIT_FAILURE);
+  }
+
+  _time = _alarm;
+  ++_interrupts;
+
+  CH_IRQ_PROLOGUE();
+
+  chSysLockFromISR();
+  chSysTimerHandlerI();
+  chSysUnlockFromISR();
+
+  CH_IRQ_EPILOGUE();
+
+  _dbg_check_lock();
+  if (chSchIsPreemptionRequired()) {
+    chSchDoReschedule();
+  }
+  _dbg_check_unlock();
+}
+
+/**
+ * @brief   Starts the alarm of the system timer.
+ */
+void port_timer_start_alarm(systime_t time)
+{
+  _alarm = _toSimTime(time);
+  _alarmArmed = true;
+}
+
+/**
+ * @brief   Stops the alarm of the system timer.
+ */
+void port_timer_stop_alarm(void)
+{
+  _alarmArmed = false;
+}
+
+/**
+ * @brief   Changes the alarm of the system timer.
+ */
+void port_timer_set_alarm(systime_t time)
+{
+  _alarm = _toSimTime(time);
+}
+
+/**
+ * @brief   Returns the system time.
+ */
+systime_t port_timer_get_time(void)
+{
+  return (systime_t)_time;
+}
+
+/**
+ * @brief   Returns the time of the alarm.
+ */
+systime_t port_timer_get_alarm(void)
+{
+  return (systime_t)_alarm;
+}
+
+/**
+ * @brief   Halt hook of the kernel configuration (see CH_CFG_SYSTEM_HALT_HOOK in aos_chconf.h).
+ * @details Replaces the implementation in aos_debug.c, which prints to the serial drivers of the modules.
+ *          On the host the reason is printed to stderr and the process is aborted instead of hanging.
+ *
+ * @param[in] reason  The reason of the halt.
+ */
+void aosPrintHaltErrorCode(const char* reason)
+{
+  fprintf(stderr, "system halted: %s\n", (reason != NULL) ? reason : "unknown");
+  abort();
+}
+
+/**
+ * @brief   Returns the simulated time, which does not wrap around.
+ *
+ * @return  Simulated time in system ticks.
+ */
+uint64_t port_sim_get_time(void)
+{
+  return _time;
+}
+
+/**
+ * @brief   Returns the number of system timer interrupts so far.
+ * @details On the target each of them is an interrupt of the system timer, so the number shows how often the timers
+ *          woke up the MCU.
+ */
+uint64_t port_sim_get_interrupts(void)
+{
+  return _interrupts;
+}
@@ -0,0 +1,246 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chcore.h
+ * @brief   ChibiOS/RT port for x86-64 Linux hosts with simulated time.
+ * @details Threads are switched cooperatively like in the SIMIA32 port, but the system time is not bound to the real time.
+ *          It only advances when all threads sleep: the idle thread then jumps to the next alarm of the (tickless) system
+ *          timer and handles it as an interrupt. Runs are hence deterministic and take no longer than their computations.
+ */
+
+#ifndef CHCORE_H
+#define CHCORE_H
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+#define PORT_SUPPORTS_RT                TRUE
+
+#define PORT_NATURAL_ALIGN              sizeof (void *)
+
+#define PORT_STACK_ALIGN                sizeof (stkalign_t)
+
+#define PORT_WORKING_AREA_ALIGN         sizeof (stkalign_t)
+
+#define PORT_ARCHITECTURE_HOST
+
+#define PORT_ARCHITECTURE_NAME          "Host simulation"
+
+#define PORT_CORE_VARIANT_NAME          "x86-64"
+
+#define PORT_COMPILER_NAME              "GCC " __VERSION__
+
+#define PORT_INFO                       "No preemption, simulated time"
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+#if !defined(PORT_IDLE_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define PORT_IDLE_THREAD_STACK_SIZE     256
+#endif
+
+/**
+ * @brief   Per-thread stack overhead for the C library (e.g. printf()).
+ */
+#if !defined(PORT_INT_REQUIRED_STACK) || defined(__DOXYGEN__)
+#define PORT_INT_REQUIRED_STACK         32768
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(__x86_64__)
+#error "this port requires an x86-64 host"
+#endif
+
+#if CH_CFG_ST_TIMEDELTA == 0
+#error "this port requires a tickless system timer (CH_CFG_ST_TIMEDELTA > 0)"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+#if !defined(_FROM_ASM_)
+
+typedef struct {
+  uint8_t a[16];
+} stkalign_t __attribute__((aligned(16)));
+
+/**
+ * @brief   Callee-saved registers of a suspended thread, in stack order.
+ */
+struct port_intctx {
+  void* r15;
+  void* r14;
+  void* r13;
+  void* r12;
+  void* rbx;
+  void* rbp;
+  void* rip;
+};
+
+struct port_extctx {
+};
+
+struct port_context {
+  struct port_intctx* sp;
+};
+
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Setup of the context of a new thread.
+ * @details The thread starts in _port_thread_trampoline(), which passes r12 and r13 to _port_thread_start().
+ */
+#define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg) {                      \
+  uint8_t* rsp = (uint8_t*)((uintptr_t)(wtop) & ~(uintptr_t)15);           \
+  rsp -= sizeof(struct port_intctx);                                        \
+  ((struct port_intctx*)rsp)->r15 = NULL;                                   \
+  ((struct port_intctx*)rsp)->r14 = NULL;                                   \
+  ((struct port_intctx*)rsp)->r13 = (void*)(arg);                           \
+  ((struct port_intctx*)rsp)->r12 = (void*)(pf);                            \
+  ((struct port_intctx*)rsp)->rbx = NULL;                                   \
+  ((struct port_intctx*)rsp)->rbp = NULL;                                   \
+  ((struct port_intctx*)rsp)->rip = (void*)_port_thread_trampoline;         \
+  (tp)->ctx.sp = (struct port_intctx*)rsp;                                  \
+}
+
+#define PORT_WA_SIZE(n) (sizeof (struct port_intctx) +                      \
+                         sizeof (stkalign_t) +                              \
+                         ((size_t)(n)) +                                    \
+                         ((size_t)(PORT_INT_REQUIRED_STACK)))
+
+#define PORT_WORKING_AREA(s, n)                                             \
+  stkalign_t s[THD_WORKING_AREA_SIZE(n) / sizeof (stkalign_t)]
+
+#define PORT_IRQ_PROLOGUE() {                                               \
+  port_isr_context_flag = true;                                             \
+}
+
+#define PORT_IRQ_EPILOGUE() {                                               \
+  port_isr_context_flag = false;                                            \
+}
+
+#define PORT_IRQ_HANDLER(id) void id(void)
+
+#define PORT_FAST_IRQ_HANDLER(id) void id(void)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(_FROM_ASM_)
+
+extern bool port_isr_context_flag;
+extern syssts_t port_irq_sts;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void port_switch(thread_t* ntp, thread_t* otp);
+  void _port_thread_trampoline(void);
+  __attribute__((noreturn)) void _port_thread_start(msg_t (*pf)(void* p), void* p);
+  rtcnt_t port_rt_get_counter_value(void);
+  void port_wait_for_interrupt(void);
+  void port_timer_start_alarm(systime_t time);
+  void port_timer_stop_alarm(void);
+  void port_timer_set_alarm(systime_t time);
+  systime_t port_timer_get_time(void);
+  systime_t port_timer_get_alarm(void);
+  uint64_t port_sim_get_time(void);
+  uint64_t port_sim_get_interrupts(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(_FROM_ASM_) */
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#if !defined(_FROM_ASM_)
+
+static inline void port_init(void) {
+
+  port_irq_sts = (syssts_t)0;
+  port_isr_context_flag = false;
+}
+
+static inline syssts_t port_get_irq_status(void) {
+
+  return port_irq_sts;
+}
+
+static inline bool port_irq_enabled(syssts_t sts) {
+
+  return sts == (syssts_t)0;
+}
+
+static inline bool port_is_isr_context(void) {
+
+  return port_isr_context_flag;
+}
+
+static inline void port_lock(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+static inline void port_unlock(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+
+static inline void port_lock_from_isr(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+static inline void port_unlock_from_isr(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+
+static inline void port_disable(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+static inline void port_suspend(void) {
+
+  port_irq_sts = (syssts_t)1;
+}
+
+static inline void port_enable(void) {
+
+  port_irq_sts = (syssts_t)0;
+}
+
+#endif /* !defined(_FROM_ASM_) */
+
+#endif /* CHCORE_H */
@@ -0,0 +1,65 @@
+################################################################################
+# AMiRo-OS is an operating system designed for the Autonomous Mini Robot       #
+# (AMiRo) platform.                                                            #
+# Copyright (C) 2016..2019  Thomas Schöpping et al.                            #
+#                                                                              #
+# This program is free software: you can redistribute it and/or modify         #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# This program is distributed in the hope that it will be useful,              #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.        #
+#                                                                              #
+# This research/work was supported by the Cluster of Excellence Cognitive      #
+# Interaction Technology 'CITEC' (EXC 277) at Bielefeld University, which is   #
+# funded by the German Research Foundation (DFG).                              #
+################################################################################
+
+
+
+# absolute path to this directory
+HOST_DIR := $(dir $(abspath $(lastword $(MAKEFILE_LIST))))
+
+# The layered kernel configuration can not be parsed by the smart build.
+USE_SMART_BUILD = no
+
+# RTOS files.
+include $(CHIBIOS)/os/rt/rt.mk
+# HAL files (optional), the simulator platform without any drivers (see halconf.h).
+include $(CHIBIOS)/os/hal/hal.mk
+include $(CHIBIOS)/os/hal/boards/simulator/board.mk
+include $(CHIBIOS)/os/hal/ports/simulator/posix/platform.mk
+include $(CHIBIOS)/os/hal/osal/rt/osal.mk
+
+# host port
+PORTSRC = $(HOST_DIR)chcore.c
+PORTINC = $(HOST_DIR)
+
+# C sources
+HOSTCSRC = $(KERNSRC) \
+           $(PORTSRC)
+
+# HAL sources and include paths (optional)
+HOSTHALSRC = $(OSALSRC) \
+             $(HALSRC) \
+             $(PLATFORMSRC) \
+             $(BOARDSRC)
+HOSTHALINC = $(OSALINC) \
+             $(HALINC) \
+             $(PLATFORMINC) \
+             $(BOARDINC)
+
+# include paths
+HOSTINC = $(PORTINC) \
+          $(KERNINC) \
+          $(CHIBIOS)/os/license \
+          $(AMIROOS)/modules
+
+# The build rules of the simulator apply to any host.
+RULESPATH = $(CHIBIOS)/os/common/startup/SIMIA32/compilers/GCC
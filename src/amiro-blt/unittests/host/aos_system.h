@@ -0,0 +1,67 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    aos_system.h
+ * @brief   Minimal replacement of the system module for the host unit tests.
+ * @details The unit tests are linked without the rest of AMiRo-OS.
+ *          The uptime is derived from the system time of the simulator.
+ */
+
+#ifndef _AMIROOS_SYSTEM_H_
+#define _AMIROOS_SYSTEM_H_
+
+#include <ch.h>
+#include <aos_debug.h>
+#include <aos_time.h>
+
+/**
+ * @brief   Size of the stack guard page (used by aos_thread.h).
+ * @note    The simulator port does not use guard pages.
+ */
+#if !defined(PORT_GUARD_PAGE_SIZE)
+#define PORT_GUARD_PAGE_SIZE                    0
+#endif
+
+/**
+ * @brief   Retrieves the system uptime.
+ *
+ * @param[out] ut   Pointer to the system uptime.
+ */
+static inline void aosSysGetUptimeX(aos_timestamp_t* ut)
+{
+  *ut = (aos_timestamp_t)chTimeI2US(chVTGetSystemTimeX());
+
+  return;
+}
+
+/**
+ * @brief   Retrieves the system uptime.
+ *
+ * @param[out] ut   Pointer to the system uptime.
+ */
+static inline void aosSysGetUptime(aos_timestamp_t* ut)
+{
+  chSysLock();
+  aosSysGetUptimeX(ut);
+  chSysUnlock();
+
+  return;
+}
+
+#endif /* _AMIROOS_SYSTEM_H_ */
@@ -0,0 +1,52 @@
+/*
+ * AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+ * Copyright (C) 2016..2019  Thomas Schöpping et al.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * @brief   ChibiOS Configuration file for the host unit tests.
+ * @details The kernel is configured like for any host build (tools/host/chconf.h), but with all runtime checks of the
+ *          kernel enabled.
+ *
+ * @addtogroup hostut_ch_config
+ * @details Kernel related settings and hooks.
+ * @{
+ */
+
+#ifndef HOSTUT_CHCONF_H
+#define HOSTUT_CHCONF_H
+
+/**
+ * @brief   Debug option, system state check.
+ */
+#define CH_DBG_SYSTEM_STATE_CHECK           TRUE
+
+/**
+ * @brief   Debug option, parameters checks.
+ */
+#define CH_DBG_ENABLE_CHECKS                TRUE
+
+/**
+ * @brief   Debug option, consistency checks.
+ */
+#define CH_DBG_ENABLE_ASSERTS               TRUE
+
+#include_next <chconf.h>
+
+#endif  /* HOSTUT_CHCONF_H */
+
+/** @} */
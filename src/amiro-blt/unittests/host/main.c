@@ -0,0 +1,385 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    main.c
+ * @brief   Host unit tests and benchmarks of the periphery LLDs.
+ * @details Runs the periphery unit tests on the ChibiOS Posix simulator against
+ *          register models on mock buses and measures the read paths of the
+ *          drivers. Usage:
+ *            ut_host [test] [bench]
+ *          Without arguments, both the tests and the benchmarks are run.
+ *          The exit status is non-zero if any test failed.
+ */
+
+#include <ch.h>
+#include <hal.h>
+#include <aos_system.h>
+#include <aos_unittest.h>
+#include <mock_bus.h>
+#include <mock_devices.h>
+#include <ut_alld_vcnl4020.h>
+#include <ut_alld_l3g4200d.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief   Number of calls per benchmark.
+ */
+#define BENCH_ITERATIONS              100000
+
+/**
+ * @brief   Event flag of the proximity sensor interrupt.
+ */
+#define IOEVENTFLAGS_IRINT            ((eventflags_t)1 << 0)
+
+/**
+ * @brief   Event flag of the gyroscope interrupt.
+ */
+#define IOEVENTFLAGS_GYRODRDY         ((eventflags_t)1 << 1)
+
+/**
+ * @brief   Timeout of bus transfers in microseconds.
+ */
+#define BUS_TIMEOUT                   MICROSECONDS_PER_SECOND
+
+/**
+ * @brief   A benchmarked LLD function.
+ */
+typedef struct {
+  /**
+   * @brief   Name of the benchmark.
+   */
+  const char* name;
+
+  /**
+   * @brief   Function that calls the LLD once.
+   */
+  apalExitStatus_t (*func)(void);
+
+  /**
+   * @brief   Statistics of the bus used by the LLD.
+   */
+  mock_busstats_t* stats;
+} bench_t;
+
+/*
+ * Mock buses and devices.
+ */
+static MockI2CDriver _i2c;
+static MockSPIDriver _spi;
+static mock_regmap_t _vcnlDev;
+static mock_vcnl4020_t _vcnlModel;
+static mock_regmap_t _l3gDev;
+static mock_l3g4200d_t _l3gModel;
+static event_source_t _vcnlEvents;
+static event_source_t _l3gEvents;
+
+/*
+ * Drivers.
+ */
+static VCNL4020Driver _vcnl = {
+  /* I2C driver */ &_i2c,
+};
+static L3G4200DDriver _l3g = {
+  /* SPI driver */ &_spi,
+};
+static SPIConfig _spiconfig;
+static l3g4200d_lld_cfg_t _l3gcfg;
+
+/*
+ * Unit tests.
+ */
+static ut_vcnl4020data_t _utVcnl4020Data = {
+  /* driver       */ &_vcnl,
+  /* timeout      */ BUS_TIMEOUT,
+  /* event source */ &_vcnlEvents,
+  /* event flags  */ IOEVENTFLAGS_IRINT,
+};
+static aos_unittest_t _utAlldVcnl4020 = {
+  /* name           */ "VCNL4020",
+  /* info           */ "proximity sensor (mock)",
+  /* test function  */ utAlldVcnl4020Func,
+  /* shell command  */ {
+    /* name     */ "unittest:Proximity",
+    /* callback */ NULL,
+    /* next     */ NULL,
+    /* bucket   */ NULL,
+  },
+  /* data           */ &_utVcnl4020Data,
+};
+static ut_l3g4200ddata_t _utL3g4200dData = {
+  /* driver            */ &_l3g,
+  /* SPI configuration */ &_spiconfig,
+  /* event source      */ &_l3gEvents,
+  /* event flags       */ IOEVENTFLAGS_GYRODRDY,
+};
+static aos_unittest_t _utAlldL3g4200d = {
+  /* name           */ "L3G4200D",
+  /* info           */ "Gyroscope (mock)",
+  /* test function  */ utAlldL3g4200dFunc,
+  /* shell command  */ {
+    /* name     */ "unittest:Gyroscope",
+    /* callback */ NULL,
+    /* next     */ NULL,
+    /* bucket   */ NULL,
+  },
+  /* data           */ &_utL3g4200dData,
+};
+
+/**
+ * @brief   Writes to stdout.
+ */
+static size_t _stdoutWrite(void* instance, const uint8_t* bp, size_t n)
+{
+  (void)instance;
+
+  return fwrite(bp, 1, n, stdout);
+}
+
+/**
+ * @brief   Reads nothing.
+ */
+static size_t _stdoutRead(void* instance, uint8_t* bp, size_t n)
+{
+  (void)instance;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+/**
+ * @brief   Writes a single character to stdout.
+ */
+static msg_t _stdoutPut(void* instance, uint8_t b)
+{
+  (void)instance;
+
+  return (putchar(b) == EOF) ? MSG_RESET : MSG_OK;
+}
+
+/**
+ * @brief   Reads nothing.
+ */
+static msg_t _stdoutGet(void* instance)
+{
+  (void)instance;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT _stdoutVmt = {
+  /* instance offset */ 0,
+  /* write           */ _stdoutWrite,
+  /* read            */ _stdoutRead,
+  /* put             */ _stdoutPut,
+  /* get             */ _stdoutGet,
+};
+
+/**
+ * @brief   Stream to print the test output to.
+ */
+static BaseSequentialStream _stdout = {
+  /* VMT */ &_stdoutVmt,
+};
+
+/*
+ * Benchmarked read paths.
+ */
+static apalExitStatus_t _benchVcnl4020ReadReg(void)
+{
+  uint8_t data;
+  return vcnl4020_lld_readreg(&_vcnl, VCNL4020_LLD_REGADDR_IDREV, &data, BUS_TIMEOUT);
+}
+
+static apalExitStatus_t _benchVcnl4020ReadAls(void)
+{
+  uint16_t als;
+  return vcnl4020_lld_readals(&_vcnl, &als, BUS_TIMEOUT);
+}
+
+static apalExitStatus_t _benchVcnl4020ReadProx(void)
+{
+  uint16_t prox;
+  return vcnl4020_lld_readprox(&_vcnl, &prox, BUS_TIMEOUT);
+}
+
+static apalExitStatus_t _benchVcnl4020ReadAlsAndProx(void)
+{
+  uint16_t als, prox;
+  return vcnl4020_lld_readalsandprox(&_vcnl, &als, &prox, BUS_TIMEOUT);
+}
+
+static apalExitStatus_t _benchVcnl4020ReadTh(void)
+{
+  uint16_t lth, hth;
+  return vcnl4020_lld_readth(&_vcnl, &lth, &hth, BUS_TIMEOUT);
+}
+
+static apalExitStatus_t _benchL3g4200dReadRegister(void)
+{
+  uint8_t data;
+  return l3g4200d_lld_read_register(&_l3g, L3G4200D_LLD_REGISTER_WHO_AM_I, &data, 1);
+}
+
+static apalExitStatus_t _benchL3g4200dReadAllData(void)
+{
+  int16_t data[3];
+  return l3g4200d_lld_read_all_data(&_l3g, data, &_l3gcfg);
+}
+
+static apalExitStatus_t _benchL3g4200dReadData(void)
+{
+  int16_t data;
+  return l3g4200d_lld_read_data(&_l3g, &data, L3G4200D_LLD_X_AXIS, &_l3gcfg);
+}
+
+static apalExitStatus_t _benchL3g4200dReadConfig(void)
+{
+  l3g4200d_lld_cfg_t cfg;
+  return l3g4200d_lld_read_config(&_l3g, &cfg);
+}
+
+static apalExitStatus_t _benchL3g4200dReadIntConfig(void)
+{
+  l3g4200d_lld_int_cfg_t cfg;
+  return l3g4200d_lld_read_int_config(&_l3g, &cfg);
+}
+
+static apalExitStatus_t _benchL3g4200dReadFifoSrc(void)
+{
+  uint8_t fifo;
+  return l3g4200d_lld_read_fifo_src_register(&_l3g, &fifo);
+}
+
+static const bench_t _benchmarks[] = {
+  {"vcnl4020_lld_readreg",                  _benchVcnl4020ReadReg,        &_i2c.stats},
+  {"vcnl4020_lld_readals",                  _benchVcnl4020ReadAls,        &_i2c.stats},
+  {"vcnl4020_lld_readprox",                 _benchVcnl4020ReadProx,       &_i2c.stats},
+  {"vcnl4020_lld_readalsandprox",           _benchVcnl4020ReadAlsAndProx, &_i2c.stats},
+  {"vcnl4020_lld_readth",                   _benchVcnl4020ReadTh,         &_i2c.stats},
+  {"l3g4200d_lld_read_register",            _benchL3g4200dReadRegister,   &_spi.stats},
+  {"l3g4200d_lld_read_all_data",            _benchL3g4200dReadAllData,    &_spi.stats},
+  {"l3g4200d_lld_read_data",                _benchL3g4200dReadData,       &_spi.stats},
+  {"l3g4200d_lld_read_config",              _benchL3g4200dReadConfig,     &_spi.stats},
+  {"l3g4200d_lld_read_int_config",          _benchL3g4200dReadIntConfig,  &_spi.stats},
+  {"l3g4200d_lld_read_fifo_src_register",   _benchL3g4200dReadFifoSrc,    &_spi.stats},
+};
+
+/**
+ * @brief   Current monotonic time in nanoseconds.
+ */
+static uint64_t _nanoseconds(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Runs all benchmarks.
+ * @details Besides the time per call, the number of bus transfers and bytes
+ *          per call are printed, which change whenever a driver splits or
+ *          merges transfers.
+ *
+ * @return  Number of calls that did not return APAL_STATUS_OK.
+ */
+static uint32_t _benchRun(void)
+{
+  uint32_t errors = 0;
+
+  // stop the device models so the measurements are not disturbed
+  mockBusStop();
+
+  printf("\n%-40s %12s %12s %12s\n", "benchmark", "ns/call", "transfers", "bytes");
+  for (size_t b = 0; b < sizeof(_benchmarks) / sizeof(_benchmarks[0]); ++b) {
+    uint32_t status = APAL_STATUS_OK;
+    mockBusResetStats(_benchmarks[b].stats);
+    const uint64_t t0 = _nanoseconds();
+    for (uint32_t i = 0; i < BENCH_ITERATIONS; ++i) {
+      status |= _benchmarks[b].func();
+    }
+    const uint64_t t1 = _nanoseconds();
+    if (status != APAL_STATUS_OK) {
+      ++errors;
+    }
+    printf("%-40s %12.1f %12.2f %12.2f%s\n",
+           _benchmarks[b].name,
+           (double)(t1 - t0) / BENCH_ITERATIONS,
+           (double)_benchmarks[b].stats->transfers / BENCH_ITERATIONS,
+           (double)_benchmarks[b].stats->bytes / BENCH_ITERATIONS,
+           (status != APAL_STATUS_OK) ? " (failed)" : "");
+  }
+
+  mockBusStart();
+
+  return errors;
+}
+
+/**
+ * @brief   Application entry point.
+ */
+int main(int argc, char* argv[])
+{
+  bool test = (argc < 2);
+  bool bench = (argc < 2);
+  uint32_t failed = 0;
+
+  for (int arg = 1; arg < argc; ++arg) {
+    if (strcmp(argv[arg], "test") == 0) {
+      test = true;
+    } else if (strcmp(argv[arg], "bench") == 0) {
+      bench = true;
+    } else {
+      printf("Usage: %s [test] [bench]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  halInit();
+  chSysInit();
+
+  chEvtObjectInit(&_vcnlEvents);
+  chEvtObjectInit(&_l3gEvents);
+  mockI2CObjectInit(&_i2c);
+  mockSPIObjectInit(&_spi);
+  mockVcnl4020Init(&_vcnlDev, &_vcnlModel, &_vcnlEvents, IOEVENTFLAGS_IRINT);
+  mockI2CAttach(&_i2c, &_vcnlDev);
+  mockL3g4200dInit(&_l3gDev, &_l3gModel, &_l3gEvents, IOEVENTFLAGS_GYRODRDY);
+  mockSPIAttach(&_spi, &_l3gDev);
+  mockBusStart();
+
+  if (test) {
+    aos_utresult_t result = aosUtRun(&_stdout, &_utAlldVcnl4020, NULL);
+    failed += result.failed;
+    result = aosUtRun(&_stdout, &_utAlldL3g4200d, NULL);
+    failed += result.failed;
+  }
+
+  if (bench) {
+    l3g4200d_lld_read_config(&_l3g, &_l3gcfg);
+    failed += _benchRun();
+  }
+
+  fflush(stdout);
+
+  return (failed == 0) ? 0 : 1;
+}
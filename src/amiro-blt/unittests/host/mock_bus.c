@@ -0,0 +1,374 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    mock_bus.c
+ * @brief   Mock I2C and SPI buses with register map devices.
+ *
+ * @addtogroup host_mock_bus
+ * @{
+ */
+
+#include <mock_bus.h>
+#include <aos_debug.h>
+#include <string.h>
+
+/**
+ * @brief   All devices with an update hook.
+ */
+static mock_regmap_t* _devices[MOCK_MAXDEVICES];
+
+/**
+ * @brief   Number of devices with an update hook.
+ */
+static size_t _ndevices = 0;
+
+/**
+ * @brief   Timer to update the devices.
+ */
+static virtual_timer_t _updatetimer;
+
+/**
+ * @brief   Reads a register of a device.
+ */
+static inline uint8_t _regRead(mock_regmap_t* dev, uint8_t reg)
+{
+  return (dev->read != NULL) ? dev->read(dev, reg) : dev->regs[reg];
+}
+
+/**
+ * @brief   Writes a register of a device.
+ */
+static inline void _regWrite(mock_regmap_t* dev, uint8_t reg, uint8_t data)
+{
+  if (dev->write != NULL) {
+    dev->write(dev, reg, data);
+  } else {
+    dev->regs[reg] = data;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Looks up the device with the given address on an I2C bus.
+ */
+static mock_regmap_t* _i2cFind(MockI2CDriver* i2cd, uint16_t addr)
+{
+  mock_regmap_t* dev = i2cd->devices;
+
+  while (dev != NULL && dev->addr != addr) {
+    dev = dev->next;
+  }
+
+  return dev;
+}
+
+/**
+ * @brief   Updates all devices and rearms the timer.
+ */
+static void _updateCb(void* par)
+{
+  (void)par;
+
+  chSysLockFromISR();
+  for (size_t d = 0; d < _ndevices; ++d) {
+    _devices[d]->update(_devices[d]);
+  }
+  chVTSetI(&_updatetimer, chTimeUS2I(MOCK_UPDATEPERIOD), _updateCb, NULL);
+  chSysUnlockFromISR();
+
+  return;
+}
+
+/**
+ * @brief   Initializes a register map device.
+ * @details All registers are reset to 0.
+ *
+ * @param[out] dev    The device to initialize.
+ * @param[in]  addr   I2C slave address (ignored on SPI).
+ * @param[in]  read   Optional read hook.
+ * @param[in]  write  Optional write hook.
+ * @param[in]  update Optional periodic update hook.
+ * @param[in]  model  Device specific model data.
+ */
+void mockRegmapInit(mock_regmap_t* dev, uint16_t addr, mock_readcb_t read, mock_writecb_t write, mock_updatecb_t update, void* model)
+{
+  aosDbgCheck(dev != NULL);
+
+  dev->next = NULL;
+  dev->addr = addr;
+  dev->pointer = 0;
+  memset(dev->regs, 0, sizeof(dev->regs));
+  dev->read = read;
+  dev->write = write;
+  dev->update = update;
+  dev->model = model;
+
+  if (update != NULL) {
+    aosDbgAssert(_ndevices < MOCK_MAXDEVICES);
+    _devices[_ndevices++] = dev;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Initializes a mock I2C driver without any devices.
+ *
+ * @param[out] i2cd   The driver to initialize.
+ */
+void mockI2CObjectInit(MockI2CDriver* i2cd)
+{
+  aosDbgCheck(i2cd != NULL);
+
+  i2cd->devices = NULL;
+  mockBusResetStats(&i2cd->stats);
+
+  return;
+}
+
+/**
+ * @brief   Attaches a device to an I2C bus.
+ *
+ * @param[in] i2cd    The bus.
+ * @param[in] dev     The device to attach.
+ */
+void mockI2CAttach(MockI2CDriver* i2cd, mock_regmap_t* dev)
+{
+  aosDbgCheck(i2cd != NULL);
+  aosDbgCheck(dev != NULL);
+
+  dev->next = i2cd->devices;
+  i2cd->devices = dev;
+
+  return;
+}
+
+/**
+ * @brief   Transmits data to a device and receives a response.
+ *
+ * @param[in]  i2cd     The bus.
+ * @param[in]  addr     Slave address.
+ * @param[in]  txbuf    Data to transmit (register address first).
+ * @param[in]  txbytes  Number of bytes to transmit.
+ * @param[out] rxbuf    Buffer for the response.
+ * @param[in]  rxbytes  Number of bytes to receive.
+ *
+ * @return  MSG_OK on success or MSG_RESET if no device acknowledged the address.
+ */
+msg_t mockI2CMasterTransmit(MockI2CDriver* i2cd, uint16_t addr, const uint8_t* txbuf, size_t txbytes, uint8_t* rxbuf, size_t rxbytes)
+{
+  aosDbgCheck(i2cd != NULL);
+  aosDbgCheck(txbuf != NULL || txbytes == 0);
+  aosDbgCheck(rxbuf != NULL || rxbytes == 0);
+
+  chSysLock();
+  ++i2cd->stats.transfers;
+  mock_regmap_t* dev = _i2cFind(i2cd, addr);
+  if (dev == NULL) {
+    chSysUnlock();
+    return MSG_RESET;
+  }
+  i2cd->stats.bytes += txbytes + rxbytes;
+  if (txbytes > 0) {
+    dev->pointer = txbuf[0];
+    for (size_t b = 1; b < txbytes; ++b) {
+      _regWrite(dev, dev->pointer++, txbuf[b]);
+    }
+  }
+  for (size_t b = 0; b < rxbytes; ++b) {
+    rxbuf[b] = _regRead(dev, dev->pointer++);
+  }
+  // hooks may have signaled events
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Receives data from a device at its current register pointer.
+ *
+ * @param[in]  i2cd     The bus.
+ * @param[in]  addr     Slave address.
+ * @param[out] rxbuf    Buffer for the data.
+ * @param[in]  rxbytes  Number of bytes to receive.
+ *
+ * @return  MSG_OK on success or MSG_RESET if no device acknowledged the address.
+ */
+msg_t mockI2CMasterReceive(MockI2CDriver* i2cd, uint16_t addr, uint8_t* rxbuf, size_t rxbytes)
+{
+  return mockI2CMasterTransmit(i2cd, addr, NULL, 0, rxbuf, rxbytes);
+}
+
+/**
+ * @brief   Initializes a mock SPI driver without a device.
+ *
+ * @param[out] spid   The driver to initialize.
+ */
+void mockSPIObjectInit(MockSPIDriver* spid)
+{
+  aosDbgCheck(spid != NULL);
+
+  spid->device = NULL;
+  mockBusResetStats(&spid->stats);
+
+  return;
+}
+
+/**
+ * @brief   Attaches the device to an SPI bus.
+ *
+ * @param[in] spid    The bus.
+ * @param[in] dev     The device to attach.
+ */
+void mockSPIAttach(MockSPIDriver* spid, mock_regmap_t* dev)
+{
+  aosDbgCheck(spid != NULL);
+  aosDbgCheck(dev != NULL);
+
+  spid->device = dev;
+
+  return;
+}
+
+/**
+ * @brief   Transmits a command with optional data and receives data afterwards.
+ * @details The first transmitted byte is the command, further transmitted bytes
+ *          are written to the device. The received bytes are read from the
+ *          device. If no byte is transmitted, the data is read at the current
+ *          register pointer.
+ *
+ * @param[in]  spid     The bus.
+ * @param[in]  txbuf    Data to transmit.
+ * @param[in]  txbytes  Number of bytes to transmit.
+ * @param[out] rxbuf    Buffer for the received data.
+ * @param[in]  rxbytes  Number of bytes to receive.
+ */
+void mockSPITransmitAndReceive(MockSPIDriver* spid, const uint8_t* txbuf, size_t txbytes, uint8_t* rxbuf, size_t rxbytes)
+{
+  aosDbgCheck(spid != NULL && spid->device != NULL);
+  aosDbgCheck(txbuf != NULL || txbytes == 0);
+  aosDbgCheck(rxbuf != NULL || rxbytes == 0);
+
+  mock_regmap_t* dev = spid->device;
+  uint8_t inc = MOCK_SPI_MULT;
+
+  chSysLock();
+  ++spid->stats.transfers;
+  spid->stats.bytes += txbytes + rxbytes;
+  if (txbytes > 0) {
+    dev->pointer = txbuf[0] & MOCK_SPI_ADDRMASK;
+    inc = txbuf[0] & MOCK_SPI_MULT;
+    for (size_t b = 1; b < txbytes; ++b) {
+      _regWrite(dev, dev->pointer, txbuf[b]);
+      dev->pointer = (dev->pointer + (inc ? 1 : 0)) & MOCK_SPI_ADDRMASK;
+    }
+  }
+  for (size_t b = 0; b < rxbytes; ++b) {
+    rxbuf[b] = _regRead(dev, dev->pointer);
+    dev->pointer = (dev->pointer + (inc ? 1 : 0)) & MOCK_SPI_ADDRMASK;
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return;
+}
+
+/**
+ * @brief   Exchanges data with the device.
+ * @details The first byte is the command, the according received byte is a
+ *          dummy. Depending on the read flag of the command, the remaining
+ *          bytes are either read from or written to the device.
+ *          The buffers may be identical.
+ *
+ * @param[in]  spid     The bus.
+ * @param[in]  txbuf    Data to transmit.
+ * @param[out] rxbuf    Buffer for the received data.
+ * @param[in]  n        Number of bytes to exchange.
+ */
+void mockSPIExchange(MockSPIDriver* spid, const uint8_t* txbuf, uint8_t* rxbuf, size_t n)
+{
+  aosDbgCheck(spid != NULL && spid->device != NULL);
+  aosDbgCheck(txbuf != NULL && rxbuf != NULL && n > 0);
+
+  mock_regmap_t* dev = spid->device;
+  const uint8_t cmd = txbuf[0];
+
+  chSysLock();
+  ++spid->stats.transfers;
+  spid->stats.bytes += n;
+  dev->pointer = cmd & MOCK_SPI_ADDRMASK;
+  rxbuf[0] = 0xFF;
+  for (size_t b = 1; b < n; ++b) {
+    if (cmd & MOCK_SPI_READ) {
+      rxbuf[b] = _regRead(dev, dev->pointer);
+    } else {
+      _regWrite(dev, dev->pointer, txbuf[b]);
+      rxbuf[b] = 0xFF;
+    }
+    if (cmd & MOCK_SPI_MULT) {
+      dev->pointer = (dev->pointer + 1) & MOCK_SPI_ADDRMASK;
+    }
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return;
+}
+
+/**
+ * @brief   Starts the periodic update of the devices.
+ */
+void mockBusStart(void)
+{
+  chVTObjectInit(&_updatetimer);
+  chVTSet(&_updatetimer, chTimeUS2I(MOCK_UPDATEPERIOD), _updateCb, NULL);
+
+  return;
+}
+
+/**
+ * @brief   Stops the periodic update of the devices.
+ */
+void mockBusStop(void)
+{
+  chVTReset(&_updatetimer);
+
+  return;
+}
+
+/**
+ * @brief   Resets transfer statistics.
+ *
+ * @param[out] stats  The statistics to reset.
+ */
+void mockBusResetStats(mock_busstats_t* stats)
+{
+  aosDbgCheck(stats != NULL);
+
+  chSysLock();
+  stats->transfers = 0;
+  stats->bytes = 0;
+  chSysUnlock();
+
+  return;
+}
+
+/** @} */
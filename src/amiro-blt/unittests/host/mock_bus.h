@@ -0,0 +1,214 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    mock_bus.h
+ * @brief   Mock I2C and SPI buses with register map devices.
+ * @details Each device is a map of 256 8-bit registers, which is accessed the
+ *          way the AMiRo periphery accesses its registers:
+ *            - I2C: The first transmitted byte sets the register pointer,
+ *              further bytes are written and received bytes are read with
+ *              auto-increment of the pointer.
+ *            - SPI: The first byte holds the register address (bits 5:0),
+ *              the read flag (bit 7) and the auto-increment flag (bit 6) as
+ *              used by the ST sensors.
+ *          Devices may hook register accesses to model side effects and are
+ *          updated periodically to model self-timed measurements.
+ *
+ * @addtogroup host_mock_bus
+ * @{
+ */
+
+#ifndef _AMIROOS_MOCK_BUS_H_
+#define _AMIROOS_MOCK_BUS_H_
+
+#include <ch.h>
+
+/**
+ * @brief   Maximum number of devices that are updated periodically.
+ */
+#define MOCK_MAXDEVICES                         8
+
+/**
+ * @brief   Update period of the devices in microseconds.
+ */
+#define MOCK_UPDATEPERIOD                       1000
+
+/**
+ * @brief   SPI read flag.
+ */
+#define MOCK_SPI_READ                           0x80u
+
+/**
+ * @brief   SPI auto-increment flag.
+ */
+#define MOCK_SPI_MULT                           0x40u
+
+/**
+ * @brief   SPI register address mask.
+ */
+#define MOCK_SPI_ADDRMASK                       0x3Fu
+
+/*
+ * Forward declarations.
+ */
+typedef struct mock_regmap mock_regmap_t;
+
+/**
+ * @brief   Register read hook.
+ * @note    Called with the system locked.
+ *
+ * @param[in] dev   The accessed device.
+ * @param[in] reg   The accessed register.
+ *
+ * @return  The value to return to the master.
+ */
+typedef uint8_t (*mock_readcb_t)(mock_regmap_t* dev, uint8_t reg);
+
+/**
+ * @brief   Register write hook.
+ * @note    Called with the system locked.
+ *
+ * @param[in] dev   The accessed device.
+ * @param[in] reg   The accessed register.
+ * @param[in] data  The value written by the master.
+ */
+typedef void (*mock_writecb_t)(mock_regmap_t* dev, uint8_t reg, uint8_t data);
+
+/**
+ * @brief   Periodic update hook.
+ * @note    Called from the update timer (I-class context).
+ *
+ * @param[in] dev   The device to update.
+ */
+typedef void (*mock_updatecb_t)(mock_regmap_t* dev);
+
+/**
+ * @brief   Register map device.
+ */
+struct mock_regmap {
+  /**
+   * @brief   Next device on the same I2C bus.
+   */
+  mock_regmap_t* next;
+
+  /**
+   * @brief   I2C slave address (ignored on SPI).
+   */
+  uint16_t addr;
+
+  /**
+   * @brief   Register pointer.
+   */
+  uint8_t pointer;
+
+  /**
+   * @brief   Register contents.
+   */
+  uint8_t regs[256];
+
+  /**
+   * @brief   Optional read hook.
+   * @details If NULL, reads return the register contents.
+   */
+  mock_readcb_t read;
+
+  /**
+   * @brief   Optional write hook.
+   * @details If NULL, writes are stored in the registers.
+   */
+  mock_writecb_t write;
+
+  /**
+   * @brief   Optional periodic update hook.
+   */
+  mock_updatecb_t update;
+
+  /**
+   * @brief   Device specific model data.
+   */
+  void* model;
+};
+
+/**
+ * @brief   Transfer statistics of a mock bus.
+ */
+typedef struct mock_busstats {
+  /**
+   * @brief   Number of transfers (transactions).
+   */
+  uint32_t transfers;
+
+  /**
+   * @brief   Number of bytes transferred in either direction.
+   */
+  uint32_t bytes;
+} mock_busstats_t;
+
+/**
+ * @brief   Mock I2C driver.
+ */
+typedef struct {
+  /**
+   * @brief   Devices attached to the bus.
+   */
+  mock_regmap_t* devices;
+
+  /**
+   * @brief   Transfer statistics.
+   */
+  mock_busstats_t stats;
+} MockI2CDriver;
+
+/**
+ * @brief   Mock SPI driver.
+ */
+typedef struct {
+  /**
+   * @brief   The single device attached to the bus.
+   */
+  mock_regmap_t* device;
+
+  /**
+   * @brief   Transfer statistics.
+   */
+  mock_busstats_t stats;
+} MockSPIDriver;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mockRegmapInit(mock_regmap_t* dev, uint16_t addr, mock_readcb_t read, mock_writecb_t write, mock_updatecb_t update, void* model);
+  void mockI2CObjectInit(MockI2CDriver* i2cd);
+  void mockI2CAttach(MockI2CDriver* i2cd, mock_regmap_t* dev);
+  msg_t mockI2CMasterTransmit(MockI2CDriver* i2cd, uint16_t addr, const uint8_t* txbuf, size_t txbytes, uint8_t* rxbuf, size_t rxbytes);
+  msg_t mockI2CMasterReceive(MockI2CDriver* i2cd, uint16_t addr, uint8_t* rxbuf, size_t rxbytes);
+  void mockSPIObjectInit(MockSPIDriver* spid);
+  void mockSPIAttach(MockSPIDriver* spid, mock_regmap_t* dev);
+  void mockSPIExchange(MockSPIDriver* spid, const uint8_t* txbuf, uint8_t* rxbuf, size_t n);
+  void mockSPITransmitAndReceive(MockSPIDriver* spid, const uint8_t* txbuf, size_t txbytes, uint8_t* rxbuf, size_t rxbytes);
+  void mockBusStart(void);
+  void mockBusStop(void);
+  void mockBusResetStats(mock_busstats_t* stats);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AMIROOS_MOCK_BUS_H_ */
+
+/** @} */
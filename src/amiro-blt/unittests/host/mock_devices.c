@@ -0,0 +1,517 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    mock_devices.c
+ * @brief   Register models of the mocked periphery.
+ *
+ * @addtogroup host_mock_devices
+ * @{
+ */
+
+#include <mock_devices.h>
+#include <alld_vcnl4020.h>
+#include <alld_l3g4200d.h>
+
+/******************************************************************************/
+/* VCNL4020                                                                   */
+/******************************************************************************/
+
+/**
+ * @brief   Duration of a step of the scripted proximity values in milliseconds.
+ */
+#define VCNL4020_PROXSTEP             250
+
+/**
+ * @brief   Duration of a step of the scripted ambient light values in milliseconds.
+ */
+#define VCNL4020_ALSSTEP              1000
+
+/**
+ * @brief   Scripted proximity values.
+ * @details An obstacle approaches and leaves again every three seconds, exceeding
+ *          0x2000 (the threshold of the unit test) for 750ms.
+ */
+static const uint16_t _vcnl4020Prox[] = {
+  0x0890, 0x08A4, 0x0AC0, 0x1480, 0x2310, 0x2F40, 0x2580, 0x1870, 0x0C20, 0x0910, 0x0898, 0x0888,
+};
+
+/**
+ * @brief   Scripted ambient light values.
+ */
+static const uint16_t _vcnl4020Als[] = {
+  0x0120, 0x0180, 0x0230, 0x01C0,
+};
+
+/**
+ * @brief   Proximity measurement periods in milliseconds per PROXRATE setting.
+ */
+static const uint16_t _vcnl4020ProxPeriod[] = {
+  512, 256, 128, 64, 32, 16, 8, 4,
+};
+
+/**
+ * @brief   Ambient light measurement periods in milliseconds per ALPARAM rate setting.
+ */
+static const uint16_t _vcnl4020AlsPeriod[] = {
+  1000, 500, 333, 250, 200, 167, 125, 100,
+};
+
+/**
+ * @brief   Sets interrupt status flags and signals the active edge of the interrupt line.
+ */
+static void _vcnl4020SetIntStatusI(mock_regmap_t* dev, uint8_t flags)
+{
+  mock_vcnl4020_t* vcnl = (mock_vcnl4020_t*)dev->model;
+  const uint8_t status = dev->regs[VCNL4020_LLD_REGADDR_INTSTATUS];
+
+  dev->regs[VCNL4020_LLD_REGADDR_INTSTATUS] = status | flags;
+  if (status == 0 && flags != 0 && vcnl->evtsource != NULL) {
+    chEvtBroadcastFlagsI(vcnl->evtsource, vcnl->evtflags);
+  }
+
+  return;
+}
+
+/**
+ * @brief   Checks a measurement against the thresholds.
+ */
+static void _vcnl4020CheckThresholdI(mock_regmap_t* dev, uint16_t value)
+{
+  const uint16_t lth = (dev->regs[VCNL4020_LLD_REGADDR_LTH_HIGH] << 8) | dev->regs[VCNL4020_LLD_REGADDR_LTH_LOW];
+  const uint16_t hth = (dev->regs[VCNL4020_LLD_REGADDR_HTH_HIGH] << 8) | dev->regs[VCNL4020_LLD_REGADDR_HTH_LOW];
+
+  if (value > hth) {
+    _vcnl4020SetIntStatusI(dev, VCNL4020_LLD_INTSTATUSREG_THHIGH);
+  } else if (value < lth) {
+    _vcnl4020SetIntStatusI(dev, VCNL4020_LLD_INTSTATUSREG_THLOW);
+  }
+
+  return;
+}
+
+/**
+ * @brief   Performs a proximity measurement.
+ */
+static void _vcnl4020MeasureProxI(mock_regmap_t* dev)
+{
+  mock_vcnl4020_t* vcnl = (mock_vcnl4020_t*)dev->model;
+  const size_t step = (vcnl->uptime / VCNL4020_PROXSTEP) % (sizeof(_vcnl4020Prox) / sizeof(_vcnl4020Prox[0]));
+  // some noise
+  const uint16_t prox = _vcnl4020Prox[step] + (vcnl->uptime % 7);
+  const uint8_t intctrl = dev->regs[VCNL4020_LLD_REGADDR_INTCTRL];
+
+  dev->regs[VCNL4020_LLD_REGADDR_PROXRES_HIGH] = prox >> 8;
+  dev->regs[VCNL4020_LLD_REGADDR_PROXRES_LOW] = prox & 0xFF;
+  dev->regs[VCNL4020_LLD_REGADDR_CMD] |= VCNL4020_LLD_CMDREG_PROXRDY;
+  if (intctrl & VCNL4020_LLD_INTCTRLREG_PROXRDY_EN) {
+    _vcnl4020SetIntStatusI(dev, VCNL4020_LLD_INTSTATUSREG_PROXRDY);
+  }
+  if ((intctrl & VCNL4020_LLD_INTCTRLREG_THRES_EN) && !(intctrl & VCNL4020_LLD_INTCTRLREG_THRES_SEL)) {
+    _vcnl4020CheckThresholdI(dev, prox);
+  }
+
+  return;
+}
+
+/**
+ * @brief   Performs an ambient light measurement.
+ */
+static void _vcnl4020MeasureAlsI(mock_regmap_t* dev)
+{
+  mock_vcnl4020_t* vcnl = (mock_vcnl4020_t*)dev->model;
+  const size_t step = (vcnl->uptime / VCNL4020_ALSSTEP) % (sizeof(_vcnl4020Als) / sizeof(_vcnl4020Als[0]));
+  const uint16_t als = _vcnl4020Als[step] + (vcnl->uptime % 3);
+  const uint8_t intctrl = dev->regs[VCNL4020_LLD_REGADDR_INTCTRL];
+
+  dev->regs[VCNL4020_LLD_REGADDR_ALRES_HIGH] = als >> 8;
+  dev->regs[VCNL4020_LLD_REGADDR_ALRES_LOW] = als & 0xFF;
+  dev->regs[VCNL4020_LLD_REGADDR_CMD] |= VCNL4020_LLD_CMDREG_ALSRDY;
+  if (intctrl & VCNL4020_LLD_INTCTRLREG_ALSRDY_EN) {
+    _vcnl4020SetIntStatusI(dev, VCNL4020_LLD_INTSTATUSREG_ALSRDY);
+  }
+  if ((intctrl & VCNL4020_LLD_INTCTRLREG_THRES_EN) && (intctrl & VCNL4020_LLD_INTCTRLREG_THRES_SEL)) {
+    _vcnl4020CheckThresholdI(dev, als);
+  }
+
+  return;
+}
+
+/**
+ * @brief   Register read hook of the VCNL4020.
+ * @details Reading a result register clears the according data ready flag.
+ */
+static uint8_t _vcnl4020Read(mock_regmap_t* dev, uint8_t reg)
+{
+  const uint8_t value = dev->regs[reg];
+
+  switch (reg) {
+    case VCNL4020_LLD_REGADDR_ALRES_LOW:
+      dev->regs[VCNL4020_LLD_REGADDR_CMD] &= ~VCNL4020_LLD_CMDREG_ALSRDY;
+      break;
+    case VCNL4020_LLD_REGADDR_PROXRES_LOW:
+      dev->regs[VCNL4020_LLD_REGADDR_CMD] &= ~VCNL4020_LLD_CMDREG_PROXRDY;
+      break;
+    default:
+      break;
+  }
+
+  return value;
+}
+
+/**
+ * @brief   Register write hook of the VCNL4020.
+ */
+static void _vcnl4020Write(mock_regmap_t* dev, uint8_t reg, uint8_t data)
+{
+  switch (reg) {
+    case VCNL4020_LLD_REGADDR_CMD:
+      dev->regs[reg] = VCNL4020_LLD_CMDREG_CFGLOCK |
+          (dev->regs[reg] & (VCNL4020_LLD_CMDREG_ALSRDY | VCNL4020_LLD_CMDREG_PROXRDY)) |
+          (data & (VCNL4020_LLD_CMDREG_ALSEN | VCNL4020_LLD_CMDREG_PROXEN | VCNL4020_LLD_CMDREG_SELFTIMED));
+      // on-demand measurements complete immediately
+      if (data & VCNL4020_LLD_CMDREG_PROXOD) {
+        _vcnl4020MeasureProxI(dev);
+      }
+      if (data & VCNL4020_LLD_CMDREG_ALSOD) {
+        _vcnl4020MeasureAlsI(dev);
+      }
+      break;
+    case VCNL4020_LLD_REGADDR_PROXRATE:
+      dev->regs[reg] = data & VCNL4020_LLD_PROXRATEREG_MASK;
+      break;
+    case VCNL4020_LLD_REGADDR_INTSTATUS:
+      // write 1 to clear
+      dev->regs[reg] &= ~data;
+      break;
+    case VCNL4020_LLD_REGADDR_IDREV:
+    case VCNL4020_LLD_REGADDR_ALRES_HIGH:
+    case VCNL4020_LLD_REGADDR_ALRES_LOW:
+    case VCNL4020_LLD_REGADDR_PROXRES_HIGH:
+    case VCNL4020_LLD_REGADDR_PROXRES_LOW:
+      // read only
+      break;
+    default:
+      dev->regs[reg] = data;
+      break;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Periodic update of the VCNL4020 (self-timed measurements).
+ */
+static void _vcnl4020Update(mock_regmap_t* dev)
+{
+  mock_vcnl4020_t* vcnl = (mock_vcnl4020_t*)dev->model;
+  const uint8_t cmd = dev->regs[VCNL4020_LLD_REGADDR_CMD];
+
+  vcnl->uptime += MOCK_UPDATEPERIOD / 1000;
+  if (!(cmd & VCNL4020_LLD_CMDREG_SELFTIMED)) {
+    return;
+  }
+  if (cmd & VCNL4020_LLD_CMDREG_PROXEN) {
+    vcnl->proxticks += MOCK_UPDATEPERIOD / 1000;
+    if (vcnl->proxticks >= _vcnl4020ProxPeriod[dev->regs[VCNL4020_LLD_REGADDR_PROXRATE] & VCNL4020_LLD_PROXRATEREG_MASK]) {
+      vcnl->proxticks = 0;
+      _vcnl4020MeasureProxI(dev);
+    }
+  }
+  if (cmd & VCNL4020_LLD_CMDREG_ALSEN) {
+    vcnl->alsticks += MOCK_UPDATEPERIOD / 1000;
+    if (vcnl->alsticks >= _vcnl4020AlsPeriod[(dev->regs[VCNL4020_LLD_REGADDR_ALPARAM] & VCNL4020_LLD_ALPARAMREG_RATE_MASK) >> 4]) {
+      vcnl->alsticks = 0;
+      _vcnl4020MeasureAlsI(dev);
+    }
+  }
+
+  return;
+}
+
+/**
+ * @brief   Initializes a VCNL4020 device with its reset values.
+ * @note    The interrupt count (INTCTRL bits 7:5) is not modeled, every
+ *          measurement beyond a threshold raises the interrupt.
+ *
+ * @param[out] dev        The device to initialize.
+ * @param[out] model      Model data of the device.
+ * @param[in]  evtsource  Event source of the interrupt line (may be NULL).
+ * @param[in]  evtflags   Event flags to broadcast on an interrupt.
+ */
+void mockVcnl4020Init(mock_regmap_t* dev, mock_vcnl4020_t* model, event_source_t* evtsource, eventflags_t evtflags)
+{
+  aosDbgCheck(model != NULL);
+
+  model->evtsource = evtsource;
+  model->evtflags = evtflags;
+  model->proxticks = 0;
+  model->alsticks = 0;
+  model->uptime = 0;
+  mockRegmapInit(dev, VCNL4020_LLD_I2C_ADDR, _vcnl4020Read, _vcnl4020Write, _vcnl4020Update, model);
+  dev->regs[VCNL4020_LLD_REGADDR_CMD] = VCNL4020_LLD_CMDREG_CFGLOCK;
+  dev->regs[VCNL4020_LLD_REGADDR_IDREV] = 0x21;
+  dev->regs[VCNL4020_LLD_REGADDR_PROXRATE] = VCNL4020_LLD_PROXRATEREG_DEFAULT;
+  dev->regs[VCNL4020_LLD_REGADDR_LEDCURRENT] = VCNL4020_LLD_LEDCURRENTREG_DEFAULT;
+  dev->regs[VCNL4020_LLD_REGADDR_ALPARAM] = VCNL4020_LLD_ALPARAMREG_RATE_DEFAULT | VCNL4020_LLD_ALPARAMREG_AVG_DEFAULT;
+
+  return;
+}
+
+/******************************************************************************/
+/* L3G4200D                                                                   */
+/******************************************************************************/
+
+/**
+ * @brief   Depth of the FIFO.
+ */
+#define L3G4200D_FIFODEPTH            32
+
+/**
+ * @brief   Number of samples per step of the scripted angular rates.
+ */
+#define L3G4200D_RATESTEP             8
+
+/**
+ * @brief   Scripted angular rate (one period of a sine).
+ */
+static const int16_t _l3g4200dRate[] = {
+  0, 153, 283, 370, 400, 370, 283, 153, 0, -153, -283, -370, -400, -370, -283, -153,
+};
+
+/**
+ * @brief   Output data rates in Hz per CTRL_REG1 DR setting.
+ */
+static const uint16_t _l3g4200dOdr[] = {
+  100, 200, 400, 800,
+};
+
+/**
+ * @brief   Checks whether the FIFO is enabled and not in bypass mode.
+ */
+static inline bool _l3g4200dFifoActive(mock_regmap_t* dev)
+{
+  return (dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG5] & L3G4200D_LLD_FIFO_EN) &&
+         ((dev->regs[L3G4200D_LLD_REGISTER_FIFO_CTRL_REG] & ~L3G4200D_LLD_WTM_MASK) != L3G4200D_LLD_FM_BYPASS);
+}
+
+/**
+ * @brief   Evaluates the INT2 line and signals its active edge.
+ */
+static void _l3g4200dUpdateInt2I(mock_regmap_t* dev)
+{
+  mock_l3g4200d_t* l3g = (mock_l3g4200d_t*)dev->model;
+  const uint8_t ctrl3 = dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG3];
+  bool line = (ctrl3 & L3G4200D_LLD_I2_DRDY) && (dev->regs[L3G4200D_LLD_REGISTER_STATUS_REG] & L3G4200D_LLD_ZYXDA);
+
+  if (_l3g4200dFifoActive(dev)) {
+    const uint8_t wtm = dev->regs[L3G4200D_LLD_REGISTER_FIFO_CTRL_REG] & L3G4200D_LLD_WTM_MASK;
+    line = line ||
+           ((ctrl3 & L3G4200D_LLD_I2_WTM) && l3g->level >= wtm) ||
+           ((ctrl3 & L3G4200D_LLD_I2_ORUN) && l3g->overrun) ||
+           ((ctrl3 & L3G4200D_LLD_I2_EMPTY) && l3g->level == 0);
+  }
+  if (line && !l3g->int2 && l3g->evtsource != NULL) {
+    chEvtBroadcastFlagsI(l3g->evtsource, l3g->evtflags);
+  }
+  l3g->int2 = line;
+
+  return;
+}
+
+/**
+ * @brief   Takes a sample of the scripted angular rates.
+ */
+static void _l3g4200dSampleI(mock_regmap_t* dev)
+{
+  mock_l3g4200d_t* l3g = (mock_l3g4200d_t*)dev->model;
+  const uint8_t ctrl1 = dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG1];
+  const size_t nrates = sizeof(_l3g4200dRate) / sizeof(_l3g4200dRate[0]);
+  const size_t step = l3g->samples / L3G4200D_RATESTEP;
+  int16_t sample[3];
+
+  sample[0] = (ctrl1 & L3G4200D_LLD_XEN) ? _l3g4200dRate[step % nrates] : 0;
+  sample[1] = (ctrl1 & L3G4200D_LLD_YEN) ? _l3g4200dRate[(step + nrates / 4) % nrates] / 2 : 0;
+  sample[2] = (ctrl1 & L3G4200D_LLD_ZEN) ? -_l3g4200dRate[(step + nrates / 2) % nrates] / 4 : 0;
+  ++l3g->samples;
+
+  if (_l3g4200dFifoActive(dev)) {
+    if (l3g->level == L3G4200D_FIFODEPTH) {
+      l3g->overrun = true;
+      if ((dev->regs[L3G4200D_LLD_REGISTER_FIFO_CTRL_REG] & ~L3G4200D_LLD_WTM_MASK) == L3G4200D_LLD_FM_FMMODE) {
+        // FIFO mode stops collecting when full
+        return;
+      }
+      // stream modes discard the oldest sample
+      l3g->head = (l3g->head + 1) % L3G4200D_FIFODEPTH;
+      --l3g->level;
+    }
+    const uint8_t tail = (l3g->head + l3g->level) % L3G4200D_FIFODEPTH;
+    l3g->fifo[tail][0] = sample[0];
+    l3g->fifo[tail][1] = sample[1];
+    l3g->fifo[tail][2] = sample[2];
+    ++l3g->level;
+  } else {
+    // the output registers hold the latest sample only
+    l3g->head = 0;
+    l3g->level = 1;
+    l3g->fifo[0][0] = sample[0];
+    l3g->fifo[0][1] = sample[1];
+    l3g->fifo[0][2] = sample[2];
+  }
+
+  if (dev->regs[L3G4200D_LLD_REGISTER_STATUS_REG] & L3G4200D_LLD_ZYXDA) {
+    dev->regs[L3G4200D_LLD_REGISTER_STATUS_REG] |= L3G4200D_LLD_ZYXOR | L3G4200D_LLD_ZOR | L3G4200D_LLD_YOR | L3G4200D_LLD_XOR;
+  }
+  dev->regs[L3G4200D_LLD_REGISTER_STATUS_REG] |= L3G4200D_LLD_ZYXDA | L3G4200D_LLD_ZDA | L3G4200D_LLD_YDA | L3G4200D_LLD_XDA;
+
+  return;
+}
+
+/**
+ * @brief   Register read hook of the L3G4200D.
+ * @details The output registers present the oldest sample in the FIFO.
+ *          Reading OUT_Z_H (the last byte of a burst read) completes the
+ *          sample and removes it from the FIFO.
+ */
+static uint8_t _l3g4200dRead(mock_regmap_t* dev, uint8_t reg)
+{
+  mock_l3g4200d_t* l3g = (mock_l3g4200d_t*)dev->model;
+
+  if (reg >= L3G4200D_LLD_REGISTER_OUT_X_L && reg <= L3G4200D_LLD_REGISTER_OUT_Z_H) {
+    const uint16_t value = (uint16_t)l3g->fifo[l3g->head][(reg - L3G4200D_LLD_REGISTER_OUT_X_L) / 2];
+    const bool high = ((reg - L3G4200D_LLD_REGISTER_OUT_X_L) % 2) != ((dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG4] & L3G4200D_LLD_BLE_MSB) ? 1 : 0);
+    if (reg == L3G4200D_LLD_REGISTER_OUT_Z_H) {
+      dev->regs[L3G4200D_LLD_REGISTER_STATUS_REG] = 0;
+      if (_l3g4200dFifoActive(dev) && l3g->level > 0) {
+        l3g->head = (l3g->head + 1) % L3G4200D_FIFODEPTH;
+        --l3g->level;
+        l3g->overrun = false;
+      }
+      _l3g4200dUpdateInt2I(dev);
+    }
+    return high ? (value >> 8) : (value & 0xFF);
+  } else if (reg == L3G4200D_LLD_REGISTER_FIFO_SRC_REG) {
+    const uint8_t wtm = dev->regs[L3G4200D_LLD_REGISTER_FIFO_CTRL_REG] & L3G4200D_LLD_WTM_MASK;
+    const uint8_t level = _l3g4200dFifoActive(dev) ? l3g->level : 0;
+    return ((level >= wtm) ? L3G4200D_LLD_WTM : 0) |
+           (l3g->overrun ? L3G4200D_LLD_OVRN : 0) |
+           ((level == 0) ? L3G4200D_LLD_EMPTY : 0) |
+           ((level < L3G4200D_FIFODEPTH) ? level : L3G4200D_LLD_FSS_MASK);
+  } else {
+    return dev->regs[reg];
+  }
+}
+
+/**
+ * @brief   Register write hook of the L3G4200D.
+ */
+static void _l3g4200dWrite(mock_regmap_t* dev, uint8_t reg, uint8_t data)
+{
+  mock_l3g4200d_t* l3g = (mock_l3g4200d_t*)dev->model;
+
+  switch (reg) {
+    case L3G4200D_LLD_REGISTER_WHO_AM_I:
+    case L3G4200D_LLD_REGISTER_OUT_TEMP:
+    case L3G4200D_LLD_REGISTER_STATUS_REG:
+    case L3G4200D_LLD_REGISTER_OUT_X_L:
+    case L3G4200D_LLD_REGISTER_OUT_X_H:
+    case L3G4200D_LLD_REGISTER_OUT_Y_L:
+    case L3G4200D_LLD_REGISTER_OUT_Y_H:
+    case L3G4200D_LLD_REGISTER_OUT_Z_L:
+    case L3G4200D_LLD_REGISTER_OUT_Z_H:
+    case L3G4200D_LLD_REGISTER_FIFO_SRC_REG:
+    case L3G4200D_LLD_REGISTER_INT1_SRC:
+      // read only
+      break;
+    case L3G4200D_LLD_REGISTER_FIFO_CTRL_REG:
+      dev->regs[reg] = data;
+      // bypass mode resets the FIFO
+      if ((data & ~L3G4200D_LLD_WTM_MASK) == L3G4200D_LLD_FM_BYPASS) {
+        l3g->head = 0;
+        l3g->level = 0;
+        l3g->overrun = false;
+      }
+      _l3g4200dUpdateInt2I(dev);
+      break;
+    case L3G4200D_LLD_REGISTER_CTRL_REG3:
+    case L3G4200D_LLD_REGISTER_CTRL_REG5:
+      dev->regs[reg] = data;
+      _l3g4200dUpdateInt2I(dev);
+      break;
+    default:
+      dev->regs[reg] = data;
+      break;
+  }
+
+  return;
+}
+
+/**
+ * @brief   Periodic update of the L3G4200D (sampling at the output data rate).
+ */
+static void _l3g4200dUpdate(mock_regmap_t* dev)
+{
+  mock_l3g4200d_t* l3g = (mock_l3g4200d_t*)dev->model;
+  const uint8_t ctrl1 = dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG1];
+
+  if (!(ctrl1 & L3G4200D_LLD_PD)) {
+    return;
+  }
+  l3g->odracc += _l3g4200dOdr[ctrl1 >> 6] * (MOCK_UPDATEPERIOD / 1000);
+  while (l3g->odracc >= 1000) {
+    l3g->odracc -= 1000;
+    _l3g4200dSampleI(dev);
+  }
+  _l3g4200dUpdateInt2I(dev);
+
+  return;
+}
+
+/**
+ * @brief   Initializes an L3G4200D device with its reset values.
+ * @note    Only the INT2 (data ready/FIFO) line is modeled.
+ *
+ * @param[out] dev        The device to initialize.
+ * @param[out] model      Model data of the device.
+ * @param[in]  evtsource  Event source of the INT2 line (may be NULL).
+ * @param[in]  evtflags   Event flags to broadcast on an interrupt.
+ */
+void mockL3g4200dInit(mock_regmap_t* dev, mock_l3g4200d_t* model, event_source_t* evtsource, eventflags_t evtflags)
+{
+  aosDbgCheck(model != NULL);
+
+  model->evtsource = evtsource;
+  model->evtflags = evtflags;
+  model->head = 0;
+  model->level = 0;
+  model->overrun = false;
+  model->int2 = false;
+  model->odracc = 0;
+  model->samples = 0;
+  for (size_t s = 0; s < L3G4200D_FIFODEPTH; ++s) {
+    model->fifo[s][0] = model->fifo[s][1] = model->fifo[s][2] = 0;
+  }
+  mockRegmapInit(dev, 0, _l3g4200dRead, _l3g4200dWrite, _l3g4200dUpdate, model);
+  dev->regs[L3G4200D_LLD_REGISTER_WHO_AM_I] = L3G4200D_LLD_WHO_AM_I;
+  dev->regs[L3G4200D_LLD_REGISTER_CTRL_REG1] = L3G4200D_LLD_ZEN | L3G4200D_LLD_YEN | L3G4200D_LLD_XEN;
+
+  return;
+}
+
+/** @} */
@@ -0,0 +1,126 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    mock_devices.h
+ * @brief   Register models of the mocked periphery.
+ * @details The measurements of the models follow scripted tables, so every run
+ *          of the unit tests sees the same data. Interrupt lines are modeled as
+ *          event flags that are broadcast on the active edge.
+ *
+ * @addtogroup host_mock_devices
+ * @{
+ */
+
+#ifndef _AMIROOS_MOCK_DEVICES_H_
+#define _AMIROOS_MOCK_DEVICES_H_
+
+#include <mock_bus.h>
+
+/**
+ * @brief   VCNL4020 proximity sensor model.
+ */
+typedef struct mock_vcnl4020 {
+  /**
+   * @brief   Event source of the interrupt line.
+   */
+  event_source_t* evtsource;
+
+  /**
+   * @brief   Event flags to broadcast on an interrupt.
+   */
+  eventflags_t evtflags;
+
+  /**
+   * @brief   Milliseconds since the last proximity measurement.
+   */
+  uint32_t proxticks;
+
+  /**
+   * @brief   Milliseconds since the last ambient light measurement.
+   */
+  uint32_t alsticks;
+
+  /**
+   * @brief   Milliseconds since startup, selects the scripted values.
+   */
+  uint32_t uptime;
+} mock_vcnl4020_t;
+
+/**
+ * @brief   L3G4200D gyroscope model.
+ */
+typedef struct mock_l3g4200d {
+  /**
+   * @brief   Event source of the INT2 (data ready/FIFO) line.
+   */
+  event_source_t* evtsource;
+
+  /**
+   * @brief   Event flags to broadcast on an interrupt.
+   */
+  eventflags_t evtflags;
+
+  /**
+   * @brief   FIFO of angular rate samples.
+   */
+  int16_t fifo[32][3];
+
+  /**
+   * @brief   Index of the oldest sample in the FIFO.
+   */
+  uint8_t head;
+
+  /**
+   * @brief   Number of samples in the FIFO.
+   */
+  uint8_t level;
+
+  /**
+   * @brief   Flag whether the FIFO overran since it was last read.
+   */
+  bool overrun;
+
+  /**
+   * @brief   Current state of the INT2 line.
+   */
+  bool int2;
+
+  /**
+   * @brief   Accumulated sample time (output data rate times milliseconds).
+   */
+  uint32_t odracc;
+
+  /**
+   * @brief   Number of samples taken, selects the scripted values.
+   */
+  uint32_t samples;
+} mock_l3g4200d_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mockVcnl4020Init(mock_regmap_t* dev, mock_vcnl4020_t* model, event_source_t* evtsource, eventflags_t evtflags);
+  void mockL3g4200dInit(mock_regmap_t* dev, mock_l3g4200d_t* model, event_source_t* evtsource, eventflags_t evtflags);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AMIROOS_MOCK_DEVICES_H_ */
+
+/** @} */
@@ -0,0 +1,216 @@
+/*
+AMiRo-OS is an operating system designed for the Autonomous Mini Robot (AMiRo) platform.
+Copyright (C) 2016..2019  Thomas Schöpping et al.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    periphAL.h
+ * @brief   Periphery abstraction layer of the host unit tests.
+ * @details Implements the I2C and SPI interfaces on top of the mock buses
+ *          (see mock_bus.h) instead of the ChibiOS HAL.
+ *          GPIO, PWM and QEI are not provided, since none of the mocked
+ *          devices uses them. usleep() is provided by the host C library.
+ */
+
+#ifndef _AMIROOS_PERIPHAL_H_
+#define _AMIROOS_PERIPHAL_H_
+
+/*============================================================================*/
+/* VERSION                                                                    */
+/*============================================================================*/
+
+/**
+ * @brief   The periphery abstraction layer interface major version.
+ * @note    Changes of the major version imply incompatibilities.
+ */
+#define PERIPHAL_VERSION_MAJOR    1
+
+/**
+ * @brief   The periphery abstraction layer interface minor version.
+ * @note    A higher minor version implies new functionalty, but all old interfaces are still available.
+ */
+#define PERIPHAL_VERSION_MINOR    0
+
+/*============================================================================*/
+/* DEPENDENCIES                                                               */
+/*============================================================================*/
+
+#include <periphALtypes.h>
+#include <hal.h>
+#include <aos_debug.h>
+#include <mock_bus.h>
+#include <stdio.h>
+
+/*============================================================================*/
+/* I2C                                                                        */
+/*============================================================================*/
+
+/**
+ * @brief I2C driver type.
+ */
+typedef MockI2CDriver apalI2CDriver_t;
+
+/**
+ * @brief Transmit data and receive a response.
+ *
+ * @param[in]   i2cd      The I2C driver to use.
+ * @param[in]   addr      Address to write to.
+ * @param[in]   txbuf     Buffer containing data to send.
+ * @param[in]   txbytes   Number of bytes to send.
+ * @param[out]  rxbuf     Buffer to store a response to.
+ * @param[in]   rxbytes   Number of bytes to receive.
+ * @param[in]   timeout   Timeout for the function to return (in microseconds).
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalI2CMasterTransmit(apalI2CDriver_t* i2cd, const apalI2Caddr_t addr, const uint8_t* const txbuf, const size_t txbytes, uint8_t* const rxbuf, const size_t rxbytes, const apalTime_t timeout)
+{
+  aosDbgCheck(i2cd != NULL);
+  (void)timeout;
+
+  return (mockI2CMasterTransmit(i2cd, addr, txbuf, txbytes, rxbuf, rxbytes) == MSG_OK) ? APAL_STATUS_OK : APAL_STATUS_ERROR;
+}
+
+/**
+ * @brief Read data from a specific address.
+ *
+ * @param[in]   i2cd      The I2C driver to use.
+ * @param[in]   addr      Address to read.
+ * @param[out]  rxbuf     Buffer to store the response to.
+ * @param[in]   rxbytes   Number of bytes to receive.
+ * @param[in]   timeout   Timeout for the function to return (in microseconds).
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalI2CMasterReceive(apalI2CDriver_t* i2cd, const apalI2Caddr_t addr, uint8_t* const rxbuf, const size_t rxbytes, const apalTime_t timeout)
+{
+  aosDbgCheck(i2cd != NULL);
+  (void)timeout;
+
+  return (mockI2CMasterReceive(i2cd, addr, rxbuf, rxbytes) == MSG_OK) ? APAL_STATUS_OK : APAL_STATUS_ERROR;
+}
+
+/*============================================================================*/
+/* SPI                                                                        */
+/*============================================================================*/
+
+/**
+ * @brief SPI driver type.
+ */
+typedef MockSPIDriver apalSPIDriver_t;
+
+/**
+ * @brief SPI configuration type.
+ * @details The unit test data refers to the configuration, but the mock bus does not need any.
+ */
+typedef struct {
+  uint8_t unused;
+} SPIConfig;
+
+/**
+ * @brief Transmit and receive data from SPI
+ *
+ * @param[in]   spid      The SPI driver to use.
+ * @param[in]   txData    Buffer containing data to send.
+ * @param[out]  rxData    Buffer to store.
+ * @param[in]   length    Number of bytes to send.
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalSPIExchange(apalSPIDriver_t* spid, const uint8_t* const txData , uint8_t* const rxData, const size_t length)
+{
+  aosDbgCheck(spid != NULL);
+
+  mockSPIExchange(spid, txData, rxData, length);
+
+  return APAL_STATUS_OK;
+}
+
+/**
+ * @brief Receive data from SPI
+ *
+ * @param[in]   spid      The SPI driver to use.
+ * @param[out]  data      Buffer to store.
+ * @param[in]   length    Number of bytes to send.
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalSPIReceive(apalSPIDriver_t* spid, uint8_t* const data, const size_t length)
+{
+  aosDbgCheck(spid != NULL);
+
+  mockSPITransmitAndReceive(spid, NULL, 0, data, length);
+
+  return APAL_STATUS_OK;
+}
+
+/**
+ * @brief Transmit data to SPI
+ *
+ * @param[in]   spid      The SPI driver to use.
+ * @param[in]   data      Buffer containing data to send.
+ * @param[in]   length    Number of bytes to send.
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalSPITransmit(apalSPIDriver_t* spid, const uint8_t* const data, const size_t length)
+{
+  aosDbgCheck(spid != NULL);
+
+  mockSPITransmitAndReceive(spid, data, length, NULL, 0);
+
+  return APAL_STATUS_OK;
+}
+
+/**
+ * @brief Transmit data to SPI and receive data afterwards without releasing the bus in between
+ *
+ * @param   spid        The SPI driver to use.
+ * @param   txData      Transmit data buffer.
+ * @param   rxData      Receive data buffer.
+ * @param   txLength    Number of bytes to send.
+ * @param   rxLength    Number of bytes to receive.
+ *
+ * @return The status indicates whether the function call was succesful.
+ */
+static inline apalExitStatus_t apalSPITransmitAndReceive(apalSPIDriver_t* spid, const uint8_t* const txData , uint8_t* const rxData, const size_t txLength, const size_t rxLength)
+{
+  aosDbgCheck(spid != NULL);
+
+  mockSPITransmitAndReceive(spid, txData, txLength, rxData, rxLength);
+
+  return APAL_STATUS_OK;
+}
+
+/*============================================================================*/
+/* DEBUG                                                                      */
+/*============================================================================*/
+
+/**
+ * @brief Assert function to check a given condition.
+ *
+ * @param[in] c   The condition to check.
+ */
+#define apalDbgAssert(c)              aosDbgAssert(c)
+
+/**
+ * @brief Printf function for messages printed only in debug builds.
+ *
+ * @param[in] fmt   Formatted string to print.
+ */
+#define apalDbgPrintf(fmt, ...)       printf(fmt, ##__VA_ARGS__)
+
+#endif /* _AMIROOS_PERIPHAL_H_ */
@@ -16,9 +16,19 @@ using namespace types;
 using namespace amiro::constants;
 
 ControllerAreaNetworkRx::ControllerAreaNetworkRx(CANDriver *can, const uint8_t boardId)
-    : BaseStaticThread<128>(),
+    : BaseStaticThread<512>(),
       boardId(boardId),
+      proximityFloorTimestamp(0),
+      odometryTimestamp(0),
+      nextProximityRingTimestamp(0),
+      nextProximityFloorTimestamp(0),
+      nextOdometryTimestamp(0),
       canDriver(can) {
+  this->lidarWallTime = 0;
+  this->lidarWallValid = false;
+  for (int idx = 0; idx < 8; ++idx)
+    this->proximityRingTimestamp[idx] = 0;
+
 #ifdef STM32F4XX
   this->canConfig.mcr = CAN_MCR_ABOM | CAN_MCR_AWUM | CAN_MCR_TXFP;
   this->canConfig.btr = CAN_BTR_SJW(1) | CAN_BTR_TS2(3) | CAN_BTR_TS1(15)
@@ -54,10 +64,34 @@ msg_t ControllerAreaNetworkRx::receiveSensorVal(CANRxFrame *frame) {
       if (frame->DLC == 2) {
         int index = deviceId & 0x7;
         proximityRingValue[index] = frame->data16[0];
+        proximityRingTimestamp[index] = nextProximityRingTimestamp;
         return RDY_OK;
       }
       break;
 
+    case CAN::SENSOR_TIMESTAMP_ID:
+      // The meaning of the timestamps depends on the sending module
+      switch (this->decodeBoardId(frame)) {
+        case CAN::POWER_MANAGEMENT_ID:
+          if (frame->DLC == 4) {
+            nextProximityRingTimestamp = frame->data32[0];
+            return RDY_OK;
+          }
+          break;
+
+        case CAN::DI_WHEEL_DRIVE_ID:
+          if (frame->DLC == 8) {
+            nextOdometryTimestamp = frame->data32[0];
+            nextProximityFloorTimestamp = frame->data32[1];
+            return RDY_OK;
+          }
+          break;
+
+        default:
+          break;
+      }
+      break;
+
     case CAN::ACTUAL_SPEED_ID:
       if (frame->DLC == 8) {
         actualSpeed[0] = frame->data32[0];
@@ -71,6 +105,7 @@ msg_t ControllerAreaNetworkRx::receiveSensorVal(CANRxFrame *frame) {
         this->robotPosition.x = (frame->data8[0] << 8 | frame->data8[1] << 16 | frame->data8[2] << 24);
         this->robotPosition.y = (frame->data8[3] << 8 | frame->data8[4] << 16 | frame->data8[5] << 24);
         this->robotPosition.f_z = (frame->data8[6] << 8 | frame->data8[7] << 16);
+        this->odometryTimestamp = nextOdometryTimestamp;
         return RDY_OK;
       }
       break;
@@ -82,6 +117,7 @@ msg_t ControllerAreaNetworkRx::receiveSensorVal(CANRxFrame *frame) {
         proximityFloorValue[1] = frame->data16[1];
         proximityFloorValue[2] = frame->data16[2];
         proximityFloorValue[3] = frame->data16[3];
+        proximityFloorTimestamp = nextProximityFloorTimestamp;
         return RDY_OK;
       }
       break;
@@ -124,6 +160,23 @@ msg_t ControllerAreaNetworkRx::receiveSensorVal(CANRxFrame *frame) {
       }
       break;
 
+    case CAN::LIDAR_SCAN_ID:
+      if (this->lidarScan.receive(frame->data8, frame->DLC)) {
+        return RDY_OK;
+      }
+      break;
+
+    case CAN::LIDAR_WALL_ID:
+      if (frame->DLC == sizeof(LidarScan::Wall)) {
+        chSysLock();
+        memcpy(&this->lidarWall, frame->data8, sizeof(LidarScan::Wall));
+        this->lidarWallTime = chTimeNow();
+        this->lidarWallValid = true;
+        chSysUnlock();
+        return RDY_OK;
+      }
+      break;
+
     case CAN::GYROSCOPE_ID:
       if (frame->DLC == 6) {
         gyroscopeValue[0] = frame->data16[0];
@@ -176,6 +229,61 @@ uint16_t ControllerAreaNetworkRx::getProximityFloorValue(int index) {
   return this->proximityFloorValue[index];
 }
 
+uint32_t ControllerAreaNetworkRx::getProximityRingTimestamp(int index) {
+  return this->proximityRingTimestamp[index];
+}
+
+uint32_t ControllerAreaNetworkRx::getProximityFloorTimestamp() {
+  return this->proximityFloorTimestamp;
+}
+
+uint32_t ControllerAreaNetworkRx::getOdometryTimestamp() {
+  return this->odometryTimestamp;
+}
+
+bool ControllerAreaNetworkRx::getLidarScan(uint8_t (&ranges)[LidarScan::POINTS], uint32_t &scanCount) {
+  return this->lidarScan.getScan(ranges, scanCount);
+}
+
+LidarScan::Receiver& ControllerAreaNetworkRx::getLidarScanReceiver() {
+  return this->lidarScan;
+}
+
+systime_t ControllerAreaNetworkRx::getLidarWall(LidarScan::Wall &wall) {
+  systime_t age = TIME_INFINITE;
+
+  chSysLock();
+  if (this->lidarWallValid) {
+    wall = this->lidarWall;
+    age = chTimeNow() - this->lidarWallTime;
+  }
+  chSysUnlock();
+
+  return age;
+}
+
+//----------------------------------------------------------------
+
+msg_t ControllerAreaNetworkRx::receiveSystemTime(CANRxFrame *frame, uint64_t uptime) {
+  if (this->decodeDeviceId(frame) == CAN::SYSTEM_TIME_ID && frame->DLC == 4) {
+    // The time was taken right before the transmission of the frame. Without an uptime
+    // the frame waited in the FIFO for an unknown time and is not used.
+    if (uptime > 0)
+      SystemTime::synchronize(frame->data32[0] + CAN::SYSTEM_TIME_LATENCY, uptime);
+    return RDY_OK;
+  }
+  return RDY_RESET;
+}
+
+msg_t ControllerAreaNetworkRx::receivePowerState(CANRxFrame *frame) {
+  if (this->decodeDeviceId(frame) == CAN::POWER_STATE_ID && frame->DLC == 1) {
+    if (frame->data8[0] <= PowerState::PARKED)
+      PowerState::set(PowerState::State(frame->data8[0]));
+    return RDY_OK;
+  }
+  return RDY_RESET;
+}
+
 //----------------------------------------------------------------
 
 msg_t ControllerAreaNetworkRx::main(void) {
@@ -194,12 +302,22 @@ msg_t ControllerAreaNetworkRx::main(void) {
 
       case EVENT_MASK(CAN::RECEIVED_ID):
         CANRxFrame rxframe;
-        msg_t message = canReceive(this->canDriver, CAN_ANY_MAILBOX, &rxframe, TIME_IMMEDIATE);
-        if (message == RDY_OK) {
-          // chprintf((BaseSequentialStream*) &global.sercanmux1, "Rx Message");
-          message = this->receiveMessage(&rxframe);
-          if (message != RDY_OK)
-            this->receiveSensorVal(&rxframe);
+        // Take the time of reception before anything else for the time synchronisation.
+        // It is taken in this thread and not in the ISR, so it is only valid for the first
+        // frame: the FIFO was emptied before, so that frame arrived while this thread
+        // waited and is late by the wake-up latency only (part of SYSTEM_TIME_LATENCY).
+        // Later frames waited in the FIFO behind it for an unknown time.
+        uint64_t uptime = SystemTime::getUptime();
+        // Empty the FIFO, since one event may stand for several frames (e.g. LIDAR_SCAN_ID)
+        while (canReceive(this->canDriver, CAN_ANY_MAILBOX, &rxframe, TIME_IMMEDIATE) == RDY_OK) {
+          if (this->receiveSystemTime(&rxframe, uptime) != RDY_OK
+              && this->receivePowerState(&rxframe) != RDY_OK) {
+            // chprintf((BaseSequentialStream*) &global.sercanmux1, "Rx Message");
+            msg_t message = this->receiveMessage(&rxframe);
+            if (message != RDY_OK)
+              this->receiveSensorVal(&rxframe);
+          }
+          uptime = 0;
         }
         break;
     }
@@ -54,6 +54,22 @@ void ControllerAreaNetworkTx::setLightColor(int index, Color color) {
   this->transmitMessage(&frame);
 }
 
+void ControllerAreaNetworkTx::setLightAnimation(const LightAnimation &animation) {
+  CANTxFrame frame;
+  frame.SID = 0;
+  this->encodeDeviceId(&frame, CAN::LIGHT_ANIMATION_ID);
+  frame.data8[0] = animation.effect;
+  frame.data8[1] = animation.mask;
+  frame.data8[2] = animation.red;
+  frame.data8[3] = animation.green;
+  frame.data8[4] = animation.blue;
+  frame.data8[5] = animation.period;
+  frame.data8[6] = animation.repeat;
+  frame.data8[7] = animation.param;
+  frame.DLC = 8;
+  this->transmitMessage(&frame);
+}
+
 void ControllerAreaNetworkTx::setOdometry(types::position robotPosition) {
   CANTxFrame frame;
   frame.SID = 0;
@@ -123,6 +139,56 @@ void ControllerAreaNetworkTx::broadcastShutdown() {
 
 }
 
+void ControllerAreaNetworkTx::broadcastSystemTime() {
+  CANTxFrame frame;
+  frame.SID = 0x00u;
+  this->encodeDeviceId(&frame, CAN::SYSTEM_TIME_ID);
+  frame.DLC = 4;
+  // Same delay as transmitMessage(), but take the time as late as possible
+  BaseThread::sleep(MS2ST(2));
+  frame.data32[0] = SystemTime::getTime();
+  this->sendMessage(&frame);
+}
+
+void ControllerAreaNetworkTx::broadcastPowerState(PowerState::State state) {
+  // The frame is not received by this module itself
+  PowerState::set(state);
+
+  CANTxFrame frame;
+  frame.SID = 0x00u;
+  this->encodeDeviceId(&frame, CAN::POWER_STATE_ID);
+  frame.data8[0] = state;
+  frame.DLC = 1;
+  this->transmitMessage(&frame);
+}
+
+void ControllerAreaNetworkTx::broadcastLidarScan(const uint8_t (&ranges)[LidarScan::POINTS], uint8_t sequence) {
+  CANTxFrame frame;
+
+  BaseThread::sleep(MS2ST(2));
+
+  // The frames are sent back to back, canTransmit() waits for a free mailbox
+  for (uint8_t fragment = 0; fragment < LidarScan::FRAGMENTS; ++fragment) {
+    const uint16_t first = fragment * LidarScan::FRAGMENT_POINTS;
+    const uint8_t count = (LidarScan::POINTS - first < LidarScan::FRAGMENT_POINTS) ? LidarScan::POINTS - first : LidarScan::FRAGMENT_POINTS;
+    frame.SID = 0x00u;
+    this->encodeDeviceId(&frame, CAN::LIDAR_SCAN_ID);
+    frame.data8[0] = ((sequence & 0x0Fu) << 4) | fragment;
+    memcpy(&frame.data8[1], &ranges[first], count);
+    frame.DLC = 1 + count;
+    this->sendMessage(&frame);
+  }
+}
+
+void ControllerAreaNetworkTx::broadcastLidarWall(const LidarScan::Wall &wall) {
+  CANTxFrame frame;
+  frame.SID = 0x00u;
+  this->encodeDeviceId(&frame, CAN::LIDAR_WALL_ID);
+  memcpy(frame.data8, &wall, sizeof(wall));
+  frame.DLC = sizeof(wall);
+  this->transmitMessage(&frame);
+}
+
 //----------------------------------------------------------------
 
 void ControllerAreaNetworkTx::txQueryShell(uint8_t toBoardId, char *textdata, uint16_t size) {
@@ -177,8 +243,16 @@ msg_t ControllerAreaNetworkTx::main(void) {
     eventmask_t eventMask = this->waitOneEvent(ALL_EVENTS);
     switch (eventMask) {
       case EVENT_MASK(CAN::PERIODIC_TIMER_ID):
+        // Keep the system time running, see SystemTime::getUptime()
+        SystemTime::getUptime();
         updateSensorVal();
         periodicBroadcast();
+        // Drop to a heartbeat while the robot is parked
+        if (this->evtimer.et_interval != PowerState::getUpdatePeriod()) {
+          chSysLock();
+          this->evtimer.et_interval = PowerState::getUpdatePeriod();
+          chSysUnlock();
+        }
         break;
     }
   }
@@ -210,6 +284,11 @@ void ControllerAreaNetworkTx::encodeIndexId(CANTxFrame *frame, int index) {
 //----------------------------------------------------------------
 
 void ControllerAreaNetworkTx::transmitMessage(CANTxFrame *frame) {
+  BaseThread::sleep(MS2ST(2));
+  this->sendMessage(frame);
+}
+
+void ControllerAreaNetworkTx::sendMessage(CANTxFrame *frame) {
   this->encodeBoardId(frame, boardId);
   frame->IDE = CAN_IDE_STD;
   frame->RTR = CAN_RTR_DATA;
@@ -224,6 +303,5 @@ void ControllerAreaNetworkTx::transmitMessage(CANTxFrame *frame) {
    * 1/ (1 MHz) * (SOF + ID + RTR + IDE + RES + DLC + DATA + CRC + DELIM + ACK + DELIM + EOF) * #RETRIES
    */
 
-  BaseThread::sleep(MS2ST(2));
   canTransmit(this->canDriver, CAN_TX_MAILBOXES, frame, US2ST(545));
 }
@@ -19,9 +19,9 @@ getVcnl4020Offset (uint16_t *buffer, uint8_t idx) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_1, vcnl4020offset[idx]));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_1, vcnl4020offset[idx]));
       if (this->bsmv >= 0x01u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -51,9 +51,9 @@ setVcnl4020Offset (uint16_t buffer, uint8_t idx) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_1, vcnl4020offset[idx]));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_1, vcnl4020offset[idx]));
       if (this->bsmv >= 0x01u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -79,9 +79,9 @@ setwheelfactor (float buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, wheelfactor));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, wheelfactor));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -107,9 +107,9 @@ getWheelFactor (float *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, wheelfactor));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, wheelfactor));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -135,9 +135,9 @@ setiGain (float buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, igain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, igain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -163,9 +163,9 @@ getiGain (float *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, igain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, igain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -193,9 +193,9 @@ setdGain (float buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, dgain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, dgain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -221,9 +221,9 @@ getdGain (float *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, dgain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, dgain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -251,9 +251,9 @@ setpGain (int buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, pgain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, pgain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -279,9 +279,9 @@ getpGain (int *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, pgain));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_3, pgain));
       if (this->bsmv >= 0x03u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -308,9 +308,9 @@ getEd (float *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Ed));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Ed));
       if (this->bsmv >= 0x02u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -335,9 +335,9 @@ setEd (float buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Ed));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Ed));
       if (this->bsmv >= 0x02u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -362,9 +362,9 @@ getEb (float *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Eb));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Eb));
       if (this->bsmv >= 0x02u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -389,9 +389,9 @@ setEb (float buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Eb));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIODiWheelDrive::DiWheelDrive_1_2, Eb));
       if (this->bsmv >= 0x02u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
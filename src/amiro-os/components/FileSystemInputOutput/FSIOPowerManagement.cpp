@@ -19,9 +19,9 @@ getVcnl4020Offset (uint16_t *buffer, uint8_t idx) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIOPowerManagement::PowerManagement_1_1, vcnl4020offset[idx]));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIOPowerManagement::PowerManagement_1_1, vcnl4020offset[idx]));
       if (this->bsmv >= 0x01u) {
-        bytesWritten = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+        bytesWritten = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -51,9 +51,9 @@ setVcnl4020Offset (uint16_t buffer, uint8_t idx) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FSIOPowerManagement::PowerManagement_1_1, vcnl4020offset[idx]));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FSIOPowerManagement::PowerManagement_1_1, vcnl4020offset[idx]));
       if (this->bsmv >= 0x01u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
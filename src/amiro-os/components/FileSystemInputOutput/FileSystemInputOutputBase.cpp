@@ -1,8 +1,270 @@
 #include <amiro/FileSystemInputOutput/FileSystemInputOutputBase.hpp>
 
+#include <cstring>
+
 using namespace amiro;
 using namespace amiro::fileSystemIo;
 
+static const struct BaseFileStreamVMT fsio_cache_base_file_stream_methods = {
+
+    /* .write       */ FileSystemIoBase::cacheWrite,
+    /* .read        */ FileSystemIoBase::cacheRead,
+    /* .put         */ 0,
+    /* .get         */ 0,
+    /* .close       */ FileSystemIoBase::cacheClose,
+    /* .geterror    */ FileSystemIoBase::cacheGeterror,
+    /* .getsize     */ FileSystemIoBase::cacheGetsize,
+    /* .getposition */ FileSystemIoBase::cacheGetposition,
+    /* .lseek       */ FileSystemIoBase::cacheLseek,
+
+};
+
+FileSystemIoBase::
+FileSystemIoBase(AT24 &at24c01, uint8_t BSMV, uint8_t bsmv, uint8_t HMV, uint8_t hmv)
+  : at24c01(at24c01),
+    BSMV(BSMV),
+    bsmv(bsmv),
+    HMV(HMV),
+    hmv(hmv),
+    imageValid(false),
+    dirtyMask(0),
+    pageWrites{},
+    writeErrors(0) {
+
+  this->cache.bfs.vmt = &fsio_cache_base_file_stream_methods;
+  this->cache.fsio = this;
+  this->cache.position = 0;
+  chMtxInit(&this->mutex);
+  chMtxInit(&this->syncMutex);
+}
+
+msg_t
+FileSystemIoBase::
+main() {
+
+  this->setName("FSIO");
+
+  while (!this->shouldTerminate()) {
+
+    // write back what is pending (e.g. modifications before the start)
+    if (this->getDirtyPages() > 0) {
+      // let further modifications accumulate
+      this->sleep(FLUSH_DELAY);
+      this->sync();
+    }
+
+    // retry failed pages after another delay
+    this->waitAnyEventTimeout(ALL_EVENTS, (this->getDirtyPages() > 0) ? FLUSH_DELAY : TIME_INFINITE);
+  }
+
+  this->sync();
+
+  return RDY_OK;
+}
+
+msg_t
+FileSystemIoBase::
+sync() {
+
+  msg_t res = OK;
+
+  // serialize the write-backs of the thread and of other callers
+  chMtxLock(&this->syncMutex);
+
+  for (uint8_t page = 0; page < this->getNumPages(); ++page) {
+    res |= this->flushPage(page);
+  }
+
+  chMtxUnlock();
+
+  return res;
+}
+
+msg_t
+FileSystemIoBase::
+flushPage(uint8_t page) {
+
+  const uint8_t pageSize = this->at24c01.page_size;
+  const uint32_t mask = (1u << page);
+  uint8_t *buffer = this->pageBuffer;
+
+  chDbgAssert(pageSize <= sizeof(this->pageBuffer), "FileSystemIoBase::flushPage(), #1", "page size not supported");
+
+  // take a snapshot of the page, modifications during the write mark it dirty again
+  chMtxLock(&this->mutex);
+  const bool dirty = (this->dirtyMask & mask);
+  if (dirty) {
+    memcpy(buffer, &this->image[page * pageSize], pageSize);
+    this->dirtyMask &= ~mask;
+  }
+  chMtxUnlock();
+
+  if (!dirty) {
+    return OK;
+  }
+
+  this->at24c01.acquire();
+  chFileStreamSeek((BaseFileStream*)&this->at24c01, page * pageSize);
+  const size_t bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, pageSize);
+  this->at24c01.release();
+
+  chMtxLock(&this->mutex);
+  if (bytesWritten == pageSize) {
+    ++this->pageWrites[page];
+  } else {
+    this->dirtyMask |= mask;
+    ++this->writeErrors;
+  }
+  chMtxUnlock();
+
+  return (bytesWritten == pageSize) ? OK : IO_ERROR;
+}
+
+bool
+FileSystemIoBase::
+load() {
+
+  if (this->imageValid) {
+    return true;
+  }
+
+  const size_t size = static_cast<size_t>(cacheGetsize(&this->cache));
+
+  chDbgAssert(size / this->at24c01.page_size <= MAX_PAGES, "FileSystemIoBase::load(), #1", "too many pages");
+
+  this->at24c01.acquire();
+  chFileStreamSeek((BaseFileStream*)&this->at24c01, 0);
+  this->imageValid = (chSequentialStreamRead((BaseFileStream*)&this->at24c01, this->image, size) == size);
+  this->at24c01.release();
+
+  return this->imageValid;
+}
+
+uint32_t
+FileSystemIoBase::
+getPageWrites(uint8_t page) {
+
+  return (page < MAX_PAGES) ? this->pageWrites[page] : 0;
+}
+
+uint32_t
+FileSystemIoBase::
+getWriteErrors() {
+
+  return this->writeErrors;
+}
+
+uint8_t
+FileSystemIoBase::
+getDirtyPages() {
+
+  return __builtin_popcount(this->dirtyMask);
+}
+
+uint8_t
+FileSystemIoBase::
+getNumPages() {
+
+  return cacheGetsize(&this->cache) / this->at24c01.page_size;
+}
+
+size_t
+FileSystemIoBase::
+cacheWrite(void *instance, const uint8_t *bp, size_t n) {
+
+  Cache *cache = (Cache*) instance;
+  FileSystemIoBase *fsio = cache->fsio;
+  const size_t size = static_cast<size_t>(cacheGetsize(cache));
+  const uint8_t pageSize = fsio->at24c01.page_size;
+  size_t bytesWritten = 0;
+  bool modified = false;
+
+  chMtxLock(&fsio->mutex);
+
+  if (fsio->load() && static_cast<size_t>(cache->position) < size) {
+    bytesWritten = (n < size - cache->position) ? n : size - cache->position;
+    for (size_t i = 0; i < bytesWritten; ++i) {
+      const size_t address = cache->position + i;
+      // unchanged bytes are not written again
+      if (fsio->image[address] != bp[i]) {
+        fsio->image[address] = bp[i];
+        fsio->dirtyMask |= (1u << (address / pageSize));
+        modified = true;
+      }
+    }
+    cache->position += bytesWritten;
+  }
+
+  chMtxUnlock();
+
+  // wake up the write-back thread (if started)
+  if (modified && fsio->thread_ref != NULL) {
+    fsio->signalEvents(EVENT_MASK(0));
+  }
+
+  return bytesWritten;
+}
+
+size_t
+FileSystemIoBase::
+cacheRead(void *instance, uint8_t *bp, size_t n) {
+
+  Cache *cache = (Cache*) instance;
+  FileSystemIoBase *fsio = cache->fsio;
+  const size_t size = static_cast<size_t>(cacheGetsize(cache));
+  size_t bytesRead = 0;
+
+  chMtxLock(&fsio->mutex);
+
+  if (fsio->load() && static_cast<size_t>(cache->position) < size) {
+    bytesRead = (n < size - cache->position) ? n : size - cache->position;
+    memcpy(bp, &fsio->image[cache->position], bytesRead);
+    cache->position += bytesRead;
+  }
+
+  chMtxUnlock();
+
+  return bytesRead;
+}
+
+uint32_t
+FileSystemIoBase::
+cacheClose(void *instance) {
+
+  (void) instance;
+  return FILE_OK;
+}
+
+int
+FileSystemIoBase::
+cacheGeterror(void *instance) {
+
+  return EEPROM::geterror(&((Cache*) instance)->fsio->at24c01);
+}
+
+fileoffset_t
+FileSystemIoBase::
+cacheGetsize(void *instance) {
+
+  const fileoffset_t size = EEPROM::getsize(&((Cache*) instance)->fsio->at24c01);
+  return (size < CACHE_SIZE) ? size : static_cast<fileoffset_t>(CACHE_SIZE);
+}
+
+fileoffset_t
+FileSystemIoBase::
+cacheGetposition(void *instance) {
+
+  return ((Cache*) instance)->position;
+}
+
+fileoffset_t
+FileSystemIoBase::
+cacheLseek(void *instance, fileoffset_t offset) {
+
+  ((Cache*) instance)->position = offset;
+  return FILE_OK;
+}
+
 msg_t
 FileSystemIoBase::init()
 {
@@ -11,8 +273,8 @@ FileSystemIoBase::init()
   // Get the preamble
   const uint8_t bufferSize = sizeof(FileSystemIoBase::preamble_1_1);
   uint8_t buffer[bufferSize];
-  chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
-  const size_t bytesRead = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+  chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
+  const size_t bytesRead = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
 
   // reading failed -> error
   if (bytesRead != bufferSize) {
@@ -63,8 +325,8 @@ getCheck() {
   // Get the preamble
   const uint8_t bufferSize = sizeof(FileSystemIoBase::preamble_1_1);
   uint8_t buffer[bufferSize];
-  chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
-  const size_t bytesRead = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) buffer, bufferSize);
+  chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
+  const size_t bytesRead = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) buffer, bufferSize);
 
   if (bytesRead != bufferSize) {
     return IO_ERROR;
@@ -90,9 +352,9 @@ FileSystemIoBase::initPreamble(const uint8_t BSMV, const uint8_t bsmv, const boo
 
   if (strict) {
     // initialize the magic byte
-    chFileStreamSeek((BaseFileStream*)&this->at24c01, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
+    chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, magicByte));
     buffer[0] = magicByteValue();
-    if (chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, 1) != 1) {
+    if (chSequentialStreamWrite((BaseFileStream*)&this->cache, buffer, 1) != 1) {
       return IO_ERROR;
     }
   }
@@ -102,16 +364,16 @@ FileSystemIoBase::initPreamble(const uint8_t BSMV, const uint8_t bsmv, const boo
     case 1:
       if (strict) {
         // initialize the BSMV
-        chFileStreamSeek((BaseFileStream*)&this->at24c01, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMajorVersion));
+        chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMajorVersion));
         buffer[0] = BSMV;
-        if (chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, 1) != 1) {
+        if (chSequentialStreamWrite((BaseFileStream*)&this->cache, buffer, 1) != 1) {
           return IO_ERROR;
         }
       }
       // initialize the bsmv
-      chFileStreamSeek((BaseFileStream*)&this->at24c01, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMinorVersion));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMinorVersion));
       buffer[0] = bsmv;
-      if (chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, 1) != 1) {
+      if (chSequentialStreamWrite((BaseFileStream*)&this->cache, buffer, 1) != 1) {
         return IO_ERROR;
       }
       // initialize the content
@@ -119,9 +381,9 @@ FileSystemIoBase::initPreamble(const uint8_t BSMV, const uint8_t bsmv, const boo
       {
         case 2:
           // initialize the board ID
-          chFileStreamSeek((BaseFileStream*)&this->at24c01, offsetof(FileSystemIoBase::preamble_1_2, boardId));
+          chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_2, boardId));
           buffer[0] = 0;
-          if (chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, 1) != 1) {
+          if (chSequentialStreamWrite((BaseFileStream*)&this->cache, buffer, 1) != 1) {
             return IO_ERROR;
           }
           if (!strict) {
@@ -130,11 +392,11 @@ FileSystemIoBase::initPreamble(const uint8_t BSMV, const uint8_t bsmv, const boo
 
         case 1:
           // initialize the bsmv, the HMV and the hmv
-          chFileStreamSeek((BaseFileStream*)&this->at24c01, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMinorVersion));
+          chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_1, byteStructureMinorVersion));
           buffer[0] = bsmv;
           buffer[1] = this->HMV;
           buffer[2] = this->hmv;
-          if (chSequentialStreamWrite((BaseFileStream*)&this->at24c01, buffer, 3) != 3) {
+          if (chSequentialStreamWrite((BaseFileStream*)&this->cache, buffer, 3) != 3) {
             return IO_ERROR;
           }
           if (!strict) {
@@ -173,9 +435,9 @@ getBoardId (uint8_t *buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FileSystemIoBase::preamble_1_2, boardId));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_2, boardId));
       if (this->bsmv >= 0x02u) {
-        bytesRead = chSequentialStreamRead((BaseFileStream*)&at24c01, (uint8_t*) bufferTmp, bufferSize);
+        bytesRead = chSequentialStreamRead((BaseFileStream*)&this->cache, (uint8_t*) bufferTmp, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -203,9 +465,9 @@ setBoardId (uint8_t buffer) {
   switch (this->BSMV) {
     case 0x01u:
       // Set the pointer to the address
-      chFileStreamSeek((BaseFileStream*)&at24c01, offsetof(FileSystemIoBase::preamble_1_2, boardId));
+      chFileStreamSeek((BaseFileStream*)&this->cache, offsetof(FileSystemIoBase::preamble_1_2, boardId));
       if (this->bsmv >= 0x02u) {
-        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&at24c01, (const uint8_t*) &buffer, bufferSize);
+        bytesWritten = chSequentialStreamWrite((BaseFileStream*)&this->cache, (const uint8_t*) &buffer, bufferSize);
       } else {
         return NOT_IMPLEMENTED;
       }
@@ -1,5 +1,7 @@
 #include <amiro/Lidar.h>
 
+#include <chdebug.h>
+
 #include <global.hpp>
 
 using namespace chibios_rt;
@@ -7,13 +9,25 @@ using namespace amiro;
 
 extern Global global;
 
-uint8_t Lidar::scannedData[NUMBER_OF_CHARACTERS + 1] = {};
+static_assert((LIDAR_RX_CHUNK_SIZE & (LIDAR_RX_CHUNK_SIZE - 1)) == 0, "LIDAR_RX_CHUNK_SIZE must be a power of two");
 
 Lidar::Lidar(const uint8_t boardId, Lidar::SETUP setup)
     : BaseStaticThread<256>(),
+      uartConfig{
+        /* txend1_cb    */ NULL,
+        /* txend2_cb    */ Lidar::txEndCallback,
+        /* rxend_cb     */ Lidar::rxEndCallback,
+        /* rxchar_cb    */ NULL,
+        /* rxerr_cb     */ NULL,
+        /* speed        */ 19200,
+        /* CR1 register */ 0,
+        /* CR2 register */ 0,
+        /* CR3 register */ 0
+      },
       boardId(boardId),
       setup(setup) {
 
+  chBSemInit(&this->txDone, TRUE);
 }
 
 Lidar::
@@ -31,14 +45,85 @@ Lidar::
   this->isReady = false;
 };
 
-void Lidar::flushSD2InputQueue() {
+void Lidar::rxEndCallback(UARTDriver *uartp) {
+  Lidar &lidar = global.lidar;
+
+  // Continue with the other buffer right away, the USART holds the next
+  // character until the DMA is enabled again
+  chSysLockFromIsr();
+  lidar.rxEnd += LIDAR_RX_CHUNK_SIZE;
+  uartStartReceiveI(uartp, LIDAR_RX_CHUNK_SIZE, lidar.rxBuffer[(lidar.rxEnd / LIDAR_RX_CHUNK_SIZE) & 1]);
+  if (lidar.thread_ref != NULL) {
+    chEvtSignalI(lidar.thread_ref, EVENT_MASK(0));
+  }
+  chSysUnlockFromIsr();
+}
+
+void Lidar::txEndCallback(UARTDriver *uartp) {
+  (void) uartp;
+
+  chSysLockFromIsr();
+  chBSemSignalI(&global.lidar.txDone);
+  chSysUnlockFromIsr();
+}
+
+void Lidar::startSerial(uint32_t speed) {
+
+  uartStop(&UARTD2);
+  this->uartConfig.speed = speed;
+  uartStart(&UARTD2, &this->uartConfig);
+
+  // Drop everything received so far and start the reception into the first buffer
+  this->rxEnd = 0;
+  this->rxRead = 0;
+  uartStartReceive(&UARTD2, LIDAR_RX_CHUNK_SIZE, this->rxBuffer[0]);
+}
+
+void Lidar::sendCommand(const char *command) {
+
+  chBSemReset(&this->txDone, TRUE);
+  uartStartSend(&UARTD2, strlen(command), command);
+  if (chBSemWaitTimeout(&this->txDone, MS2ST(100)) != RDY_OK) {
+    uartStopSend(&UARTD2);
+  }
+}
+
+size_t Lidar::fetchData(const uint8_t *&data) {
+
+  chDbgAssert(chThdSelf() == this->thread_ref, "Lidar::fetchData(), #1", "not the Lidar thread");
+
   chSysLock();
-  chIQResetI(&SD2.iqueue);
+  // The DMA counter is consistent with rxEnd here, since the end of buffer
+  // interrupt is masked (a full buffer reads as LIDAR_RX_CHUNK_SIZE)
+  const uint32_t end = this->rxEnd;
+  const uint32_t fill = LIDAR_RX_CHUNK_SIZE - dmaStreamGetTransactionSize(UARTD2.dmarx);
   chSysUnlock();
+
+  // Only the last completed and the active buffer are valid
+  if (end - this->rxRead > LIDAR_RX_CHUNK_SIZE) {
+    this->rxRead = end;
+    ++this->errorCount;
+    this->resetDecoder();
+  }
+
+  const uint32_t offset = this->rxRead % LIDAR_RX_CHUNK_SIZE;
+  const uint32_t available = (end + fill) - this->rxRead;
+  data = &this->rxBuffer[(this->rxRead / LIDAR_RX_CHUNK_SIZE) & 1][offset];
+
+  return (available < LIDAR_RX_CHUNK_SIZE - offset) ? available : LIDAR_RX_CHUNK_SIZE - offset;
+}
+
+bool_t Lidar::consumeData(size_t n) {
+
+  // The characters must not have been overwritten while they were processed
+  const bool_t valid = (this->rxEnd - this->rxRead <= LIDAR_RX_CHUNK_SIZE);
+  this->rxRead += n;
+  return valid;
 }
 
 msg_t Lidar::main(void) {
 
+  this->setName("Lidar");
 
   switch (this->boardId) {
     case(CAN::LIGHT_RING_ID): {
@@ -49,22 +134,20 @@ msg_t Lidar::main(void) {
 
       // Setup the driver and lidar, if we want to communicate with it
       if (setup != SETUP::POWER_ONLY) {
-        // Flush the queue because there is a "0" in it
-        flushSD2InputQueue();
+        // Start at the default speed of the LIDAR and drop what was received so far
+        startSerial(19200);
 
         // Configure LIDAR serial interface speed
-//       chprintf((BaseSequentialStream*) &global.sercanmux1, "Speed switch to " STR(SD_SPEED) "\n");
-        chprintf((BaseSequentialStream*) &SD2, "SS" STR(SD_SPEED_PREFIX) STR(SD_SPEED) LF);
+        sendCommand("SS" STR(SD_SPEED_PREFIX) STR(SD_SPEED) LF);
 
         // Check if the switch went well, otherwise terminate the thread
         if (checkDataString("SS" STR(SD_SPEED_PREFIX) STR(SD_SPEED) "\n00P\n\n")) {
           chprintf((BaseSequentialStream*) &global.sercanmux1, "Lidar speed switch OK\n");
           // Configure serial interface of STM32
-          sdStop(&SD2);
-          SerialConfig sdLidarconf = { SD_SPEED, 0, 0, 0 };
-          sdStart(&SD2, &sdLidarconf);
+          startSerial(SD_SPEED);
         } else {
           chprintf((BaseSequentialStream*) &global.sercanmux1, "Lidar speed switch NOT OK: Terminating Lidar \n");
+          uartStop(&UARTD2);
           palWritePad(GPIOB, GPIOB_LASER_EN, PAL_LOW);
           return -1;
         }
@@ -75,178 +158,198 @@ msg_t Lidar::main(void) {
       break;
   }
 
-  evtInit(&this->evtimer, UPDATE_LIDAR_PERIOD_MSEC);
-
-  EvtSource *eventTimerEvtSource = reinterpret_cast<EvtSource *>(&this->evtimer.et_es);
+  if (setup == SETUP::POWER_ONLY) {
+    while (!this->shouldTerminate()) {
+      this->waitAnyEventTimeout(ALL_EVENTS, MS2ST(100));
+    }
+    return RDY_OK;
+  }
 
-  EvtListener eventTimerEvtListener;
+  systime_t lastScan = chTimeNow();
+  uint32_t lastScanCount = this->scanCount;
+  bool_t streaming = false;
 
-  // TODO Does PERIODIC_TIMER_ID has something to do with ControllerAreNetwork.h ?
-  eventTimerEvtSource->registerOne(&eventTimerEvtListener, CAN::PERIODIC_TIMER_ID);
+  while (!this->shouldTerminate()) {
 
-  evtStart(&this->evtimer);
+    // (Re)start the continuous scan
+    if (!streaming) {
+//                   Read (725-(44-1))=682 values with two-character encoding what makes 1364 datapoints per scan
+      this->resetDecoder();
+      sendCommand(DATA_ACQ_CODE STR(STARTING_STEP_PREFIX) STR(STARTING_STEP) STR(END_STEP_PREFIX) STR(END_STEP) STR(CLUSTER_COUNT) STR(SCAN_INTERVALL) STR(NUMBER_OF_INTERVALL) LF);
+      lastScan = chTimeNow();
+      streaming = true;
+    }
 
-  this->setName("Lidar");
+    // Wait for a full buffer, but decode partially filled buffers as well
+    this->waitAnyEventTimeout(ALL_EVENTS, LIDAR_RX_POLL_PERIOD);
 
-  while (!this->shouldTerminate()) {
+    const uint8_t *data;
+    size_t n;
+    while ((n = fetchData(data)) > 0) {
+      for (size_t idx = 0; idx < n; ++idx) {
+        decode(data[idx]);
+      }
+      if (!consumeData(n)) {
+        ++this->errorCount;
+        resetDecoder();
+      }
+    }
 
-    eventmask_t eventMask = this->waitOneEvent(ALL_EVENTS);
-    switch (eventMask) {
-      case EVENT_MASK(CAN::PERIODIC_TIMER_ID):
-//         printDetails();
-        if (setup != SETUP::POWER_ONLY) {
-          updateSensorVal();
-        }
-        break;
+    if (this->scanCount != lastScanCount) {
+      lastScanCount = this->scanCount;
+      lastScan = chTimeNow();
+    } else if (chTimeElapsedSince(lastScan) > LIDAR_SCAN_TIMEOUT) {
+      streaming = false;
     }
   }
 
-  evtStop(&this->evtimer);
-  eventTimerEvtSource->unregister(&eventTimerEvtListener);
+  // Stop the stream and switch off the laser
+  sendCommand("QT" LF);
+  uartStop(&UARTD2);
 
   return RDY_OK;
 }
 
 bool_t Lidar::getScan(uint16_t (&scannedData)[NUMBER_OF_STEPS]) {
-  if (this->isReady && !this->isFail) {
+  return getScan(scannedData, this->scanCountRead);
+}
+
+bool_t Lidar::getScan(uint16_t (&scannedData)[NUMBER_OF_STEPS], uint32_t &lastScanCount) {
+
+  // The decoder never writes the front buffer, so copy it without locking
+  // and check that no further scan was completed in the meantime
+  for (uint8_t attempt = 0; attempt < 3; ++attempt) {
     chSysLock();
-      memcpy(&scannedData, &(Lidar::scannedData[0]), NUMBER_OF_CHARACTERS);
-      this->isReady = false;
+    const uint32_t scanCount = this->scanCount;
+    const uint8_t frontIdx = this->frontIdx;
     chSysUnlock();
-    return true;
-  } else {
-    return false;
+
+    if (scanCount == lastScanCount) {
+      return false;
+    }
+
+    memcpy(&scannedData, &this->scans[frontIdx], sizeof(scannedData));
+
+    chSysLock();
+    const bool_t valid = (scanCount == this->scanCount);
+    chSysUnlock();
+
+    if (valid) {
+      lastScanCount = scanCount;
+      return true;
+    }
   }
+
+  return false;
 }
 
 uint16_t Lidar::getNumberOfValues() {
   return NUMBER_OF_STEPS;
 }
 
+uint32_t Lidar::getScanCount() {
+  return this->scanCount;
+}
+
+uint32_t Lidar::getErrorCount() {
+  return this->errorCount;
+}
+
 uint16_t Lidar::twoCharacterEncoding(uint8_t &char1, uint8_t &char2) {
   return uint16_t((((char1 - 0x30) & 0b00111111) << 6) | ((char2 - 0x30) & 0b00111111));
 }
 
 bool_t Lidar::getData(uint8_t &data, uint32_t timeoutMs) {
 
-//     data = sdGet(&SD2);
-    msg_t dataTmp = chIQGetTimeout(&SD2.iqueue, MS2ST(timeoutMs));
-    if  (dataTmp == Q_TIMEOUT || dataTmp == Q_RESET) {
+  const systime_t start = chTimeNow();
+  const uint8_t *received;
+
+  while (fetchData(received) == 0) {
+    if (chTimeElapsedSince(start) >= MS2ST(timeoutMs)) {
       return false;
-    } else {
-      data = uint8_t(dataTmp);
-      ++this->dataCounter;
-      return true;
     }
+    this->waitAnyEventTimeout(ALL_EVENTS, LIDAR_RX_POLL_PERIOD);
+  }
+
+  data = *received;
+  consumeData(1);
+  return true;
 }
 
-msg_t Lidar::updateSensorVal() {
+void Lidar::resetDecoder() {
+  this->step = DATA_VALID_CHECK;
+  this->checkStatusIdx = 0;
+}
 
-  chSysLock();
-    // Set this flag so that the everyone knows, that scannedData will be filed right now
-    this->isReady = false;
-    // Reset the FAIL flag
-    this->isFail = false;
-  chSysUnlock();
+void Lidar::decode(uint8_t input) {
 
-  while (!this->isReady) {
-    switch(step) {
-      case SEND_SCAN_CMD:
-        flushSD2InputQueue();
-//                     Read (725-(44-1))=682 values with two-character encoding what makes 1364 datapoints
-//                     1456 in total:
-//                     16 (Cmd-Echo) + ? (Remaining Scans) + 1 (LF) + ? (String Characters) + 1 (LF) + 2 (Status) + 1 (Sum) + 1 (LF) + ? (Timestamp) + 1 (LF) + 1364 (Data for a certain setup) + 1 (Sum) + 1 (LF) + 1 (LF)
-        chprintf((BaseSequentialStream*) &SD2,DATA_ACQ_CODE STR(STARTING_STEP_PREFIX) STR(STARTING_STEP) STR(END_STEP_PREFIX) STR(END_STEP) STR(CLUSTER_COUNT) STR(SCAN_INTERVALL) STR(NUMBER_OF_INTERVALL) LF);
-        step = DATA_VALID_CHECK;
-        this->dataCounter = 0;
-        break;
-      case DATA_VALID_CHECK:
-        if(getData(this->newInput, 200)) {
-          // TODO check for last data, if scan has a few errors
-          // HACK The timeout fix this issue at least, because after a while there
-          //      wont be any transmitts
-          if (this->newInput == validScanTag[this->checkStatusIdx]) {
-            if (++this->checkStatusIdx == 5) {
-              // scan_data is without error: Found the sting "\n99b\n"
-              step = DATA_START_CHECK;
-              this->checkStatusIdx = 0;
-            }
+  switch(step) {
+    case DATA_VALID_CHECK:
+      // Every scan starts with the command echo and the status "\n99b\n"
+      if (input == validScanTag[this->checkStatusIdx]) {
+        if (++this->checkStatusIdx == 5) {
+          step = DATA_START_CHECK;
+          this->checkStatusIdx = 0;
+        }
+      } else {
+        this->checkStatusIdx = (input == validScanTag[0]) ? 1 : 0;
+      }
+      break;
+    case DATA_START_CHECK:
+      // Skip the timestamp, the data starts after the next linefeed
+      if (input == 10) {
+        step = DATA_RECORD;
+        this->dataIdx = 0;
+        this->heldInput = 0;
+        this->highInput = 0;
+        this->lineSum = 0;
+        this->lineError = false;
+        this->lastInput = input;
+      }
+      break;
+    case DATA_RECORD:
+      if (input != 10) {
+        // The last character of a line is its checksum, so decode a character
+        // not until the next one has been received
+        if (this->heldInput != 0) {
+          this->lineSum += this->heldInput;
+          if (this->highInput == 0) {
+            this->highInput = this->heldInput;
           } else {
-            this->checkStatusIdx = 0;
+            if (this->dataIdx < NUMBER_OF_STEPS) {
+              this->scans[1 - this->frontIdx][this->dataIdx] = twoCharacterEncoding(this->highInput, this->heldInput);
+            }
+            ++this->dataIdx;
+            this->highInput = 0;
           }
-        } else {
-          step = FAIL;
         }
-        break;
-      case DATA_START_CHECK:
-        // Check for the next linefeed to start the record
-        if(getData(this->newInput, 200)) {
-          if (this->newInput == 10) {
-            step = DATA_RECORD;
-            this->dataIdx = 0;
-          }
-        } else {
-          step = FAIL;
+        this->heldInput = input;
+      } else if (this->lastInput != 10) {
+        // End of a line: the held character is the checksum of the line
+        if (((this->lineSum & 0x3F) + 0x30) != this->heldInput) {
+          this->lineError = true;
         }
-        break;
-      case DATA_RECORD:
-        if(getData(this->newInput, 200)) {
-          if (this->lastInput == 10 && this->newInput == 10) {
-            // end of data
-            this->lastInput = 0x0;  // Just to delete this->lastInput value
-            step = DATA_DECODE;
-          } else if  (this->newInput != 10) {
-            Lidar::scannedData[this->dataIdx++] = this->newInput;
-            this->lastInput = this->newInput;
-          } else {  // this->lastInput != 10 && this->newInput == 10
-            // This is the case, where we know that the last character was the checksum.
-            // Therefore, we need to decrement the counter
-            --this->dataIdx;
-            this->lastInput = this->newInput;
-          }
-          //chprintf((BaseSequentialStream*) &global.sercanmux1, "%d ", this->newInput);
+        this->heldInput = 0;
+        this->lineSum = 0;
+      } else {
+        // End of the scan ("\n\n")
+        if (!this->lineError && this->highInput == 0 && this->dataIdx == NUMBER_OF_STEPS) {
+          chSysLock();
+          // Hand over the scan, the old front buffer is overwritten next
+          this->frontIdx = 1 - this->frontIdx;
+          ++this->scanCount;
+          this->isReady = true;
+          chSysUnlock();
         } else {
-          step = FAIL;
+          ++this->errorCount;
         }
-        break;
-      case DATA_DECODE:
-        // Decode the recorded data
-        for (uint16_t idx=0; idx < NUMBER_OF_CHARACTERS; idx += 2) {
-          //TODO Check if +1 is right
-          *((uint16_t*) &(Lidar::scannedData[idx])) = twoCharacterEncoding(Lidar::scannedData[idx],Lidar::scannedData[idx+1]);
-        }
-        // To print out the data in this thread, choose "step = DATA_SHOW"
-        step = FINISH;
-        break;
-      case DATA_SHOW:
-        // Show the decoded data
-        chprintf((BaseSequentialStream*) &global.sercanmux1, "\n%d", this->dataCounter);
-        for (uint32_t idx=0; idx < this->dataIdx; idx+=2) {
-          chprintf((BaseSequentialStream*) &global.sercanmux1, "\n%d", *((uint16_t*) &(Lidar::scannedData[idx])));
-        }
-        step = FINISH;
-        break;
-      case FAIL:
-        // Set the FAIL flag
-        chSysLock();
-          // Set this flag so that the everyone knows, that scannedData holds wrong information
-          this->isFail = true;
-        chSysUnlock();
-        break;
-      case FINISH:
-        // Clean up
-        this->step = SEND_SCAN_CMD;
-        chSysLock();
-          // Set this flag so that the everyone knows, that scannedData holds the actual data
-          this->isReady = true;
-        chSysUnlock();
-        break;
-      default:
-        break;
-    }
+        step = DATA_VALID_CHECK;
+      }
+      this->lastInput = input;
+      break;
+    default:
+      break;
   }
-
-  return RDY_OK;
 }
 
 void Lidar::printData() {
@@ -298,7 +401,7 @@ void Lidar::printDetails() {
   chprintf((BaseSequentialStream*) &global.sercanmux1, "Print sensor details:\n");
 
   // Tell the sensor to transmit its details
-  chprintf((BaseSequentialStream*) &SD2, "VV\n");
+  sendCommand("VV" LF);
 
   // Print the transmitted data
   printData();
@@ -309,7 +412,7 @@ void Lidar::printSpecification() {
   chprintf((BaseSequentialStream*) &global.sercanmux1, "Print sensor specification:\n");
 
   // Tell the sensor to transmit its specifications
-  chprintf((BaseSequentialStream*) &SD2, "PP\n");
+  sendCommand("PP" LF);
 
   // Print the transmitted data
   printData();
@@ -319,7 +422,7 @@ void Lidar::printInformation() {
   chprintf((BaseSequentialStream*) &global.sercanmux1, "Print sensor information:\n");
 
   // Tell the sensor to transmit its information
-  chprintf((BaseSequentialStream*) &SD2, "II\n");
+  sendCommand("II" LF);
 
   // Print the transmitted data
   printData();
@@ -0,0 +1,97 @@
+#include <amiro/LidarScan.h>
+
+#include <string.h>  // memcpy
+
+#include <amiro/Constants.h>
+
+using namespace amiro;
+
+void LidarScan::compact(const uint16_t (&scan)[STEPS], uint8_t (&ranges)[POINTS]) {
+  for (uint16_t point = 0; point < POINTS; ++point) {
+    uint16_t minimum = 0xFFFFu;
+    for (uint16_t step = point * DECIMATION; step < (point + 1) * DECIMATION && step < STEPS; ++step) {
+      // Values below 20 mm are error codes of the LIDAR
+      if (scan[step] >= 20 && scan[step] < minimum)
+        minimum = scan[step];
+    }
+
+    if (minimum == 0xFFFFu)
+      ranges[point] = INVALID;
+    else if (minimum > 254 * RESOLUTION_MM)
+      ranges[point] = FAR;
+    else
+      ranges[point] = (minimum + RESOLUTION_MM - 1) / RESOLUTION_MM;
+  }
+}
+
+uint16_t LidarScan::toMillimeter(uint8_t range) {
+  return (range == FAR) ? 0 : range * RESOLUTION_MM;
+}
+
+int32_t LidarScan::getAngle(uint8_t point) {
+  // Twice the step of the center to stay integer for even decimations
+  const int32_t doubleStep = 2 * (FIRST_STEP + point * DECIMATION) + DECIMATION - 1 - 2 * FRONT_STEP;
+  return int32_t((int64_t(doubleStep) * constants::PIe6) / STEPS_PER_TURN);
+}
+
+//----------------------------------------------------------------
+
+LidarScan::Receiver::Receiver()
+    : pendingMask(0),
+      pendingSequence(0),
+      scanCount(0),
+      dropCount(0) {
+  memset(this->complete, INVALID, sizeof(this->complete));
+}
+
+bool LidarScan::Receiver::receive(const uint8_t *data, uint8_t size) {
+  const uint8_t sequence = data[0] >> 4;
+  const uint8_t fragment = data[0] & 0x0Fu;
+  const uint16_t first = fragment * FRAGMENT_POINTS;
+
+  if (size < 2 || fragment >= FRAGMENTS || size - 1 != ((POINTS - first < FRAGMENT_POINTS) ? POINTS - first : FRAGMENT_POINTS))
+    return false;
+
+  // A new sequence number starts a new scan
+  if (sequence != this->pendingSequence || (this->pendingMask & (1u << fragment))) {
+    if (this->pendingMask != 0)
+      ++this->dropCount;
+    this->pendingMask = 0;
+    this->pendingSequence = sequence;
+  }
+
+  memcpy(&this->pending[first], &data[1], size - 1);
+  this->pendingMask |= (1u << fragment);
+
+  if (this->pendingMask == (1u << FRAGMENTS) - 1) {
+    chSysLock();
+    memcpy(this->complete, this->pending, sizeof(this->complete));
+    ++this->scanCount;
+    chSysUnlock();
+    this->pendingMask = 0;
+  }
+
+  return true;
+}
+
+bool LidarScan::Receiver::getScan(uint8_t (&ranges)[POINTS], uint32_t &scanCount) {
+  bool copied = false;
+
+  chSysLock();
+  if (this->scanCount != scanCount) {
+    memcpy(ranges, this->complete, sizeof(ranges));
+    scanCount = this->scanCount;
+    copied = true;
+  }
+  chSysUnlock();
+
+  return copied;
+}
+
+uint32_t LidarScan::Receiver::getScanCount() {
+  return this->scanCount;
+}
+
+uint32_t LidarScan::Receiver::getDropCount() {
+  return this->dropCount;
+}
@@ -0,0 +1,171 @@
+#include <ch.hpp>
+#include <hal.h>
+
+#include <string.h>  // memset
+
+#include <amiro/LightAnimator.h>
+
+using namespace chibios_rt;
+using namespace amiro;
+
+namespace {
+
+/*
+ * Mixes two colors, level 0 is a and 256 is b
+ */
+Color mix(Color a, Color b, const int level) {
+  return Color(a.getRed() + (((b.getRed() - a.getRed()) * level) >> 8),
+               a.getGreen() + (((b.getGreen() - a.getGreen()) * level) >> 8),
+               a.getBlue() + (((b.getBlue() - a.getBlue()) * level) >> 8));
+}
+
+/*
+ * The ring sensors are opposite to the LEDs with the same index
+ */
+inline int led2Sensor(const int led) {
+  return (led < 4) ? led + 4 : led - 4;
+}
+
+}
+
+LightAnimator::LightAnimator(TLC5947 *tlc5947, ControllerAreaNetworkRx *sensors)
+    : BaseStaticThread<256>(),
+      tlc5947(tlc5947),
+      sensors(sensors),
+      startTime(0),
+      animating(false) {
+  for (int i = 0; i < TLC5947::LEDS; ++i)
+    this->baseColors[i] = Color::BLACK;
+  memset(&this->animation, 0, sizeof(this->animation));
+}
+
+// only the thread writes the TLC5947, so it never shows an outdated copy of the base colors
+void LightAnimator::setColor(int index, Color color) {
+  chSysLock();
+  this->baseColors[index] = color;
+  chSysUnlock();
+  this->signalEvents(static_cast<eventmask_t>(1));
+}
+
+void LightAnimator::animate(const LightAnimation &animation) {
+  if (animation.effect == LightAnimation::SET) {
+    const Color color(animation.red, animation.green, animation.blue);
+    chSysLock();
+    for (int i = 0; i < TLC5947::LEDS; ++i) {
+      if (animation.mask & (1u << i))
+        this->baseColors[i] = color;
+    }
+    chSysUnlock();
+    this->signalEvents(static_cast<eventmask_t>(1));
+    return;
+  }
+
+  chSysLock();
+  this->animation = animation;
+  this->startTime = chTimeNow();
+  this->animating = (animation.effect != LightAnimation::STOP);
+  chSysUnlock();
+  this->signalEvents(static_cast<eventmask_t>(1));
+}
+
+bool LightAnimator::isAnimating() {
+  return this->animating;
+}
+
+msg_t LightAnimator::main(void) {
+  Color colors[TLC5947::LEDS];
+  LightAnimation animation;
+
+  this->setName("LightAnimator");
+
+  while (!this->shouldTerminate()) {
+    chSysLock();
+    const bool animating = this->animating;
+    const systime_t startTime = this->startTime;
+    animation = this->animation;
+    for (int i = 0; i < TLC5947::LEDS; ++i)
+      colors[i] = this->baseColors[i];
+    chSysUnlock();
+
+    if (animating) {
+      // the frame depends on the time since the start only, not on the number of frames
+      const uint32_t elapsedMs = (uint64_t) (chTimeNow() - startTime) * 1000 / CH_FREQUENCY;
+      if (!this->render(animation, elapsedMs, colors)) {
+        // done, unless a new animation was started in the meantime
+        chSysLock();
+        if (this->startTime == startTime)
+          this->animating = false;
+        chSysUnlock();
+      }
+      this->tlc5947->setColors(colors);
+      this->tlc5947->update();
+
+      this->waitAnyEventTimeout(ALL_EVENTS, MS2ST(REFRESH_PERIOD_MS));
+    } else {
+      // the base colors changed or an animation ended, a change after the copy signals again
+      this->tlc5947->setColors(colors);
+      this->tlc5947->update();
+
+      this->waitAnyEvent(ALL_EVENTS);
+    }
+  }
+
+  return RDY_OK;
+}
+
+/*
+ * Renders the LEDs of the animation over the base colors
+ *
+ * Returns false if the animation is over, the colors are not changed then.
+ */
+bool LightAnimator::render(const LightAnimation &animation, uint32_t elapsedMs, Color (&colors)[TLC5947::LEDS]) {
+  const uint32_t periodMs = ((animation.period > 0) ? animation.period : 1) * LightAnimation::PERIOD_UNIT_MS;
+  const uint32_t cycle = elapsedMs / periodMs;
+  const int phase = (elapsedMs % periodMs) * 256 / periodMs;  // 0 .. 255
+  const Color color(animation.red, animation.green, animation.blue);
+  const Color black(Color::BLACK);
+
+  if (animation.repeat > 0 && cycle >= animation.repeat && animation.effect != LightAnimation::PROXIMITY)
+    return false;
+
+  for (int led = 0; led < TLC5947::LEDS; ++led) {
+    if (!(animation.mask & (1u << led)))
+      continue;
+
+    switch (animation.effect) {
+      case LightAnimation::BLINK: {
+        const int onTime = (animation.param > 0) ? animation.param + 1 : 128;
+        colors[led] = (phase < onTime) ? color : black;
+        break;
+      }
+
+      case LightAnimation::FADE: {
+        const int level = (phase < 128) ? 2 * phase : 2 * (255 - phase);
+        colors[led] = mix(colors[led], color, level);
+        break;
+      }
+
+      case LightAnimation::CHASE: {
+        // distance to the head, which moves one LED per step
+        const int distance = ((phase * TLC5947::LEDS >> 8) - led + TLC5947::LEDS) % TLC5947::LEDS;
+        colors[led] = (distance <= animation.param) ? mix(black, color, 256 >> distance) : black;
+        break;
+      }
+
+      case LightAnimation::PROXIMITY: {
+        const uint32_t fullScale = (animation.param > 0) ? animation.param << 8 : 0x1000;
+        uint32_t value = this->sensors->getProximityRingValue(led2Sensor(led));
+        if (value > fullScale)
+          value = fullScale;
+        const int level = value * 510 / fullScale;
+        colors[led] = (level < 255) ? Color(0x00, level, 255 - level) : Color(level - 255, 510 - level, 0x00);
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
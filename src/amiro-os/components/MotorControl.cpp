@@ -83,6 +83,14 @@ int MotorControl::getCurrentRPMRight() {
   return this->actualSpeed[RIGHT_WHEEL];
 }
 
+int MotorControl::getCurrentPWMLeft() {
+  return this->pwmPercentage[LEFT_WHEEL];
+}
+
+int MotorControl::getCurrentPWMRight() {
+  return this->pwmPercentage[RIGHT_WHEEL];
+}
+
 kinematic MotorControl::getCurrentVelocity() {
   return this->currentVelocity;
 }
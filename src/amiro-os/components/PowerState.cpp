@@ -0,0 +1,40 @@
+#include <ch.hpp>
+#include <hal.h>
+
+#include <amiro/Constants.h>
+#include <amiro/PowerState.h>
+
+using namespace amiro;
+
+volatile PowerState::State PowerState::state = PowerState::ACTIVE;
+
+//----------------------------------------------------------------
+
+PowerState::State PowerState::get() {
+  return state;
+}
+
+bool PowerState::isParked() {
+  return state == PARKED;
+}
+
+bool PowerState::set(State newState) {
+  chSysLock();
+  const bool changed = (state != newState);
+  state = newState;
+  chSysUnlock();
+
+  return changed;
+}
+
+systime_t PowerState::getUpdatePeriod() {
+  return isParked() ? CAN::PARKED_UPDATE_PERIOD : CAN::UPDATE_PERIOD;
+}
+
+const char* PowerState::getName(State value) {
+  switch (value) {
+    case ACTIVE: return "active";
+    case PARKED: return "parked";
+  }
+  return "unknown";
+}
@@ -0,0 +1,119 @@
+#include <string.h>  // strcmp
+
+#include <amiro/ReactiveController.h>
+
+using namespace amiro;
+
+namespace {
+
+inline int32_t limit(const int64_t value, const int32_t max) {
+  return (value > max) ? max : (value < -max) ? -max : value;
+}
+
+}
+
+ReactiveController::ReactiveController(int32_t maxTranslation, int32_t maxRotation)
+    : behaviourCount(0),
+      maxTranslation(maxTranslation),
+      maxRotation(maxRotation) {
+  for (int i = 0; i < MAX_BEHAVIOURS; ++i) {
+    this->behaviours[i] = NULL;
+    this->weights[i] = 0;
+    this->biasX[i] = 0;
+    this->biasWz[i] = 0;
+  }
+}
+
+uint8_t ReactiveController::addBehaviour(const Behaviour *behaviour, uint16_t weight) {
+  if (this->behaviourCount >= MAX_BEHAVIOURS)
+    return 0;
+
+  this->behaviours[this->behaviourCount] = behaviour;
+  this->weights[this->behaviourCount] = (weight > MAX_WEIGHT) ? (uint16_t) MAX_WEIGHT : weight;
+  this->biasX[this->behaviourCount] = behaviour->x;
+  this->biasWz[this->behaviourCount] = behaviour->w_z;
+  return ++this->behaviourCount;
+}
+
+uint8_t ReactiveController::findBehaviour(const char *name) {
+  for (uint8_t i = 0; i < this->behaviourCount; ++i) {
+    if (strcmp(this->behaviours[i]->name, name) == 0)
+      return i + 1;
+  }
+  return 0;
+}
+
+const ReactiveController::Behaviour *ReactiveController::getBehaviour(uint8_t id) {
+  return (id > 0 && id <= this->behaviourCount) ? this->behaviours[id - 1] : NULL;
+}
+
+uint8_t ReactiveController::getBehaviourCount() {
+  return this->behaviourCount;
+}
+
+void ReactiveController::setWeight(uint8_t id, uint16_t weight) {
+  if (id > 0 && id <= this->behaviourCount)
+    this->weights[id - 1] = (weight > MAX_WEIGHT) ? (uint16_t) MAX_WEIGHT : weight;
+}
+
+uint16_t ReactiveController::getWeight(uint8_t id) {
+  return (id > 0 && id <= this->behaviourCount) ? this->weights[id - 1] : 0;
+}
+
+void ReactiveController::setBias(uint8_t id, int16_t x, int16_t w_z) {
+  if (id > 0 && id <= this->behaviourCount) {
+    this->biasX[id - 1] = x;
+    this->biasWz[id - 1] = w_z;
+  }
+}
+
+uint16_t ReactiveController::activation(uint16_t value, uint16_t low, uint16_t high) {
+  if (high > low) {
+    if (value <= low)
+      return 0;
+    if (value >= high)
+      return ACTIVATION_ONE;
+    return ((uint32_t)(value - low) << 15) / (high - low);
+  } else {
+    if (value >= low)
+      return 0;
+    if (value <= high)
+      return ACTIVATION_ONE;
+    return ((uint32_t)(low - value) << 15) / (low - high);
+  }
+}
+
+void ReactiveController::update(const uint16_t *sensors, types::kinematic &kinematic) {
+  // velocities in Q16 (Q8 values times Q8 weights)
+  int64_t x = 0;
+  int64_t w_z = 0;
+
+  for (uint8_t b = 0; b < this->behaviourCount; ++b) {
+    const uint16_t weight = this->weights[b];
+    if (weight == 0)
+      continue;
+
+    const Behaviour *behaviour = this->behaviours[b];
+    // output of the behaviour in Q8
+    int32_t bx = this->biasX[b] << 8;
+    int32_t bw_z = this->biasWz[b] << 8;
+    for (uint8_t i = 0; i < behaviour->count; ++i) {
+      const Input &input = behaviour->inputs[i];
+      const int32_t a = activation(sensors[input.sensor], input.low, input.high);
+      bx += (input.x * a) >> 7;
+      bw_z += (input.w_z * a) >> 7;
+    }
+
+    // limit each behaviour to 32 m/s and 32 rad/s
+    x += (int64_t) limit(bx, 0x7FFF << 8) * weight;
+    w_z += (int64_t) limit(bw_z, 0x7FFF << 8) * weight;
+  }
+
+  // mm/s to µm/s and mrad/s to µrad/s
+  kinematic.x = limit((x * 1000) >> 16, this->maxTranslation);
+  kinematic.y = 0;
+  kinematic.z = 0;
+  kinematic.w_x = 0;
+  kinematic.w_y = 0;
+  kinematic.w_z = limit((w_z * 1000) >> 16, this->maxRotation);
+}
@@ -0,0 +1,76 @@
+#include <ch.hpp>
+#include <hal.h>
+
+#include <amiro/SystemTime.h>
+
+using namespace amiro;
+
+uint64_t SystemTime::cycles = 0;
+uint32_t SystemTime::lastCounterValue = 0;
+uint32_t SystemTime::offset = 0;
+int32_t SystemTime::slew = 0;
+uint64_t SystemTime::slewUptime = 0;
+bool SystemTime::synchronized = false;
+
+//----------------------------------------------------------------
+
+uint64_t SystemTime::getUptimeI() {
+  const uint32_t counterValue = halGetCounterValue();
+  // the difference is correct across a wrap around of the counter
+  cycles += uint32_t(counterValue - lastCounterValue);
+  lastCounterValue = counterValue;
+
+  return cycles / (halGetCounterFrequency() / 1000000);
+}
+
+uint64_t SystemTime::getUptime() {
+  chSysLock();
+  const uint64_t uptime = getUptimeI();
+  chSysUnlock();
+
+  return uptime;
+}
+
+uint32_t SystemTime::getTime() {
+  chSysLock();
+  const uint64_t uptime = getUptimeI();
+  if (slew < 0) {
+    // take at most 1/2^SLEW_SHIFT of the elapsed time back, the remainder is kept for the next call
+    uint32_t step = uint32_t(uptime - slewUptime) >> SLEW_SHIFT;
+    if (step > uint32_t(-slew))
+      step = -slew;
+    offset -= step;
+    slew += step;
+    slewUptime += uint64_t(step) << SLEW_SHIFT;
+  }
+  const uint32_t time = uint32_t(uptime) + offset;
+  chSysUnlock();
+
+  return time;
+}
+
+uint32_t SystemTime::getAge(uint32_t timestamp) {
+  const int32_t age = int32_t(getTime() - timestamp);
+  // timestamps of modules that are slightly ahead or taken before a step back
+  return (age > 0) ? age : 0;
+}
+
+void SystemTime::synchronize(uint32_t masterTime, uint64_t localUptime) {
+  chSysLock();
+  const uint32_t masterOffset = masterTime - uint32_t(localUptime);
+  const int32_t error = int32_t(masterOffset - offset);
+  if (!synchronized || error >= 0 || error < -MAX_SLEW) {
+    offset = masterOffset;
+    slew = 0;
+  } else {
+    if (slew == 0)
+      slewUptime = getUptimeI();
+    slew = error;
+  }
+  synchronized = true;
+  chSysUnlock();
+}
+
+bool SystemTime::isSynchronized() {
+  return synchronized;
+}
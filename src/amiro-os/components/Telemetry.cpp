@@ -0,0 +1,150 @@
+#include <ch.hpp>
+#include <hal.h>
+
+#include <string.h>  // strlen, strcmp, memcpy
+
+#include <amiro/Telemetry.h>
+
+using namespace chibios_rt;
+using namespace amiro;
+
+Telemetry::Telemetry(BaseSequentialStream *stream)
+    : BaseStaticThread<512>(),
+      stream(stream),
+      channelCount(0),
+      sequence(0),
+      enabled(false),
+      frameCount(0) {
+  for (int i = 0; i < MAX_CHANNELS; ++i) {
+    this->channels[i] = NULL;
+    this->periods[i] = 0;
+    this->nextSample[i] = 0;
+  }
+}
+
+uint8_t Telemetry::registerChannel(const Channel *channel, uint16_t periodMs) {
+  if (this->channelCount >= MAX_CHANNELS)
+    return 0;
+  if (channel->count * tlmTypeSize(channel->type) > TLM_MAX_PAYLOAD)
+    return 0;
+  // the description has to fit into a single frame
+  if (5 + strlen(channel->name) + 1 + strlen(channel->fields) + 1 > TLM_MAX_PAYLOAD)
+    return 0;
+
+  this->channels[this->channelCount] = channel;
+  this->periods[this->channelCount] = periodMs;
+  return ++this->channelCount;
+}
+
+uint8_t Telemetry::findChannel(const char *name) {
+  for (uint8_t i = 0; i < this->channelCount; ++i) {
+    if (strcmp(this->channels[i]->name, name) == 0)
+      return i + 1;
+  }
+  return 0;
+}
+
+const Telemetry::Channel *Telemetry::getChannel(uint8_t id) {
+  return (id > 0 && id <= this->channelCount) ? this->channels[id - 1] : NULL;
+}
+
+uint16_t Telemetry::getPeriod(uint8_t id) {
+  return (id > 0 && id <= this->channelCount) ? this->periods[id - 1] : 0;
+}
+
+void Telemetry::setPeriod(uint8_t id, uint16_t periodMs) {
+  if (id > 0 && id <= this->channelCount)
+    this->periods[id - 1] = periodMs;
+}
+
+uint8_t Telemetry::getChannelCount() {
+  return this->channelCount;
+}
+
+void Telemetry::enable(bool enable) {
+  this->enabled = enable;
+}
+
+bool Telemetry::isEnabled() {
+  return this->enabled;
+}
+
+uint32_t Telemetry::getFrameCount() {
+  return this->frameCount;
+}
+
+void Telemetry::send(uint8_t id, const uint8_t *payload, size_t length) {
+  uint32_t time = (uint32_t)(((uint64_t) System::getTime() * 1000) / CH_FREQUENCY);
+  size_t size = tlmEncodeFrame(id, this->sequence++, time, payload, length, this->frame);
+
+  // a single write, so the frame is not interleaved with the text of other threads
+  chSequentialStreamWrite(this->stream, this->frame, size);
+  ++this->frameCount;
+}
+
+void Telemetry::sendDescription(uint8_t id) {
+  const Channel *channel = this->channels[id - 1];
+  uint16_t period = this->periods[id - 1];
+  uint8_t *payload = (uint8_t *) this->payload;
+  size_t nameLength = strlen(channel->name) + 1;
+  size_t fieldsLength = strlen(channel->fields) + 1;
+
+  payload[0] = id;
+  payload[1] = channel->type;
+  payload[2] = channel->count;
+  payload[3] = (uint8_t) period;
+  payload[4] = (uint8_t) (period >> 8);
+  memcpy(&payload[5], channel->name, nameLength);
+  memcpy(&payload[5 + nameLength], channel->fields, fieldsLength);
+
+  this->send(TLM_DESCRIPTION_ID, payload, 5 + nameLength + fieldsLength);
+}
+
+msg_t Telemetry::main(void) {
+  systime_t time = System::getTime();
+  systime_t nextDescription = time;
+  bool wasEnabled = false;
+
+  this->setName("Telemetry");
+
+  while (!this->shouldTerminate()) {
+    time += MS2ST(PERIOD_MS);
+
+    if (this->enabled) {
+      systime_t now = System::getTime();
+
+      // describe all channels when the stream starts and periodically afterwards
+      if (!wasEnabled || (int32_t)(now - nextDescription) >= 0) {
+        for (uint8_t id = 1; id <= this->channelCount; ++id)
+          this->sendDescription(id);
+        nextDescription = now + MS2ST(DESCRIPTION_PERIOD_MS);
+      }
+
+      for (uint8_t i = 0; i < this->channelCount; ++i) {
+        uint16_t period = this->periods[i];
+        if (period == 0)
+          continue;
+        if (!wasEnabled || (int32_t)(now - this->nextSample[i]) >= 0) {
+          const Channel *channel = this->channels[i];
+          channel->sample(this->payload);
+          this->send(i + 1, (const uint8_t *) this->payload, channel->count * tlmTypeSize(channel->type));
+
+          // skip samples instead of catching up if the stream was too slow
+          this->nextSample[i] += MS2ST(period);
+          if (!wasEnabled || (int32_t)(now - this->nextSample[i]) >= 0)
+            this->nextSample[i] = now + MS2ST(period);
+        }
+      }
+    }
+    wasEnabled = this->enabled;
+
+    if (time >= System::getTime()) {
+      this->sleepUntil(time);
+    } else {
+      // the stream blocked (e.g. a full output queue), restart the period
+      time = System::getTime();
+    }
+  }
+
+  return RDY_OK;
+}
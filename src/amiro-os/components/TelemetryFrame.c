@@ -0,0 +1,155 @@
+#include <string.h>
+
+#include <amiro/TelemetryFrame.h>
+
+/**
+ * @brief Size of a single value
+ */
+size_t tlmTypeSize(tlm_type_t type) {
+
+  switch (type) {
+    case TLM_INT8:
+    case TLM_UINT8:
+      return 1;
+    case TLM_INT16:
+    case TLM_UINT16:
+      return 2;
+    case TLM_INT32:
+    case TLM_UINT32:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021), start with crc = 0xFFFF
+ */
+uint16_t tlmCrc16(const uint8_t *data, size_t n, uint16_t crc) {
+  size_t i;
+  int bit;
+
+  for (i = 0; i < n; ++i) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+  }
+
+  return crc;
+}
+
+/**
+ * @brief COBS encoding without delimiter
+ *
+ * @param dst Buffer of at least n + n / 254 + 1 bytes
+ * @return Number of encoded bytes
+ */
+size_t tlmCobsEncode(const uint8_t *src, size_t n, uint8_t *dst) {
+  size_t codeIdx = 0;
+  size_t out = 1;
+  uint8_t code = 1;
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    if (src[i] == 0) {
+      dst[codeIdx] = code;
+      codeIdx = out++;
+      code = 1;
+    } else {
+      dst[out++] = src[i];
+      if (++code == 0xFF) {
+        dst[codeIdx] = code;
+        codeIdx = out++;
+        code = 1;
+      }
+    }
+  }
+  dst[codeIdx] = code;
+
+  return out;
+}
+
+/**
+ * @brief COBS decoding of data without delimiters
+ *
+ * @param dst Buffer of at least n bytes
+ * @return Number of decoded bytes, 0 if the data is no valid COBS sequence
+ */
+size_t tlmCobsDecode(const uint8_t *src, size_t n, uint8_t *dst) {
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < n) {
+    uint8_t code = src[in++];
+    if (code == 0 || in + code - 1 > n)
+      return 0;
+    memcpy(&dst[out], &src[in], code - 1);
+    in += code - 1;
+    out += code - 1;
+    if (code != 0xFF && in < n)
+      dst[out++] = 0;
+  }
+
+  return out;
+}
+
+/**
+ * @brief Builds an encoded frame including both delimiters
+ *
+ * @param frame Buffer of TLM_MAX_FRAME_SIZE bytes
+ * @return Size of the frame, 0 if the payload is too long
+ */
+size_t tlmEncodeFrame(uint8_t id, uint8_t sequence, uint32_t time,
+                      const uint8_t *payload, size_t length, uint8_t *frame) {
+  uint8_t raw[TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + 2];
+  uint16_t crc;
+  size_t n;
+
+  if (length > TLM_MAX_PAYLOAD)
+    return 0;
+
+  raw[0] = id;
+  raw[1] = sequence;
+  raw[2] = (uint8_t)time;
+  raw[3] = (uint8_t)(time >> 8);
+  raw[4] = (uint8_t)(time >> 16);
+  raw[5] = (uint8_t)(time >> 24);
+  memcpy(&raw[TLM_HEADER_SIZE], payload, length);
+  n = TLM_HEADER_SIZE + length;
+  crc = tlmCrc16(raw, n, 0xFFFFu);
+  raw[n++] = (uint8_t)crc;
+  raw[n++] = (uint8_t)(crc >> 8);
+
+  frame[0] = 0;
+  n = 1 + tlmCobsEncode(raw, n, &frame[1]);
+  frame[n++] = 0;
+
+  return n;
+}
+
+/**
+ * @brief Decodes the data between two delimiters
+ *
+ * @return 1 if the data is a valid frame, 0 otherwise
+ */
+int tlmDecodeFrame(const uint8_t *data, size_t n, tlm_frame_t *frame) {
+  uint8_t raw[TLM_MAX_FRAME_SIZE];
+  size_t length;
+
+  if (n < 1 || n > TLM_MAX_FRAME_SIZE - 2)
+    return 0;
+
+  length = tlmCobsDecode(data, n, raw);
+  if (length < TLM_HEADER_SIZE + 2 || length > TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + 2)
+    return 0;
+  if (tlmCrc16(raw, length - 2, 0xFFFFu) != (uint16_t)(raw[length - 2] | (raw[length - 1] << 8)))
+    return 0;
+
+  frame->id = raw[0];
+  frame->sequence = raw[1];
+  frame->time = (uint32_t)raw[2] | ((uint32_t)raw[3] << 8) | ((uint32_t)raw[4] << 16) | ((uint32_t)raw[5] << 24);
+  frame->length = length - TLM_HEADER_SIZE - 2;
+  memcpy(frame->payload, &raw[TLM_HEADER_SIZE], frame->length);
+
+  return 1;
+}
@@ -0,0 +1,238 @@
+#include <ch.h>
+#include <hal.h>
+#include <chprintf.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <amiro/ThreadProfiler.h>
+
+/*
+ * Marks a thread that has been preempted: it is ready, but its latency is not
+ * a wakeup latency.
+ */
+#define TPROF_PREEMPTED                 1
+
+/*
+ * Upper bound of the first latency bin in microseconds, each further bin
+ * doubles it. The last bin holds everything above.
+ */
+#define TPROF_LATENCY_BIN0_US           16
+
+/*
+ * Counter values of the last context switch and of the window start.
+ */
+static halrtcnt_t tprofLastSwitch;
+static halrtcnt_t tprofWindowStart;
+
+static void tprofMarkReady(halrtcnt_t now) {
+  Thread *tp;
+
+  /* 0 means not ready and TPROF_PREEMPTED is reserved.*/
+  if (now <= TPROF_PREEMPTED) {
+    now = TPROF_PREEMPTED + 1;
+  }
+  for (tp = rlist.r_queue.p_next; tp != (Thread *)&rlist.r_queue; tp = tp->p_next) {
+    if (tp->tprof_ready == 0) {
+      tp->tprof_ready = now;
+    }
+  }
+}
+
+void tprofThreadInit(Thread *tp) {
+  tp->tprof_cycles = 0;
+  tp->tprof_ready = 0;
+  tp->tprof_latency_max = 0;
+  memset(tp->tprof_latency, 0, sizeof(tp->tprof_latency));
+}
+
+void tprofContextSwitch(Thread *ntp, Thread *otp) {
+  const halrtcnt_t now = halGetCounterValue();
+
+  otp->tprof_cycles += now - tprofLastSwitch;
+  tprofLastSwitch = now;
+  if (otp->p_state == THD_STATE_READY) {
+    otp->tprof_ready = TPROF_PREEMPTED;
+  }
+  tprofMarkReady(now);
+
+  if (ntp->tprof_ready > TPROF_PREEMPTED) {
+    const uint32_t latency = now - ntp->tprof_ready;
+    uint32_t bound = TPROF_LATENCY_BIN0_US * (halGetCounterFrequency() / 1000000);
+    uint8_t bin = 0;
+    while (bin < TPROF_LATENCY_BINS - 1 && latency >= bound) {
+      bound <<= 1;
+      ++bin;
+    }
+    if (ntp->tprof_latency[bin] < 0xFFFF) {
+      ++ntp->tprof_latency[bin];
+    }
+    if (latency > ntp->tprof_latency_max) {
+      ntp->tprof_latency_max = latency;
+    }
+  }
+  ntp->tprof_ready = 0;
+}
+
+void tprofTick(void) {
+  tprofMarkReady(halGetCounterValue());
+}
+
+/**
+ * @brief Starts a new measurement window of the CPU times
+ */
+void tprofStart(void) {
+  Thread *tp;
+
+  chSysLock();
+  for (tp = rlist.r_newer; tp != (Thread *)&rlist; tp = tp->p_newer) {
+    tp->tprof_cycles = 0;
+  }
+  tprofLastSwitch = halGetCounterValue();
+  tprofWindowStart = tprofLastSwitch;
+  chSysUnlock();
+}
+
+/**
+ * @brief Clears the wakeup latency statistics of all threads
+ */
+void tprofResetLatencies(void) {
+  Thread *tp;
+
+  chSysLock();
+  for (tp = rlist.r_newer; tp != (Thread *)&rlist; tp = tp->p_newer) {
+    tp->tprof_latency_max = 0;
+    memset(tp->tprof_latency, 0, sizeof(tp->tprof_latency));
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief Copies the profiles of the threads in the registry
+ *
+ * @param[out] threads  profiles
+ * @param[in] count     maximum number of profiles
+ * @param[out] window   length of the measurement window in counter cycles
+ *
+ * @return number of profiles
+ */
+size_t tprofSnapshot(tprof_thread_t *threads, size_t count, uint32_t *window) {
+  Thread *stacks[TPROF_MAX_THREADS];
+  Thread *tp;
+  halrtcnt_t now;
+  size_t n = 0;
+  size_t i;
+
+  if (count > TPROF_MAX_THREADS) {
+    count = TPROF_MAX_THREADS;
+  }
+
+  chSysLock();
+  now = halGetCounterValue();
+  for (tp = rlist.r_newer; tp != (Thread *)&rlist && n < count; tp = tp->p_newer) {
+    threads[n].name = chRegGetThreadName(tp);
+    threads[n].prio = tp->p_prio;
+    threads[n].cycles = tp->tprof_cycles;
+    if (tp == currp) {
+      threads[n].cycles += now - tprofLastSwitch;
+    }
+    threads[n].latency_max = tp->tprof_latency_max;
+    memcpy(threads[n].latency, tp->tprof_latency, sizeof(threads[n].latency));
+    stacks[n] = tp;
+    ++n;
+  }
+  *window = now - tprofWindowStart;
+  chSysUnlock();
+
+  /*
+   * The stacks are scanned outside of the lock. The threads of the modules
+   * are static, so their working areas stay valid.
+   */
+  for (i = 0; i < n; ++i) {
+    const uint8_t *stack = (const uint8_t *)(stacks[i] + 1);
+    if (*stack != CH_STACK_FILL_VALUE) {
+      /* not a filled working area, e.g. the main thread */
+      threads[i].stack_free = -1;
+      continue;
+    }
+    threads[i].stack_free = 0;
+    while (stack[threads[i].stack_free] == CH_STACK_FILL_VALUE) {
+      ++threads[i].stack_free;
+    }
+  }
+
+  return n;
+}
+
+void tprofShell(BaseSequentialStream *chp, int argc, char *argv[]) {
+  static tprof_thread_t threads[TPROF_MAX_THREADS];
+  const uint32_t cycles_per_us = halGetCounterFrequency() / 1000000;
+  bool_t histogram = FALSE;
+  int seconds = 1;
+  uint32_t window;
+  uint32_t permille;
+  size_t n;
+  size_t i;
+  uint8_t bin;
+  int arg;
+
+  for (arg = 0; arg < argc; ++arg) {
+    if (strcmp(argv[arg], "latency") == 0) {
+      histogram = TRUE;
+    } else if (strcmp(argv[arg], "reset") == 0) {
+      tprofResetLatencies();
+      chprintf(chp, "wakeup latencies cleared\r\n");
+      return;
+    } else if (argv[arg][0] >= '0' && argv[arg][0] <= '9') {
+      seconds = atoi(argv[arg]);
+    } else {
+      seconds = 0;
+      break;
+    }
+  }
+
+  if (seconds <= 0 || seconds > TPROF_MAX_WINDOW) {
+    chprintf(chp, "Usage: profile [seconds] [latency]\r\n");
+    chprintf(chp, "       profile reset\r\n");
+    chprintf(chp, "  seconds   measurement window of the CPU times (1 to %u, default 1)\r\n", TPROF_MAX_WINDOW);
+    chprintf(chp, "  latency   print the wakeup latency histograms\r\n");
+    chprintf(chp, "  reset     clear the wakeup latency statistics\r\n");
+    return;
+  }
+
+  tprofStart();
+  chThdSleepSeconds(seconds);
+  n = tprofSnapshot(threads, TPROF_MAX_THREADS, &window);
+
+  chprintf(chp, "%-16s %4s %7s %10s %12s\r\n", "thread", "prio", "CPU %", "stack free", "latency max");
+  for (i = 0; i < n; ++i) {
+    permille = (uint32_t)(((uint64_t)threads[i].cycles * 1000) / window);
+    chprintf(chp, "%-16s %4u %3u.%u%% ", threads[i].name ? threads[i].name : "?", threads[i].prio, permille / 10, permille % 10);
+    if (threads[i].stack_free >= 0) {
+      chprintf(chp, "%10d ", threads[i].stack_free);
+    } else {
+      chprintf(chp, "%10s ", "-");
+    }
+    chprintf(chp, "%9u us\r\n", threads[i].latency_max / cycles_per_us);
+  }
+  if (n == TPROF_MAX_THREADS) {
+    chprintf(chp, "(only the first %u threads are shown)\r\n", TPROF_MAX_THREADS);
+  }
+
+  if (histogram) {
+    chprintf(chp, "\r\nwakeup latencies (us)\r\n%-16s", "thread");
+    for (bin = 0; bin < TPROF_LATENCY_BINS - 1; ++bin) {
+      chprintf(chp, " %6s%-4u", "<", TPROF_LATENCY_BIN0_US << bin);
+    }
+    chprintf(chp, " %6s%-4u\r\n", ">=", TPROF_LATENCY_BIN0_US << (TPROF_LATENCY_BINS - 2));
+    for (i = 0; i < n; ++i) {
+      chprintf(chp, "%-16s", threads[i].name ? threads[i].name : "?");
+      for (bin = 0; bin < TPROF_LATENCY_BINS; ++bin) {
+        chprintf(chp, " %10u", threads[i].latency[bin]);
+      }
+      chprintf(chp, "\r\n");
+    }
+  }
+
+  return;
+}
@@ -0,0 +1,416 @@
+#include <ch.h>
+#include <hal.h>
+#include <chprintf.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <amiro/TopologyBenchmark.h>
+
+/*
+ * Period of the CAN broadcasts and the sensor threads (CAN::UPDATE_PERIOD).
+ */
+#define TBMK_UPDATE_PERIOD              US2ST(62500)
+
+/*
+ * The workloads below are estimates of the execution times on the STM32
+ * (including the bus transfers at 400 kHz I2C / 2.25 MHz SPI). Update them
+ * when a component changes significantly.
+ */
+
+static const tbmk_task_t tbmkDiWheelDriveTasks[] = {
+  /* name            priority         period              offset     load  bus            bus */
+  {"CanRx",          HIGHPRIO,        MS2ST(5),           0,           40, TBMK_BUS_NONE,   0},
+  {"CanTx",          HIGHPRIO - 1,    TBMK_UPDATE_PERIOD, MS2ST(1),   400, TBMK_BUS_NONE,   0},
+  {"Odometry",       NORMALPRIO + 20, MS2ST(50),          0,          150, TBMK_BUS_NONE,   0},
+  {"DistControl",    NORMALPRIO + 9,  MS2ST(10),          0,          120, TBMK_BUS_NONE,   0},
+  {"hmc5883l",       NORMALPRIO + 8,  TBMK_UPDATE_PERIOD, MS2ST(2),   450, TBMK_BUS_I2C1, 400},
+  {"MotorControl",   NORMALPRIO + 7,  MS2ST(10),          0,          200, TBMK_BUS_NONE,   0},
+  {"l3g4200d",       NORMALPRIO + 5,  MS2ST(100),         MS2ST(3),   150, TBMK_BUS_SPI1, 100},
+  {"lis331dlh",      NORMALPRIO + 4,  TBMK_UPDATE_PERIOD, MS2ST(3),   150, TBMK_BUS_SPI1, 100},
+  {"vcnl4020[0]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(4),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[1]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(4),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[2]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(4),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[3]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(4),   600, TBMK_BUS_I2C2, 500},
+  {"ina219",         NORMALPRIO,      MS2ST(1000),        MS2ST(5),   400, TBMK_BUS_I2C2, 300},
+  {"UserThread",     NORMALPRIO,      MS2ST(100),         0,         1000, TBMK_BUS_NONE,   0},
+};
+
+static const tbmk_task_t tbmkPowerManagementTasks[] = {
+  /* name            priority         period              offset     load  bus            bus */
+  {"CanRx",          HIGHPRIO,        MS2ST(5),           0,           40, TBMK_BUS_NONE,   0},
+  {"CanTx",          HIGHPRIO - 1,    TBMK_UPDATE_PERIOD, MS2ST(1),   600, TBMK_BUS_NONE,   0},
+  {"adc1_vsys",      NORMALPRIO,      MS2ST(1),           0,           10, TBMK_BUS_NONE,   0},
+  {"vcnl4020[0]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C1, 500},
+  {"vcnl4020[1]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C1, 500},
+  {"vcnl4020[2]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C1, 500},
+  {"vcnl4020[3]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[4]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[5]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[6]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C2, 500},
+  {"vcnl4020[7]",    NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(2),   600, TBMK_BUS_I2C1, 500},
+  {"ina219[0]",      NORMALPRIO,      MS2ST(1000),        MS2ST(3),   400, TBMK_BUS_I2C1, 300},
+  {"ina219[1]",      NORMALPRIO,      MS2ST(1000),        MS2ST(3),   400, TBMK_BUS_I2C1, 300},
+  {"ina219[2]",      NORMALPRIO,      MS2ST(1000),        MS2ST(3),   400, TBMK_BUS_I2C2, 300},
+  {"ina219[3]",      NORMALPRIO,      MS2ST(1000),        MS2ST(3),   400, TBMK_BUS_I2C2, 300},
+  {"ina219[4]",      NORMALPRIO,      MS2ST(1000),        MS2ST(3),   400, TBMK_BUS_I2C2, 300},
+  {"bq27500[0]",     NORMALPRIO,      MS2ST(1000),        MS2ST(7),   800, TBMK_BUS_I2C1, 700},
+  {"bq27500[1]",     NORMALPRIO,      MS2ST(1000),        MS2ST(7),   800, TBMK_BUS_I2C2, 700},
+  {"mpr121",         NORMALPRIO,      TBMK_UPDATE_PERIOD, MS2ST(6),   300, TBMK_BUS_I2C2, 250},
+  {"UserThread",     NORMALPRIO,      MS2ST(100),         0,         1000, TBMK_BUS_NONE,   0},
+};
+
+static const tbmk_task_t tbmkLightRingTasks[] = {
+  /* name            priority         period              offset     load  bus            bus */
+  {"CanRx",          HIGHPRIO,        MS2ST(5),           0,           40, TBMK_BUS_NONE,   0},
+  {"CanTx",          HIGHPRIO - 1,    TBMK_UPDATE_PERIOD, MS2ST(1),   200, TBMK_BUS_NONE,   0},
+  {"tlc5947",        NORMALPRIO + 5,  MS2ST(20),          0,          300, TBMK_BUS_SPI1, 200},
+  {"Lidar",          NORMALPRIO,      MS2ST(5000),        0,          100, TBMK_BUS_NONE,   0},
+  {"UserThread",     NORMALPRIO,      MS2ST(100),         0,         1000, TBMK_BUS_NONE,   0},
+};
+
+const tbmk_topology_t tbmkDiWheelDrive = {
+  "DiWheelDrive",
+  tbmkDiWheelDriveTasks,
+  sizeof(tbmkDiWheelDriveTasks) / sizeof(tbmkDiWheelDriveTasks[0]),
+};
+
+const tbmk_topology_t tbmkPowerManagement = {
+  "PowerManagement",
+  tbmkPowerManagementTasks,
+  sizeof(tbmkPowerManagementTasks) / sizeof(tbmkPowerManagementTasks[0]),
+};
+
+const tbmk_topology_t tbmkLightRing = {
+  "LightRing",
+  tbmkLightRingTasks,
+  sizeof(tbmkLightRingTasks) / sizeof(tbmkLightRingTasks[0]),
+};
+
+static const tbmk_topology_t *const tbmkTopologies[] = {
+  &tbmkDiWheelDrive,
+  &tbmkPowerManagement,
+  &tbmkLightRing,
+};
+
+/*
+ * Time base of the response time measurement.
+ */
+#if HAL_IMPLEMENTS_COUNTERS
+typedef halrtcnt_t tbmk_counter_t;
+#define tbmkGetCounter()                halGetCounterValue()
+#define tbmkGetCounterFrequency()       halGetCounterFrequency()
+#else
+typedef systime_t tbmk_counter_t;
+#define tbmkGetCounter()                chTimeNow()
+#define tbmkGetCounterFrequency()       CH_FREQUENCY
+#endif
+
+/*
+ * Context of a synthetic thread.
+ */
+typedef struct {
+  const tbmk_task_t *task;
+  tbmk_result_t *result;
+  Mutex *bus;
+  systime_t start;
+  systime_t duration;
+  uint32_t loops;
+  uint32_t busloops;
+} tbmk_context_t;
+
+static tbmk_context_t tbmkContexts[TBMK_MAX_TASKS];
+static Thread *tbmkThreads[TBMK_MAX_TASKS];
+static Mutex tbmkBuses[TBMK_BUS_COUNT];
+static volatile uint32_t tbmkSink;
+
+static inline uint32_t tbmkTicksToUs(systime_t ticks) {
+  return (uint32_t)(((uint64_t)ticks * 1000000UL) / CH_FREQUENCY);
+}
+
+static inline uint32_t tbmkCounterToUs(tbmk_counter_t cnt) {
+  return (uint32_t)(((uint64_t)cnt * 1000000UL) / tbmkGetCounterFrequency());
+}
+
+#ifdef __GNUC__
+__attribute__((noinline))
+#endif
+static void tbmkSpin(uint32_t loops) {
+  while (loops--) {
+    tbmkSink++;
+#if defined(SIMULATOR)
+    /* The simulator checks for its (timer) interrupts only on request.*/
+    if ((loops & 0x3Fu) == 0) {
+      ChkIntSources();
+    }
+#endif
+  }
+}
+
+/*
+ * Sleeps until the given time, returns immediately if it already passed.
+ */
+static void tbmkSleepUntil(systime_t time) {
+  chSysLock();
+  const systime_t delta = time - chTimeNow();
+  if (delta > 0 && delta <= ((systime_t)-1) / 2) {
+    chThdSleepS(delta);
+  }
+  chSysUnlock();
+
+  return;
+}
+
+/*
+ * Determines the number of busy loop iterations per millisecond.
+ */
+static uint32_t tbmkCalibrate(void) {
+  const uint32_t chunk = 64;
+  uint32_t loops = 0;
+  systime_t start = chTimeNow();
+
+  /* Align to a system tick.*/
+  while (chTimeNow() == start) {
+    tbmkSpin(1);
+  }
+
+  start = chTimeNow();
+  while (chTimeNow() - start < MS2ST(100)) {
+    tbmkSpin(chunk);
+    loops += chunk;
+  }
+
+  return loops / 100;
+}
+
+static msg_t tbmkThread(void *arg) {
+  tbmk_context_t *ctx = (tbmk_context_t*)arg;
+  const tbmk_task_t *task = ctx->task;
+  systime_t release = task->offset;
+  systime_t now;
+
+  chRegSetThreadName(task->name);
+
+  /* Releases are handled relative to ctx->start to be safe from overflows.*/
+  while (release < ctx->duration) {
+    tbmkSleepUntil(ctx->start + release);
+
+    const systime_t wakeup = chTimeNow() - ctx->start;
+    const tbmk_counter_t begin = tbmkGetCounter();
+
+    if (ctx->bus != NULL) {
+      chMtxLock(ctx->bus);
+      tbmkSpin(ctx->busloops);
+      chMtxUnlock();
+      tbmkSpin(ctx->loops - ctx->busloops);
+    } else {
+      tbmkSpin(ctx->loops);
+    }
+
+    const uint32_t response = tbmkTicksToUs(wakeup - release) +
+                              tbmkCounterToUs(tbmkGetCounter() - begin);
+
+    ctx->result->releases++;
+    ctx->result->sum_us += response;
+    if (response > ctx->result->max_us) {
+      ctx->result->max_us = response;
+    }
+    if (response > tbmkTicksToUs(task->period)) {
+      ctx->result->misses++;
+    }
+
+    /* Drop releases whose deadline passed before the task could start.*/
+    release += task->period;
+    now = chTimeNow() - ctx->start;
+    while (release + task->period <= now && release < ctx->duration) {
+      ctx->result->skipped++;
+      release += task->period;
+    }
+  }
+
+  return RDY_OK;
+}
+
+/*
+ * Assigns rate monotonic priorities above NORMALPRIO (shorter period, higher
+ * priority; equal periods share a priority).
+ */
+static tprio_t tbmkRateMonotonic(const tbmk_topology_t *topology, size_t index) {
+  tprio_t prio = NORMALPRIO;
+  size_t i;
+
+  for (i = 0; i < topology->count; ++i) {
+    if (topology->tasks[i].period > topology->tasks[index].period) {
+      bool_t counted = FALSE;
+      size_t j;
+      /* count every longer period only once */
+      for (j = 0; j < i; ++j) {
+        if (topology->tasks[j].period == topology->tasks[i].period) {
+          counted = TRUE;
+          break;
+        }
+      }
+      if (!counted) {
+        ++prio;
+      }
+    }
+  }
+
+  return prio;
+}
+
+const tbmk_topology_t *tbmkFind(const char *name) {
+  size_t i;
+
+  for (i = 0; i < sizeof(tbmkTopologies) / sizeof(tbmkTopologies[0]); ++i) {
+    if (strcmp(name, tbmkTopologies[i]->name) == 0) {
+      return tbmkTopologies[i];
+    }
+  }
+
+  return NULL;
+}
+
+bool_t tbmkRun(const tbmk_topology_t *topology, const tbmk_options_t *options,
+               tbmk_result_t *results, uint32_t *idle_permille) {
+  const tprio_t prio = chThdGetPriority();
+  bool_t success = TRUE;
+  uint32_t loops_per_ms;
+  systime_t start;
+  size_t i;
+
+  chDbgCheck(topology != NULL && options != NULL && results != NULL, "tbmkRun");
+
+  if (topology->count > TBMK_MAX_TASKS) {
+    return FALSE;
+  }
+
+  for (i = 0; i < TBMK_BUS_COUNT; ++i) {
+    chMtxInit(&tbmkBuses[i]);
+  }
+  memset(results, 0, topology->count * sizeof(tbmk_result_t));
+
+  /* Calibrate and create the threads without being interrupted by them.*/
+  chThdSetPriority(HIGHPRIO);
+  loops_per_ms = tbmkCalibrate();
+  start = chTimeNow() + MS2ST(10);
+
+  for (i = 0; i < topology->count; ++i) {
+    const tbmk_task_t *task = &topology->tasks[i];
+    tbmk_context_t *ctx = &tbmkContexts[i];
+
+    ctx->task = task;
+    ctx->result = &results[i];
+    ctx->bus = (task->bus != TBMK_BUS_NONE) ? &tbmkBuses[task->bus] : NULL;
+    ctx->start = start;
+    ctx->duration = options->duration;
+    ctx->loops = (uint32_t)(((uint64_t)task->load_us * options->load_percent * loops_per_ms) / 100000UL);
+    ctx->busloops = (uint32_t)(((uint64_t)task->bus_us * options->load_percent * loops_per_ms) / 100000UL);
+    results[i].prio = options->rate_monotonic ? tbmkRateMonotonic(topology, i) : task->prio;
+
+    tbmkThreads[i] = chThdCreateFromHeap(NULL, TBMK_WA_SIZE, results[i].prio, tbmkThread, ctx);
+    if (tbmkThreads[i] == NULL) {
+      success = FALSE;
+    }
+  }
+
+  chThdSetPriority(prio);
+
+  /* Measure the idle time while the threads run.*/
+  tbmkSleepUntil(start);
+#if CH_DBG_THREADS_PROFILING
+  const systime_t idle = chThdGetTicks(chSysGetIdleThread());
+#endif
+  chThdSleep(options->duration);
+#if CH_DBG_THREADS_PROFILING
+  if (idle_permille != NULL) {
+    *idle_permille = (uint32_t)(((uint64_t)(chThdGetTicks(chSysGetIdleThread()) - idle) * 1000UL) / options->duration);
+  }
+#else
+  if (idle_permille != NULL) {
+    *idle_permille = TBMK_IDLE_UNKNOWN;
+  }
+#endif
+
+  for (i = 0; i < topology->count; ++i) {
+    if (tbmkThreads[i] != NULL) {
+      chThdWait(tbmkThreads[i]);
+    }
+  }
+
+  return success;
+}
+
+void tbmkPrint(BaseSequentialStream *chp, const tbmk_topology_t *topology,
+               const tbmk_options_t *options, const tbmk_result_t *results,
+               uint32_t idle_permille) {
+  uint32_t demand = 0;
+  uint32_t misses = 0;
+  size_t i;
+
+  chprintf(chp, "topology %s: %u tasks, %u ms, load %u%%, %s priorities\r\n",
+           topology->name, (uint32_t)topology->count, tbmkTicksToUs(options->duration) / 1000,
+           options->load_percent, options->rate_monotonic ? "rate monotonic" : "configured");
+  chprintf(chp, "task            prio  period[us]  load[us]  releases  misses  skipped  wcrt[us]   avg[us]\r\n");
+  for (i = 0; i < topology->count; ++i) {
+    const tbmk_task_t *task = &topology->tasks[i];
+    const uint32_t load = (task->load_us * options->load_percent) / 100;
+
+    chprintf(chp, "%-14s  %4u  %10u  %8u  %8u  %6u  %7u  %8u  %8u\r\n",
+             task->name, (uint32_t)results[i].prio, tbmkTicksToUs(task->period), load,
+             results[i].releases, results[i].misses, results[i].skipped, results[i].max_us,
+             (results[i].releases > 0) ? (uint32_t)(results[i].sum_us / results[i].releases) : 0);
+    demand += (uint32_t)(((uint64_t)load * 1000UL) / tbmkTicksToUs(task->period));
+    misses += results[i].misses + results[i].skipped;
+  }
+
+  chprintf(chp, "demand %u.%u%%, ", demand / 10, demand % 10);
+  if (idle_permille != TBMK_IDLE_UNKNOWN) {
+    chprintf(chp, "idle %u.%u%%, ", idle_permille / 10, idle_permille % 10);
+  }
+  chprintf(chp, "%u deadline misses\r\n", misses);
+
+  return;
+}
+
+void tbmkShell(BaseSequentialStream *chp, int argc, char *argv[],
+               const tbmk_topology_t *topology) {
+  static tbmk_result_t results[TBMK_MAX_TASKS];
+  tbmk_options_t options = {S2ST(10), 100, FALSE};
+  uint32_t idle_permille = TBMK_IDLE_UNKNOWN;
+  uint8_t numbers = 0;
+  int arg;
+
+  for (arg = 0; arg < argc; ++arg) {
+    if (strcmp(argv[arg], "rm") == 0) {
+      options.rate_monotonic = TRUE;
+    } else if (tbmkFind(argv[arg]) != NULL) {
+      topology = tbmkFind(argv[arg]);
+    } else if (argv[arg][0] >= '0' && argv[arg][0] <= '9' && numbers == 0) {
+      options.duration = S2ST(atoi(argv[arg]));
+      ++numbers;
+    } else if (argv[arg][0] >= '0' && argv[arg][0] <= '9' && numbers == 1) {
+      options.load_percent = atoi(argv[arg]);
+      ++numbers;
+    } else {
+      topology = NULL;
+      break;
+    }
+  }
+
+  if (topology == NULL || options.duration == 0) {
+    chprintf(chp, "Usage: bmk_topology [topology] [seconds] [load%%] [rm]\r\n");
+    chprintf(chp, "  topology  DiWheelDrive, PowerManagement or LightRing\r\n");
+    chprintf(chp, "  seconds   duration of the run (default 10)\r\n");
+    chprintf(chp, "  load%%     scaling of the workloads (default 100)\r\n");
+    chprintf(chp, "  rm        use rate monotonic instead of the configured priorities\r\n");
+    return;
+  }
+
+  if (!tbmkRun(topology, &options, results, &idle_permille)) {
+    chprintf(chp, "not enough memory for all %u threads, results are incomplete\r\n", (uint32_t)topology->count);
+  }
+  tbmkPrint(chp, topology, &options, results, idle_permille);
+
+  return;
+}
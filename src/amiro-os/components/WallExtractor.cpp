@@ -0,0 +1,337 @@
+#include <amiro/WallExtractor.h>
+
+#include <string.h>  // memcpy
+
+#include <amiro/Constants.h>
+
+using namespace chibios_rt;
+using namespace amiro;
+using namespace amiro::constants;
+
+/**
+ * Sine of the quarter circle in steps of the LIDAR (1024 per turn), Q14
+ */
+static const int16_t sineTable[LidarScan::STEPS_PER_TURN / 4 + 1] = {
+      0,   101,   201,   302,   402,   503,   603,   704,   804,   904,  1005,  1105,
+   1205,  1306,  1406,  1506,  1606,  1706,  1806,  1906,  2006,  2105,  2205,  2305,
+   2404,  2503,  2603,  2702,  2801,  2900,  2999,  3098,  3196,  3295,  3393,  3492,
+   3590,  3688,  3786,  3883,  3981,  4078,  4176,  4273,  4370,  4467,  4563,  4660,
+   4756,  4852,  4948,  5044,  5139,  5235,  5330,  5425,  5520,  5614,  5708,  5803,
+   5897,  5990,  6084,  6177,  6270,  6363,  6455,  6547,  6639,  6731,  6823,  6914,
+   7005,  7096,  7186,  7276,  7366,  7456,  7545,  7635,  7723,  7812,  7900,  7988,
+   8076,  8163,  8250,  8337,  8423,  8509,  8595,  8680,  8765,  8850,  8935,  9019,
+   9102,  9186,  9269,  9352,  9434,  9516,  9598,  9679,  9760,  9841,  9921, 10001,
+  10080, 10159, 10238, 10316, 10394, 10471, 10549, 10625, 10702, 10778, 10853, 10928,
+  11003, 11077, 11151, 11224, 11297, 11370, 11442, 11514, 11585, 11656, 11727, 11797,
+  11866, 11935, 12004, 12072, 12140, 12207, 12274, 12340, 12406, 12472, 12537, 12601,
+  12665, 12729, 12792, 12854, 12916, 12978, 13039, 13100, 13160, 13219, 13279, 13337,
+  13395, 13453, 13510, 13567, 13623, 13678, 13733, 13788, 13842, 13896, 13949, 14001,
+  14053, 14104, 14155, 14206, 14256, 14305, 14354, 14402, 14449, 14497, 14543, 14589,
+  14635, 14680, 14724, 14768, 14811, 14854, 14896, 14937, 14978, 15019, 15059, 15098,
+  15137, 15175, 15213, 15250, 15286, 15322, 15357, 15392, 15426, 15460, 15493, 15525,
+  15557, 15588, 15619, 15649, 15679, 15707, 15736, 15763, 15791, 15817, 15843, 15868,
+  15893, 15917, 15941, 15964, 15986, 16008, 16029, 16049, 16069, 16088, 16107, 16125,
+  16143, 16160, 16176, 16192, 16207, 16221, 16235, 16248, 16261, 16273, 16284, 16295,
+  16305, 16315, 16324, 16332, 16340, 16347, 16353, 16359, 16364, 16369, 16373, 16376,
+  16379, 16381, 16383, 16384, 16384,
+};
+
+/**
+ * Sine of an angle in LIDAR steps (Q14)
+ */
+static int32_t stepSin(int32_t step) {
+  step &= (LidarScan::STEPS_PER_TURN - 1);
+  const int32_t quarter = LidarScan::STEPS_PER_TURN / 4;
+  if (step <= quarter)
+    return sineTable[step];
+  else if (step <= 2 * quarter)
+    return sineTable[2 * quarter - step];
+  else if (step <= 3 * quarter)
+    return -sineTable[step - 2 * quarter];
+  else
+    return -sineTable[4 * quarter - step];
+}
+
+WallExtractor::WallExtractor(Lidar *lidar, ControllerAreaNetworkTx *can)
+    : BaseStaticThread<256>(),
+      lidar(lidar),
+      can(can),
+      scanCount(0),
+      maxDuration(0) {
+  this->wall.segments = 0;
+}
+
+//----------------------------------------------------------------
+
+int32_t WallExtractor::sin(int32_t angle) {
+  // Angle in 1/256 steps of the LIDAR, interpolated linearly between the steps
+  const int32_t position = int32_t((int64_t(angle) * LidarScan::STEPS_PER_TURN * 256) / int32_t(2 * PIe6 / 1000));
+  const int32_t step = position >> 8;
+  const int32_t fraction = position & 0xFF;
+  const int32_t low = stepSin(step);
+  return low + (((stepSin(step + 1) - low) * fraction) >> 8);
+}
+
+int32_t WallExtractor::cos(int32_t angle) {
+  return sin(angle + int32_t(PIe3 / 2));
+}
+
+int32_t WallExtractor::atan2(int32_t y, int32_t x) {
+  if (x == 0 && y == 0)
+    return 0;
+
+  const int32_t ax = (x < 0) ? -x : x;
+  const int32_t ay = (y < 0) ? -y : y;
+  int32_t angle;
+
+  // atan(z) ~ z * (PI/4 + 0.273 * (1 - z)) for 0 <= z <= 1, z in Q15
+  if (ax >= ay) {
+    const int32_t z = int32_t((int64_t(ay) << 15) / ax);
+    angle = (z * (785 + ((273 * (32768 - z)) >> 15))) >> 15;
+  } else {
+    const int32_t z = int32_t((int64_t(ax) << 15) / ay);
+    angle = int32_t(PIe3 / 2) - ((z * (785 + ((273 * (32768 - z)) >> 15))) >> 15);
+  }
+
+  if (x < 0)
+    angle = int32_t(PIe3) - angle;
+  return (y < 0) ? -angle : angle;
+}
+
+uint32_t WallExtractor::sqrt(uint32_t value) {
+  uint32_t root = 0;
+  uint32_t bit = 1u << 30;
+
+  while (bit > value)
+    bit >>= 2;
+
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+//----------------------------------------------------------------
+
+void WallExtractor::toCartesian(const uint16_t (&scan)[LidarScan::STEPS]) {
+  for (uint16_t idx = 0; idx < LidarScan::STEPS; ++idx) {
+    const int32_t step = LidarScan::FIRST_STEP + idx - LidarScan::FRONT_STEP;
+    const int32_t range = scan[idx];
+    this->x[idx] = int16_t((range * stepSin(step + LidarScan::STEPS_PER_TURN / 4)) >> 14);
+    this->y[idx] = int16_t((range * stepSin(step)) >> 14);
+  }
+}
+
+bool WallExtractor::isJump(uint16_t step) {
+  // Values below 20 mm are error codes of the LIDAR
+  if (this->scan[step] < 20 || this->scan[step - 1] < 20)
+    return true;
+  const int32_t difference = int32_t(this->scan[step]) - int32_t(this->scan[step - 1]);
+  const int32_t threshold = JUMP_THRESHOLD_MM + (this->scan[step] >> 4);
+  return (difference > threshold) || (-difference > threshold);
+}
+
+uint16_t WallExtractor::findSplit(uint16_t first, uint16_t last, int32_t &deviation) {
+  const int32_t dx = this->x[last] - this->x[first];
+  const int32_t dy = this->y[last] - this->y[first];
+  uint16_t splitIdx = first;
+  int32_t maxCross = 0;
+
+  // The distance of a point to the line is |cross| / length
+  for (uint16_t idx = first + 1; idx < last; ++idx) {
+    int32_t cross = (this->x[idx] - this->x[first]) * dy - (this->y[idx] - this->y[first]) * dx;
+    if (cross < 0)
+      cross = -cross;
+    if (cross > maxCross) {
+      maxCross = cross;
+      splitIdx = idx;
+    }
+  }
+
+  const int32_t length = sqrt(uint32_t(dx * dx + dy * dy));
+  deviation = (length > 0) ? maxCross / length : 0;
+  return splitIdx;
+}
+
+uint8_t WallExtractor::split(uint16_t first, uint16_t last, uint8_t count) {
+  Segment *stack = this->stack;
+  uint8_t depth = 0;
+
+  stack[depth++] = {first, last};
+
+  // The right part is pushed first, so the segments are found from the first step on
+  while (depth > 0 && count < MAX_SEGMENTS) {
+    const Segment segment = stack[--depth];
+    int32_t deviation;
+    const uint16_t splitIdx = this->findSplit(segment.first, segment.last, deviation);
+
+    if (deviation > SPLIT_THRESHOLD_MM && depth + 2 <= MAX_SEGMENTS) {
+      stack[depth++] = {splitIdx, segment.last};
+      stack[depth++] = {segment.first, splitIdx};
+    } else {
+      this->segments[count++] = segment;
+    }
+  }
+
+  return count;
+}
+
+uint8_t WallExtractor::merge(uint8_t count) {
+  if (count == 0)
+    return 0;
+
+  uint8_t merged = 0;
+  for (uint8_t idx = 1; idx < count; ++idx) {
+    Segment &current = this->segments[merged];
+    int32_t deviation = SPLIT_THRESHOLD_MM + 1;
+
+    // Only segments of the same cluster share a point
+    if (current.last == this->segments[idx].first)
+      this->findSplit(current.first, this->segments[idx].last, deviation);
+
+    if (deviation <= SPLIT_THRESHOLD_MM)
+      current.last = this->segments[idx].last;
+    else
+      this->segments[++merged] = this->segments[idx];
+  }
+
+  return merged + 1;
+}
+
+void WallExtractor::fit(const Segment &segment, LidarScan::Wall &wall) {
+  const int32_t count = segment.last - segment.first + 1;
+  int32_t sumX = 0, sumY = 0;
+
+  for (uint16_t idx = segment.first; idx <= segment.last; ++idx) {
+    sumX += this->x[idx];
+    sumY += this->y[idx];
+  }
+  const int32_t meanX = sumX / count;
+  const int32_t meanY = sumY / count;
+
+  int64_t sxx = 0, syy = 0, sxy = 0;
+  for (uint16_t idx = segment.first; idx <= segment.last; ++idx) {
+    const int32_t dx = this->x[idx] - meanX;
+    const int32_t dy = this->y[idx] - meanY;
+    sxx += dx * dx;
+    syy += dy * dy;
+    sxy += dx * dy;
+  }
+
+  // Scale the moments down to 32 bit, atan2 only depends on their ratio
+  int64_t a = -2 * sxy;
+  int64_t b = syy - sxx;
+  while (a > INT32_MAX || a < -INT32_MAX || b > INT32_MAX || b < -INT32_MAX) {
+    a >>= 1;
+    b >>= 1;
+  }
+
+  // Direction of the normal of the least squares line
+  int32_t angle = atan2(int32_t(a), int32_t(b)) / 2;
+  int32_t distance = (meanX * cos(angle) + meanY * sin(angle)) >> 14;
+  if (distance < 0) {
+    distance = -distance;
+    angle += int32_t(PIe3);
+  }
+  if (angle > int32_t(PIe3))
+    angle -= 2 * int32_t(PIe3);
+
+  // Length of the segment along the line
+  int32_t length = ((this->x[segment.last] - this->x[segment.first]) * -sin(angle)
+                    + (this->y[segment.last] - this->y[segment.first]) * cos(angle)) >> 14;
+
+  wall.distance = uint16_t(distance);
+  wall.angle = int16_t(angle);
+  wall.length = uint16_t((length < 0) ? -length : length);
+}
+
+uint8_t WallExtractor::extract(const uint16_t (&scan)[LidarScan::STEPS], LidarScan::Wall &wall) {
+  uint8_t count = 0;
+
+  if (&scan != &this->scan)
+    memcpy(this->scan, scan, sizeof(this->scan));
+  this->toCartesian(this->scan);
+
+  // Split every cluster of valid steps
+  uint16_t first = 0;
+  for (uint16_t step = 1; step <= LidarScan::STEPS; ++step) {
+    if (step == LidarScan::STEPS || this->isJump(step)) {
+      if (this->scan[first] >= 20 && step - first >= MIN_POINTS)
+        count = this->split(first, step - 1, count);
+      first = step;
+    }
+  }
+  count = this->merge(count);
+
+  // Take the nearest segment that is long enough
+  wall.segments = 0;
+  wall.distance = 0xFFFFu;
+  for (uint8_t idx = 0; idx < count; ++idx) {
+    const Segment &segment = this->segments[idx];
+    if (segment.last - segment.first + 1 < MIN_POINTS)
+      continue;
+
+    LidarScan::Wall candidate;
+    this->fit(segment, candidate);
+    if (candidate.length >= MIN_LENGTH_MM && candidate.distance < wall.distance) {
+      wall.distance = candidate.distance;
+      wall.angle = candidate.angle;
+      wall.length = candidate.length;
+      wall.segments = count;
+    }
+  }
+
+  if (wall.segments == 0) {
+    wall.distance = 0;
+    wall.angle = 0;
+    wall.length = 0;
+  }
+
+  return count;
+}
+
+bool WallExtractor::getWall(LidarScan::Wall &wall) {
+  chSysLock();
+  wall = this->wall;
+  chSysUnlock();
+  return this->scanCount != 0;
+}
+
+systime_t WallExtractor::getMaxDuration() {
+  return this->maxDuration;
+}
+
+//----------------------------------------------------------------
+
+msg_t WallExtractor::main(void) {
+  this->setName("WallExtractor");
+
+  while (!this->shouldTerminate()) {
+    // The LIDAR delivers about 10 scans per second
+    if (this->lidar->getScan(this->scan, this->scanCount)) {
+      LidarScan::Wall wall;
+      const systime_t start = chTimeNow();
+      this->extract(this->scan, wall);
+      const systime_t duration = chTimeElapsedSince(start);
+      if (duration > this->maxDuration)
+        this->maxDuration = duration;
+
+      wall.sequence = uint8_t(this->scanCount);
+      chSysLock();
+      this->wall = wall;
+      chSysUnlock();
+
+      this->can->broadcastLidarWall(wall);
+    } else {
+      this->sleep(MS2ST(20));
+    }
+  }
+
+  return RDY_OK;
+}
@@ -6,6 +6,7 @@
 #include <chprintf.h>
 #include <cmath>  // abs()
 #include <amiro/Constants.h>
+#include <amiro/PowerState.h>
 #include <global.hpp>
 
 namespace amiro {
@@ -76,7 +77,7 @@ main() {
 
     this->eventSource.broadcastFlags(0);
 
-    this->waitAnyEventTimeout(ALL_EVENTS, CAN::UPDATE_PERIOD);
+    this->waitAnyEventTimeout(ALL_EVENTS, PowerState::getUpdatePeriod());
 
   }
   return RDY_OK;
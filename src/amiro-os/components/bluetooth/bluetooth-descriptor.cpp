@@ -28,7 +28,7 @@ uint8_t BluetoothDescriptor::bluetoothDescriptorGetLinkId() {
 }
 
 size_t BluetoothDescriptor::bluetoothDescriptorGetBufferLength() {
-  return sizeof(this->buffer);
+  return BLUETOOTH_DESCRIPTOR_BUFFER_SIZE;
 }
 
 size_t BluetoothDescriptor::bluetoothDescriptorGetPayloadLength() {
@@ -36,9 +36,14 @@ size_t BluetoothDescriptor::bluetoothDescriptorGetPayloadLength() {
 }
 
 uint8_t* BluetoothDescriptor::bluetoothDescriptorGetBuffer() {
-  return this->buffer;
+  return &this->buffer[BLUETOOTH_DESCRIPTOR_HEADROOM];
 }
 
 uint8_t* BluetoothDescriptor::bluetoothDescriptorGetPayload() {
-  return this->buffer;
+  return &this->buffer[BLUETOOTH_DESCRIPTOR_HEADROOM];
+}
+
+uint8_t* BluetoothDescriptor::bluetoothDescriptorGetFrame(size_t headerLength) {
+  chDbgCheck(headerLength <= BLUETOOTH_DESCRIPTOR_HEADROOM, "bluetoothDescriptorGetFrame");
+  return &this->buffer[BLUETOOTH_DESCRIPTOR_HEADROOM - headerLength];
 }
@@ -54,17 +54,10 @@ msg_t BluetoothTransport::main(void) {
             continue;
       }
 
-      if (transmitState == BLUETOOTH_TRANSPORT_PLAIN) {
-        uint8_t* buffer = transmit->bluetoothDescriptorGetPayload();
-        size_t length = transmit->bluetoothDescriptorGetPayloadLength();
-
-        memcpy(buffer+length, "\r\n", 2);
-
-        uartStartSend(uart, length + 2, buffer);
-      } else {
-        transmitState = BLUETOOTH_TRANSPORT_PAYLOAD;
-        uartStartSend(uart, FRAME_HEADER_SIZE, getEncodeHeader());
-      }
+      // descriptors posted meanwhile are chained by the interrupt handler
+      System::lock();
+      startTransmitI();
+      System::unlock();
       waitAnyEvent((eventmask_t) TRANSMIT_COMPLETED_EVENT);
     }
   }
@@ -80,61 +73,22 @@ void BluetoothTransport::bluetoothTransportTransmitCompleted_cb(UARTDriver *uart
 }
 
 void BluetoothTransport::bluetoothTransportTransmitCompleted() {
-  switch (transmitState) {
-    case BLUETOOTH_TRANSPORT_PLAIN: {
-      postTransmitDescriptorI();
-
-      System::lockFromIsr();
-      signalEventsI((eventmask_t) TRANSMIT_COMPLETED_EVENT);
-      System::unlockFromIsr();
-      break;
-    }
-    case BLUETOOTH_TRANSPORT_HEADER: {
-      System::lockFromIsr();
-      uartStartSendI(uart, FRAME_HEADER_SIZE, getEncodeHeader());
-      System::unlockFromIsr();
-      transmitState = BLUETOOTH_TRANSPORT_PAYLOAD;
-      /* no break */
-    }
-    case BLUETOOTH_TRANSPORT_PAYLOAD: {
-      System::lockFromIsr();
-      uartStartSendI(uart, transmit->bluetoothDescriptorGetPayloadLength(), transmit->bluetoothDescriptorGetPayload());
-      System::unlockFromIsr();
-      transmitState = BLUETOOTH_TRANSPORT_TRAILER;
-      break;
-    }
-    case BLUETOOTH_TRANSPORT_TRAILER: {
-      postTransmitDescriptorI();
-
-      System::lockFromIsr();
-      uartStartSendI(uart, FRAME_TRAILER_SIZE, getEncodeTailer());
-
-      // check whether any new transmision in the mailbox during the present tranmmision
-      msg_t msg = transmitMailbox.fetchI((msg_t *) &transmit);
-      System::unlockFromIsr();
+  System::lockFromIsr();
+  storageMailbox.postI((msg_t) transmit);
 
-      if (msg == RDY_OK) {
-        if (transmit->bluetoothDescriptorGetPayloadLength()) {
-          transmitState = BLUETOOTH_TRANSPORT_HEADER;
-        } else {
-          postTransmitDescriptorI();
-          transmitState = BLUETOOTH_TRANSPORT_IDLE;
-        }
-      } else {
-        transmitState = BLUETOOTH_TRANSPORT_IDLE;
-      }
-      break;
-    }
-    case BLUETOOTH_TRANSPORT_IDLE: {
-      System::lockFromIsr();
-      signalEventsI((eventmask_t) TRANSMIT_COMPLETED_EVENT);
+  // start the next descriptor right away if there is one
+  while (transmitMailbox.fetchI((msg_t *) &transmit) == RDY_OK) {
+    if (transmit->bluetoothDescriptorGetPayloadLength()) {
+      startTransmitI();
       System::unlockFromIsr();
-      break;
-    }
-    default: {
-      break;
+      return;
     }
+    storageMailbox.postI((msg_t) transmit);
   }
+
+  transmit = NULL;
+  signalEventsI((eventmask_t) TRANSMIT_COMPLETED_EVENT);
+  System::unlockFromIsr();
 }
 
 void BluetoothTransport::bluetoothTransportCharacterReceived_cb(UARTDriver *uart, uint16_t c) {
@@ -293,28 +247,32 @@ void BluetoothTransport::postReceiveDescriptorI() {
   System::unlockFromIsr();
 }
 
-void BluetoothTransport::postTransmitDescriptorI() {
-  System::lockFromIsr();
-  storageMailbox.postI((msg_t) transmit);
-  transmit = NULL;
-  System::unlockFromIsr();
-}
-
 /*
+ * Builds the frame around the payload of the transmit descriptor and sends it
+ * with a single DMA transfer.
+ *
  * The header encode/decode are in compliance with of the multiplexing mode
  * Reference: iWRAP4 user guide Version 4.1 page 142-143
  */
-uint8_t*  BluetoothTransport::getEncodeHeader() {
-  transmitFrameBuffer[1] = 0xbf;
-  transmitFrameBuffer[2] = transmit->bluetoothDescriptorGetLinkId();
-  transmitFrameBuffer[3] = (transmit->bluetoothDescriptorGetPayloadLength() >> 8) & 0x3;
-  transmitFrameBuffer[4] = transmit->bluetoothDescriptorGetPayloadLength() & 0xFF;
-  return &transmitFrameBuffer[1];
-}
+void BluetoothTransport::startTransmitI() {
+  size_t length = transmit->bluetoothDescriptorGetPayloadLength();
+  uint8_t *frame;
+
+  if (transmitState == BLUETOOTH_TRANSPORT_PLAIN) {
+    frame = transmit->bluetoothDescriptorGetFrame(0);
+    frame[length++] = '\r';
+    frame[length++] = '\n';
+  } else {
+    frame = transmit->bluetoothDescriptorGetFrame(FRAME_HEADER_SIZE);
+    frame[0] = 0xbf;
+    frame[1] = transmit->bluetoothDescriptorGetLinkId();
+    frame[2] = (length >> 8) & 0x3;
+    frame[3] = length & 0xFF;
+    frame[FRAME_HEADER_SIZE + length] = ~frame[1];
+    length += FRAME_HEADER_SIZE + FRAME_TRAILER_SIZE;
+  }
 
-uint8_t* BluetoothTransport::getEncodeTailer() {
-  transmitFrameBuffer[0] = ~transmitFrameBuffer[2];
-  return &transmitFrameBuffer[0];
+  uartStartSendI(uart, length, frame);
 }
 
 int BluetoothTransport::decodeHeader() {
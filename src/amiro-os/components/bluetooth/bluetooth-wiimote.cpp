@@ -15,7 +15,8 @@ extern Global global;
  */
 BluetoothWiimote::BluetoothWiimote(BLUETOOTH *bluetooth, uint8_t rxtx) :
   BaseStaticThread<128>(), wiimoteConn(bluetooth, this, "WIIMOTE"),
-  mailbox(mailboxBuffer, BLUETOOTH_WIIMOTE_MAILBOX_SIZE), accelerometer{0,0,0} {
+  mailbox(mailboxBuffer, BLUETOOTH_WIIMOTE_MAILBOX_SIZE), accelerometer{0,0,0},
+  eventSource(), reportTime(0), reportCount(0) {
   iwrap = &(bluetooth->iwrap);
   rx_tx = rxtx;
   linkId = 0xFF;
@@ -67,6 +68,11 @@ msg_t BluetoothWiimote::wiimoteReceive() {
       accelerometer.y_axis = (buffer[5] << 2) + ((buffer[3] & 0x20) >> 4) - 0x1FF;
       accelerometer.z_axis = (buffer[6] << 2) + ((buffer[3] & 0x40) >> 5) - 0x1FF;
 
+      // notify the listeners before anything is sent to the Wiimote
+      reportTime = halGetCounterValue();
+      ++reportCount;
+      eventSource.broadcastFlags(0);
+
       bluetoothWiimoteDataBtnAcc();
   } else {
     chSequentialStreamWrite((BaseSequentialStream*) &global.sercanmux1, buffer, length);
@@ -133,6 +139,18 @@ BluetoothWiimote::Buttons * BluetoothWiimote::getButtons() {
   return &buttons;
 }
 
+EvtSource* BluetoothWiimote::getEventSource() {
+  return &eventSource;
+}
+
+halrtcnt_t BluetoothWiimote::getReportTime() {
+  return reportTime;
+}
+
+uint32_t BluetoothWiimote::getReportCount() {
+  return reportCount;
+}
+
 /*
  * @brief :  On-off LEDs and Motor of Wiimote.
  *
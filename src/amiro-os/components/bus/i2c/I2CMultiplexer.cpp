@@ -1,10 +1,13 @@
+#include <chdebug.h>
 #include <amiro/bus/i2c/I2CMultiplexer.hpp>
 
 namespace amiro {
 
 I2CMultiplexer::
 I2CMultiplexer(I2CDriver *driver) :
-  driver(driver) {
+  driver(driver),
+  owner(NULL),
+  holds(0) {
 
 #if CH_USE_MUTEXES
   chMtxInit(&this->mutex);
@@ -47,6 +50,12 @@ void
 I2CMultiplexer::
 acquireBus() {
 
+  // the owner may transfer on any channel without locking the bus again
+  if (this->owner == chThdSelf()) {
+    ++this->holds;
+    return;
+  }
+
 #if CH_USE_MUTEXES
   chMtxLock(&this->mutex);
 #elif CH_USE_SEMAPHORES
@@ -54,12 +63,22 @@ acquireBus() {
 #endif
 
   this->driver->acquireBus();
+  this->owner = chThdSelf();
+  this->holds = 1;
 }
 
 void
 I2CMultiplexer::
 releaseBus() {
 
+  chDbgAssert(this->owner == chThdSelf(), "I2CMultiplexer::releaseBus(), #1", "not owner");
+
+  // keep the channel selected until the outermost hold is released
+  if (--this->holds > 0)
+    return;
+
+  this->deselect();
+  this->owner = NULL;
   this->driver->releaseBus();
 
 #if CH_USE_MUTEXES
@@ -9,12 +9,6 @@ VI2CDriver(I2CMultiplexer *driver, const uint8_t bus_id) :
   driver(driver),
   id(bus_id) {
 
-#if CH_USE_MUTEXES
-  chMtxInit(&this->mutex);
-#else
-  chSemInit(&this->semaphore, 1);
-#endif /* CH_USE_MUTEXES */
-
 };
 
 
@@ -56,7 +50,6 @@ masterTransmit(const I2CTxParams *params, systime_t timeout) {
     ret = this->driver->masterTransmit(params, timeout);
   }
 
-  this->driver->deselect();
   this->driver->releaseBus();
 
   return ret;
@@ -73,7 +66,6 @@ masterReceive(const I2CRxParams *params, systime_t timeout) {
   if (!(ret = this->driver->select(this->id)))
     ret = this->driver->masterReceive(params, timeout);
 
-  this->driver->deselect();
   this->driver->releaseBus();
 
   return ret;
@@ -85,11 +77,7 @@ void
 VI2CDriver::
 acquireBus() {
 
-#if CH_USE_MUTEXES
-  chMtxLock(&this->mutex);
-#elif CH_USE_SEMAPHORES
-  chSemWait(&this->semaphore);
-#endif
+  this->driver->acquireBus();
 
 }
 
@@ -97,11 +85,7 @@ void
 VI2CDriver::
 releaseBus() {
 
-#if CH_USE_MUTEXES
-  chMtxUnlock();
-#elif CH_USE_SEMAPHORES
-  chSemSignal(&this->semaphore);
-#endif
+  this->driver->releaseBus();
 
 }
 
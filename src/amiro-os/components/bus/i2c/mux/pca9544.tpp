@@ -23,16 +23,20 @@ select(const uint8_t bus_id) {
 	chDbgCheck(bus_id <= 0x03u, "PCA9544 select bus_id");
 
 	uint8_t tmp = PCA9544::BUS_ON | bus_id;
+	msg_t ret;
 
 	if (bus_id == this->selected)
 		return RDY_OK;
 
-	this->selected = bus_id;
-
 	this->tx_params.txbuf = &tmp;
 	this->tx_params.txbytes = 1;
 	this->tx_params.rxbytes = 0;
-	return this->masterTransmit(&this->tx_params); // TODO select timeout
+	ret = this->masterTransmit(&this->tx_params); // TODO select timeout
+
+	// the channel is unknown after a failed transfer, select it again next time
+	this->selected = (ret == RDY_OK) ? bus_id : -1;
+
+	return ret;
 
 }
 
@@ -54,7 +54,9 @@ poll_ack(void* instance) {
   i2c_rxparams.rxbuf = dummy_buf;
   i2c_rxparams.rxbytes = sizeof(dummy_buf);
 
-  for (register uint16_t wr_time = 0x0000u; wr_time < bfs->max_t_wr; wr_time++) {
+  const systime_t start = chTimeNow();
+
+  for (;;) {
 
     bfs_i2c_driver->acquireBus();
 
@@ -73,6 +75,10 @@ poll_ack(void* instance) {
       break;
     }
 
+    if (chTimeElapsedSince(start) > AT24::get_t_wr(bfs))
+      break;
+
+    // Leave the bus to the other devices while the write cycle completes
     chThdSleepMicroseconds(10);
 
   }
@@ -141,11 +147,13 @@ write(void* instance, const uint8_t* bp, size_t n) {
       scratchpad[i++] = *ptr++;
     }
 
-    // acknowledge polling
+    // Phase 1: transfer the page
+    // The bus is only held for the transfer itself. If the device does not
+    // acknowledge (write cycle of a former write still running), retry until
+    // the maximum write cycle time passed.
+    const systime_t start = chTimeNow();
 
-    // acknowledge polling and
-    // address device
-    for (register uint16_t wr_time = 0x0000u; wr_time < bfs->max_t_wr; wr_time++) {
+    for (;;) {
 
       bfs->i2c_driver->acquireBus();
 
@@ -168,6 +176,9 @@ write(void* instance, const uint8_t* bp, size_t n) {
         break;
       }
 
+      if (chTimeElapsedSince(start) > AT24::get_t_wr(bfs))
+        break;
+
       chThdSleepMicroseconds(10);
 
     }
@@ -182,6 +193,12 @@ write(void* instance, const uint8_t* bp, size_t n) {
     num_bytes -= tx_bytes;
     tx_bytes = AT24_MAX_PAGE_SIZE;
 
+    // Phase 2: wait for the write cycle without occupying the bus
+    // The cycle of the last page completes in the background, the next access
+    // polls for it.
+    if (num_bytes > 0)
+      chThdSleep(AT24::get_t_wr(bfs));
+
   }
 
   if (ret_val != RDY_OK)
@@ -205,6 +222,8 @@ read(void* instance, uint8_t* bp, size_t n) {
   uint8_t i;
   uint8_t scratchpad[2];
   msg_t ret_val;
+  size_t rx_bytes;
+  fileoffset_t cur_pos = bfs->position;
   register I2CTxParams* bfs_i2c_txparams = &bfs->i2c_txparams;
 
   // If no bytes are to be read, shortcut stop
@@ -216,38 +235,50 @@ read(void* instance, uint8_t* bp, size_t n) {
 
 #if HAL_USE_I2C
 
-  // Fill address buffer
-  i = 0;
-  // Support for 16bit-addressable devices
-  if (bfs->size > 0x0080u)
-    scratchpad[i++] = (bfs->position >> 8) & 0xFFu;
-
-  scratchpad[i++] = bfs->position & 0xFFu;
-
   // if device does not answer within timeout, don't read anything
   if (poll_ack(bfs) != RDY_OK)
     return 0;
 
-  bfs->i2c_driver->acquireBus();
+  // Read in chunks and release the bus in between, so the other devices
+  // are not blocked for the whole transfer.
+  for (size_t num_bytes = 0; num_bytes < n; num_bytes += rx_bytes) {
 
-  bfs_i2c_txparams->txbuf = scratchpad;
-  bfs_i2c_txparams->txbytes = i;
-  bfs_i2c_txparams->rxbuf = bp;
-  bfs_i2c_txparams->rxbytes = n;
+    rx_bytes = n - num_bytes;
+    if (rx_bytes > AT24_READ_CHUNK_SIZE)
+      rx_bytes = AT24_READ_CHUNK_SIZE;
 
-  // address device
-  // and read data
-  ret_val = bfs->i2c_driver->masterTransmit(bfs_i2c_txparams);
+    // Fill address buffer
+    i = 0;
+    // Support for 16bit-addressable devices
+    if (bfs->size > 0x0080u)
+      scratchpad[i++] = (cur_pos >> 8) & 0xFFu;
 
-  if (ret_val != RDY_OK)
-    bfs->error = bfs->i2c_driver->getErrors();
+    scratchpad[i++] = cur_pos & 0xFFu;
 
-  bfs->i2c_driver->releaseBus();
+    bfs->i2c_driver->acquireBus();
 
-  // We cannot tell where I²C transfer went wrong
-  // therefore report 0 bytes read
-  if (ret_val != RDY_OK)
-    return 0;
+    bfs_i2c_txparams->txbuf = scratchpad;
+    bfs_i2c_txparams->txbytes = i;
+    bfs_i2c_txparams->rxbuf = bp + num_bytes;
+    bfs_i2c_txparams->rxbytes = rx_bytes;
+
+    // address device
+    // and read data
+    ret_val = bfs->i2c_driver->masterTransmit(bfs_i2c_txparams);
+
+    if (ret_val != RDY_OK)
+      bfs->error = bfs->i2c_driver->getErrors();
+
+    bfs->i2c_driver->releaseBus();
+
+    // We cannot tell where I²C transfer went wrong
+    // therefore report 0 bytes read
+    if (ret_val != RDY_OK)
+      return 0;
+
+    cur_pos += rx_bytes;
+
+  }
 
 #endif
 
@@ -255,6 +286,18 @@ read(void* instance, uint8_t* bp, size_t n) {
 
 }
 
+systime_t
+AT24::
+get_t_wr(EEPROM* bfs) {
+
+  // max_t_wr is given in multiples of 10 µs
+  if (!bfs->max_t_wr)
+    return 1;
+
+  return US2ST(10u * (uint32_t) bfs->max_t_wr);
+
+}
+
 /**
  * Close EEPROM device.
  * \note EEPROMs do not support close semantics.
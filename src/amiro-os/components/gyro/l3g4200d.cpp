@@ -7,6 +7,7 @@
 #include <amiro/bus/spi/HWSPIDriver.hpp>
 #include <amiro/gyro/l3g4200d.hpp>
 #include <amiro/Constants.h>
+#include <amiro/PowerState.h>
 #include <global.hpp>
 
 using namespace chibios_rt;
@@ -37,7 +38,8 @@ msg_t L3G4200D::main() {
   this->setName("l3g4200d");
 
   while (!this->shouldTerminate()) {
-    time += this->period_st;
+    // The gyroscope is powered down while the robot is parked
+    time += PowerState::isParked() ? PowerState::getUpdatePeriod() : this->period_st;
 
     updateSensorData();
     calcAngular();
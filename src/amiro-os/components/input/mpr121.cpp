@@ -1,6 +1,7 @@
 #include <amiro/bus/i2c/I2CDriver.hpp>
 #include <amiro/input/mpr121.hpp>
 #include <amiro/Constants.h>
+#include <amiro/PowerState.h>
 
 namespace amiro {
 
@@ -172,7 +173,7 @@ main(void) {
 
     this->eventSource.broadcastFlags(0);
 
-    this->waitAnyEventTimeout(ALL_EVENTS, CAN::UPDATE_PERIOD);
+    this->waitAnyEventTimeout(ALL_EVENTS, PowerState::getUpdatePeriod());
   }
 
   return RDY_OK;
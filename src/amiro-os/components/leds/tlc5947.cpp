@@ -1,19 +1,47 @@
 #include <ch.hpp>
 #include <hal.h>
 
+#include <string.h>  // memcpy, memcmp
+
 #include <amiro/bus/spi/HWSPIDriver.hpp>
 #include <amiro/leds/tlc5947.hpp>
 
 using namespace chibios_rt;
 using namespace amiro;
 
+/*
+ * 8 bit color to 12 bit grayscale with gamma 2.2
+ */
+static const uint16_t gammaGrayscale[256] = {
+     0,    0,    0,    0,    0,    1,    1,    2,    2,    3,    3,    4,    5,    6,    7,    8,
+     9,   11,   12,   14,   15,   17,   19,   21,   23,   25,   27,   29,   32,   34,   37,   40,
+    43,   46,   49,   52,   55,   59,   62,   66,   70,   73,   77,   82,   86,   90,   95,   99,
+   104,  109,  114,  119,  124,  129,  135,  140,  146,  152,  158,  164,  170,  176,  182,  189,
+   196,  202,  209,  216,  224,  231,  238,  246,  254,  261,  269,  277,  286,  294,  302,  311,
+   320,  328,  337,  347,  356,  365,  375,  384,  394,  404,  414,  424,  435,  445,  456,  467,
+   477,  488,  500,  511,  522,  534,  545,  557,  569,  581,  594,  606,  619,  631,  644,  657,
+   670,  683,  697,  710,  724,  738,  752,  766,  780,  794,  809,  823,  838,  853,  868,  884,
+   899,  914,  930,  946,  962,  978,  994, 1011, 1027, 1044, 1061, 1078, 1095, 1112, 1130, 1147,
+  1165, 1183, 1201, 1219, 1237, 1256, 1274, 1293, 1312, 1331, 1350, 1370, 1389, 1409, 1429, 1449,
+  1469, 1489, 1509, 1530, 1551, 1572, 1593, 1614, 1635, 1657, 1678, 1700, 1722, 1744, 1766, 1789,
+  1811, 1834, 1857, 1880, 1903, 1926, 1950, 1974, 1997, 2021, 2045, 2070, 2094, 2119, 2143, 2168,
+  2193, 2219, 2244, 2270, 2295, 2321, 2347, 2373, 2400, 2426, 2453, 2479, 2506, 2534, 2561, 2588,
+  2616, 2644, 2671, 2700, 2728, 2756, 2785, 2813, 2842, 2871, 2900, 2930, 2959, 2989, 3019, 3049,
+  3079, 3109, 3140, 3170, 3201, 3232, 3263, 3295, 3326, 3358, 3390, 3421, 3454, 3486, 3518, 3551,
+  3584, 3617, 3650, 3683, 3716, 3750, 3784, 3818, 3852, 3886, 3920, 3955, 3990, 4025, 4060, 4095
+};
+
 TLC5947::TLC5947(HWSPIDriver *spi, ioportid_t blankPort, int blankPad)
     : BaseStaticThread<192>(),
       spi(spi),
       blankPort(blankPort),
       blankPad(blankPad),
-      brightness(0x00u) {
-  for (int i = 0; i < 8; i++)
+      changed(0xFFu),
+      brightness(0x00u),
+      grayscaleBrightness(-1),
+      sentFrame(0),
+      frameCount(0) {
+  for (int i = 0; i < LEDS; i++)
     this->colors[i] = Color::BLACK;
 }
 
@@ -40,43 +68,71 @@ void TLC5947::setBrightness(int brightness) {
 }
 
 void TLC5947::setColor(int index, Color color) {
-  this->colors[index] = color;
+  chSysLock();
+  if (color.getRed() != this->colors[index].getRed() ||
+      color.getGreen() != this->colors[index].getGreen() ||
+      color.getBlue() != this->colors[index].getBlue()) {
+    this->colors[index] = color;
+    this->changed |= 1u << index;
+  }
+  chSysUnlock();
+}
+
+void TLC5947::setColors(const Color (&colors)[LEDS]) {
+  chSysLock();
+  for (int i = 0; i < LEDS; i++)
+    this->colors[i] = colors[i];
+  this->changed = 0xFFu;
+  chSysUnlock();
 }
 
 void TLC5947::update() {
   this->signalEvents(static_cast<eventmask_t>(1));
 }
 
+uint32_t TLC5947::getFrameCount() {
+  return this->frameCount;
+}
+
 msg_t TLC5947::main(void) {
-  uint8_t buffer[36];
+  Color colors[LEDS];
+  bool sent = false;
 
   this->setName("Tlc5947");
 
   while (!this->shouldTerminate()) {
+    // take over the pending colors as a whole
+    chSysLock();
+    uint8_t changed = this->changed;
+    this->changed = 0;
+    for (int i = 0; i < LEDS; i++)
+      colors[i] = this->colors[i];
+    chSysUnlock();
+
     int brightness = this->brightness;
+    if (brightness != this->grayscaleBrightness) {
+      this->calculateGrayscales(brightness);
+      changed = 0xFFu;
+    }
+
+    if (changed) {
+      const uint8_t *sentFrame = this->frames[this->sentFrame];
+      uint8_t *frame = this->frames[this->sentFrame ^ 1];
+
+      // rebuild the changed pairs of LEDs only
+      memcpy(frame, sentFrame, FRAME_SIZE);
+      for (int i = 0; i < LEDS; i += 2) {
+        if (changed & (3u << i))
+          this->packColors(&frame[i / 2 * 9], colors[i], colors[i + 1]);
+      }
 
-    for (int i = 0, j = 0; i < 8; i += 2) {
-      Color color1 = this->colors[i];
-      Color color2 = this->colors[i + 1];
-
-      int values[6];
-      values[0] = caluclateBlueGrayscale(color1, brightness);
-      values[1] = caluclateGreenGrayscale(color1, brightness);
-      values[2] = caluclateRedGrayscale(color1, brightness);
-      values[3] = caluclateBlueGrayscale(color2, brightness);
-      values[4] = caluclateGreenGrayscale(color2, brightness);
-      values[5] = caluclateRedGrayscale(color2, brightness);
-
-      for (int k = 0; k < 6; k += 2) {
-        int value1 = values[k];
-        int value2 = values[k + 1];
-
-        buffer[j++] = static_cast<uint8_t>((value1 >> 4) & 0xff);
-        buffer[j++] = static_cast<uint8_t>((value1 << 4) | ((value2 >> 8) & 0xff));
-        buffer[j++] = static_cast<uint8_t>(value2 & 0xff);
+      if (!sent || memcmp(frame, sentFrame, FRAME_SIZE) != 0) {
+        this->spi->write(frame, FRAME_SIZE);
+        this->sentFrame ^= 1;
+        ++this->frameCount;
+        sent = true;
       }
     }
-    this->spi->write(buffer, 36);
 
     this->waitAnyEvent(ALL_EVENTS);
   }
@@ -84,14 +140,30 @@ msg_t TLC5947::main(void) {
   return true;
 }
 
-int TLC5947::caluclateRedGrayscale(Color color, int brightness) const {
-  return color.getRed() * brightness * 16 / 100;
-}
-
-int TLC5947::caluclateGreenGrayscale(Color color, int brightness) const {
-  return color.getGreen() * brightness * 16 / 100;
+void TLC5947::calculateGrayscales(int brightness) {
+  for (int i = 0; i < 256; i++) {
+    this->redGreenGrayscale[i] = gammaGrayscale[i] * brightness / 100;
+    this->blueGrayscale[i] = gammaGrayscale[i] * brightness * 3 / (100 * 4);
+  }
+  this->grayscaleBrightness = brightness;
 }
 
-int TLC5947::caluclateBlueGrayscale(Color color, int brightness) const {
-  return color.getBlue() * brightness * (16 * 3) / (100 * 4);
+/*
+ * Packs the 12 bit grayscales of two LEDs (blue, green, red each) into 9 bytes
+ */
+void TLC5947::packColors(uint8_t *frame, Color &color1, Color &color2) const {
+  const uint16_t values[6] = {
+    this->blueGrayscale[color1.getBlue()],
+    this->redGreenGrayscale[color1.getGreen()],
+    this->redGreenGrayscale[color1.getRed()],
+    this->blueGrayscale[color2.getBlue()],
+    this->redGreenGrayscale[color2.getGreen()],
+    this->redGreenGrayscale[color2.getRed()],
+  };
+
+  for (int k = 0; k < 6; k += 2) {
+    *frame++ = static_cast<uint8_t>(values[k] >> 4);
+    *frame++ = static_cast<uint8_t>((values[k] << 4) | (values[k + 1] >> 8));
+    *frame++ = static_cast<uint8_t>(values[k + 1]);
+  }
 }
@@ -6,6 +6,7 @@
 #include <amiro/bus/i2c/I2CDriver.hpp>
 #include <amiro/magneto/hmc5883l.hpp>
 #include <amiro/Constants.h>
+#include <amiro/PowerState.h>
 
 using namespace chibios_rt;
 
@@ -51,7 +52,7 @@ main(void) {
 
     this->eventSource.broadcastFlags(0);
 
-    this->waitAnyEventTimeout(ALL_EVENTS, CAN::UPDATE_PERIOD);
+    this->waitAnyEventTimeout(ALL_EVENTS, PowerState::getUpdatePeriod());
   }
 
   return RDY_OK;
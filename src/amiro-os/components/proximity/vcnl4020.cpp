@@ -7,6 +7,7 @@
 #include <amiro/bus/i2c/I2CDriver.hpp>
 #include <amiro/proximity/vcnl4020.hpp>
 #include <amiro/Constants.h>
+#include <amiro/PowerState.h>
 
 using namespace chibios_rt;
 
@@ -108,7 +109,7 @@ main(void) {
 
     this->eventSource.broadcastFlags(0);
 
-    this->waitAnyEventTimeout(ALL_EVENTS, CAN::UPDATE_PERIOD);
+    this->waitAnyEventTimeout(ALL_EVENTS, PowerState::getUpdatePeriod());
   }
 
   return RDY_OK;
@@ -1,6 +1,6 @@
 #include <ch.h>
 #include <hal.h>
-#include <string.h>  // memcpy
+#include <string.h>  // memcpy, memchr
 #include <chprintf.h>
 #include <amiro/Constants.h>
 
@@ -12,7 +12,10 @@ using namespace chibios_rt;
 SerialCanMux::SerialCanMux(SerialDriver *_sd_, CANDriver *can, const uint8_t boardId)
   : BaseSequentialStreamInterface(),
     sd_(_sd_),
-    canDriver(can)
+    canDriver(can),
+    replyTime(0),
+    replyBacklog(0),
+    replyThread(this)
 {
 //    oqueue(ob, 500, NULL, NULL);
     myID = boardId;
@@ -25,6 +28,12 @@ SerialCanMux::SerialCanMux(SerialDriver *_sd_, CANDriver *can, const uint8_t boa
     txmsg.IDE = CAN_IDE_STD;
     txmsg.RTR = CAN_RTR_DATA;
     txmsg.DLC = 0;
+
+    replyFrame.IDE = CAN_IDE_STD;
+    replyFrame.RTR = CAN_RTR_DATA;
+    replyFrame.DLC = 0;
+
+    chOQInit(&replyQueue, replyBuffer, sizeof(replyBuffer), replyNotify, this);
 }
 
 SerialCanMux::~SerialCanMux() {
@@ -115,10 +124,13 @@ msg_t SerialCanMux::sendViaCan(uint32_t id, uint8_t *inputs, size_t size) {
 size_t SerialCanMux::write(const uint8_t *bp, size_t n) {
   size_t size;
 
-  if (myID != replyShellID) {
-     msg_t status = sendViaCan(CAN::SHELL_REPLY_ID(replyShellID), (uint8_t *)bp, n);
-     BaseThread::sleep(US2ST(500));
-     size = (status == RDY_OK) ? n : 0;
+  if (myID != replyShellID && replyQueued()) {
+    size = chOQWriteTimeout(&replyQueue, bp, n, TIME_INFINITE);
+    if (memchr(bp, '\n', n) != NULL)
+      flush();
+  } else if (myID != replyShellID) {
+    msg_t status = sendViaCan(CAN::SHELL_REPLY_ID(replyShellID), (uint8_t *)bp, n);
+    size = (status == RDY_OK) ? n : 0;
   } else {
     size = sdWrite(sd_, bp, n);
   }
@@ -127,6 +139,9 @@ size_t SerialCanMux::write(const uint8_t *bp, size_t n) {
 }
 
 size_t SerialCanMux::read(uint8_t *bp, size_t n) {
+  // the shell waits for input, so send the prompt
+  flush();
+
   size_t size = sdRead(sd_, inputChar, n);
 
   checkByteForBLReset(inputChar, size);
@@ -142,9 +157,12 @@ size_t SerialCanMux::read(uint8_t *bp, size_t n) {
 msg_t SerialCanMux::put(uint8_t b) {
   msg_t byte;
 
-  if (myID != replyShellID) {
+  if (myID != replyShellID && replyQueued()) {
+    byte = chOQPutTimeout(&replyQueue, b, TIME_INFINITE);
+    if (b == '\n')
+      flush();
+  } else if (myID != replyShellID) {
     byte = sendViaCan(CAN::SHELL_REPLY_ID(replyShellID), &b, 1);
-    BaseThread::sleep(US2ST(200));
   } else {
     byte = sdPut(sd_, b);
   }
@@ -153,6 +171,9 @@ msg_t SerialCanMux::put(uint8_t b) {
 }
 
 msg_t SerialCanMux::get(void) {
+  // the shell waits for input, so send the prompt
+  flush();
+
   msg_t byte = sdGet(sd_);
   uint8_t b = (uint8_t) byte;
 
@@ -166,6 +187,111 @@ msg_t SerialCanMux::get(void) {
 
 //----------------------------------------------------------------
 
+/*
+ * Coalescing of the output for a remote board.
+ */
+
+void SerialCanMux::start(tprio_t prio) {
+  replyThread.start(prio);
+}
+
+void SerialCanMux::flush() {
+  if (replyQueued())
+    replyThread.signalEvents(ReplyThread::FLUSH_EVENT);
+}
+
+bool SerialCanMux::replyQueued() {
+  return (replyThread.thread_ref != NULL);
+}
+
+void SerialCanMux::replyNotify(GenericQueue *qp) {
+  SerialCanMux *mux = (SerialCanMux *) chQGetLink(qp);
+
+  if (mux->replyQueued())
+    mux->replyThread.signalEventsI(ReplyThread::DATA_EVENT);
+}
+
+/*
+ * Waits until the remote serial driver has room for n more bytes.
+ */
+void SerialCanMux::throttleReply(size_t n) {
+  const uint32_t bytesPerSecond = REPLY_BAUDRATE / 10;
+
+  while (true) {
+    systime_t now = chTimeNow();
+    systime_t elapsed = now - replyTime;
+    replyTime = now;
+
+    size_t drained = (elapsed > (REPLY_WINDOW * CH_FREQUENCY) / bytesPerSecond) ? REPLY_WINDOW : elapsed * bytesPerSecond / CH_FREQUENCY;
+    replyBacklog = (drained < replyBacklog) ? replyBacklog - drained : 0;
+
+    if (replyBacklog + n <= REPLY_WINDOW)
+      break;
+
+    BaseThread::sleep(((replyBacklog + n - REPLY_WINDOW) * CH_FREQUENCY + bytesPerSecond - 1) / bytesPerSecond);
+  }
+
+  replyBacklog += n;
+}
+
+void SerialCanMux::sendReplies() {
+  while (true) {
+    chSysLock();
+    size_t n = chOQGetFullI(&replyQueue);
+    if (n > 8)
+      n = 8;
+    for (size_t i = 0; i < n; ++i)
+      replyFrame.data8[i] = (uint8_t) chOQGetI(&replyQueue);
+    if (n > 0)
+      chSchRescheduleS();
+    chSysUnlock();
+
+    if (n == 0)
+      break;
+
+    // the shell might have been switched back meanwhile
+    if (replyShellID == myID) {
+      sdWrite(sd_, replyFrame.data8, n);
+      continue;
+    }
+
+    throttleReply(n);
+    replyFrame.SID = (CAN::SHELL_REPLY_ID(replyShellID) << CAN::DEVICE_ID_SHIFT) | myID;
+    replyFrame.DLC = n;
+    // drop the output if the bus is not available (e.g. during shutdown)
+    canTransmit(canDriver, CAN_TX_MAILBOXES, &replyFrame, MS2ST(10));
+  }
+}
+
+SerialCanMux::ReplyThread::ReplyThread(SerialCanMux *mux)
+  : BaseStaticThread<256>(),
+    mux(mux) {
+}
+
+msg_t SerialCanMux::ReplyThread::main() {
+  setName("SerialCanMux");
+
+  while (!this->shouldTerminate()) {
+    eventmask_t events = this->waitAnyEventTimeout(ALL_EVENTS, MS2ST(100));
+
+    // collect a full frame unless a line is complete or the output pauses
+    while (events != 0 && !(events & FLUSH_EVENT)) {
+      chSysLock();
+      size_t queued = chOQGetFullI(&mux->replyQueue);
+      chSysUnlock();
+      if (queued >= 8)
+        break;
+      events = this->waitAnyEventTimeout(ALL_EVENTS, MS2ST(REPLY_IDLE_MS));
+    }
+
+    mux->sendReplies();
+  }
+
+  return RDY_OK;
+}
+
+//----------------------------------------------------------------
+
 /*
  * Converse data from CAN bus into input queue of serial driver.
  */
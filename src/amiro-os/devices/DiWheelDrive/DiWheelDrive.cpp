@@ -143,10 +143,12 @@ msg_t DiWheelDrive::updateSensorVal() {
 
   // Update odometry values
   this->robotPosition = global.odometry.getPosition();
+  this->odometryTimestamp = SystemTime::getTime();
 
   // Update proximity values
   for (int idx = 0; idx < 4; ++idx)
     this->proximityFloorValue[idx] = global.vcnl4020[idx].getProximityScaledWoOffset();
+  this->proximityFloorTimestamp = SystemTime::getTime();
 
   // Update magnetometer values
   for (uint8_t axis = 0; axis < 3; ++axis) {
@@ -173,6 +175,15 @@ void DiWheelDrive::periodicBroadcast() {
   this->transmitMessage(&frame);
 
   // Send the valocites µm/s of the x axis and µrad/s around z axis: end
+  // Send the timestamps of the following odometry and proximity values of the floor
+  BaseThread::sleep(US2ST(10)); // Use to sleep for 10 CAN cycle (@1Mbit), otherwise the cognition-board might not receive all messagee
+  frame.SID = 0;
+  this->encodeDeviceId(&frame, CAN::SENSOR_TIMESTAMP_ID);
+  frame.data32[0] = this->odometryTimestamp;
+  frame.data32[1] = this->proximityFloorTimestamp;
+  frame.DLC = 8;
+  this->transmitMessage(&frame);
+
   // Send the odometry: start
   BaseThread::sleep(US2ST(10)); // Use to sleep for 10 CAN cycle (@1Mbit), otherwise the cognition-board might not receive all messagee
   // Set the frame id
@@ -10,6 +10,10 @@
 #ifndef _CHCONF_H_
 #define _CHCONF_H_
 
+#ifdef AMIRO_THREAD_PROFILER
+#include <amiro/ThreadProfilerConf.h>
+#endif
+
 /*===========================================================================*/
 /**
  * @name Kernel parameters and options
@@ -513,6 +517,9 @@ void haltErrorCode(void);
 /* NVIC VTOR initialization (only offset!) */
 #define CORTEX_VTOR_INIT 0x00006000
 
+/* Sleep until the next interrupt (at the latest the next tick) instead of spinning in the idle thread. */
+#define CORTEX_ENABLE_WFI_IDLE TRUE
+
 #endif  /* _CHCONF_H_ */
 
 /** @} */
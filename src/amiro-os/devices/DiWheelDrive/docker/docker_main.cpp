@@ -16,6 +16,7 @@ using namespace amiro;
 extern Global global;
 
 bool dock_success = false;
+volatile uint8_t dock_state[2] = {0xFF, DOCK_MAIN_CODE_NONE};
 int32_t mag_max = 0, mag_min = -2;
 
 sm_docker_main_nodes_t sm_docker_main_table [] = {
@@ -33,6 +34,8 @@ fp_docker_main_t dm_get_next_state(fp_docker_main_t current_state, docker_main_c
     int state_entries = sizeof(sm_docker_main_table) / sizeof(sm_docker_main_nodes_t);
     for(int i = 0; i<state_entries; i++){
         if((sm_docker_main_table[i].current_state == current_state) && (sm_docker_main_table[i].state_code == state_code)){
+                dock_state[0] = i;
+                dock_state[1] = state_code;
                 return sm_docker_main_table[i].next_state;
         }
     }
@@ -88,11 +91,15 @@ void docker_main(UserThread *thread)
            thread->sleep(MS2ST(500));
     }
 
+    /*Park the robot while it is charging*/
+    global.robot.broadcastPowerState(PowerState::PARKED);
+
     while(1){
         if(GetBatteryPercentage() < 100){
             thread->sleep(MS2ST(1000*60*BATTERY_STATUS_CHECK_INTERVAL));
         }else{
              /*Charging Done*/
+             global.robot.broadcastPowerState(PowerState::ACTIVE);
              LedOnAllHold(thread, LED_ALERT_SUCCESS);
              MoveForwardAwayFromDock(thread);
              dock_success = true;
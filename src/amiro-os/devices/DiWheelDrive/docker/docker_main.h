@@ -7,6 +7,10 @@ using namespace amiro;
 
 extern bool dock_success;
 
+/* Last transition of the state machine (index into sm_docker_main_table, 0xFF before the first one)
+ * and the code of the last state, for the telemetry */
+extern volatile uint8_t dock_state[2];
+
 /*
 #define MS2ST(msec)                                                         \
   ((systime_t)(((((uint32_t)(msec)) * ((uint32_t)CH_FREQUENCY) - 1UL) /     \
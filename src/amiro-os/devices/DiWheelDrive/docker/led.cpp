@@ -4,19 +4,25 @@
 using namespace amiro;
 extern Global global;
 
+/*sets all LEDs with a single frame*/
+static void LedSetAll(Color color)
+{
+    LightAnimation animation = {LightAnimation::SET, LightAnimation::ALL_LEDS, 0, 0, 0, 0, 0, 0};
+    animation.red = color.getRed();
+    animation.green = color.getGreen();
+    animation.blue = color.getBlue();
+    global.robot.setLightAnimation(animation);
+}
+
 void LedOnAll(Color color)
 {
-    for (uint8_t led = 0; led < 8; ++led) {
-        global.robot.setLightColor(led, color);
-    }
+    LedSetAll(color);
 }
 
 void LedOnAllHold(UserThread *thread, Color color)
 {
-    for(uint8_t i=0; i<10; i++){
-        LedOnAll(color);
-        thread->sleep(MS2ST(500));
-    }
+    LedOnAll(color);
+    thread->sleep(MS2ST(5000));
     LedOffAll();
 }
 
@@ -37,9 +43,7 @@ void LedTurnRight()
 
 void LedOffAll()
 {
-    for (uint8_t led = 0; led < 8; ++led) {
-        global.robot.setLightColor(led, Color(Color::BLACK));
-    }
+    LedSetAll(Color(Color::BLACK));
 }
 
 void LedOff(LedLocation_t location)
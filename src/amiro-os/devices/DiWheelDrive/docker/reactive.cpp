@@ -0,0 +1,129 @@
+#include <amiro/Constants.h>
+#include "../global.hpp"
+#include "reactive.h"
+#include "sensors.h"
+#include "motors.h"
+using namespace amiro;
+extern Global global;
+
+/* Velocity of one speed unit (SPEED_OFFSET µrpm on each wheel) in Q8, computed once instead of per command */
+static const int32_t REACTIVE_SPEED_UNIT_X_Q8 =    /* mm/s */
+    constants::DiWheelDrive::wheelCircumferenceSI * SPEED_OFFSET / 60.0f / 1000.0f * 256.0f + 0.5f;
+static const int32_t REACTIVE_SPEED_UNIT_WZ_Q8 =   /* mrad/s */
+    2.0f * constants::DiWheelDrive::wheelCircumferenceSI * SPEED_OFFSET / 60.0f / constants::DiWheelDrive::wheelBaseDistanceSI / 1000.0f * 256.0f + 0.5f;
+
+/*  Collision protection: active from 2 cm (no effect on the state machines) to 1 cm.
+ *  Stops the forward motion and turns away from the obstacle. */
+static const ReactiveController::Input avoid_inputs[] = {
+    /* sensor                                low   high  x [mm/s] w_z [mrad/s] */
+    { REACTIVE_SENSOR_RING + ProxLeftTop,    2720, 7600,    -20,     -200 },
+    { REACTIVE_SENSOR_RING + ProxFrontLeft,  2720, 7600,    -40,     -300 },
+    { REACTIVE_SENSOR_RING + ProxFrontRight, 2720, 7600,    -40,      300 },
+    { REACTIVE_SENSOR_RING + ProxRightTop,   2720, 7600,    -20,      200 },
+};
+
+/*  Keeps the wall on the left between 6 cm (no activation) and 3 cm (full activation).
+ *  Balanced at half activation of both sensors, turns towards the wall if there is none. */
+static const ReactiveController::Input wall_follow_inputs[] = {
+    /* sensor                                low   high  x [mm/s] w_z [mrad/s] */
+    { REACTIVE_SENSOR_RING + ProxLeftTop,     317, 1320,      0,     -800 },
+    { REACTIVE_SENSOR_RING + ProxLeftBottom,  317, 1320,      0,      400 },
+};
+
+/*  Turns towards the front floor sensor above the black line (low values). */
+static const ReactiveController::Input line_follow_inputs[] = {
+    /* sensor                                    low     high  x [mm/s] w_z [mrad/s] */
+    { REACTIVE_SENSOR_FLOOR + FloorFrontLeft,  0x1800, 0x0800,      0,      800 },
+    { REACTIVE_SENSOR_FLOOR + FloorFrontRight, 0x1800, 0x0800,      0,     -800 },
+};
+
+#define REACTIVE_INPUTS(inputs) inputs, sizeof(inputs) / sizeof(inputs[0])
+
+static const ReactiveController::Behaviour behaviours[] = {
+    /* name          inputs, count                         x [mm/s] w_z [mrad/s] */
+    { "command",     NULL, 0,                                    0,        0 },
+    { "avoid",       REACTIVE_INPUTS(avoid_inputs),              0,        0 },
+    { "wall_follow", REACTIVE_INPUTS(wall_follow_inputs),       20,      200 },
+    { "line_follow", REACTIVE_INPUTS(line_follow_inputs),       20,        0 },
+};
+
+ReactiveController reactive(100e3, 2e6);
+
+static void ReactiveSetup()
+{
+    if(reactive.getBehaviourCount() == 0){
+        /* in the order of ReactiveBehaviour_t, the commanded velocity and the collision
+         * protection (no effect above 2 cm) are active by default */
+        for(unsigned int i = 0; i < sizeof(behaviours) / sizeof(behaviours[0]); i++){
+            reactive.addBehaviour(&behaviours[i], (i + 1 <= ReactiveAvoid) ? ReactiveController::WEIGHT_ONE : 0);
+        }
+    }
+}
+
+void ReactiveSetWeights(uint16_t command, uint16_t avoid, uint16_t wall_follow, uint16_t line_follow)
+{
+    ReactiveSetup();
+    reactive.setWeight(ReactiveCommand, command);
+    reactive.setWeight(ReactiveAvoid, avoid);
+    reactive.setWeight(ReactiveWallFollow, wall_follow);
+    reactive.setWeight(ReactiveLineFollow, line_follow);
+}
+
+bool ReactiveIsCommandOnly()
+{
+    ReactiveSetup();
+    for(uint8_t id = 1; id <= reactive.getBehaviourCount(); id++){
+        if(reactive.getWeight(id) != ((id == ReactiveCommand) ? ReactiveController::WEIGHT_ONE : 0)){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Converts speed units into a bias, rounded and limited to the range of the bias */
+static int16_t ReactiveBias(int units, int32_t unit_q8)
+{
+    int32_t bias = (units * unit_q8 + 0x80) >> 8;
+    if(bias > 0x7FFF){
+        bias = 0x7FFF;
+    }else if(bias < -0x7FFF){
+        bias = -0x7FFF;
+    }
+    return (int16_t) bias;
+}
+
+void ReactiveDrive(int speed, int rotation)
+{
+    ReactiveSetup();
+    reactive.setBias(ReactiveCommand, ReactiveBias(speed, REACTIVE_SPEED_UNIT_X_Q8), ReactiveBias(rotation, REACTIVE_SPEED_UNIT_WZ_Q8));
+}
+
+void ReactiveRun(UserThread *thread, systime_t duration)
+{
+    uint16_t sensors[REACTIVE_SENSOR_COUNT];
+    types::kinematic kinematic;
+    systime_t time = chTimeNow();
+    const systime_t end = time + duration;
+
+    ReactiveSetup();
+    do{
+        for(int i = 0; i < 8; i++){
+            sensors[REACTIVE_SENSOR_RING + i] = ProximitySensorValue((ProxSensorLocation_t)i);
+        }
+        for(int i = 0; i < 4; i++){
+            sensors[REACTIVE_SENSOR_FLOOR + i] = global.vcnl4020[i].getProximityScaledWoOffset();
+        }
+
+        reactive.update(sensors, kinematic);
+        global.motorcontrol.setTargetSpeed(kinematic);
+
+        time += REACTIVE_PERIOD;
+        if((int32_t)(end - time) < 0){
+            time = end;
+        }
+        /* skip the sleep if the tick took too long */
+        if((int32_t)(time - chTimeNow()) > 0){
+            thread->sleepUntil(time);
+        }
+    }while(time != end);
+}
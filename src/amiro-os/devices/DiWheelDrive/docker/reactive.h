@@ -0,0 +1,47 @@
+/*  Reactive controller of the docking behaviours
+ *
+ *  The state machines command a velocity, the controller blends it with the
+ *  reactive behaviours and sets one kinematic per tick at sensor rate.
+ */
+
+#ifndef __REACTIVE_H
+#define __REACTIVE_H
+#include <amiro/ReactiveController.h>
+#include "../userthread.hpp"
+#include "../global.hpp"
+
+using namespace amiro;
+
+/* Sensor values of the controller: ring (ProxSensorLocation_t) followed by floor (FloorSensorLocation_t) */
+#define REACTIVE_SENSOR_RING    0
+#define REACTIVE_SENSOR_FLOOR   8
+#define REACTIVE_SENSOR_COUNT   12
+
+/* Period of the controller, new ring values arrive with every CAN update */
+#define REACTIVE_PERIOD         CAN::UPDATE_PERIOD
+
+/* Ids of the behaviours in the controller */
+typedef enum {
+    ReactiveCommand = 1,    /* Velocity commanded by the state machines */
+    ReactiveAvoid,          /* Collision protection with the ring sensors */
+    ReactiveWallFollow,     /* Keeps a wall on the left */
+    ReactiveLineFollow,     /* Follows a black line with the front floor sensors */
+}ReactiveBehaviour_t;
+
+extern ReactiveController reactive;
+
+/* Sets the weights of all behaviours (WEIGHT_ONE is 1.0) */
+extern void ReactiveSetWeights(uint16_t command, uint16_t avoid, uint16_t wall_follow, uint16_t line_follow);
+
+/* True if only the commanded velocity is active. By default the collision protection is
+ * active as well, "reactive avoid 0" disables it and opts out of the controller */
+extern bool ReactiveIsCommandOnly();
+
+/* Commands a velocity in the speed units of RobotDriveForward() and RobotRotateClockwise(),
+ * positive rotation is counterclockwise */
+extern void ReactiveDrive(int speed, int rotation);
+
+/* Runs the controller for a duration */
+extern void ReactiveRun(UserThread *thread, systime_t duration);
+
+#endif
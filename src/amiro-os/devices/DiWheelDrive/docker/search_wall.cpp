@@ -7,11 +7,15 @@
 #include "sensors.h"
 #include "motors.h"
 #include "search_wall.h"
+#include "reactive.h"
 
 using namespace amiro;
 
 search_wall_code_t  sw_wall[8];
 
+/*drive through the reactive controller (default), the tuned wheel speeds if opted out (see ReactiveIsCommandOnly())*/
+static bool sw_reactive = false;
+
 sm_search_wall_node_t sm_sw_transition_table[] = {
     { SW_Fn_Start,                  SW_CODE_NONE,       SW_Fn_CheckFrontLeft        },
     /*set 1*/
@@ -108,8 +112,13 @@ docker_main_codes_t SearchWall(UserThread *thread)
     search_wall_code_t state_code = SW_CODE_NONE;
     fp_search_wall_t current_state = SW_Fn_Start, next_state = NULL;
     LedOnAllHold(thread, LED_ALERT_STATE_CHANGE);
+
+    ReactiveDrive(0, 0);
     while(1){
         SW_GetWallStateAll(sw_wall);
+
+        /*the tuned wheel speeds only if all reactive behaviours are weighted out*/
+        sw_reactive = !ReactiveIsCommandOnly();
         
         /*Execute State*/
         state_code = current_state();
@@ -131,7 +140,12 @@ docker_main_codes_t SearchWall(UserThread *thread)
         current_state = next_state;
 
         
-        thread->sleep(MS2ST(500));
+        if(sw_reactive){
+            /*the states command the velocity, the behaviours run at sensor rate in between*/
+            ReactiveRun(thread, MS2ST(500));
+        }else{
+            thread->sleep(MS2ST(500));
+        }
     }
     
     return DOCK_MAIN_CODE_SEARCH_WALL_SUCCESS;
@@ -166,25 +180,41 @@ search_wall_code_t SW_Fn_CheckFrontRight_3()
 
 search_wall_code_t SW_Fn_DriveForward_Slow()
 {
-    RobotDriveForward(SEARCH_WALL_SPEED_LOW, 0);
+    if(sw_reactive){
+        ReactiveDrive(SEARCH_WALL_SPEED_LOW, 0);
+    }else{
+        RobotDriveForward(SEARCH_WALL_SPEED_LOW, 0);
+    }
     return SW_CODE_NONE;
 }
 
 search_wall_code_t SW_Fn_DriveForward_Fast()
 {
-    RobotDriveForward(SEARCH_WALL_SPEED_HIGH, 0);
+    if(sw_reactive){
+        ReactiveDrive(SEARCH_WALL_SPEED_HIGH, 0);
+    }else{
+        RobotDriveForward(SEARCH_WALL_SPEED_HIGH, 0);
+    }
     return SW_CODE_NONE;
 }
 
 search_wall_code_t SW_Fn_RotateClockwise_Fast()
 {
-    RobotRotateClockwise(SEARCH_WALL_ROTATE_HIGH, 0);
+    if(sw_reactive){
+        ReactiveDrive(0, -SEARCH_WALL_ROTATE_HIGH);
+    }else{
+        RobotRotateClockwise(SEARCH_WALL_ROTATE_HIGH, 0);
+    }
     return SW_CODE_NONE;
 }
 
 search_wall_code_t SW_Fn_RotateClockwise_Slow()
 {
-    RobotRotateClockwise(SEARCH_WALL_ROTATE_LOW, 0);
+    if(sw_reactive){
+        ReactiveDrive(0, -SEARCH_WALL_ROTATE_LOW);
+    }else{
+        RobotRotateClockwise(SEARCH_WALL_ROTATE_LOW, 0);
+    }
     return SW_CODE_NONE;
 }
 
@@ -200,6 +230,7 @@ search_wall_code_t SW_Fn_CheckLeftBottom()
 
 search_wall_code_t SW_Fn_FollowWall()
 {
+    ReactiveDrive(0, 0);
     RobotStop();
     return SW_CODE_NONE;
 }
@@ -40,6 +40,19 @@ void OdometerReset()
    global.odometry.resetPosition();
 }
 
+bool LidarWallReading(uint16_t *distance_mm, int16_t *angle_mrad)
+{
+    LidarScan::Wall wall;
+    systime_t age = global.robot.getLidarWall(wall);
+
+    if (age >= MS2ST(500) || wall.segments == 0) {
+        return false;
+    }
+    *distance_mm = wall.distance;
+    *angle_mrad = wall.angle;
+    return true;
+}
+
 uint16_t ProxyDistance2uint16_t(float distance)
 {
     uint16_t value = 0;
@@ -59,6 +59,10 @@ extern int16_t AccelReading(accel_axis_t axis);
 extern types::position OdometerReading();
 extern void OdometerReset();
 
+/* Wall in front of the robot as extracted by the LightRing from the LIDAR scans.
+ * Returns false if no recent wall is available. */
+extern bool LidarWallReading(uint16_t *distance_mm, int16_t *angle_mrad);
+
 /*Distance(in cm) to Approximate uint16_t [0.5 to 10 in 0.5 cm increments]*/
 extern uint16_t ProxyDistance2uint16_t(float distance);
 /*
@@ -6,6 +6,7 @@
 #include "exti.hpp"
 
 volatile uint32_t shutdown_now = 0x00000000u; // = BL_SHUTDOWN_NONE in main.cpp
+volatile bool accel_wakeup = false;
 
 EXTConfig extcfg = {
 
@@ -87,8 +88,8 @@ EXTConfig extcfg = {
     },
     /* channel 15 */
     {
-      /* mode */ EXT_CH_MODE_DISABLED,
-      /* cb   */ NULL,
+      /* mode */ EXT_MODE_GPIOB | EXT_CH_MODE_FALLING_EDGE, // enabled while parked
+      /* cb   */ accel_wakeup_cb,
     },
     /* channel 16 */
     {
@@ -117,3 +118,11 @@ void power_down_cb(EXTDriver *extp, expchannel_t channel) {
     palWritePad(GPIOC, GPIOC_SYS_INT_N, PAL_LOW); // indicate that the module needs some time to shut down
     shutdown_now = 5; // = SHUTDOWN_HANDLE_REQUEST in main.cpp
 }
+
+void accel_wakeup_cb(EXTDriver *extp, expchannel_t channel) {
+
+  (void) extp;
+  (void) channel;
+  // the accelerometer detected a movement, handled by the main thread
+  accel_wakeup = true;
+}
@@ -2,9 +2,11 @@
 #define EXT_HPP_
 
 extern volatile uint32_t shutdown_now;
+extern volatile bool accel_wakeup;
 
 extern EXTConfig extcfg;
 
 void power_down_cb(EXTDriver *extp, expchannel_t channel);
+void accel_wakeup_cb(EXTDriver *extp, expchannel_t channel);
 
 #endif /* EXT_HPP_ */
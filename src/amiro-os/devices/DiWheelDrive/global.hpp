@@ -21,6 +21,7 @@
 #include <amiro/eeprom/at24.hpp>
 #include <amiro/FileSystemInputOutput/FSIODiWheelDrive.hpp>
 #include <amiro/serial_reset/serial_can_mux.hpp>
+#include <amiro/Telemetry.h>
 #include <amiro/MotorIncrements.h>
 #include <amiro/MotorControl.h>
 #include <amiro/DistControl.h>
@@ -160,6 +161,7 @@ public:
   DistControl distcontrol;
   Odometry odometry;
   SerialCanMux sercanmux1;
+  Telemetry telemetry;
 
   DiWheelDrive robot;
 
@@ -192,6 +194,7 @@ public:
     distcontrol(&motorcontrol, &increments),
     odometry(&increments, &l3g4200d),
     sercanmux1(&SD1, &CAND1, CAN::DI_WHEEL_DRIVE_ID),
+    telemetry((BaseSequentialStream *) &sercanmux1),
     robot(&CAND1),
     userThread()
   {
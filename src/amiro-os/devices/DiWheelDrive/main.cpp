@@ -11,8 +11,16 @@
 #include <ch.hpp>
 
 #include <amiro/util/util.h>
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+#include <amiro/TopologyBenchmark.h>
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+#include <amiro/ThreadProfiler.h>
+#endif
 #include <global.hpp>
 #include <exti.hpp>
+#include "docker/docker_main.h"
+#include "docker/reactive.h"
 
 #include <chprintf.h>
 #include <shell.h>
@@ -39,6 +47,9 @@ void systemShutdown() {
   global.userThread.requestTerminate();
   global.userThread.wait();
 
+  global.telemetry.requestTerminate();
+  global.telemetry.wait();
+
   k.x = 0x00u;
   k.w_z = 0x00u;
 
@@ -63,6 +74,9 @@ void systemShutdown() {
   global.odometry.requestTerminate();
   global.odometry.wait();
 
+  // write back pending modifications of the memory
+  global.memory.sync();
+
   // stop I²C
   for (i = 0; i < global.V_I2C2.size(); ++i)
     global.V_I2C2[i].stop();
@@ -208,6 +222,11 @@ void shellRequestGetMemoryData(BaseSequentialStream *chp, int argc, char *argv[]
     chprintf(chp, "Warning: request exceeds eeprom size -> limiting to %u values.\n", num_elements);
   }
 
+  // write back pending modifications of the memory layout first
+  global.memory.sync();
+
+  // the stream position and the bus are shared with the write-behind flush
+  global.at24c01.acquire();
   chFileStreamSeek((BaseFileStream*)&global.at24c01, start_byte);
 
   // Work around, because stm32f1 cannot read a single byte
@@ -215,6 +234,7 @@ void shellRequestGetMemoryData(BaseSequentialStream *chp, int argc, char *argv[]
     type_size = 2;
 
   uint32_t bytes_read = chSequentialStreamRead((BaseFileStream*)&global.at24c01, buffer, type_size*num_elements);
+  global.at24c01.release();
 
   if (bytes_read != type_size*num_elements)
     chprintf(chp, "Warning: %u of %u requested bytes were read.\n", bytes_read, type_size*num_elements);
@@ -578,6 +598,43 @@ void shellRequestCalib(BaseSequentialStream *chp, int __unused argc, char __unus
   global.robot.calibrate();
 }
 
+void shellRequestGetMemoryStats(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestGetMemoryStats\n");
+
+  if (argc >= 1 && !strcmp(argv[0], "sync")) {
+    if (global.memory.sync() != global.memory.OK)
+      chprintf(chp, "Sync: FAIL\n");
+    else
+      chprintf(chp, "Sync: OK\n");
+  }
+
+  chprintf(chp, "dirty pages:  %u\n", global.memory.getDirtyPages());
+  chprintf(chp, "write errors: %u\n", global.memory.getWriteErrors());
+  chprintf(chp, "page writes since startup:\n");
+  for (uint8_t page = 0; page < global.memory.getNumPages(); ++page) {
+    chprintf(chp, "  page %2u: %u\n", page, global.memory.getPageWrites(page));
+  }
+}
+
+void shellRequestGetLidarScan(BaseSequentialStream *chp, int __unused argc, char __unused *argv[]) {
+  chprintf(chp, "shellRequestGetLidarScan\n");
+
+  uint8_t ranges[LidarScan::POINTS];
+  uint32_t scanCount = 0;
+  LidarScan::Receiver &receiver = global.robot.getLidarScanReceiver();
+
+  if (!global.robot.getLidarScan(ranges, scanCount)) {
+    chprintf(chp, "No scan received from the LightRing.\n");
+    return;
+  }
+
+  chprintf(chp, "scans: %u, dropped: %u\n", receiver.getScanCount(), receiver.getDropCount());
+  chprintf(chp, "angle [mrad]\trange [mm]\n");
+  for (uint8_t point = 0; point < LidarScan::POINTS; ++point) {
+    chprintf(chp, "%d\t%u\n", LidarScan::getAngle(point) / 1000, LidarScan::toMillimeter(ranges[point]));
+  }
+}
+
 void shellRequestGetRobotId(BaseSequentialStream *chp, int __unused argc, char __unused *argv[]) {
   (void) argc;
   chprintf(chp, "shellRequestGetRobotId\n");
@@ -644,6 +701,44 @@ void shellRequestGetBootloaderInfo(BaseSequentialStream* chp, int argc, char *ar
   return;
 }
 
+/*
+ * Puts the inertial sensors to sleep while the robot is parked and wakes them up
+ * again. A movement detected by the accelerometer ends the parked state.
+ */
+void applyPowerState(PowerState::State state) {
+  if (state == PowerState::PARKED) {
+    global.l3g4200d.configure(&global.gyro_sleep_config);
+    global.lis331dlh.configure(&global.accel_sleep_config);
+    accel_wakeup = false;
+    extChannelEnable(&EXTD1, GPIOB_ACCEL_INT_N);
+  } else {
+    extChannelDisable(&EXTD1, GPIOB_ACCEL_INT_N);
+    global.l3g4200d.configure(&global.gyro_run_config);
+    global.lis331dlh.configure(&global.accel_run_config);
+  }
+
+  return;
+}
+
+void shellRequestPowerState(BaseSequentialStream *chp, int argc, char *argv[]) {
+  if (argc == 1) {
+    if (strcmp(argv[0], "active") == 0) {
+      global.robot.broadcastPowerState(PowerState::ACTIVE);
+    } else if (strcmp(argv[0], "parked") == 0) {
+      global.robot.broadcastPowerState(PowerState::PARKED);
+    } else {
+      chprintf(chp, "Usage: %s\n","power_state [active|parked]");
+      return;
+    }
+  } else if (argc > 1) {
+    chprintf(chp, "Usage: %s\n","power_state [active|parked]");
+    return;
+  }
+
+  chprintf(chp, "power state: %s\n", PowerState::getName(PowerState::get()));
+  return;
+}
+
 void shellRequestMotorDrive(BaseSequentialStream *chp, int argc, char *argv[]) {
   types::kinematic tmp;
   tmp.w_z = 0;
@@ -709,6 +804,123 @@ void shellRequestMotorResetGains(BaseSequentialStream *chp, int argc, char *argv
   return;
 }
 
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+void shellRequestTopologyBenchmark(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestTopologyBenchmark\n");
+  tbmkShell(chp, argc, argv, &tbmkDiWheelDrive);
+}
+#endif
+
+#ifdef AMIRO_THREAD_PROFILER
+void shellRequestProfile(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestProfile\n");
+  tprofShell(chp, argc, argv);
+}
+#endif
+
+/*
+ * Telemetry channels
+ */
+static void sampleOdometry(void *values) {
+  types::position position = global.odometry.getPosition();
+  int32_t *v = (int32_t *) values;
+  v[0] = position.x;
+  v[1] = position.y;
+  v[2] = position.f_z;
+}
+
+static void sampleWheelRpm(void *values) {
+  int32_t *v = (int32_t *) values;
+  v[0] = global.motorcontrol.getCurrentRPMLeft();
+  v[1] = global.motorcontrol.getCurrentRPMRight();
+}
+
+static void samplePwm(void *values) {
+  int16_t *v = (int16_t *) values;
+  v[0] = global.motorcontrol.getCurrentPWMLeft();
+  v[1] = global.motorcontrol.getCurrentPWMRight();
+}
+
+static void sampleFloor(void *values) {
+  uint16_t *v = (uint16_t *) values;
+  for (uint8_t i = 0; i < global.vcnl4020.size(); i++)
+    v[i] = global.vcnl4020[i].getProximityScaledWoOffset();
+}
+
+static void sampleProximity(void *values) {
+  uint16_t *v = (uint16_t *) values;
+  for (int i = 0; i < 8; i++)
+    v[i] = global.robot.getProximityRingValue(i);
+}
+
+static void sampleDockState(void *values) {
+  uint8_t *v = (uint8_t *) values;
+  v[0] = dock_state[0];
+  v[1] = dock_state[1];
+}
+
+static const Telemetry::Channel telemetryChannels[] = {
+  /* name         values                  type        count  sampler */
+  {"odometry",    "x_um,y_um,phi_urad",   TLM_INT32,  3,     sampleOdometry},
+  {"wheel_rpm",   "left,right",           TLM_INT32,  2,     sampleWheelRpm},
+  {"pwm",         "left,right",           TLM_INT16,  2,     samplePwm},
+  {"floor",       "fl,lw,rw,fr",          TLM_UINT16, 4,     sampleFloor},
+  {"proximity",   "r0,r1,r2,r3,r4,r5,r6,r7", TLM_UINT16, 8,  sampleProximity},
+  {"dock_state",  "transition,code",      TLM_UINT8,  2,     sampleDockState},
+};
+
+/* default periods in ms */
+static const uint16_t telemetryPeriods[] = {50, 20, 20, 100, 100, 100};
+
+void shellRequestTelemetry(BaseSequentialStream *chp, int argc, char *argv[]) {
+  if (argc == 1 && (strcmp(argv[0], "on") == 0 || strcmp(argv[0], "off") == 0)) {
+    global.telemetry.enable(strcmp(argv[0], "on") == 0);
+    return;
+  }
+
+  if (argc == 2) {
+    uint8_t id = global.telemetry.findChannel(argv[0]);
+    if (id == 0) {
+      chprintf(chp, "unknown channel %s\n", argv[0]);
+      return;
+    }
+    global.telemetry.setPeriod(id, atoi(argv[1]));
+    return;
+  }
+
+  if (argc != 0) {
+    chprintf(chp, "Usage: %s\n","telemetry [on|off]");
+    chprintf(chp, "       %s\n","telemetry <channel> <period in ms, 0 to disable>");
+    return;
+  }
+
+  chprintf(chp, "telemetry %s, %u frames sent\n", global.telemetry.isEnabled() ? "on" : "off", global.telemetry.getFrameCount());
+  for (uint8_t id = 1; id <= global.telemetry.getChannelCount(); id++)
+    chprintf(chp, "%2u %-12s %5u ms\n", id, global.telemetry.getChannel(id)->name, global.telemetry.getPeriod(id));
+}
+
+void shellRequestReactive(BaseSequentialStream *chp, int argc, char *argv[]) {
+  if (argc == 2) {
+    uint8_t id = reactive.findBehaviour(argv[0]);
+    if (id == 0) {
+      chprintf(chp, "unknown behaviour %s\n", argv[0]);
+      return;
+    }
+    int weight = atoi(argv[1]);
+    reactive.setWeight(id, (weight > 0) ? weight * ReactiveController::WEIGHT_ONE / 100 : 0);
+    return;
+  }
+
+  if (argc != 0) {
+    chprintf(chp, "Usage: %s\n","reactive");
+    chprintf(chp, "       %s\n","reactive <behaviour> <weight in %>");
+    return;
+  }
+
+  for (uint8_t id = 1; id <= reactive.getBehaviourCount(); id++)
+    chprintf(chp, "%u %-12s %3u%%\n", id, reactive.getBehaviour(id)->name, reactive.getWeight(id) * 100 / ReactiveController::WEIGHT_ONE);
+}
+
 static const ShellCommand commands[] = {
   {"shutdown", shellRequestShutdown},
   {"wakeup", shellRequestWakeup},
@@ -717,6 +929,7 @@ static const ShellCommand commands[] = {
   {"get_board_id", shellRequestGetBoardId},
   {"set_board_id", shellRequestSetBoardId},
   {"get_memory_data", shellRequestGetMemoryData},
+  {"memory_stats", shellRequestGetMemoryStats},
   {"get_vcnl", shellRequestGetVcnl},
   {"calib_vcnl_offset", shellRequestCalib},
   {"set_vcnl_offset", shellRequestSetVcnlOffset},
@@ -726,7 +939,9 @@ static const ShellCommand commands[] = {
   {"get_Ed_Eb", shellRequestGetCalibrationConstants},
   {"set_Ed_Eb", shellRequestSetCalibrationConstants},
   {"get_robot_id", shellRequestGetRobotId},
+  {"get_lidar_scan", shellRequestGetLidarScan},
   {"get_system_load", shellRequestGetSystemLoad},
+  {"power_state", shellRequestPowerState},
   {"set_lights", shellRequestSetLights},
   {"shell_board", shellSwitchBoardCmd},
   {"get_bootloader_info", shellRequestGetBootloaderInfo},
@@ -735,6 +950,14 @@ static const ShellCommand commands[] = {
   {"motor_calibrate", shellRequestMotorCalibrate},
   {"motor_getGains", shellRequestMotorGetGains},
   {"motor_resetGains", shellRequestMotorResetGains},
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+  {"bmk_topology", shellRequestTopologyBenchmark},
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+  {"profile", shellRequestProfile},
+#endif
+  {"telemetry", shellRequestTelemetry},
+  {"reactive", shellRequestReactive},
   {NULL, NULL}
 };
 
@@ -784,6 +1007,7 @@ int main(void) {
 
 //  int16_t accel;
   Thread *shelltp = NULL;
+  PowerState::State powerState = PowerState::ACTIVE;
 
   /*
    * System initializations.
@@ -844,6 +1068,7 @@ int main(void) {
   global.HW_I2C2.start(&global.i2c2_config);
 
   global.memory.init();
+  global.memory.start(NORMALPRIO);
 
   uint8_t i = 0;
   if (global.memory.getBoardId(&i) == fileSystemIo::FileSystemIoBase::OK) {
@@ -876,6 +1101,8 @@ int main(void) {
 
   global.robot.start(HIGHPRIO - 1);
 
+  global.sercanmux1.start(NORMALPRIO + 1);
+
   global.motorcontrol.start(NORMALPRIO + 7);
 
   global.distcontrol.start(NORMALPRIO + 9);
@@ -890,6 +1117,11 @@ int main(void) {
   global.lis331dlh.configure(&global.accel_run_config);
   global.lis331dlh.start(NORMALPRIO+4);
 
+  // Start the telemetry stream, it is enabled with the shell command 'telemetry on'
+  for (size_t i = 0; i < sizeof(telemetryChannels) / sizeof(telemetryChannels[0]); i++)
+    global.telemetry.registerChannel(&telemetryChannels[i], telemetryPeriods[i]);
+  global.telemetry.start(NORMALPRIO - 1);
+
   // Start the user thread
   global.userThread.start(NORMALPRIO);
 
@@ -916,6 +1148,16 @@ int main(void) {
     boardWriteLed(0);
     BaseThread::sleep(MS2ST(250));
 
+    if (accel_wakeup) {
+      accel_wakeup = false;
+      if (PowerState::isParked())
+        global.robot.broadcastPowerState(PowerState::ACTIVE);
+    }
+    if (PowerState::get() != powerState) {
+      powerState = PowerState::get();
+      applyPowerState(powerState);
+    }
+
     if (shutdown_now != SHUTDOWN_NONE) {
       if ((*((uint32_t*)(BL_CALLBACK_TABLE_ADDR)) != (('A'<<24) | ('-'<<16) | ('B'<<8) | ('L'<<0))) && (*((uint32_t*)(BL_CALLBACK_TABLE_ADDR)) != BL_MAGIC_NUMBER)) {
         chprintf((BaseSequentialStream*) &SD1, "ERROR: unable to shut down (bootloader deprecated).\n");
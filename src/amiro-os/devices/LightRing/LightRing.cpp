@@ -9,6 +9,9 @@ using namespace chibios_rt;
 using namespace amiro;
 using namespace types;
 
+static_assert(LidarScan::STEPS == NUMBER_OF_STEPS && LidarScan::FIRST_STEP == STARTING_STEP,
+              "LidarScan does not match the configuration of the LIDAR");
+
 extern volatile uint32_t shutdown_now;
 extern Global global;
 
@@ -17,7 +20,9 @@ LightRing::LightRing(CANDriver *can, TLC5947 *tlc5947, fileSystemIo::FSIOLightRi
     : ControllerAreaNetworkTx(can, CAN::LIGHT_RING_ID),
       ControllerAreaNetworkRx(can, CAN::LIGHT_RING_ID),
       tlc5947(tlc5947),
-      memory(memory) {
+      memory(memory),
+      bcCounter(0),
+      lidarScanCount(0) {
   chDbgCheck(tlc5947 != NULL, "LightRing");
 }
 
@@ -27,8 +32,7 @@ void LightRing::setLightBrightness(int brightness) {
 }
 
 void LightRing::setLightColor(int index, Color color) {
-  this->tlc5947->setColor(index, color);
-  this->tlc5947->update();
+  global.lightAnimator.setColor(index, color);
 }
 
 msg_t LightRing::receiveMessage(CANRxFrame *frame) {
@@ -69,6 +73,22 @@ msg_t LightRing::receiveMessage(CANRxFrame *frame) {
       }
       break;
 
+    case CAN::LIGHT_ANIMATION_ID:
+      if (frame->DLC == 8) {
+        LightAnimation animation;
+        animation.effect = frame->data8[0];
+        animation.mask = frame->data8[1];
+        animation.red = frame->data8[2];
+        animation.green = frame->data8[3];
+        animation.blue = frame->data8[4];
+        animation.period = frame->data8[5];
+        animation.repeat = frame->data8[6];
+        animation.param = frame->data8[7];
+        global.lightAnimator.animate(animation);
+        return RDY_OK;
+      }
+      break;
+
     case CAN::BRIGHTNESS_ID:
       if (frame->DLC == 1) {
         int brightness = frame->data8[0];
@@ -117,4 +137,12 @@ LightRing::terminate(void) {
 
 void LightRing::periodicBroadcast() {
 
+  // Stream the scans of the LIDAR at a few Hz
+  if (++this->bcCounter >= LidarScan::SCAN_PERIOD) {
+    this->bcCounter = 0;
+    if (global.lidar.getScan(this->lidarScan, this->lidarScanCount)) {
+      LidarScan::compact(this->lidarScan, this->lidarRanges);
+      this->broadcastLidarScan(this->lidarRanges, uint8_t(this->lidarScanCount));
+    }
+  }
 }
@@ -7,6 +7,7 @@
 #include <amiro/ControllerAreaNetworkTx.h>
 #include <amiro/leds/tlc5947.hpp>
 #include <amiro/FileSystemInputOutput/FSIOLightRing.hpp>
+#include <amiro/LidarScan.h>
 
 using namespace chibios_rt;
 
@@ -33,6 +34,10 @@ namespace amiro {
   private:
     TLC5947 *tlc5947;
     fileSystemIo::FSIOLightRing *memory;
+    uint8_t bcCounter;
+    uint32_t lidarScanCount;
+    uint16_t lidarScan[LidarScan::STEPS];
+    uint8_t lidarRanges[LidarScan::POINTS];
   };
 
 }
@@ -7,10 +7,12 @@
 #include <amiro/bus/i2c/HWI2CDriver.hpp>
 #include <amiro/bus/spi/HWSPIDriver.hpp>
 #include <amiro/leds/tlc5947.hpp>
+#include <amiro/LightAnimator.h>
 #include <amiro/eeprom/at24.hpp>
 #include <amiro/FileSystemInputOutput/FSIOLightRing.hpp>
 #include <LightRing.h>
 #include <amiro/Lidar.h>
+#include <amiro/WallExtractor.h>
 #include <amiro/radio/a2500r24a.hpp>
 #include <amiro/serial_reset/serial_can_mux.hpp>
 #include <userthread.hpp>
@@ -32,12 +34,6 @@ public:
     /* CR2 register */ 0,
     /* CR3 register */ 0
   };
-  SerialConfig sd2_config{
-    /* speed        */ 19200,
-    /* CR1 register */ 0,
-    /* CR2 register */ 0,
-    /* CR3 register */ 0
-  };
 
   SPIConfig spi1_config{
     /* callback function pointer   */ NULL,
@@ -69,10 +65,14 @@ public:
 
   LightRing robot;
 
+  LightAnimator lightAnimator;
+
   SerialCanMux sercanmux1;
 
   Lidar lidar;
 
+  WallExtractor wallExtractor;
+
   A2500R24A a2500r24a;
 
   UserThread userThread;
@@ -87,8 +87,14 @@ public:
     at24c01(0x400u / 0x08u, 0x08u, 500u, &HW_I2C2),
     memory(at24c01, /*BMSV*/ 1, /*bmsv*/ 2, /*HMV*/ 1, /*hmv*/ 0),
     robot(&CAND1, &tlc5947, &memory),
+    lightAnimator(&tlc5947, &robot),
     sercanmux1(&SD1, &CAND1, CAN::LIGHT_RING_ID),
+#ifdef AMIRO_LIDAR_POWER_ONLY
     lidar(CAN::LIGHT_RING_ID, Lidar::SETUP::POWER_ONLY),
+#else
+    lidar(CAN::LIGHT_RING_ID, Lidar::SETUP::SERIAL_IO),
+#endif
+    wallExtractor(&lidar, &robot),
     a2500r24a(&HW_SPI2),
     userThread()
   {
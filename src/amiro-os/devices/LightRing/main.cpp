@@ -13,6 +13,12 @@
 #include "global.hpp"
 #include <amiro/util/util.h>
 #include <amiro/Color.h>
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+#include <amiro/TopologyBenchmark.h>
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+#include <amiro/ThreadProfiler.h>
+#endif
 #include <exti.hpp>
 
 #include <chprintf.h>
@@ -202,13 +208,23 @@ void systemShutdown() {
   global.robot.setLightBrightness(0);
   global.robot.terminate();
 
+  global.lightAnimator.requestTerminate();
+  global.lightAnimator.signalEvents(ALL_EVENTS);
+  global.lightAnimator.wait();
+
   global.tlc5947.requestTerminate();
   global.tlc5947.update();
   global.tlc5947.wait();
 
+  global.wallExtractor.requestTerminate();
+  global.wallExtractor.wait();
+
   global.lidar.requestTerminate();
   global.lidar.wait();
 
+  // write back pending modifications of the memory
+  global.memory.sync();
+
 //  boardStandby();
 
   return;
@@ -349,6 +365,11 @@ void shellRequestGetMemoryData(BaseSequentialStream *chp, int argc, char *argv[]
     chprintf(chp, "Warning: request exceeds eeprom size -> limiting to %u values.\n", num_elements);
   }
 
+  // write back pending modifications of the memory layout first
+  global.memory.sync();
+
+  // the stream position and the bus are shared with the write-behind flush
+  global.at24c01.acquire();
   chFileStreamSeek((BaseFileStream*)&global.at24c01, start_byte);
 
   // Work around, because stm32f1 cannot read a single byte
@@ -356,6 +377,7 @@ void shellRequestGetMemoryData(BaseSequentialStream *chp, int argc, char *argv[]
     type_size = 2;
 
   uint32_t bytes_read = chSequentialStreamRead((BaseFileStream*)&global.at24c01, buffer, type_size*num_elements);
+  global.at24c01.release();
 
   if (bytes_read != type_size*num_elements)
     chprintf(chp, "Warning: %u of %u requested bytes were read.\n", bytes_read, type_size*num_elements);
@@ -398,6 +420,66 @@ void shellRequestCheck(BaseSequentialStream *chp, int __unused argc, char __unus
   boardPeripheryCheck(chp);
 }
 
+void shellRequestGetMemoryStats(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestGetMemoryStats\n");
+
+  if (argc >= 1 && !strcmp(argv[0], "sync")) {
+    if (global.memory.sync() != global.memory.OK)
+      chprintf(chp, "Sync: FAIL\n");
+    else
+      chprintf(chp, "Sync: OK\n");
+  }
+
+  chprintf(chp, "dirty pages:  %u\n", global.memory.getDirtyPages());
+  chprintf(chp, "write errors: %u\n", global.memory.getWriteErrors());
+  chprintf(chp, "page writes since startup:\n");
+  for (uint8_t page = 0; page < global.memory.getNumPages(); ++page) {
+    chprintf(chp, "  page %2u: %u\n", page, global.memory.getPageWrites(page));
+  }
+}
+
+void shellRequestGetLidarWall(BaseSequentialStream *chp, int __unused argc, char __unused *argv[]) {
+  chprintf(chp, "shellRequestGetLidarWall\n");
+
+  LidarScan::Wall wall;
+  chprintf(chp, "scans: %u, dropped: %u\n", global.lidar.getScanCount(), global.lidar.getErrorCount());
+  if (!global.wallExtractor.getWall(wall)) {
+    chprintf(chp, "No scan processed yet.\n");
+    return;
+  }
+  chprintf(chp, "segments:        %u\n", wall.segments);
+  chprintf(chp, "distance [mm]:   %u\n", wall.distance);
+  chprintf(chp, "angle [mrad]:    %d\n", wall.angle);
+  chprintf(chp, "length [mm]:     %u\n", wall.length);
+  chprintf(chp, "max. duration:   %u ticks\n", global.wallExtractor.getMaxDuration());
+}
+
+void shellRequestAnimation(BaseSequentialStream *chp, int argc, char *argv[]) {
+  if (argc < 1 || argc > 8) {
+    chprintf(chp, "Usage: %s\n", "animation <effect> [<mask> <red> <green> <blue> <period ms> <repeat> <param>]");
+    chprintf(chp, "effects: 0 stop, 1 set, 2 blink, 3 fade, 4 chase, 5 proximity\n");
+    return;
+  }
+
+  LightAnimation animation = {0, LightAnimation::ALL_LEDS, 0xFF, 0xFF, 0xFF, 1000 / LightAnimation::PERIOD_UNIT_MS, 0, 0};
+  animation.effect = atoi(argv[0]);
+  if (argc > 1)
+    animation.mask = strtol(argv[1], NULL, 0);
+  if (argc > 4) {
+    animation.red = atoi(argv[2]);
+    animation.green = atoi(argv[3]);
+    animation.blue = atoi(argv[4]);
+  }
+  if (argc > 5)
+    animation.period = atoi(argv[5]) / LightAnimation::PERIOD_UNIT_MS;
+  if (argc > 6)
+    animation.repeat = atoi(argv[6]);
+  if (argc > 7)
+    animation.param = atoi(argv[7]);
+
+  global.lightAnimator.animate(animation);
+}
+
 void shellRequestGetRobotId(BaseSequentialStream *chp, int __unused argc, char __unused *argv[]) {
   chprintf(chp, "shellRequestGetRobotId\n");
   chprintf(chp, "Robot ID: %u\n", global.robot.getRobotID());
@@ -460,6 +542,20 @@ void shellRequestGetBootloaderInfo(BaseSequentialStream* chp, int argc, char *ar
   return;
 }
 
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+void shellRequestTopologyBenchmark(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestTopologyBenchmark\n");
+  tbmkShell(chp, argc, argv, &tbmkLightRing);
+}
+#endif
+
+#ifdef AMIRO_THREAD_PROFILER
+void shellRequestProfile(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestProfile\n");
+  tprofShell(chp, argc, argv);
+}
+#endif
+
 static const ShellCommand commands[] = {
   {"shutdown", shellRequestShutdown},
   {"check", shellRequestCheck},
@@ -467,10 +563,19 @@ static const ShellCommand commands[] = {
   {"get_board_id", shellRequestGetBoardId},
   {"set_board_id", shellRequestSetBoardId},
   {"get_memory_data", shellRequestGetMemoryData},
+  {"memory_stats", shellRequestGetMemoryStats},
   {"get_robot_id", shellRequestGetRobotId},
+  {"get_lidar_wall", shellRequestGetLidarWall},
+  {"animation", shellRequestAnimation},
   {"get_system_load", shellRequestGetSystemLoad},
   {"shell_board", shellSwitchBoardCmd},
   {"get_bootloader_info", shellRequestGetBootloaderInfo},
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+  {"bmk_topology", shellRequestTopologyBenchmark},
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+  {"profile", shellRequestProfile},
+#endif
   {NULL, NULL}
 };
 
@@ -499,10 +604,9 @@ int main(void) {
   System::init();
 
   /*
-   * Activates the serial driver 2 using the driver default configuration.
+   * Activates the serial driver 1 (USART2 is run by the LIDAR driver).
    */
   sdStart(&SD1, &global.sd1_config);
-  sdStart(&SD2, &global.sd2_config);
 
   chprintf((BaseSequentialStream*) &SD1, "\n");
   chprintf((BaseSequentialStream*) &SD1, BOARD_NAME " " BOARD_VERSION "\n");
@@ -536,6 +640,7 @@ int main(void) {
   global.HW_I2C2.start(&global.i2c2_config);
 
   global.memory.init();
+  global.memory.start(NORMALPRIO);
 
   uint8_t i = 0;
   if (global.memory.getBoardId(&i) == fileSystemIo::FileSystemIoBase::OK) {
@@ -547,13 +652,18 @@ int main(void) {
 
   global.tlc5947.start(NORMALPRIO + 5);
   global.tlc5947.enable();
+  global.lightAnimator.start(NORMALPRIO + 4);
 
   global.robot.start(HIGHPRIO - 1);
 
+  global.sercanmux1.start(NORMALPRIO + 1);
+
 //   lidar.start(NORMALPRIO + 15); UNCOMMENT TO START LIDAR
 
   global.lidar.start(NORMALPRIO);
 
+  global.wallExtractor.start(NORMALPRIO - 1);
+
   global.userThread.start(NORMALPRIO);
 
   /* let the SYS_SYNC_N pin go, to signal that the initialization of the module is done */
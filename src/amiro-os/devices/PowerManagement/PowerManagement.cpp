@@ -109,15 +109,24 @@ msg_t PowerManagement::updateSensorVal() {
 
   // update infrared sensor value
   // Note: The CANRx Value will never be updated in this thread
-  for (int idx = 0; idx < 8; idx++)
+  const uint32_t timestamp = SystemTime::getTime();
+  for (int idx = 0; idx < 8; idx++) {
     this->proximityRingValue[idx] = global.vcnl4020[idx].getProximityScaledWoOffset();
+    this->proximityRingTimestamp[idx] = timestamp;
+  }
 
   return 0;
 }
 
 void PowerManagement::periodicBroadcast() {
   CANTxFrame frame;
-  if (this->bc_counter % 10 == 0) {
+  // A full battery ends the parked state
+  if (PowerState::isParked() && this->powerStatus.state_of_charge >= 100) {
+    this->broadcastPowerState(PowerState::ACTIVE);
+  }
+  // While parked, each broadcast is a heartbeat that carries the status and the time
+  const bool heartbeat = PowerState::isParked();
+  if (heartbeat || this->bc_counter % 10 == 0) {
     frame.SID = 0;
     this->encodeDeviceId(&frame, CAN::POWER_STATUS_ID);
     frame.data8[0] = this->powerStatus.charging_flags.value;
@@ -127,6 +136,16 @@ void PowerManagement::periodicBroadcast() {
     frame.DLC = 6;
     this->transmitMessage(&frame);
   }
+  if (heartbeat || this->bc_counter % CAN::SYSTEM_TIME_PERIOD == 0) {
+    // The PowerManagement is the time master of the robot
+    this->broadcastSystemTime();
+  }
+  // The proximity values of the ring were all taken at the same time
+  frame.SID = 0;
+  this->encodeDeviceId(&frame, CAN::SENSOR_TIMESTAMP_ID);
+  frame.data32[0] = this->proximityRingTimestamp[0];
+  frame.DLC = 4;
+  this->transmitMessage(&frame);
   for (int i = 0; i < 8; i++) {
     frame.SID = 0;
     this->encodeDeviceId(&frame, CAN::PROXIMITY_RING_ID(i));
@@ -37,6 +37,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <amiro/util/util.h>
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+#include <amiro/TopologyBenchmark.h>
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+#include <amiro/ThreadProfiler.h>
+#endif
 #include <global.hpp>
 #include <exti.hpp>
 
@@ -176,6 +182,9 @@ void systemShutdown() {
     global.ina219[i].wait();
   }
 
+  // write back pending modifications of the memory
+  global.memory.sync();
+
   // 60 sec timeout
   chVTSet(&shutdownTimeout, MS2ST(60000), shutdownTimeoutISR, NULL);
 
@@ -601,8 +610,14 @@ void shellRequestGetMemoryData(BaseSequentialStream *chp, int argc, char *argv[]
     chprintf(chp, "Warning: request exceeds eeprom size -> limiting to %u values.\n", num_elements);
   }
 
+  // write back pending modifications of the memory layout first
+  global.memory.sync();
+
+  // the stream position and the bus are shared with the write-behind flush
+  global.at24c01.acquire();
   chFileStreamSeek((BaseFileStream*)&global.at24c01, start_byte);
   uint32_t bytes_read = chSequentialStreamRead((BaseFileStream*)&global.at24c01, buffer, type_size*num_elements);
+  global.at24c01.release();
 
   if (bytes_read != type_size*num_elements) {
     chprintf(chp, "Warning: %u of %u requested bytes were read.\n", bytes_read, type_size*num_elements);
@@ -736,6 +751,24 @@ void shellRequestCalib(BaseSequentialStream *chp, int __unused argc, char __unus
 
 }
 
+void shellRequestGetMemoryStats(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestGetMemoryStats\n");
+
+  if (argc >= 1 && !strcmp(argv[0], "sync")) {
+    if (global.memory.sync() != global.memory.OK)
+      chprintf(chp, "Sync: FAIL\n");
+    else
+      chprintf(chp, "Sync: OK\n");
+  }
+
+  chprintf(chp, "dirty pages:  %u\n", global.memory.getDirtyPages());
+  chprintf(chp, "write errors: %u\n", global.memory.getWriteErrors());
+  chprintf(chp, "page writes since startup:\n");
+  for (uint8_t page = 0; page < global.memory.getNumPages(); ++page) {
+    chprintf(chp, "  page %2u: %u\n", page, global.memory.getPageWrites(page));
+  }
+}
+
 void shellRequestGetRobotId(BaseSequentialStream *chp, int __unused argc, char __unused *argv[]) {
   chprintf(chp, "shellRequestGetRobotId\n");
   chprintf(chp, "Robot ID: %u\n", global.robot.getRobotID());
@@ -888,6 +921,37 @@ void shellRequestWiiSteering(BaseSequentialStream* chp, int argc, char *argv[])
   return;
 }
 
+void shellRequestWiiLatency(BaseSequentialStream* chp, int argc, char *argv[]) {
+  const bool reset = (argc == 1 && strcmp(argv[0], "reset") == 0);
+
+  if (argc > 1 || (argc == 1 && !reset)) {
+    chprintf(chp, "Usage: %s\n", "wii_latency [reset]");
+    return;
+  }
+
+  const UserThread::WiiLatency latency = global.userThread.getWiiLatency(reset);
+  chprintf(chp, "reports: %u\n", latency.reports);
+  chprintf(chp, "latency [us]: last %u, max %u, avg %u\n", latency.last_us, latency.max_us, latency.avg_us);
+  if (reset) {
+    chprintf(chp, "statistics reset\n");
+  }
+  return;
+}
+
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+void shellRequestTopologyBenchmark(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestTopologyBenchmark\n");
+  tbmkShell(chp, argc, argv, &tbmkPowerManagement);
+}
+#endif
+
+#ifdef AMIRO_THREAD_PROFILER
+void shellRequestProfile(BaseSequentialStream *chp, int argc, char *argv[]) {
+  chprintf(chp, "shellRequestProfile\n");
+  tprofShell(chp, argc, argv);
+}
+#endif
+
 static const ShellCommand commands[] = {
   {"shutdown", shellRequestShutdown},
   {"check", shellRequestCheck},
@@ -895,6 +959,7 @@ static const ShellCommand commands[] = {
   {"get_board_id", shellRequestGetBoardId},
   {"set_board_id", shellRequestSetBoardId},
   {"get_memory_data", shellRequestGetMemoryData},
+  {"memory_stats", shellRequestGetMemoryStats},
   {"get_vcnl", shellRequestGetVcnl},
   {"calib_vcnl_offset", shellRequestCalib},
   {"set_vcnl_offset", shellRequestSetVcnlOffset},
@@ -907,6 +972,13 @@ static const ShellCommand commands[] = {
   {"shell_board", shellSwitchBoardCmd},
   {"get_bootloader_info", shellRequestGetBootloaderInfo},
   {"wii_steering", shellRequestWiiSteering},
+  {"wii_latency", shellRequestWiiLatency},
+#ifdef AMIRO_TOPOLOGY_BENCHMARK
+  {"bmk_topology", shellRequestTopologyBenchmark},
+#endif
+#ifdef AMIRO_THREAD_PROFILER
+  {"profile", shellRequestProfile},
+#endif
   {NULL, NULL}
 };
 
@@ -1016,6 +1088,8 @@ int main(void) {
 
   global.robot.start(HIGHPRIO - 1);
 
+  global.sercanmux1.start(NORMALPRIO + 1);
+
   pwmStart(&PWMD3, &global.pwm3_config);
   pwmDisableChannel(&PWMD3, 1);
 
@@ -1044,6 +1118,7 @@ int main(void) {
   }
 
   global.memory.init();
+  global.memory.start(NORMALPRIO);
   uint8_t i = 0;
   if (global.memory.getBoardId(&i) == fileSystemIo::FileSystemIoBase::OK) {
     chprintf((BaseSequentialStream*) &SD1, "Board ID: %u\n", i);
@@ -1,6 +1,7 @@
 #include "userthread.h"
 
 #include "global.hpp"
+#include <amiro/ReactiveController.h>
 #include <array>
 #include <chprintf.h>
 #include <cmath>
@@ -17,45 +18,38 @@ namespace obstacle_avoidance {
 
 uint16_t constexpr proxThresholdLow = 0x0000;
 uint16_t constexpr proxThresholdHigh = 0x1000;
-uint16_t constexpr proxRange = proxThresholdHigh - proxThresholdLow;
-
-std::array< std::array<float, 2>, 8> constexpr namMatrix = {
-    /*                              x     w_z */
-    std::array<float, 2>/* SSW */{ 0.00f,  0.00f},
-    std::array<float, 2>/* WSW */{ 0.25f, -0.25f},
-    std::array<float, 2>/* WNW */{-0.75f, -0.50f},
-    std::array<float, 2>/* NNW */{-0.75f, -1.00f},
-    std::array<float, 2>/* NNE */{-0.75f,  1.00f},
-    std::array<float, 2>/* ENE */{-0.75f,  0.50f},
-    std::array<float, 2>/* ESE */{ 0.25f,  0.25f},
-    std::array<float, 2>/* SSE */{ 0.00f,  0.00f}
-};
-uint32_t constexpr baseTranslation = 100e3; // 2cm/s
-uint32_t constexpr baseRotation = 1e6; // 1rad/s
-types::kinematic constexpr defaultKinematic = {
-    /*  x  [µm/s]   */ baseTranslation,
-    /*  y  [µm/s]   */ 0,
-    /*  z  [µm/s]   */ 0,
-    /* w_x [µrad/s] */ 0,
-    /* w_y [µrad/s] */ 0,
-    /* w_z [µrad/s] */ 0
+
+/*
+ * NAM of the ring sensors scaled by the base translation (100 mm/s) and
+ * rotation (1 rad/s)
+ */
+ReactiveController::Input constexpr namMatrix[] = {
+    /*        sensor  low               high          x [mm/s] w_z [mrad/s] */
+    /* WSW */ {1, proxThresholdLow, proxThresholdHigh,   25,  -250},
+    /* WNW */ {2, proxThresholdLow, proxThresholdHigh,  -75,  -500},
+    /* NNW */ {3, proxThresholdLow, proxThresholdHigh,  -75, -1000},
+    /* NNE */ {4, proxThresholdLow, proxThresholdHigh,  -75,  1000},
+    /* ENE */ {5, proxThresholdLow, proxThresholdHigh,  -75,   500},
+    /* ESE */ {6, proxThresholdLow, proxThresholdHigh,   25,   250}
 };
+ReactiveController::Behaviour constexpr avoid = {"avoid", namMatrix, sizeof(namMatrix) / sizeof(namMatrix[0]), 0, 0};
+ReactiveController::Behaviour constexpr cruise = {"cruise", NULL, 0, 100, 0};
 
-inline uint8_t ProxId2LedId(const uint8_t proxId) {
-    return (proxId < 4) ? proxId+4 : proxId-4;
-}
+ReactiveController controller(200e3, 3.1415927f * 1000000.0f);
 
-Color Prox2Color(const float prox) {
-  float p = 0.0f;
-  if (prox < 0.5f) {
-    p = 2.0f * prox;
-    return Color(0x00, p*0xFF, (1.0f-p)*0xFF);
-  } else {
-    p = 2.0f * (prox - 0.5f);
-    return Color(p*0xFF, (1.0f-p)*0xFF, 0x00);
+void setup() {
+  if (controller.getBehaviourCount() == 0) {
+    controller.addBehaviour(&cruise, ReactiveController::WEIGHT_ONE);
+    controller.addBehaviour(&avoid, ReactiveController::WEIGHT_ONE);
   }
 }
 
+/*
+ * Heat map of the ring sensors, runs on the LightRing
+ */
+LightAnimation constexpr heatMap = {LightAnimation::PROXIMITY, LightAnimation::ALL_LEDS, 0, 0, 0, 0, 0, proxThresholdHigh >> 8};
+LightAnimation constexpr stop = {LightAnimation::STOP, 0, 0, 0, 0, 0, 0, 0};
+
 } /* namespace obstacle_avoidance */
 
 namespace wii_steering {
@@ -63,15 +57,70 @@ namespace wii_steering {
 BluetoothWiimote wiimote(&global.wt12, RX_TX);
 BluetoothSerial btserial(&global.wt12, RX_TX);
 
-float deadzone;
 char bt_address[18] = {'\0'};
-float wiimoteCalib[3] = {0.0f};
 uint8_t principal_axis = 1;
 int8_t axis_direction = -1;
 
 uint32_t constexpr maxTranslation = 500e3;
 uint32_t constexpr maxRotation = 3.1415927f * 1000000.0f * 2.0f;
 
+/*
+ * The accelerometer reports 100 counts per G. The calibration offsets, the
+ * deadzone and the gains are precomputed in counts, so a report is mapped to
+ * a kinematic with a few integer operations.
+ */
+int32_t constexpr countsPerG = 100;
+chibios_rt::EvtListener reportListener;
+int16_t wiimoteCalib[3] = {0, 0, 0};     // offset in counts
+int16_t deadzone = 10;                   // in counts
+int32_t translationGain = maxTranslation / (countsPerG - 10);  // µm/s per count
+int32_t rotationGain = maxRotation / (countsPerG - 10);        // µrad/s per count
+
+/*
+ * Latency from the reception of a report until the CAN frame is queued
+ */
+uint32_t reports = 0;
+uint32_t lastReportCount = 0;
+halrtcnt_t latencyLast = 0;
+halrtcnt_t latencyMax = 0;
+uint64_t latencySum = 0;
+
+void updateGains() {
+  translationGain = maxTranslation / (countsPerG - deadzone);
+  rotationGain = maxRotation / (countsPerG - deadzone);
+}
+
+/*
+ * Applies calibration, limit to 1G and deadzone.
+ * Returns counts beyond the deadzone in (-(100 - deadzone), 100 - deadzone).
+ */
+inline int32_t normalize(const int16_t raw, const uint8_t axis) {
+  int32_t value = raw - wiimoteCalib[axis];
+
+  if (value > countsPerG) {
+    value = countsPerG;
+  } else if (value < -countsPerG) {
+    value = -countsPerG;
+  }
+
+  if (value >= deadzone) {
+    return value - deadzone;
+  } else if (value <= -deadzone) {
+    return value + deadzone;
+  } else {
+    return 0;
+  }
+}
+
+void resetLatency() {
+  chSysLock();
+  reports = 0;
+  latencyLast = 0;
+  latencyMax = 0;
+  latencySum = 0;
+  chSysUnlock();
+}
+
 }
 
 UserThread::UserThread() :
@@ -110,6 +159,8 @@ UserThread::main()
         case IDLE:
         {
           if (next_state == OBSTACLE_AVOIDANCE) {
+            obstacle_avoidance::setup();
+
             // set all LEDs to white for one second
             for (uint8_t led = 0; led < 8; ++led) {
               global.robot.setLightColor(led, Color(Color::WHITE));
@@ -118,8 +169,15 @@ UserThread::main()
             for (uint8_t led = 0; led < 8; ++led) {
               global.robot.setLightColor(led, Color(Color::BLACK));
             }
+
+            // map the sensor values to the top LEDs
+            global.robot.setLightAnimation(obstacle_avoidance::heatMap);
           }
           /* if (this->next_state == WII_STEERING) */ else {
+            // wake up on every report of the Wiimote controller
+            wii_steering::wiimote.getEventSource()->registerOne(&wii_steering::reportListener, REPORT_EVENT);
+            this->getAndClearEvents(EVENT_MASK(REPORT_EVENT));
+
             // setup bluetooth
             wii_steering::wiimote.bluetoothWiimoteListen(wii_steering::bt_address);
             wii_steering::btserial.bluetoothSerialListen("ALL");
@@ -144,6 +202,7 @@ UserThread::main()
             // stop the robot
             kinematic = {0, 0, 0, 0, 0, 0};
             global.robot.setTargetSpeed(kinematic);
+            global.robot.setLightAnimation(obstacle_avoidance::stop);
 
             // set all LEDs to white for one second
             for (uint8_t led = 0; led < 8; ++led) {
@@ -171,6 +230,7 @@ UserThread::main()
             wii_steering::wiimote.bluetoothWiimoteDisconnect(wii_steering::bt_address);
             wii_steering::btserial.bluetoothSerialStop();
             wii_steering::wiimote.bluetoothWiimoteStop();
+            wii_steering::wiimote.getEventSource()->unregister(&wii_steering::reportListener);
 
             // set all LEDs to black
             for (uint8_t led = 0; led < 8; ++led) {
@@ -189,7 +249,12 @@ UserThread::main()
     }
 
     // sleep here so the loop is executed as quickly as possible
-    this->sleep(CAN::UPDATE_PERIOD);
+    if (current_state == WII_STEERING && wii_steering::wiimote.bluetoothWiimoteIsConnected()) {
+      // apply each report as soon as it arrives, but keep the robot updated if reports are missing
+      this->waitOneEventTimeout(EVENT_MASK(REPORT_EVENT), CAN::UPDATE_PERIOD);
+    } else {
+      this->sleep(CAN::UPDATE_PERIOD);
+    }
 
     /*
      * exeute behaviour depending on the current state
@@ -214,45 +279,14 @@ UserThread::main()
         // initialize some variables
         uint8_t sensor = 0;
         std::array<uint16_t, 8> proximity;
-        std::array<float, 8> proxNormalized;
-        float factor_x = 0.0f;
-        float factor_wz = 0.0f;
 
         // read proximity values
         for (sensor = 0; sensor < 8; ++sensor) {
           proximity[sensor] = global.vcnl4020[sensor].getProximityScaledWoOffset();
         }
 
-        // normalize proximity values
-        for (sensor = 0; sensor < 8; ++sensor) {
-          register uint16_t prox = proximity[sensor];
-          // limit to high treshold
-          if (prox > obstacle_avoidance::proxThresholdHigh)
-              prox = obstacle_avoidance::proxThresholdHigh;
-          // limit to low threshold
-          else if (prox < obstacle_avoidance::proxThresholdLow)
-              prox = obstacle_avoidance::proxThresholdLow;
-          // apply low threshold
-          prox -= obstacle_avoidance::proxThresholdLow;
-          // normalize to [0, 1]
-          proxNormalized[sensor] = float(prox) / float(obstacle_avoidance::proxRange);
-        }
-
-        // map the sensor values to the top LEDs
-        for (sensor = 0; sensor < 8; ++sensor) {
-          global.robot.setLightColor(obstacle_avoidance::ProxId2LedId(sensor), obstacle_avoidance::Prox2Color(proxNormalized[sensor]));
-        }
-
-        // evaluate NAM
-        for (sensor = 0; sensor < 8; ++sensor) {
-          factor_x += proxNormalized[sensor] * obstacle_avoidance::namMatrix[sensor][0];
-          factor_wz += proxNormalized[sensor] * obstacle_avoidance::namMatrix[sensor][1];
-        }
-
         // set motor commands
-        kinematic = obstacle_avoidance::defaultKinematic;
-        kinematic.x += (factor_x * obstacle_avoidance::baseTranslation) + 0.5f;
-        kinematic.w_z += (factor_wz * obstacle_avoidance::baseRotation) + 0.5f;
+        obstacle_avoidance::controller.update(proximity.data(), kinematic);
         global.robot.setTargetSpeed(kinematic);
 
         break;
@@ -275,24 +309,21 @@ UserThread::main()
         }
         // steer AMiRo using the Wiimote controller like a joystick
         else {
-          // initialize some variables
-          float wiimoteAcc[3] = {0.0f, 0.0f, 0.0f};
-
-          // get Wiimote accelerometer data
-          wiimoteAcc[0] = wii_steering::wiimote.getAccelerometer()->x_axis;
-          wiimoteAcc[1] = wii_steering::wiimote.getAccelerometer()->y_axis;
-          wiimoteAcc[2] = wii_steering::wiimote.getAccelerometer()->z_axis;
+          BluetoothWiimote::Accelerometer *accelerometer = wii_steering::wiimote.getAccelerometer();
+          const int16_t wiimoteAcc[3] = {accelerometer->x_axis, accelerometer->y_axis, accelerometer->z_axis};
+          const uint32_t reportCount = wii_steering::wiimote.getReportCount();
+          const halrtcnt_t reportTime = wii_steering::wiimote.getReportTime();
 
           // calibrate accelerometer offset
           if (wii_steering::wiimote.getButtons()->home) {
-            chprintf((BaseSequentialStream*)&global.sercanmux1, "%f | %f | %f\n", wiimoteAcc[0], wiimoteAcc[1], wiimoteAcc[2]);
+            chprintf((BaseSequentialStream*)&global.sercanmux1, "%d | %d | %d\n", wiimoteAcc[0], wiimoteAcc[1], wiimoteAcc[2]);
 
             // detect principal axis
-            if (std::fabs(wiimoteAcc[0]) > std::fabs(wiimoteAcc[1]) && std::fabs(wiimoteAcc[0]) > std::fabs(wiimoteAcc[2])) {
+            if (std::abs(wiimoteAcc[0]) > std::abs(wiimoteAcc[1]) && std::abs(wiimoteAcc[0]) > std::abs(wiimoteAcc[2])) {
               wii_steering::principal_axis = 0;
-            } else if (std::fabs(wiimoteAcc[1]) > std::fabs(wiimoteAcc[0]) && std::fabs(wiimoteAcc[1]) > std::fabs(wiimoteAcc[2])) {
+            } else if (std::abs(wiimoteAcc[1]) > std::abs(wiimoteAcc[0]) && std::abs(wiimoteAcc[1]) > std::abs(wiimoteAcc[2])) {
               wii_steering::principal_axis = 1;
-            } else if (std::fabs(wiimoteAcc[2]) > std::fabs(wiimoteAcc[0]) && std::fabs(wiimoteAcc[2]) > std::fabs(wiimoteAcc[1])) {
+            } else if (std::abs(wiimoteAcc[2]) > std::abs(wiimoteAcc[0]) && std::abs(wiimoteAcc[2]) > std::abs(wiimoteAcc[1])) {
               wii_steering::principal_axis = 2;
             }
             wii_steering::axis_direction = (wiimoteAcc[wii_steering::principal_axis] >= 0) ? 1 : -1;
@@ -301,63 +332,33 @@ UserThread::main()
             wii_steering::wiimoteCalib[0] = wiimoteAcc[0];
             wii_steering::wiimoteCalib[1] = wiimoteAcc[1];
             wii_steering::wiimoteCalib[2] = wiimoteAcc[2];
-            wii_steering::wiimoteCalib[wii_steering::principal_axis] += -100.0f * wii_steering::axis_direction;
+            wii_steering::wiimoteCalib[wii_steering::principal_axis] -= wii_steering::countsPerG * wii_steering::axis_direction;
 
             // print information
             chprintf((BaseSequentialStream*)&global.sercanmux1, "accelerometer calibrated:\n");
             chprintf((BaseSequentialStream*)&global.sercanmux1, "\tprincipal axis: %c\n", (wii_steering::principal_axis == 0) ? 'X' : (wii_steering::principal_axis == 1) ? 'Y' : 'Z');
-            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tX = %d\n", (int32_t)wii_steering::wiimoteCalib[0]);
-            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tY = %d\n", (int32_t)wii_steering::wiimoteCalib[1]);
-            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tZ = %d\n", (int32_t)wii_steering::wiimoteCalib[2]);
-          }
-
-          for (uint8_t axis = 0; axis < 3; ++axis) {
-            // apply calibration values
-            wiimoteAcc[axis] -= wii_steering::wiimoteCalib[axis];
-
-            // normalize to (-1, 1)
-            wiimoteAcc[axis] /= 100.0f;
-
-            // limit to 1G
-            if (wiimoteAcc[axis] > 1.0f) {
-              wiimoteAcc[axis] = 1.0f;
-            } else if (wiimoteAcc[axis] < -1.0f) {
-              wiimoteAcc[axis] = -1.0f;
-            }
-
-            // apply deadzone
-            if (std::fabs(wiimoteAcc[axis]) < wii_steering::deadzone) {
-              wiimoteAcc[axis] = 0.0f;
-            }
-
-            /*
-             * the value is now in (-1 .. -deazone, 0, deadzone .. 1)
-             * note the gaps [-deadzone .. 0] and [0 .. deadzone]
-             */
-
-            // normalize (deadzone, 1) to (0, 1) and (-1, -deadzone) tpo (-1, 0)
-            if (wiimoteAcc[axis] > 0) {
-              wiimoteAcc[axis] -= wii_steering::deadzone;
-            } else if (wiimoteAcc[axis] < 0){
-              wiimoteAcc[axis] += wii_steering::deadzone;
-            }
-            wiimoteAcc[axis] *= (1.0f / (1.0f - wii_steering::deadzone));
+            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tX = %d\n", wii_steering::wiimoteCalib[0]);
+            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tY = %d\n", wii_steering::wiimoteCalib[1]);
+            chprintf((BaseSequentialStream*)&global.sercanmux1, "\tZ = %d\n", wii_steering::wiimoteCalib[2]);
           }
 
           // only move when A is pressed
           if (wii_steering::wiimote.getButtons()->A || wii_steering::wiimote.getButtons()->B) {
+            const int32_t acc_x = wii_steering::normalize(wiimoteAcc[0], 0);
             // set kinematic relaive to maximum speeds
             switch (wii_steering::principal_axis) {
               case 1:
                 if (wii_steering::axis_direction == -1) {
-                  kinematic.x = wii_steering::maxTranslation * wiimoteAcc[2];
-                  kinematic.w_z = wii_steering::maxRotation * wiimoteAcc[0] * ((wiimoteAcc[2] < 0.0f) ? 1.0f : -1.0f);
+                  const int32_t acc_z = wii_steering::normalize(wiimoteAcc[2], 2);
+                  kinematic.x = wii_steering::translationGain * acc_z;
+                  kinematic.w_z = wii_steering::rotationGain * acc_x * ((acc_z < 0) ? 1 : -1);
                   break;
                 }
               case 2:
                 if (wii_steering::axis_direction == 1) {
-                  kinematic.x = wii_steering::maxTranslation * wiimoteAcc[1];
-                  kinematic.w_z = wii_steering::maxRotation * wiimoteAcc[0] * ((wiimoteAcc[1] < 0.0f) ? 1.0f : -1.0f);
+                  const int32_t acc_y = wii_steering::normalize(wiimoteAcc[1], 1);
+                  kinematic.x = wii_steering::translationGain * acc_y;
+                  kinematic.w_z = wii_steering::rotationGain * acc_x * ((acc_y < 0) ? 1 : -1);
                   break;
                 }
               default:
@@ -370,6 +371,20 @@ UserThread::main()
 
           // set speed
           global.robot.setTargetSpeed(kinematic);
+
+          // measure the latency of new reports
+          if (reportCount != wii_steering::lastReportCount) {
+            const halrtcnt_t latency = halGetCounterValue() - reportTime;
+            chSysLock();
+            ++wii_steering::reports;
+            wii_steering::latencyLast = latency;
+            if (latency > wii_steering::latencyMax) {
+              wii_steering::latencyMax = latency;
+            }
+            wii_steering::latencySum += latency;
+            chSysUnlock();
+            wii_steering::lastReportCount = reportCount;
+          }
         }
 
         break;
@@ -424,8 +439,31 @@ UserThread::setWiiDeadzone(const float deadzone)
     dz /= 100.0f;
   }
 
-  // set value and return it
-  wii_steering::deadzone = dz;
+  // set value in counts (less than 1G) and return it
+  int16_t counts = dz * wii_steering::countsPerG + 0.5f;
+  if (counts >= wii_steering::countsPerG) {
+    counts = wii_steering::countsPerG - 1;
+  }
+  chSysLock();
+  wii_steering::deadzone = counts;
+  wii_steering::updateGains();
+  chSysUnlock();
   return dz;
 }
 
+UserThread::WiiLatency
+UserThread::getWiiLatency(const bool reset)
+{
+  WiiLatency latency;
+  chSysLock();
+  latency.reports = wii_steering::reports;
+  latency.last_us = RTT2US(wii_steering::latencyLast);
+  latency.max_us = RTT2US(wii_steering::latencyMax);
+  latency.avg_us = (wii_steering::reports > 0) ? RTT2US(wii_steering::latencySum / wii_steering::reports) : 0;
+  chSysUnlock();
+  if (reset) {
+    wii_steering::resetLatency();
+  }
+  return latency;
+}
+
@@ -10,6 +10,21 @@ class UserThread : public chibios_rt::BaseStaticThread<USER_THREAD_STACK_SIZE>
 {
 public:
 
+  enum {
+    REPORT_EVENT = 0,
+  };
+
+  /**
+   * \brief Latency from the reception of a Wiimote report until the resulting
+   *        motion command is queued for the CAN bus
+   */
+  struct WiiLatency {
+    uint32_t reports;
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t avg_us;
+  };
+
   enum State {
     IDLE,
     OBSTACLE_AVOIDANCE,
@@ -30,6 +45,8 @@ public:
   msg_t setWiiAddress(const char* address);
 
   float setWiiDeadzone(const float deadzone);
+
+  WiiLatency getWiiLatency(const bool reset = false);
 };
 
 } // end of namespace amiro
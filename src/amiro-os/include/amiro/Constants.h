@@ -38,6 +38,15 @@ namespace amiro {
 namespace CAN {
 
   const uint32_t UPDATE_PERIOD        = US2ST(62500);  // 16 Hz
+  // Heartbeat of all modules while the robot is parked (see PowerState)
+  const uint32_t PARKED_UPDATE_PERIOD = US2ST(1000000);  // 1 Hz
+
+  // The time master sends its time every 16th update, i.e. once per second
+  const uint32_t SYSTEM_TIME_PERIOD        = 16;
+  // Transmission time of a time frame (4 data bytes @1Mbit) plus the latency from the
+  // reception interrupt to the Rx thread in µs. Time frames that waited in the FIFO behind
+  // other frames are dropped (see ControllerAreaNetworkRx::main()).
+  const uint32_t SYSTEM_TIME_LATENCY       = 100;
 
   const uint32_t PERIODIC_TIMER_ID         = 1;
   const uint32_t RECEIVED_ID               = 2;
@@ -58,9 +67,12 @@ namespace CAN {
   const uint32_t MAGNETOMETER_Y_ID         = 0x55;
   const uint32_t MAGNETOMETER_Z_ID         = 0x56;
   const uint32_t GYROSCOPE_ID              = 0x58;
+  const uint32_t SENSOR_TIMESTAMP_ID       = 0x52;
   const uint32_t PROXIMITY_FLOOR_ID        = 0x51;
   const uint32_t ODOMETRY_ID               = 0x50;
   const uint32_t BRIGHTNESS_ID             = 0x40;
+  // Animation of the LightRing in a single frame (see LightAnimation)
+  const uint32_t LIGHT_ANIMATION_ID        = 0x41;
   inline constexpr uint32_t COLOR_ID(uint32_t index)             {return 0x38 | ((index) & 0x7);}
   inline constexpr uint32_t PROXIMITY_RING_ID(uint32_t index)    {return 0x30 | ((index) & 0x7);}
   const uint32_t SET_KINEMATIC_CONST_ID    = 0x22;
@@ -69,6 +81,11 @@ namespace CAN {
   const uint32_t SET_ODOMETRY_ID           = 0x12;
   const uint32_t TARGET_RPM_ID             = 0x11;
   const uint32_t TARGET_SPEED_ID           = 0x10;
+  // Multi-frame stream of compact scans (see LidarScan), below the sensor values in priority
+  const uint32_t LIDAR_SCAN_ID             = 0x68;
+  const uint32_t LIDAR_WALL_ID             = 0x69;
+  const uint32_t POWER_STATE_ID            = 0x62;
+  const uint32_t SYSTEM_TIME_ID            = 0x61;
   const uint32_t POWER_STATUS_ID           = 0x60;
   const uint32_t ROBOT_ID                  = 0x48;
   inline constexpr uint32_t SHELL_QUERY_ID(uint8_t index)        {return 0x70 | ((index) & 0x7);}
@@ -6,10 +6,13 @@
 #include <Types.h>  // ::kinematic
 
 #include <amiro/Constants.h>  // CAN::* macros
+#include <amiro/SystemTime.h>
+#include <amiro/PowerState.h>
+#include <amiro/LidarScan.h>
 
 namespace amiro {
 
-  class ControllerAreaNetworkRx : public chibios_rt::BaseStaticThread<128> {
+  class ControllerAreaNetworkRx : public chibios_rt::BaseStaticThread<512> {
   public:
     ControllerAreaNetworkRx(CANDriver *can, const uint8_t boardId);
     virtual ~ControllerAreaNetworkRx() = 0;
@@ -23,6 +26,36 @@ namespace amiro {
     int32_t getMagnetometerValue(int axis);
     int16_t getGyroscopeValue(int axis);
 
+    /**
+     * \brief Times at which the values were taken by the sending module
+     *
+     * The timestamps are synchronised across all modules (see SystemTime). They are 0
+     * if the sending module does not provide them.
+     *
+     * @return Synchronised time in microseconds
+     */
+    uint32_t getProximityRingTimestamp(int index);
+    uint32_t getProximityFloorTimestamp();
+    uint32_t getOdometryTimestamp();
+
+    /**
+     * \brief Copies the last complete LIDAR scan received from the LightRing
+     *
+     * @param ranges Quantised ranges, see LidarScan
+     * @param scanCount Number of the last scan of the caller, updated if a newer scan was copied
+     * @return True if a newer scan was copied
+     */
+    bool getLidarScan(uint8_t (&ranges)[LidarScan::POINTS], uint32_t &scanCount);
+    LidarScan::Receiver& getLidarScanReceiver();
+
+    /**
+     * \brief Last wall received from the LightRing
+     *
+     * @param wall Wall relative to the robot, see LidarScan::Wall
+     * @return Age of the wall in system ticks, TIME_INFINITE if none was received
+     */
+    systime_t getLidarWall(LidarScan::Wall &wall);
+
     void calibrateProximityRingValues();
     void calibrateProximityFloorValues();
 
@@ -42,14 +75,28 @@ namespace amiro {
     uint16_t proximityFloorValue[4];
     int32_t magnetometerValue[3];
     int16_t gyroscopeValue[3];
+    uint32_t proximityRingTimestamp[8];
+    uint32_t proximityFloorTimestamp;
+    uint32_t odometryTimestamp;
     types::position robotPosition;
     types::power_status powerStatus;
     uint8_t robotId;
+    LidarScan::Receiver lidarScan;
+    LidarScan::Wall lidarWall;
+    systime_t lidarWallTime;
+    bool lidarWallValid;
     chibios_rt::EvtListener rxFullCanEvtListener;
     chibios_rt::EvtSource *rxFullCanEvtSource;
 
   private:
     msg_t receiveSensorVal(CANRxFrame *frame);
+    msg_t receiveSystemTime(CANRxFrame *frame, uint64_t uptime);
+    msg_t receivePowerState(CANRxFrame *frame);
+
+    // Timestamps of the SENSOR_TIMESTAMP_ID frames, which precede the values
+    uint32_t nextProximityRingTimestamp;
+    uint32_t nextProximityFloorTimestamp;
+    uint32_t nextOdometryTimestamp;
 
     CANDriver *canDriver;
     CANConfig canConfig;
@@ -6,6 +6,10 @@
 #include <Types.h>  // ::kinematic
 
 #include <amiro/Constants.h>  // CAN::* macros
+#include <amiro/SystemTime.h>
+#include <amiro/PowerState.h>
+#include <amiro/LidarScan.h>
+#include <amiro/LightAnimation.h>
 
 namespace amiro {
 
@@ -29,6 +33,13 @@ namespace amiro {
      */
     void setLightColor(int index, Color color);
 
+    /**
+     * \brief Starting an animation of the light ring
+     *
+     * @param animation Effect and parameters, runs on the light ring until it ends or is stopped
+     */
+    void setLightAnimation(const LightAnimation &animation);
+
     /**
      * \brief Setting the desired speed in as kinematic struct
      *
@@ -80,6 +91,38 @@ namespace amiro {
 
     void broadcastShutdown();
 
+    /**
+     * \brief Sending the time of this module, which all other modules adopt
+     *
+     * \notice Only the time master (PowerManagement) may call this function.
+     */
+    void broadcastSystemTime();
+
+    /**
+     * \brief Adopting the given power state and sending it to all other modules
+     *
+     * @param state New power state of the robot
+     */
+    void broadcastPowerState(PowerState::State state);
+
+    /**
+     * \brief Sending a compact LIDAR scan (CAN::LIDAR_SCAN_ID)
+     *
+     * \notice All LidarScan::FRAGMENTS frames are sent back to back after a single
+     * delay of transmitMessage(), so a scan occupies the bus for about 1.5 ms.
+     *
+     * @param ranges Quantised ranges, see LidarScan::compact()
+     * @param sequence Sequence number of the scan (only the lower 4 bit are sent)
+     */
+    void broadcastLidarScan(const uint8_t (&ranges)[LidarScan::POINTS], uint8_t sequence);
+
+    /**
+     * \brief Sending the wall extracted from the last LIDAR scan (CAN::LIDAR_WALL_ID)
+     *
+     * @param wall Wall relative to the robot, see WallExtractor
+     */
+    void broadcastLidarWall(const LidarScan::Wall &wall);
+
   protected:
     virtual msg_t main();
     virtual msg_t updateSensorVal();
@@ -95,6 +138,8 @@ namespace amiro {
     chibios_rt::EvtSource *eventTimerEvtSource;
 
   private:
+    void sendMessage(CANTxFrame *frame);
+
     EvTimer evtimer;
     CANDriver *canDriver;
     CANConfig canConfig;
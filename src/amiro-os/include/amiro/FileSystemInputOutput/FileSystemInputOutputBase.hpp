@@ -17,14 +17,47 @@
  * new elements emerge.
  */
 
+#include <ch.hpp>
 #include <amiro/eeprom/at24.hpp>
 
 namespace amiro {
 namespace fileSystemIo {
 
-class FileSystemIoBase {
+/**
+ * \brief Base class of the memory layouts
+ *
+ * All accesses go to a RAM image of the EEPROM (write-behind cache), so
+ * setters return immediately and never wait for the EEPROM. Modified pages
+ * are marked dirty and written back by the thread of this class (see start())
+ * after FLUSH_DELAY, so consecutive updates (e.g. all gains of a calibration)
+ * are coalesced into single page writes. Use sync() to write back all pending
+ * changes explicitly, e.g. before a shutdown.
+ *
+ * \note The image is read from the EEPROM on the first access. As long as this
+ *       fails, all accesses fail with IO_ERROR.
+ */
+class FileSystemIoBase : public chibios_rt::BaseStaticThread<256> {
 
   public:
+    /**
+     * \brief Stream interface of the cache
+     * Provides the BaseFileStream interface of the AT24 on the RAM image.
+     */
+    struct Cache {
+      BaseFileStream bfs;
+      FileSystemIoBase *fsio;
+      fileoffset_t position;
+    };
+
+    enum {
+      CACHE_SIZE = 0x80u,   // size of the memory layouts
+      MAX_PAGES  = 32,      // pages tracked by the dirty mask
+      MAX_PAGE_SIZE = 16,   // largest supported page size
+    };
+
+    /** \brief Delay between the first modification and the write-back */
+    static constexpr systime_t FLUSH_DELAY = MS2ST(500);
+
     AT24 &at24c01;
     const uint8_t BSMV;
     const uint8_t bsmv;
@@ -64,13 +97,41 @@ class FileSystemIoBase {
 
   public:
 
-    FileSystemIoBase(AT24 &at24c01, uint8_t BSMV, uint8_t bsmv, uint8_t HMV, uint8_t hmv)
-      : at24c01(at24c01),
-        BSMV(BSMV),
-        bsmv(bsmv),
-        HMV(HMV),
-        hmv(hmv) {
-     }
+    FileSystemIoBase(AT24 &at24c01, uint8_t BSMV, uint8_t bsmv, uint8_t HMV, uint8_t hmv);
+
+    /**
+     * \brief Write-back thread
+     */
+    virtual msg_t main();
+
+    /**
+     * \brief Writes all modified pages back to the EEPROM
+     * Blocks until all pages are written.
+     * @return FSIO return types
+     */
+    msg_t sync();
+
+    /**
+     * \brief Number of writes of a page since startup (wear counter)
+     * @param page Index of the page
+     * @return Number of writes
+     */
+    uint32_t getPageWrites(uint8_t page);
+
+    /**
+     * \brief Number of page writes that failed since startup
+     */
+    uint32_t getWriteErrors();
+
+    /**
+     * \brief Number of pages with pending modifications
+     */
+    uint8_t getDirtyPages();
+
+    /**
+     * \brief Number of pages of the EEPROM
+     */
+    uint8_t getNumPages();
 
     /**
      * \brief Checks the values stored in the memory and compares the set version numbers and the version numbers found.
@@ -117,6 +178,44 @@ class FileSystemIoBase {
      */
     msg_t getBoardId (uint8_t *buffer);
 
+  protected:
+    /**
+     * \brief Stream to access the memory (via the cache)
+     */
+    Cache cache;
+
+  public:
+    static size_t cacheWrite(void *instance, const uint8_t *bp, size_t n);
+    static size_t cacheRead(void *instance, uint8_t *bp, size_t n);
+    static uint32_t cacheClose(void *instance);
+    static int cacheGeterror(void *instance);
+    static fileoffset_t cacheGetsize(void *instance);
+    static fileoffset_t cacheGetposition(void *instance);
+    static fileoffset_t cacheLseek(void *instance, fileoffset_t offset);
+
+  private:
+    /**
+     * \brief Loads the image from the EEPROM if not done yet
+     * @note Call with the mutex locked.
+     * @return True if the image is valid
+     */
+    bool load();
+
+    /**
+     * \brief Writes a single dirty page back to the EEPROM
+     * @return FSIO return types
+     */
+    msg_t flushPage(uint8_t page);
+
+    ::Mutex mutex;       // protects the image and the counters
+    ::Mutex syncMutex;   // serializes the write-backs and protects pageBuffer
+    uint8_t pageBuffer[MAX_PAGE_SIZE];
+    uint8_t image[CACHE_SIZE];
+    bool imageValid;
+    uint32_t dirtyMask;
+    uint32_t pageWrites[MAX_PAGES];
+    uint32_t writeErrors;
+
 };
 
 }
@@ -21,17 +21,19 @@
 #include <ch.hpp>
 #include <hal.h>
 #include <chprintf.h>
-#include <evtimer.h>
 
 // DO CONFIGURATION HERE : START
 // Important: SD_SPEED_PREFIX + SD_SPEED has to have 6 characters: e.g. 019200 or 115200
 #define SD_SPEED_PREFIX   // Prefix < 0     | 0     |        |        |        |        >
 #define SD_SPEED 250000 // Baudrate < 19200 | 57600 | 115200 | 250000 | 500000 | 750000 >
-#define UPDATE_LIDAR_PERIOD_MSEC MS2ST(1000)  // Periodic sensor value fetch in ms
+#define LIDAR_RX_CHUNK_SIZE 128 // Size of each of the two DMA receive buffers in bytes (power of two)
+#define LIDAR_RX_POLL_PERIOD MS2ST(2)  // Processing of partially filled DMA buffers
+#define LIDAR_SCAN_TIMEOUT MS2ST(1000)  // Restart of the scan stream if no scan was received
 // Scan acquire message : START
 // Uncomment the specific character decoding to make it available
 #define USE_2CHAR_CODE
 // #define USE_3CHAR_CODE  // TODO Not implemented yet
+// MS and MD request continuous scans (2 and 3 character encoding)
 #define DATA_ACQ_2CHAR_CODE "MS"
 #define DATA_ACQ_3CHAR_CODE "MD"
 // Important: STARTING_STEP_PREFIX + STARTING_STEP has to have 4 characters: e.g. 0005 0044 0320
@@ -42,7 +44,7 @@
 #define END_STEP 725
 #define CLUSTER_COUNT 00
 #define SCAN_INTERVALL 0
-#define NUMBER_OF_INTERVALL 01
+#define NUMBER_OF_INTERVALL 00 // 00: stream scans until the QT command
 // Scan acquire message : END
 // DO CONFIGURATION HERE : END
 
@@ -67,6 +69,17 @@
 
 namespace amiro {
 
+  /**
+  * Driver of the Hokuyo URG laser range finder
+  *
+  * The LIDAR streams scans continuously (DATA_ACQ_CODE with infinite scans).
+  * The replies are received by DMA into two alternating buffers of
+  * LIDAR_RX_CHUNK_SIZE bytes, so no interrupt is raised per character. The
+  * thread decodes the characters as they arrive (including the partially
+  * filled buffer) directly into the back buffer of two scan buffers. A
+  * completed scan becomes the front buffer by swapping an index, so getScan()
+  * copies the last scan without blocking the decoder.
+  */
   class Lidar : public chibios_rt::BaseStaticThread<256> {
   public:
     /**
@@ -80,10 +93,22 @@ namespace amiro {
     * @param scanData Array of size NUMBER_OF_STEPS which will be override
     *                 with the scanned data
     *
-    * @return True if scanData holds the current data, False if no data have been copied
+    * @return True if a new scan has been copied since the last call, False if not
     */
     bool_t getScan(uint16_t (&scanData)[NUMBER_OF_STEPS]);
 
+    /**
+    * Writes the last scan into the given array, if it is newer than the given one
+    *
+    * @param scanData Array of size NUMBER_OF_STEPS which will be override
+    *                 with the scanned data
+    * @param scanCount Number of the scan the caller has (see getScanCount()),
+    *                  updated if a newer scan has been copied
+    *
+    * @return True if a newer scan has been copied, False if not
+    */
+    bool_t getScan(uint16_t (&scanData)[NUMBER_OF_STEPS], uint32_t &scanCount);
+
     /**
     * Returns the value NUMBER_OF_STEPS which is the amount of datapoints per scan
     *
@@ -91,13 +116,28 @@ namespace amiro {
     */
     uint16_t getNumberOfValues();
 
-  protected:
-    virtual msg_t main();
+    /**
+    * Returns the number of completely received scans since startup
+    *
+    * @return Number of scans
+    */
+    uint32_t getScanCount();
 
     /**
-    * Do a scan and update the datapoints in scanData
+    * Returns the number of dropped scans since startup
+    * (checksum errors, incomplete scans and receive buffer overruns)
+    *
+    * @return Number of errors
     */
-    msg_t updateSensorVal();
+    uint32_t getErrorCount();
+
+  protected:
+    virtual msg_t main();
+
+  private:
+    // The receive stream has a single consumer: the helpers below which read
+    // it (getData(), fetchData(), consumeData() and their users) must only be
+    // called by the Lidar thread, which also receives the events they wait for.
 
     /**
     * Print received data until "\n\n" was received
@@ -152,47 +192,127 @@ namespace amiro {
     *  @param data Container for the variable
     *  @param timeoutMs Timeout in millisecond
     *
-    *  @return True if data was received, False if timed out (NOTE timeoutMs should by much smaller than UPDATE_LIDAR_PERIOD_MSEC)
+    *  @return True if data was received, False if timed out
     */
     bool_t getData(uint8_t &data, uint32_t timeoutMs);
 
     /**
-    * Container for the scanned data
+    *  Sends a command to the LIDAR and waits until it has been transmitted
     *
-    * @brief The "+1" character is for holding the last sum which is transmitted
-    *        by the LIDAR. It is not used, but it makes the algorithm much easier
-    *        we we do not care about it
+    *  @param command Zero terminated command including the line feed
     */
-    static uint8_t scannedData[NUMBER_OF_CHARACTERS + 1];
+    void sendCommand(const char *command);
 
     /**
-    *  Flushes the input queue of the SD2 serial device
+    *  (Re)starts the UART with the given speed and the DMA reception
     */
-    inline void flushSD2InputQueue();
+    void startSerial(uint32_t speed);
 
     /**
-    * Possible states for the receiver state machine
+    *  Returns the received but not yet processed characters of one DMA buffer
+    *
+    *  @param data Set to the first unprocessed character
+    *
+    *  @return Number of characters at data, 0 if there are none
     */
-    enum STATE {SEND_SCAN_CMD, DATA_VALID_CHECK, DATA_START_CHECK, DATA_RECORD, DATA_DECODE, DATA_SHOW, FAIL, FINISH};
+    size_t fetchData(const uint8_t *&data);
 
     /**
-    * Current state of the machine
+    *  Marks characters returned by fetchData() as processed
+    *
+    *  @param n Number of processed characters
+    *
+    *  @return False if the DMA overwrote the characters in the meantime
     */
-    STATE step = SEND_SCAN_CMD;
+    bool_t consumeData(size_t n);
 
     /**
-    * This is the status which comes after the command echo "\n99b\n"
+    *  Feeds a single received character into the scan decoder
+    *
+    *  @param input Received character
     */
-    const uint8_t validScanTag[5] =  {10,57,57,98,10};
+    void decode(uint8_t input);
 
     /**
-    * Index for the received status
+    *  Drops the scan which is currently decoded
     */
-    uint8_t checkStatusIdx = 0;
+    void resetDecoder();
+
+    /**
+    * DMA callbacks of the UART
+    */
+    static void rxEndCallback(UARTDriver *uartp);
+    static void txEndCallback(UARTDriver *uartp);
+
+    /**
+    * DMA receive buffers (alternately filled)
+    */
+    uint8_t rxBuffer[2][LIDAR_RX_CHUNK_SIZE];
+
+    /**
+    * Stream position at the end of the last completely filled receive buffer
+    */
+    volatile uint32_t rxEnd = 0;
+
+    /**
+    * Stream position of the next character to process
+    */
+    uint32_t rxRead = 0;
+
+    /**
+    * Signaled when a command has been transmitted
+    */
+    BinarySemaphore txDone;
+
+    /**
+    * UART configuration (speed is set by startSerial())
+    */
+    UARTConfig uartConfig;
+
+    /**
+    * Scan buffers, the decoder writes scans[1 - frontIdx]
+    */
+    uint16_t scans[2][NUMBER_OF_STEPS];
+
+    /**
+    * Index of the last completed scan
+    */
+    volatile uint8_t frontIdx = 0;
+
+    /**
+    * Number of completed scans
+    */
+    volatile uint32_t scanCount = 0;
+
+    /**
+    * Scan count of the last scan returned by getScan()
+    */
+    uint32_t scanCountRead = 0;
+
+    /**
+    * Number of dropped scans
+    */
+    volatile uint32_t errorCount = 0;
+
+    /**
+    * Possible states of the scan decoder
+    */
+    enum STATE {DATA_VALID_CHECK, DATA_START_CHECK, DATA_RECORD};
+
+    /**
+    * Current state of the decoder
+    */
+    STATE step = DATA_VALID_CHECK;
+
+    /**
+    * This is the status which comes after the command echo "\n99b\n"
+    */
+    const uint8_t validScanTag[5] =  {10,57,57,98,10};
 
     /**
     * Index for the received status
     */
+    uint8_t checkStatusIdx = 0;
 
     /**
     * Hold the board id
@@ -205,9 +325,10 @@ namespace amiro {
     SETUP setup;
 
     /**
-    * Holds the current input
+    * Last received character which is not decoded yet, because it may be the
+    * checksum of the line (0 if there is none)
     */
-    uint8_t newInput = 0xFF;
+    uint8_t heldInput = 0;
 
     /**
     * Holds the last input
@@ -215,28 +336,29 @@ namespace amiro {
     uint8_t lastInput = 0xFF;
 
     /**
-    * Counter for the received characters of the data points
+    * First character of the value which is currently decoded (0 if there is none)
     */
-    uint16_t dataIdx = 0;
+    uint8_t highInput = 0;
 
     /**
-    * Temporary variable which hold the amount of receved bytes
+    * Sum of the data characters of the current line
     */
-    uint32_t dataCounter = 0;
+    uint8_t lineSum = 0;
 
     /**
-    * Holds the information, if scannedData holds the last sensor scan
+    * Holds the information, if the current scan had a checksum error
     */
-    bool_t isReady = false;
+    bool_t lineError = false;
 
     /**
-    * Holds the information, if the datachunk was not transmitted completely
+    * Index of the next value of the current scan
     */
-    bool_t isFail = false;
-
-  private:
+    uint16_t dataIdx = 0;
 
-    EvTimer evtimer;
+    /**
+    * Holds the information, if a scan has been received
+    */
+    bool_t isReady = false;
 
   public:
   /**
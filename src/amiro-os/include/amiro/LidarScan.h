@@ -0,0 +1,127 @@
+#ifndef AMIRO_LIDAR_SCAN_H_
+#define AMIRO_LIDAR_SCAN_H_
+
+#include <ch.hpp>
+
+namespace amiro {
+
+  /**
+   * \brief Compact LIDAR scan that is streamed over CAN (CAN::LIDAR_SCAN_ID)
+   *
+   * The LightRing reduces each scan of the LIDAR (STEPS values from FIRST_STEP on,
+   * see Lidar.h) to POINTS ranges: every point is the minimum of DECIMATION
+   * consecutive steps, quantised to one byte of RESOLUTION_MM. Thus a scan fits
+   * into FRAGMENTS CAN frames, which are sent back to back at SCAN_PERIOD.
+   *
+   * Every frame starts with a header byte (4 bit sequence number of the scan, 4 bit
+   * index of the fragment) followed by up to FRAGMENT_POINTS ranges, so each frame
+   * can be decoded on its own. A receiver publishes a scan as soon as all fragments
+   * of one sequence number arrived and drops incomplete scans.
+   */
+  class LidarScan {
+  public:
+    enum : uint16_t {
+      FIRST_STEP      = 44,   // STARTING_STEP of Lidar.h
+      STEPS           = 682,  // NUMBER_OF_STEPS of Lidar.h
+      FRONT_STEP      = 384,  // Step in driving direction
+      STEPS_PER_TURN  = 1024, // Angular resolution of the LIDAR
+      DECIMATION      = 8,
+      POINTS          = (STEPS + DECIMATION - 1) / DECIMATION,
+      FRAGMENT_POINTS = 7,
+      FRAGMENTS       = (POINTS + FRAGMENT_POINTS - 1) / FRAGMENT_POINTS,
+      RESOLUTION_MM   = 16,
+    };
+
+    /**
+     * \brief Special values of the quantised ranges
+     */
+    enum : uint8_t {
+      INVALID   = 0x00u,  // No valid measurement in the interval
+      FAR       = 0xFFu,  // Beyond 254 * RESOLUTION_MM
+    };
+
+    /**
+     * \brief Wall segment extracted from a scan (CAN::LIDAR_WALL_ID, see WallExtractor)
+     *
+     * The wall is given in Hesse normal form relative to the robot: the closest point
+     * of the (infinite) wall line lies at distance in the direction of angle.
+     */
+    struct Wall {
+      uint16_t distance;  // Distance of the line in mm
+      int16_t angle;      // Direction of the normal in mrad, 0 is the driving direction, positive counterclockwise
+      uint16_t length;    // Length of the segment in mm
+      uint8_t sequence;   // Lower 8 bit of the scan count
+      uint8_t segments;   // Number of segments found in the scan, 0 if there is no wall
+    } __attribute__((packed));
+
+    /**
+     * \brief Number of broadcast periods (CAN::UPDATE_PERIOD) between two scans (4 Hz)
+     */
+    static const uint8_t SCAN_PERIOD = 4;
+
+    /**
+     * \brief Reduces a full scan to the compact ranges
+     *
+     * @param scan Ranges of the LIDAR in mm (values below 20 mm are error codes)
+     * @param ranges Quantised ranges
+     */
+    static void compact(const uint16_t (&scan)[STEPS], uint8_t (&ranges)[POINTS]);
+
+    /**
+     * \brief Range of a quantised value
+     *
+     * @return Range in mm (upper bound of the interval), 0 for INVALID and FAR
+     */
+    static uint16_t toMillimeter(uint8_t range);
+
+    /**
+     * \brief Angle of the center of a point relative to the driving direction
+     *
+     * @return Angle in µrad, positive counterclockwise
+     */
+    static int32_t getAngle(uint8_t point);
+
+    /**
+     * \brief Reassembles the scans of received fragments
+     */
+    class Receiver {
+    public:
+      Receiver();
+
+      /**
+       * \brief Handles a single frame
+       *
+       * @param data Payload of the frame
+       * @param size DLC of the frame
+       * @return True if the frame was valid
+       */
+      bool receive(const uint8_t *data, uint8_t size);
+
+      /**
+       * \brief Copies the last complete scan
+       *
+       * @param ranges Quantised ranges
+       * @param scanCount Number of the last scan of the caller, updated if a newer scan was copied
+       * @return True if a newer scan was copied
+       */
+      bool getScan(uint8_t (&ranges)[POINTS], uint32_t &scanCount);
+
+      /**
+       * \brief Number of complete and dropped scans since startup
+       */
+      uint32_t getScanCount();
+      uint32_t getDropCount();
+
+    private:
+      uint8_t pending[POINTS];
+      uint8_t complete[POINTS];
+      uint16_t pendingMask;
+      uint8_t pendingSequence;
+      uint32_t scanCount;
+      uint32_t dropCount;
+    };
+  };
+
+}
+
+#endif /* AMIRO_LIDAR_SCAN_H_ */
@@ -0,0 +1,43 @@
+#ifndef AMIRO_LIGHT_ANIMATION_H_
+#define AMIRO_LIGHT_ANIMATION_H_
+
+#include <stdint.h>
+
+namespace amiro {
+
+  /**
+   * \brief Animation of the LightRing, sent as a single CAN frame (CAN::LIGHT_ANIMATION_ID)
+   *
+   * The LightRing keeps a base color per LED (CAN::COLOR_ID or SET). An
+   * animation overrides the LEDs of its mask and runs locally with a steady
+   * refresh rate (see LightAnimator). When it ends, the base colors are shown
+   * again.
+   */
+  struct LightAnimation {
+    enum Effect {
+      STOP      = 0,  // Stops the animation
+      SET       = 1,  // Sets the base color of the LEDs
+      BLINK     = 2,  // Color and black, param is the on time in 1/256 of the period (0 = half)
+      FADE      = 3,  // Base color to color and back
+      CHASE     = 4,  // One LED of color per step around the ring, param is the length of the tail
+      PROXIMITY = 5,  // Heat map of the ring sensors (blue, green, red), full scale at param << 8 (0 = 0x1000)
+    };
+
+    enum {
+      PERIOD_UNIT_MS = 20,
+      ALL_LEDS       = 0xFF,
+    };
+
+    uint8_t effect;
+    uint8_t mask;     // Bit per LED
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t period;   // Period of one cycle in PERIOD_UNIT_MS
+    uint8_t repeat;   // Number of cycles, 0 = until stopped
+    uint8_t param;    // Depends on the effect
+  };
+
+}
+
+#endif /* AMIRO_LIGHT_ANIMATION_H_ */
@@ -0,0 +1,61 @@
+#ifndef AMIRO_LIGHT_ANIMATOR_H_
+#define AMIRO_LIGHT_ANIMATOR_H_
+
+#include <ch.hpp>
+
+#include <amiro/Color.h>
+#include <amiro/LightAnimation.h>
+#include <amiro/leds/tlc5947.hpp>
+#include <amiro/ControllerAreaNetworkRx.h>
+
+namespace amiro {
+
+  /**
+   * \brief Runs the animations of the LightRing locally
+   *
+   * The thread is the only writer of the TLC5947. Without an animation it shows
+   * the base colors whenever they change. While an animation runs, all LEDs are
+   * rendered every REFRESH_PERIOD_MS from the time since its start and set at
+   * once, so the animation keeps its speed regardless of the load of the bus
+   * and the thread.
+   */
+  class LightAnimator : public chibios_rt::BaseStaticThread<256> {
+  public:
+    enum {
+      REFRESH_PERIOD_MS = 20,
+    };
+
+    LightAnimator(TLC5947 *tlc5947, ControllerAreaNetworkRx *sensors);
+
+    /**
+     * \brief Sets the base color of a LED
+     */
+    void setColor(int index, Color color);
+
+    /**
+     * \brief Starts, stops or applies an animation
+     */
+    void animate(const LightAnimation &animation);
+
+    /**
+     * \brief True while an animation runs
+     */
+    bool isAnimating();
+
+  protected:
+    virtual msg_t main(void);
+
+  private:
+    bool render(const LightAnimation &animation, uint32_t elapsedMs, Color (&colors)[TLC5947::LEDS]);
+
+    TLC5947 *tlc5947;
+    ControllerAreaNetworkRx *sensors;
+    Color baseColors[TLC5947::LEDS];
+    LightAnimation animation;
+    systime_t startTime;
+    volatile bool animating;
+  };
+
+}
+
+#endif /* AMIRO_LIGHT_ANIMATOR_H_ */
@@ -36,6 +36,20 @@ namespace amiro {
      */
     int getCurrentRPMRight();
 
+    /**
+     * Get the current duty cycle of the left motor
+     *
+     * @return duty cycle in 1/100 %, negative if the motor runs backwards
+     */
+    int getCurrentPWMLeft();
+
+    /**
+     * Get the current duty cycle of the right motor
+     *
+     * @return duty cycle in 1/100 %, negative if the motor runs backwards
+     */
+    int getCurrentPWMRight();
+
     chibios_rt::EvtSource* getEventSource();
 
     /**
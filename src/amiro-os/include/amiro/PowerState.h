@@ -0,0 +1,64 @@
+#ifndef AMIRO_POWER_STATE_H_
+#define AMIRO_POWER_STATE_H_
+
+#include <ch.hpp>
+
+namespace amiro {
+
+  /**
+   * \brief Power state of the robot that is shared across all modules
+   *
+   * While the robot is parked (e.g. docked and charging), the modules reduce their
+   * periodic work to a heartbeat of CAN::PARKED_UPDATE_PERIOD: the CAN broadcasts and
+   * the sensor threads run at this period and the DiWheelDrive puts its inertial sensors
+   * to sleep. Any module may change the state with
+   * ControllerAreaNetworkTx::broadcastPowerState() (CAN::POWER_STATE_ID), all other
+   * modules adopt it on reception.
+   *
+   * \notice Threads that wait for a full period pick up a change of the state only
+   * after that period, i.e. waking up takes up to one heartbeat.
+   */
+  class PowerState {
+  public:
+    enum State : uint8_t {
+      ACTIVE = 0,
+      PARKED = 1,
+    };
+
+    /**
+     * \brief Current power state of this module
+     */
+    static State get();
+
+    /**
+     * \brief Whether the robot is parked
+     */
+    static bool isParked();
+
+    /**
+     * \brief Adopts the given power state
+     *
+     * @param state New power state
+     * @return True if the state changed
+     */
+    static bool set(State state);
+
+    /**
+     * \brief Period of the periodic work of the modules in the current state
+     *
+     * @return CAN::UPDATE_PERIOD or CAN::PARKED_UPDATE_PERIOD in system ticks
+     */
+    static systime_t getUpdatePeriod();
+
+    /**
+     * \brief Human readable name of a state
+     */
+    static const char* getName(State value);
+
+  private:
+    static volatile State state;
+  };
+
+}
+
+#endif /* AMIRO_POWER_STATE_H_ */
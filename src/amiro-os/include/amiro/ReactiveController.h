@@ -0,0 +1,112 @@
+#ifndef AMIRO_REACTIVE_CONTROLLER_H_
+#define AMIRO_REACTIVE_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <Types.h>
+
+namespace amiro {
+
+  /**
+   * \brief Table-driven reactive controller in fixed-point arithmetic
+   *
+   * A behaviour is a table of inputs, each mapping one sensor value linearly
+   * to a translational and a rotational velocity (Braitenberg vehicle). The
+   * activation of an input is 0 at the value low and 1 (Q15) at the value high,
+   * so low > high inverts the input (e.g. dark floor activates). The output of
+   * a behaviour is its bias plus the sum of all activations times their gains.
+   *
+   * All behaviours are blended by their weights (Q8) into one kinematic per
+   * tick, limited to the maximum velocities. Integer operations only, so the
+   * controller can run at sensor rate on every board.
+   */
+  class ReactiveController {
+  public:
+    enum {
+      MAX_BEHAVIOURS = 4,
+      ACTIVATION_ONE = 1 << 15,  // Activation of 1.0 (Q15)
+      WEIGHT_ONE     = 1 << 8,   // Weight of 1.0 (Q8)
+      MAX_WEIGHT     = 4 * WEIGHT_ONE,
+    };
+
+    struct Input {
+      uint8_t sensor;   // Index into the sensor values
+      uint16_t low;     // Value of activation 0
+      uint16_t high;    // Value of full activation
+      int16_t x;        // Gain at full activation in mm/s
+      int16_t w_z;      // Gain at full activation in mrad/s
+    };
+
+    struct Behaviour {
+      const char *name;
+      const Input *inputs;
+      uint8_t count;    // Number of inputs
+      int16_t x;        // Bias in mm/s
+      int16_t w_z;      // Bias in mrad/s
+    };
+
+    /**
+     * @param maxTranslation  Limit of the translation in µm/s
+     * @param maxRotation     Limit of the rotation in µrad/s
+     */
+    ReactiveController(int32_t maxTranslation, int32_t maxRotation);
+
+    /**
+     * \brief Adds a behaviour
+     *
+     * @param behaviour  Table of the behaviour, must stay valid
+     * @param weight     Weight of the output (Q8, WEIGHT_ONE is 1.0)
+     * @return Id of the behaviour, 0 if there are too many behaviours
+     */
+    uint8_t addBehaviour(const Behaviour *behaviour, uint16_t weight);
+
+    /**
+     * \brief Looks up a behaviour by name
+     *
+     * @return Id of the behaviour, 0 if there is no such behaviour
+     */
+    uint8_t findBehaviour(const char *name);
+
+    const Behaviour *getBehaviour(uint8_t id);
+    uint8_t getBehaviourCount();
+
+    /**
+     * \brief Sets the weight of a behaviour, limited to MAX_WEIGHT
+     */
+    void setWeight(uint8_t id, uint16_t weight);
+    uint16_t getWeight(uint8_t id);
+
+    /**
+     * \brief Overrides the bias of a behaviour, e.g. to command a behaviour without inputs
+     *
+     * @param x    Bias in mm/s
+     * @param w_z  Bias in mrad/s
+     */
+    void setBias(uint8_t id, int16_t x, int16_t w_z);
+
+    /**
+     * \brief Computes the kinematic of one tick
+     *
+     * @param sensors    Sensor values as indexed by the inputs
+     * @param kinematic  Blended kinematic (x and w_z, all other velocities 0)
+     */
+    void update(const uint16_t *sensors, types::kinematic &kinematic);
+
+    /**
+     * \brief Activation of a sensor value (Q15)
+     */
+    static uint16_t activation(uint16_t value, uint16_t low, uint16_t high);
+
+  private:
+    const Behaviour *behaviours[MAX_BEHAVIOURS];
+    volatile uint16_t weights[MAX_BEHAVIOURS];
+    volatile int16_t biasX[MAX_BEHAVIOURS];
+    volatile int16_t biasWz[MAX_BEHAVIOURS];
+    uint8_t behaviourCount;
+    int32_t maxTranslation;
+    int32_t maxRotation;
+  };
+
+}
+
+#endif /* AMIRO_REACTIVE_CONTROLLER_H_ */
@@ -0,0 +1,86 @@
+#ifndef AMIRO_SYSTEM_TIME_H_
+#define AMIRO_SYSTEM_TIME_H_
+
+#include <ch.hpp>
+
+namespace amiro {
+
+  /**
+   * \brief Microsecond clock that is synchronised across all modules
+   *
+   * The local uptime is derived from the cycle counter of the core. The PowerManagement
+   * is the time master and broadcasts its time once per second (CAN::SYSTEM_TIME_ID).
+   * All other modules adopt this time, so that the timestamps of sensor frames from
+   * different modules can be compared.
+   *
+   * Timestamps are 32 bit wide and wrap around after approximately 71 minutes. Always
+   * compare them by their difference, e.g. with getAge().
+   *
+   * The time never runs backwards on a correction of the master time. A module that is
+   * behind adopts the master time at once. A module that is ahead slows its time down
+   * to at most 1 - 1/2^SLEW_SHIFT of the real speed until it is on time. Only errors
+   * beyond MAX_SLEW, e.g. after a restart of the master, are taken over as a step back.
+   */
+  class SystemTime {
+  public:
+    enum {
+      SLEW_SHIFT = 4,      // The time runs at 15/16 of its speed at most while slewing
+      MAX_SLEW   = 62500,  // Largest error in µs that is slewed, corrected within one second
+    };
+
+    /**
+     * \brief Time since startup of this module
+     *
+     * \notice The cycle counter wraps around after 25 seconds at 168 MHz. This function
+     * has to be called at least once within this period, which the CAN threads do.
+     *
+     * @return Local uptime in microseconds
+     */
+    static uint64_t getUptime();
+
+    /**
+     * \brief Synchronised time of the robot
+     *
+     * @return Time in microseconds, which equals the local uptime as long as no time
+     *         was received from the master
+     */
+    static uint32_t getTime();
+
+    /**
+     * \brief Time that passed since the given timestamp
+     *
+     * @param timestamp Synchronised time as returned by getTime()
+     * @return Age in microseconds, 0 for timestamps ahead of the local time (e.g. from a
+     *         module whose time is slightly ahead, or taken before a step back)
+     */
+    static uint32_t getAge(uint32_t timestamp);
+
+    /**
+     * \brief Adopts the time of the master, see the class description
+     *
+     * @param masterTime Time of the master when the local uptime was localUptime
+     * @param localUptime Local uptime at which the time was received
+     */
+    static void synchronize(uint32_t masterTime, uint64_t localUptime);
+
+    /**
+     * \brief Whether the time of the master was received
+     *
+     * @return True after the first call of synchronize()
+     */
+    static bool isSynchronized();
+
+  private:
+    static uint64_t getUptimeI();
+
+    static uint64_t cycles;
+    static uint32_t lastCounterValue;
+    static uint32_t offset;
+    static int32_t slew;          // Correction of the offset that is still to be taken back
+    static uint64_t slewUptime;   // Uptime up to which the slew was applied
+    static bool synchronized;
+  };
+
+}
+
+#endif /* AMIRO_SYSTEM_TIME_H_ */
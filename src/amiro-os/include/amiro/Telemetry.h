@@ -0,0 +1,95 @@
+#ifndef AMIRO_TELEMETRY_H_
+#define AMIRO_TELEMETRY_H_
+
+#include <ch.hpp>
+
+#include <amiro/TelemetryFrame.h>
+
+namespace amiro {
+
+  /**
+   * \brief Binary telemetry stream
+   *
+   * Channels are registered with a sampling function that fills in the values
+   * and a period in ms. While the stream is enabled every channel is sampled
+   * with its own period and sent as COBS frame with CRC (see TelemetryFrame.h).
+   * The description of all channels is repeated every DESCRIPTION_PERIOD_MS,
+   * so a decoder can be attached at any time.
+   *
+   * Register all channels before the thread is started.
+   */
+  class Telemetry : public chibios_rt::BaseStaticThread<512> {
+  public:
+    enum {
+      MAX_CHANNELS          = 12,
+      PERIOD_MS             = 10,    // Resolution of the channel periods
+      DESCRIPTION_PERIOD_MS = 5000,
+    };
+
+    /**
+     * \brief Writes the values of a channel to values
+     */
+    typedef void (*Sampler)(void *values);
+
+    struct Channel {
+      const char *name;      // Name of the channel, e.g. the log file of the decoder
+      const char *fields;    // Comma separated names of the values
+      tlm_type_t type;
+      uint8_t count;         // Number of values
+      Sampler sample;
+    };
+
+    Telemetry(BaseSequentialStream *stream);
+
+    /**
+     * \brief Registers a channel
+     *
+     * @param channel   Description of the channel, must stay valid
+     * @param periodMs  Sampling period in ms, 0 disables the channel
+     * @return Id of the channel, 0 if the registry is full or the channel too large
+     */
+    uint8_t registerChannel(const Channel *channel, uint16_t periodMs);
+
+    /**
+     * \brief Looks up a channel by name
+     *
+     * @return Id of the channel, 0 if there is no such channel
+     */
+    uint8_t findChannel(const char *name);
+
+    const Channel *getChannel(uint8_t id);
+    uint16_t getPeriod(uint8_t id);
+    void setPeriod(uint8_t id, uint16_t periodMs);
+    uint8_t getChannelCount();
+
+    void enable(bool enable);
+    bool isEnabled();
+
+    /**
+     * \brief Number of frames sent since the start
+     */
+    uint32_t getFrameCount();
+
+  protected:
+    virtual msg_t main();
+
+  private:
+    void send(uint8_t id, const uint8_t *payload, size_t length);
+    void sendDescription(uint8_t id);
+
+    BaseSequentialStream *stream;
+    const Channel *channels[MAX_CHANNELS];
+    volatile uint16_t periods[MAX_CHANNELS];
+    systime_t nextSample[MAX_CHANNELS];
+    uint8_t channelCount;
+    uint8_t sequence;
+    volatile bool enabled;
+    uint32_t frameCount;
+    // buffers are members to keep them off the stack of the thread
+    uint32_t payload[TLM_MAX_PAYLOAD / sizeof(uint32_t)];
+    uint8_t frame[TLM_MAX_FRAME_SIZE];
+  };
+
+}
+
+#endif /* AMIRO_TELEMETRY_H_ */
@@ -0,0 +1,87 @@
+#ifndef AMIRO_TELEMETRY_FRAME_H_
+#define AMIRO_TELEMETRY_FRAME_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Binary telemetry frames
+ *
+ * A frame consists of a header, the values of a channel and a CRC:
+ *
+ *   id (1) | sequence (1) | time in ms (4) | payload (0..TLM_MAX_PAYLOAD) | CRC (2)
+ *
+ * All fields are little endian, the CRC is CRC-16/CCITT-FALSE over header and
+ * payload. The frame is COBS encoded and enclosed in zero bytes, so it can be
+ * interleaved with the text of the shell: text never contains a zero byte and
+ * does not pass the CRC check.
+ *
+ * Frames with the id TLM_DESCRIPTION_ID describe a data channel:
+ *
+ *   id (1) | type (1) | count (1) | period in ms (2) | name '\0' | fields '\0'
+ *
+ * where fields is a comma separated list with one name per value.
+ *
+ * This file is shared by the firmware (components/Telemetry.cpp) and the host
+ * decoder (amiro-os/tools/telemetry).
+ */
+
+/**
+ * @brief Maximum size of the payload of a frame
+ */
+#define TLM_MAX_PAYLOAD                 48
+
+/**
+ * @brief Size of id, sequence number and time stamp
+ */
+#define TLM_HEADER_SIZE                 6
+
+/**
+ * @brief Maximum size of an encoded frame including both delimiters
+ */
+#define TLM_MAX_FRAME_SIZE              (TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + 2 + 1 + 2)
+
+/**
+ * @brief Channel id of the description frames
+ */
+#define TLM_DESCRIPTION_ID              0
+
+/**
+ * @brief Types of the channel values
+ */
+typedef enum {
+  TLM_INT8 = 0,
+  TLM_UINT8 = 1,
+  TLM_INT16 = 2,
+  TLM_UINT16 = 3,
+  TLM_INT32 = 4,
+  TLM_UINT32 = 5,
+  TLM_TYPE_COUNT = 6,
+} tlm_type_t;
+
+/**
+ * @brief Decoded frame
+ */
+typedef struct {
+  uint8_t id;
+  uint8_t sequence;
+  uint32_t time;
+  size_t length;
+  uint8_t payload[TLM_MAX_PAYLOAD];
+} tlm_frame_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  size_t tlmTypeSize(tlm_type_t type);
+  uint16_t tlmCrc16(const uint8_t *data, size_t n, uint16_t crc);
+  size_t tlmCobsEncode(const uint8_t *src, size_t n, uint8_t *dst);
+  size_t tlmCobsDecode(const uint8_t *src, size_t n, uint8_t *dst);
+  size_t tlmEncodeFrame(uint8_t id, uint8_t sequence, uint32_t time,
+                        const uint8_t *payload, size_t length, uint8_t *frame);
+  int tlmDecodeFrame(const uint8_t *data, size_t n, tlm_frame_t *frame);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMIRO_TELEMETRY_FRAME_H_ */
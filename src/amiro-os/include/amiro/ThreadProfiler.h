@@ -0,0 +1,65 @@
+#ifndef AMIRO_THREAD_PROFILER_H_
+#define AMIRO_THREAD_PROFILER_H_
+
+#include <ch.h>
+#include <hal.h>
+
+/**
+ * @brief Thread profiler
+ *
+ * While the topology benchmark (amiro/TopologyBenchmark.h) replays a model of
+ * the thread set, the profiler measures the real threads of a module. It is
+ * compiled in with USE_THREAD_PROFILER=yes, which hooks it into the kernel
+ * (amiro/ThreadProfilerConf.h). For every thread in the registry it reports
+ *  - the CPU time during a measurement window, measured with the realtime
+ *    counter of the HAL (DWT cycle counter) on every context switch,
+ *  - the stack headroom, i.e. the part of the working area that never has
+ *    been written (fill pattern of CH_DBG_FILL_THREADS),
+ *  - the worst-case and a histogram of the wakeup latencies, i.e. the time
+ *    from the thread becoming ready until it runs.
+ *
+ * @note The ChibiOS 2 port offers no interrupt hooks, so the time spent in
+ *       interrupt handlers is accounted to the thread they interrupted.
+ * @note There is no hook when a thread becomes ready either. The ready list
+ *       is scanned on every context switch and system tick instead, so a
+ *       latency may be underestimated by up to one system tick.
+ */
+
+/**
+ * @brief Maximum number of threads that are reported
+ */
+#if !defined(TPROF_MAX_THREADS) || defined(__DOXYGEN__)
+#define TPROF_MAX_THREADS               24
+#endif
+
+/**
+ * @brief Maximum measurement window in seconds (the cycle counters are 32 bit)
+ */
+#if !defined(TPROF_MAX_WINDOW) || defined(__DOXYGEN__)
+#define TPROF_MAX_WINDOW                10
+#endif
+
+/**
+ * @brief Profile of a single thread
+ */
+typedef struct {
+  const char *name;       /**< @brief Name of the thread */
+  tprio_t prio;           /**< @brief Current priority */
+  uint32_t cycles;        /**< @brief Counter cycles in the measurement window */
+  int32_t stack_free;     /**< @brief Stack headroom in bytes, -1 if unknown */
+  uint32_t latency_max;   /**< @brief Worst-case wakeup latency in counter cycles */
+  uint16_t latency[TPROF_LATENCY_BINS];  /**< @brief Wakeup latency histogram */
+} tprof_thread_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void tprofStart(void);
+  void tprofResetLatencies(void);
+  size_t tprofSnapshot(tprof_thread_t *threads, size_t count, uint32_t *window);
+  void tprofShell(BaseSequentialStream *chp, int argc, char *argv[]);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMIRO_THREAD_PROFILER_H_ */
@@ -0,0 +1,58 @@
+#ifndef AMIRO_THREAD_PROFILER_CONF_H_
+#define AMIRO_THREAD_PROFILER_CONF_H_
+
+/**
+ * @brief Kernel hooks of the thread profiler
+ *
+ * This file is included by the chconf.h of the modules if the firmware is
+ * built with USE_THREAD_PROFILER=yes. It overrides the (empty) default hooks
+ * of chconf.h, so it has to be included before they are defined.
+ *
+ * @see amiro/ThreadProfiler.h
+ */
+
+/**
+ * @brief Number of bins of the wakeup latency histogram
+ */
+#define TPROF_LATENCY_BINS              8
+
+/*
+ * The stack headroom is measured by looking for the fill pattern.
+ */
+#define CH_DBG_FILL_THREADS             TRUE
+
+#define THREAD_EXT_FIELDS                                                   \
+  /* Counter cycles the thread ran in the current measurement window.*/     \
+  uint32_t tprof_cycles;                                                    \
+  /* Counter value when the thread was found ready, 0 if not ready.*/       \
+  uint32_t tprof_ready;                                                     \
+  /* Worst-case wakeup latency in counter cycles.*/                         \
+  uint32_t tprof_latency_max;                                               \
+  /* Wakeup latency histogram.*/                                            \
+  uint16_t tprof_latency[TPROF_LATENCY_BINS];
+
+#define THREAD_EXT_INIT_HOOK(tp) {                                          \
+  tprofThreadInit(tp);                                                      \
+}
+
+#define THREAD_CONTEXT_SWITCH_HOOK(ntp, otp) {                              \
+  tprofContextSwitch(ntp, otp);                                             \
+}
+
+#define SYSTEM_TICK_EVENT_HOOK() {                                          \
+  tprofTick();                                                              \
+}
+
+struct Thread;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void tprofThreadInit(struct Thread *tp);
+  void tprofContextSwitch(struct Thread *ntp, struct Thread *otp);
+  void tprofTick(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMIRO_THREAD_PROFILER_CONF_H_ */
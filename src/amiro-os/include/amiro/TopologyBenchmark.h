@@ -0,0 +1,121 @@
+#ifndef AMIRO_TOPOLOGY_BENCHMARK_H_
+#define AMIRO_TOPOLOGY_BENCHMARK_H_
+
+#include <ch.h>
+#include <hal.h>
+
+/**
+ * @brief Thread topology benchmark
+ *
+ * In contrast to the generic kernel benchmarks (ChibiOS/test/testbmk.c) this
+ * benchmark replays the static thread set of an AMiRo module: every thread of
+ * the module is modeled as a periodic task with the priority from
+ * devices/<module>/main.cpp, the period of the according component and a
+ * synthetic workload (a calibrated busy loop). Tasks that access a shared bus
+ * hold a mutex for that bus during part of their workload.
+ *
+ * For each task the worst-case and average response time (release until
+ * completion) and the number of deadline misses (deadline = period) are
+ * reported. The benchmark runs on the target (shell command) as well as on
+ * the Posix simulator (amiro-os/tools/benchmarks/topology), so scheduling
+ * changes can be evaluated by editing the task tables or by letting the
+ * benchmark assign rate monotonic priorities.
+ *
+ * @note On the target the synthetic threads run in addition to the threads of
+ *       the module, so the results show the remaining headroom.
+ * @note Response times are measured with the realtime counter of the HAL if it
+ *       is available and with the system tick otherwise. The delay between a
+ *       release and the start of a task is measured in system ticks.
+ */
+
+/**
+ * @brief Stack size of the synthetic threads
+ */
+#if !defined(TBMK_WA_SIZE) || defined(__DOXYGEN__)
+#define TBMK_WA_SIZE                    THD_WA_SIZE(256)
+#endif
+
+/**
+ * @brief Maximum number of tasks of a topology
+ */
+#define TBMK_MAX_TASKS                  24
+
+/**
+ * @brief Idle time value if the kernel does not profile threads
+ */
+#define TBMK_IDLE_UNKNOWN               0xFFFFFFFFu
+
+/**
+ * @brief Shared buses of the modeled tasks
+ */
+typedef enum {
+  TBMK_BUS_NONE = 0,
+  TBMK_BUS_I2C1 = 1,
+  TBMK_BUS_I2C2 = 2,
+  TBMK_BUS_SPI1 = 3,
+  TBMK_BUS_COUNT = 4,
+} tbmk_bus_t;
+
+/**
+ * @brief Model of a single thread
+ */
+typedef struct {
+  const char *name;   /**< @brief Name of the modeled thread */
+  tprio_t prio;       /**< @brief Priority as set in devices/<module>/main.cpp */
+  systime_t period;   /**< @brief Release period in system ticks */
+  systime_t offset;   /**< @brief Offset of the first release in system ticks */
+  uint32_t load_us;   /**< @brief Workload per release in microseconds */
+  tbmk_bus_t bus;     /**< @brief Bus that is accessed by the task */
+  uint32_t bus_us;    /**< @brief Part of the workload that holds the bus */
+} tbmk_task_t;
+
+/**
+ * @brief Thread set of a module
+ */
+typedef struct {
+  const char *name;
+  const tbmk_task_t *tasks;
+  size_t count;
+} tbmk_topology_t;
+
+/**
+ * @brief Results of a single task
+ */
+typedef struct {
+  tprio_t prio;           /**< @brief Priority the task ran at */
+  uint32_t releases;      /**< @brief Number of completed releases */
+  uint32_t misses;        /**< @brief Releases that completed after their deadline */
+  uint32_t skipped;       /**< @brief Releases that were dropped since the task fell behind */
+  uint32_t max_us;        /**< @brief Worst-case response time */
+  uint64_t sum_us;        /**< @brief Sum of all response times */
+} tbmk_result_t;
+
+/**
+ * @brief Options of a benchmark run
+ */
+typedef struct {
+  systime_t duration;     /**< @brief Duration of the run in system ticks */
+  uint16_t load_percent;  /**< @brief Scaling of all workloads in percent */
+  bool_t rate_monotonic;  /**< @brief Replace the priorities by rate monotonic ones */
+} tbmk_options_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  extern const tbmk_topology_t tbmkDiWheelDrive;
+  extern const tbmk_topology_t tbmkPowerManagement;
+  extern const tbmk_topology_t tbmkLightRing;
+
+  const tbmk_topology_t *tbmkFind(const char *name);
+  bool_t tbmkRun(const tbmk_topology_t *topology, const tbmk_options_t *options,
+               tbmk_result_t *results, uint32_t *idle_permille);
+  void tbmkPrint(BaseSequentialStream *chp, const tbmk_topology_t *topology,
+                 const tbmk_options_t *options, const tbmk_result_t *results,
+                 uint32_t idle_permille);
+  void tbmkShell(BaseSequentialStream *chp, int argc, char *argv[],
+                 const tbmk_topology_t *topology);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMIRO_TOPOLOGY_BENCHMARK_H_ */
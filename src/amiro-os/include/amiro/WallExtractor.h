@@ -0,0 +1,111 @@
+#ifndef AMIRO_WALL_EXTRACTOR_H_
+#define AMIRO_WALL_EXTRACTOR_H_
+
+#include <ch.hpp>
+
+#include <amiro/Lidar.h>
+#include <amiro/LidarScan.h>
+#include <amiro/ControllerAreaNetworkTx.h>
+
+namespace amiro {
+
+  /**
+   * \brief Extraction of wall segments from the scans of the LIDAR
+   *
+   * Every new scan is converted to cartesian coordinates (x in driving direction,
+   * y to the left, mm) and split into clusters at invalid steps and range jumps.
+   * Each cluster is split recursively at the point with the largest distance to
+   * the line between its end points (split-and-merge), neighbouring segments that
+   * are collinear are merged again. The nearest segment that is long enough is
+   * fitted by least squares and broadcast as LidarScan::Wall.
+   *
+   * All calculations use integer arithmetic (Q14 sine table with the angular
+   * resolution of the LIDAR), so a scan takes a few milliseconds on the F103.
+   */
+  class WallExtractor : public chibios_rt::BaseStaticThread<256> {
+  public:
+    enum {
+      MAX_SEGMENTS       = 32,   // Segments per scan
+      SPLIT_THRESHOLD_MM = 30,   // Maximum distance of a point to its segment
+      JUMP_THRESHOLD_MM  = 100,  // Minimum range jump between two clusters (plus 1/16 of the range)
+      MIN_POINTS         = 8,    // Minimum number of points of a wall
+      MIN_LENGTH_MM      = 200,  // Minimum length of a wall
+    };
+
+    WallExtractor(Lidar *lidar, ControllerAreaNetworkTx *can);
+
+    /**
+     * \brief Extracts the nearest wall of a scan
+     *
+     * @param scan Ranges of the LIDAR in mm
+     * @param wall Nearest wall, wall.segments is 0 if no wall was found
+     * @return Number of segments found
+     */
+    uint8_t extract(const uint16_t (&scan)[LidarScan::STEPS], LidarScan::Wall &wall);
+
+    /**
+     * \brief Last extracted wall
+     *
+     * @return True if a scan has been processed yet
+     */
+    bool getWall(LidarScan::Wall &wall);
+
+    /**
+     * \brief Worst-case duration of extract() in system ticks
+     */
+    systime_t getMaxDuration();
+
+    /**
+     * \brief Sine of an angle
+     *
+     * @param angle Angle in mrad
+     * @return Sine in Q14
+     */
+    static int32_t sin(int32_t angle);
+    static int32_t cos(int32_t angle);
+
+    /**
+     * \brief Approximated arc tangent of y/x (error below 5 mrad)
+     *
+     * @return Angle in mrad in [-PI, PI]
+     */
+    static int32_t atan2(int32_t y, int32_t x);
+
+    /**
+     * \brief Integer square root
+     */
+    static uint32_t sqrt(uint32_t value);
+
+  protected:
+    virtual msg_t main();
+
+  private:
+    struct Segment {
+      uint16_t first;
+      uint16_t last;
+    };
+
+    void toCartesian(const uint16_t (&scan)[LidarScan::STEPS]);
+    bool isJump(uint16_t step);
+    uint16_t findSplit(uint16_t first, uint16_t last, int32_t &deviation);
+    uint8_t split(uint16_t first, uint16_t last, uint8_t count);
+    uint8_t merge(uint8_t count);
+    void fit(const Segment &segment, LidarScan::Wall &wall);
+
+    Lidar *lidar;
+    ControllerAreaNetworkTx *can;
+
+    uint16_t scan[LidarScan::STEPS];
+    int16_t x[LidarScan::STEPS];
+    int16_t y[LidarScan::STEPS];
+    Segment segments[MAX_SEGMENTS];
+    Segment stack[MAX_SEGMENTS];
+
+    uint32_t scanCount;
+    LidarScan::Wall wall;
+    systime_t maxDuration;
+  };
+
+}
+
+#endif /* AMIRO_WALL_EXTRACTOR_H_ */
@@ -5,6 +5,10 @@
 
 #define BLUETOOTH_DESCRIPTOR_BUFFER_SIZE 64
 
+/* Room in front of and behind the payload for the frame header and trailer */
+#define BLUETOOTH_DESCRIPTOR_HEADROOM     4
+#define BLUETOOTH_DESCRIPTOR_TAILROOM     2
+
 namespace amiro {
 
   class BluetoothDescriptor {
@@ -22,11 +26,17 @@ namespace amiro {
     uint8_t *bluetoothDescriptorGetBuffer();
     uint8_t *bluetoothDescriptorGetPayload();
 
+    /**
+     * Returns the start of a frame with headerLength bytes in front of the
+     * payload, so header, payload and trailer can be sent in one transfer.
+     */
+    uint8_t *bluetoothDescriptorGetFrame(size_t headerLength);
+
   private:
 //    unsigned char flags;
     uint8_t linkId;
     size_t length;
-    uint8_t buffer[BLUETOOTH_DESCRIPTOR_BUFFER_SIZE];
+    uint8_t buffer[BLUETOOTH_DESCRIPTOR_HEADROOM + BLUETOOTH_DESCRIPTOR_BUFFER_SIZE + BLUETOOTH_DESCRIPTOR_TAILROOM];
 
   };
 }
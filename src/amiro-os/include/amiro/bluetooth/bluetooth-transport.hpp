@@ -60,15 +60,12 @@ namespace amiro {
 
     size_t rcvlength;
 
-    /* These arrays Contain header and trailer */
+    /* This array contains header and trailer */
     uint8_t receiveFrameBuffer[5];
-    uint8_t transmitFrameBuffer[5];
 
     void postReceiveDescriptorI();
-    void postTransmitDescriptorI();
+    void startTransmitI();
 
-    uint8_t* getEncodeHeader();
-    uint8_t* getEncodeTailer();
     int decodeHeader();
   };
 }
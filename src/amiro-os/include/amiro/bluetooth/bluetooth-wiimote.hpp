@@ -48,6 +48,19 @@ namespace amiro {
     };
     Buttons* getButtons();
 
+    /**
+     * Event source that is broadcast for every report with buttons and
+     * accelerometer data.
+     */
+    chibios_rt::EvtSource* getEventSource();
+
+    /**
+     * Realtime counter value (halGetCounterValue()) when the last report was
+     * received, to measure the latency of the steering.
+     */
+    halrtcnt_t getReportTime();
+    uint32_t getReportCount();
+
   protected:
     virtual msg_t main(void);
 
@@ -66,6 +79,10 @@ namespace amiro {
 
     Accelerometer accelerometer;
     Buttons buttons;
+
+    chibios_rt::EvtSource eventSource;
+    volatile halrtcnt_t reportTime;
+    volatile uint32_t reportCount;
   };
 }
 
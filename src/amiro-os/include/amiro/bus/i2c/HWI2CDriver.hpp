@@ -22,6 +22,12 @@ namespace amiro {
 
   /**
    * @brief   I²C HW Driver Abstraction
+   *
+   * @note    acquireBus() locks the mutex of the HAL driver, i.e. waiting
+   *          threads are served by priority and the thread holding the bus
+   *          inherits the priority of the waiting ones. Devices should hold
+   *          the bus only for their transfers and never while waiting for the
+   *          device (see AT24::write()).
    */
   class HWI2CDriver : public I2CDriver {
 
@@ -12,6 +12,10 @@ namespace amiro {
 
   /**
    * @brief   I²C Bus Multiplexer
+   *
+   * The bus is held per thread, not per channel: acquireBus() may be nested
+   * by the owning thread, e.g. by transfers of several channels, and only the
+   * outermost releaseBus() deselects the channel and frees the bus.
    */
   class I2CMultiplexer {
 
@@ -34,6 +38,16 @@ namespace amiro {
 
     I2CDriver *driver;
 
+    /**
+     * @brief   Thread holding the bus.
+     */
+    ::Thread *owner;
+
+    /**
+     * @brief   Nesting depth of acquireBus() by the owner.
+     */
+    uint8_t holds;
+
 #if I2C_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
 #if CH_USE_MUTEXES || defined(__DOXYGEN__)
     /**
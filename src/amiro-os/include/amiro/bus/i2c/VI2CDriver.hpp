@@ -17,6 +17,18 @@ namespace amiro {
 
   /**
    * @brief   Virtual I²C Driver
+   *
+   * A channel of an I²C multiplexer. Transfers outside of acquireBus()/releaseBus()
+   * lock the multiplexer and select the channel for each single transfer.
+   * acquireBus() locks the multiplexer (and thus the hardware bus) until
+   * releaseBus(), so all transfers of a device access are batched without
+   * further arbitration and, as the multiplexer caches the selected channel,
+   * without reselecting it. The owning thread may also transfer on other
+   * channels of the same multiplexer meanwhile (see I2CMultiplexer).
+   *
+   * @note    The bus is arbitrated by mutexes, i.e. waiting threads are served
+   *          by priority and the thread holding the bus inherits the priority
+   *          of the waiting ones.
    */
   class VI2CDriver : public I2CDriver {
 
@@ -38,17 +50,6 @@ namespace amiro {
     I2CMultiplexer *driver;
     uint8_t id;
 
-#if I2C_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
-#if CH_USE_MUTEXES || defined(__DOXYGEN__)
-    /**
-    * @brief   Mutex protecting the bus.
-    */
-    ::Mutex                     mutex;
-#elif CH_USE_SEMAPHORES
-    ::Semaphore                 semaphore;
-#endif
-#endif /* I2C_USE_MUTUAL_EXCLUSION */
-
   };
 
 } /* amiro */
@@ -20,6 +20,13 @@ class AT24 : public EEPROM {
     AT24_MAX_PAGE_SIZE = 8,
   };
 
+  /**
+   * Maximum number of bytes read while holding the bus
+   */
+  enum {
+    AT24_READ_CHUNK_SIZE = 32,
+  };
+
   public:
 
   /**
@@ -40,6 +47,13 @@ class AT24 : public EEPROM {
     static size_t read(void* instance, uint8_t* bp, size_t n);
     static uint32_t close(void* instance);
 
+  private:
+
+    /**
+     * Maximum write cycle time in system ticks
+     */
+    static systime_t get_t_wr(EEPROM* bfs);
+
 };
 
 } /* amiro */
@@ -7,29 +7,59 @@ namespace amiro {
 
   class HWSPIDriver;
 
+  /**
+   * \brief Driver of the TLC5947 LED controller of the LightRing
+   *
+   * Colors are set in a pending state and taken over as a whole by the thread,
+   * so an update of several LEDs (setColors) never reaches the LEDs halfway.
+   * The thread maps the colors through gamma tables that are scaled to the
+   * brightness once per brightness change, rebuilds only the changed LEDs in a
+   * second frame and sends it only if it differs from the last sent frame.
+   */
   class TLC5947 : public chibios_rt::BaseStaticThread<192> {
   public:
+    enum {
+      LEDS       = 8,
+      FRAME_SIZE = 36,  // 24 channels of 12 bit
+    };
+
     TLC5947(HWSPIDriver *spi, ioportid_t blankPort, int blankPad);
     virtual ~TLC5947();
     void disable();
     void enable();
     void setBrightness(int brightness);
     void setColor(int index, Color color);
+
+    /**
+     * \brief Sets the colors of all LEDs at once
+     */
+    void setColors(const Color (&colors)[LEDS]);
     void update();
 
+    /**
+     * \brief Number of frames sent to the TLC5947
+     */
+    uint32_t getFrameCount();
+
   protected:
     virtual msg_t main(void);
 
   private:
-    int caluclateRedGrayscale(Color color, int brightness) const;
-    int caluclateGreenGrayscale(Color color, int brightness) const;
-    int caluclateBlueGrayscale(Color color, int brightness) const;
+    void calculateGrayscales(int brightness);
+    void packColors(uint8_t *frame, Color &color1, Color &color2) const;
 
     HWSPIDriver *spi;
     ioportid_t blankPort;
     int blankPad;
-    Color colors[8];
-    int brightness;
+    Color colors[LEDS];
+    volatile uint8_t changed;          // LEDs whose color changed since the last frame
+    volatile int brightness;
+    int grayscaleBrightness;           // Brightness of the grayscale tables
+    uint16_t redGreenGrayscale[256];
+    uint16_t blueGrayscale[256];
+    uint8_t frames[2][FRAME_SIZE];
+    uint8_t sentFrame;                 // Index of the last sent frame
+    uint32_t frameCount;
   };
 
 }
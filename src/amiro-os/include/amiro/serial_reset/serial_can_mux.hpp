@@ -9,11 +9,40 @@
 
 namespace amiro {
 
+  /**
+   * \brief Shell stream that forwards to the shell of another board via CAN
+   *
+   * Output for a remote board is written into a queue and sent by a separate
+   * thread, which packs up to eight bytes into each frame. A frame is sent as
+   * soon as it is full, a line is complete, the shell waits for input or the
+   * output pauses for REPLY_IDLE_MS. The frames are paced to the baud rate of
+   * the remote serial port, so its CAN receiver is not blocked by a full output
+   * queue. Writers block if the queue is full.
+   */
   class SerialCanMux : public chibios_rt::BaseSequentialStreamInterface {
   public:
+    enum {
+      REPLY_QUEUE_SIZE = 64,      // Buffered output for the remote board
+      REPLY_IDLE_MS    = 5,       // Flush incomplete frames after this pause
+      REPLY_WINDOW     = 16,      // Bytes in flight, output queue of the remote serial driver
+      REPLY_BAUDRATE   = 115200,  // Baud rate of the remote serial port
+    };
+
     SerialCanMux(SerialDriver *_sd_, CANDriver *can, const uint8_t boardId);
     virtual ~SerialCanMux();
 
+    /**
+     * \brief Starts the thread that sends the output for a remote board
+     *
+     * Until then every write is sent immediately.
+     */
+    void start(tprio_t prio);
+
+    /**
+     * \brief Sends the buffered output for a remote board
+     */
+    void flush();
+
     void convCan2Serial(uint8_t *inputs, size_t n);
     void sendSwitchCmd(uint8_t setid);
     void rcvSwitchCmd(uint8_t setid);
@@ -26,6 +55,27 @@ namespace amiro {
   protected:
 
   private:
+    class ReplyThread : public chibios_rt::BaseStaticThread<256> {
+    public:
+      enum {
+        DATA_EVENT  = EVENT_MASK(0),
+        FLUSH_EVENT = EVENT_MASK(1),
+      };
+
+      ReplyThread(SerialCanMux *mux);
+
+    protected:
+      virtual msg_t main();
+
+    private:
+      SerialCanMux *mux;
+    };
+
+    static void replyNotify(GenericQueue *qp);
+    bool replyQueued();
+    void sendReplies();
+    void throttleReply(size_t n);
+
     /* Reset command. */
     const uint8_t inputBLReset[3] = {0x02, 0xFF, 0x00};
 //    const uint8_t inputchshell[3] = {0x00, 0x68, 0x0D};
@@ -47,6 +97,13 @@ namespace amiro {
 
     CANTxFrame txmsg;
     uint8_t inputChar[16] = {};
+
+    OutputQueue replyQueue;
+    uint8_t replyBuffer[REPLY_QUEUE_SIZE];
+    CANTxFrame replyFrame;
+    systime_t replyTime;      // Last update of replyBacklog
+    size_t replyBacklog;      // Bytes the remote serial driver has not sent yet
+    ReplyThread replyThread;
   };
 
 } /* amiro */
@@ -0,0 +1,27 @@
+/**
+ * @file    chconf.h
+ * @brief   Kernel configuration of the topology benchmark in the simulator.
+ * @details The kernel is configured like on the modules
+ *          (devices/DiWheelDrive/chconf.h) except for the settings below.
+ */
+
+#ifndef _TOPOLOGY_CHCONF_H_
+#define _TOPOLOGY_CHCONF_H_
+
+/* The simulator preempts only at system ticks, see readme.txt. */
+#define CH_FREQUENCY                    10000
+
+/* Round robin interval of 20 ms like on the modules. */
+#define CH_TIME_QUANTUM                 200
+
+/* There is no linker script providing the heap. The working areas of the
+   benchmark threads include the stack required by the C library of the host
+   (PORT_INT_REQUIRED_STACK). */
+#define CH_MEMCORE_SIZE                 0x100000
+
+/* Not supported by the simulator port. */
+#define CH_DBG_ENABLE_STACK_CHECK       FALSE
+
+#include "../../../devices/DiWheelDrive/chconf.h"
+
+#endif  /* _TOPOLOGY_CHCONF_H_ */
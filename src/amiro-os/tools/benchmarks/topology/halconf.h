@@ -0,0 +1,13 @@
+/**
+ * @file    halconf.h
+ * @brief   HAL configuration of the topology benchmark in the simulator.
+ * @details The benchmark uses no drivers. All HAL_USE_* options that are not
+ *          defined here are disabled.
+ */
+
+#ifndef _HALCONF_H_
+#define _HALCONF_H_
+
+#define HAL_USE_PAL                 TRUE
+
+#endif /* _HALCONF_H_ */
@@ -0,0 +1,64 @@
+#include <stdio.h>
+
+#include <ch.h>
+#include <hal.h>
+
+#include <amiro/TopologyBenchmark.h>
+
+/*
+ * Output stream to stdout.
+ */
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+
+  (void)ip;
+  return fwrite(bp, 1, n, stdout);
+}
+
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+
+  (void)ip;
+  return (fputc(b, stdout) == EOF) ? RDY_RESET : RDY_OK;
+}
+
+static msg_t get(void *ip) {
+
+  (void)ip;
+  return RDY_RESET;
+}
+
+static const struct BaseSequentialStreamVMT vmt = {writes, reads, put, get};
+
+static BaseSequentialStream console = {&vmt};
+
+/*
+ * System halt hook of the module configuration (see chconf.h), replaces
+ * components/Debug.c, which prints to the USART of the modules.
+ */
+void haltErrorCode(void) {
+
+  fprintf(stderr, "System halt! Error Code: %s\n",
+          (dbg_panic_msg != NULL) ? dbg_panic_msg : "unknown");
+}
+
+/*
+ * Runs the topology benchmark with the arguments of the shell command, e.g.
+ *   ./build/topology PowerManagement 20 150 rm
+ */
+int main(int argc, char *argv[]) {
+
+  halInit();
+  chSysInit();
+
+  tbmkShell(&console, argc - 1, &argv[1], &tbmkDiWheelDrive);
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file    chcore.c
+ * @brief   x86-64 variant of the SIMIA32 port (ChibiOS/os/ports/GCC/SIMIA32).
+ */
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+
+/*
+ * void port_switch(Thread *ntp, Thread *otp)
+ * Saves the callee-saved registers on the stack of the old thread and
+ * restores them from the stack of the new one. The offset of p_ctx is
+ * checked below.
+ *
+ * void _port_thread_trampoline(void)
+ * Entry of a new thread, see SETUP_CONTEXT().
+ */
+asm (
+    ".text                                              \n\t"
+    ".globl port_switch                                 \n\t"
+    ".type  port_switch, @function                      \n\t"
+    "port_switch:                                       \n\t"
+    "push   %rbp                                        \n\t"
+    "push   %rbx                                        \n\t"
+    "push   %r12                                        \n\t"
+    "push   %r13                                        \n\t"
+    "push   %r14                                        \n\t"
+    "push   %r15                                        \n\t"
+    "mov    %rsp, 24(%rsi)                              \n\t"
+    "mov    24(%rdi), %rsp                              \n\t"
+    "pop    %r15                                        \n\t"
+    "pop    %r14                                        \n\t"
+    "pop    %r13                                        \n\t"
+    "pop    %r12                                        \n\t"
+    "pop    %rbx                                        \n\t"
+    "pop    %rbp                                        \n\t"
+    "ret                                                \n\t"
+    ".globl _port_thread_trampoline                     \n\t"
+    ".type  _port_thread_trampoline, @function          \n\t"
+    "_port_thread_trampoline:                           \n\t"
+    "mov    %r12, %rdi                                  \n\t"
+    "mov    %r13, %rsi                                  \n\t"
+    "call   _port_thread_start                          \n\t"
+    "hlt                                                \n\t"
+);
+
+typedef char _port_ctx_offset_check[(offsetof(Thread, p_ctx) == 24) ? 1 : -1];
+
+/**
+ * Halts the system. In this implementation it just exits the simulation.
+ */
+void port_halt(void) {
+
+  exit(2);
+}
+
+/**
+ * @brief   Start a thread by invoking its work function.
+ * @details If the work function returns @p chThdExit() is automatically
+ *          invoked.
+ */
+void _port_thread_start(msg_t (*pf)(void *), void *p) {
+
+  chSysUnlock();
+  chThdExit(pf(p));
+  while(1);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file    chcore.h
+ * @brief   x86-64 variant of the SIMIA32 port (ChibiOS/os/ports/GCC/SIMIA32).
+ * @details Only the context switch differs from the IA32 simulator, the types
+ *          (chtypes.h) and the Posix HAL platform are shared with it.
+ */
+
+#ifndef _CHCORE_H_
+#define _CHCORE_H_
+
+#if !defined(__x86_64__)
+#error "this port requires an x86-64 host"
+#endif
+
+#if CH_DBG_ENABLE_STACK_CHECK
+#error "option CH_DBG_ENABLE_STACK_CHECK not supported by this port"
+#endif
+
+#define CH_ARCHITECTURE_SIMX64
+
+#define CH_ARCHITECTURE_NAME            "Simulator"
+
+#define CH_CORE_VARIANT_NAME            "x86-64 (integer only)"
+
+#define CH_COMPILER_NAME                "GCC " __VERSION__
+
+#define CH_PORT_INFO                    "No preemption"
+
+typedef struct {
+  uint8_t a[16];
+} stkalign_t __attribute__((aligned(16)));
+
+typedef void *regx64;
+
+struct extctx {
+};
+
+/**
+ * @brief   Callee-saved registers of a suspended thread, in stack order.
+ */
+struct intctx {
+  regx64  r15;
+  regx64  r14;
+  regx64  r13;
+  regx64  r12;
+  regx64  rbx;
+  regx64  rbp;
+  regx64  rip;
+};
+
+struct context {
+  struct intctx volatile *rsp;
+};
+
+/**
+ * @brief   Setup of the context of a new thread.
+ * @details The thread starts in _port_thread_trampoline(), which passes r12
+ *          and r13 to _port_thread_start().
+ */
+#define SETUP_CONTEXT(workspace, wsize, pf, arg) {                      \
+  uint8_t *rsp = (uint8_t *)(((uintptr_t)(workspace) + (wsize)) &      \
+                             ~(uintptr_t)15);                           \
+  rsp -= sizeof(struct intctx);                                         \
+  ((struct intctx *)rsp)->r15 = 0;                                      \
+  ((struct intctx *)rsp)->r14 = 0;                                      \
+  ((struct intctx *)rsp)->r13 = (void *)(arg);                          \
+  ((struct intctx *)rsp)->r12 = (void *)(pf);                           \
+  ((struct intctx *)rsp)->rbx = 0;                                      \
+  ((struct intctx *)rsp)->rbp = 0;                                      \
+  ((struct intctx *)rsp)->rip = (void *)_port_thread_trampoline;        \
+  tp->p_ctx.rsp = (struct intctx *)rsp;                                 \
+}
+
+#ifndef PORT_IDLE_THREAD_STACK_SIZE
+#define PORT_IDLE_THREAD_STACK_SIZE     256
+#endif
+
+#ifndef PORT_INT_REQUIRED_STACK
+#define PORT_INT_REQUIRED_STACK         32768
+#endif
+
+#define STACK_ALIGN(n) ((((n) - 1) | (sizeof(stkalign_t) - 1)) + 1)
+
+ /**
+  * Computes the thread working area global size.
+  */
+#define THD_WA_SIZE(n) STACK_ALIGN(sizeof(Thread) +                     \
+                                   sizeof(stkalign_t) +                 \
+                                   sizeof(struct intctx) +              \
+                                   sizeof(struct extctx) +              \
+                                   (n) + (PORT_INT_REQUIRED_STACK))
+
+#define WORKING_AREA(s, n) stkalign_t s[THD_WA_SIZE(n) / sizeof(stkalign_t)]
+
+#define PORT_IRQ_PROLOGUE()
+
+#define PORT_IRQ_EPILOGUE()
+
+#define PORT_IRQ_HANDLER(id) void id(void)
+
+#define port_init()
+
+#define port_lock() asm volatile("nop")
+
+#define port_unlock() asm volatile("nop")
+
+#define port_lock_from_isr()
+
+#define port_unlock_from_isr()
+
+#define port_disable()
+
+#define port_suspend()
+
+#define port_enable()
+
+#define port_wait_for_interrupt() ChkIntSources()
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void port_switch(Thread *ntp, Thread *otp);
+  void port_halt(void);
+  void _port_thread_trampoline(void);
+  __attribute__((noreturn)) void _port_thread_start(msg_t (*pf)(void *),
+                                                    void *p);
+  void ChkIntSources(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CHCORE_H_ */
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <amiro/TelemetryFrame.h>
+
+/*
+ * Channel as described by the description frames.
+ */
+typedef struct {
+  int valid;
+  tlm_type_t type;
+  uint8_t count;
+  char name[TLM_MAX_PAYLOAD];
+  char fields[TLM_MAX_PAYLOAD];
+  FILE *log;
+  unsigned long frames;
+} channel_t;
+
+static channel_t channels[256];
+static const char *directory = ".";
+
+static unsigned long frames = 0;
+static unsigned long lost = 0;
+static unsigned long invalid = 0;
+static unsigned long unknown = 0;
+
+/*
+ * Data between two delimiters that is no frame. Printable data is text of the
+ * shell and passed to stdout.
+ */
+static void handleText(const uint8_t *data, size_t n) {
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    if (!isprint(data[i]) && !isspace(data[i])) {
+      ++invalid;
+      return;
+    }
+  }
+  fwrite(data, 1, n, stdout);
+  fflush(stdout);
+}
+
+static void handleDescription(const tlm_frame_t *frame) {
+  channel_t *channel;
+  const char *name;
+  const char *fields;
+  size_t nameLength;
+
+  if (frame->length < 7 || frame->payload[0] == TLM_DESCRIPTION_ID || frame->payload[1] >= TLM_TYPE_COUNT ||
+      frame->payload[frame->length - 1] != '\0') {
+    ++invalid;
+    return;
+  }
+  name = (const char *)&frame->payload[5];
+  nameLength = strlen(name) + 1;
+  if (5 + nameLength >= frame->length) {
+    ++invalid;
+    return;
+  }
+  fields = name + nameLength;
+
+  channel = &channels[frame->payload[0]];
+  if (channel->valid && channel->type == (tlm_type_t)frame->payload[1] && channel->count == frame->payload[2] &&
+      strcmp(channel->name, name) == 0 && strcmp(channel->fields, fields) == 0) {
+    return;
+  }
+
+  /* new or changed channel */
+  if (channel->log != NULL)
+    fclose(channel->log);
+  memset(channel, 0, sizeof(*channel));
+  channel->type = (tlm_type_t)frame->payload[1];
+  channel->count = frame->payload[2];
+  strcpy(channel->name, name);
+  strcpy(channel->fields, fields);
+
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/%s.csv", directory, channel->name);
+  channel->log = fopen(path, "w");
+  if (channel->log == NULL) {
+    perror(path);
+    return;
+  }
+  fprintf(channel->log, "time_ms,sequence,%s\n", channel->fields);
+  channel->valid = 1;
+  fprintf(stderr, "channel %u: %s (%u values, %u ms) -> %s\n",
+          frame->payload[0], channel->name, channel->count, frame->payload[3] | (frame->payload[4] << 8), path);
+}
+
+static long readValue(const uint8_t *p, tlm_type_t type) {
+  uint32_t raw = 0;
+  size_t i;
+
+  for (i = 0; i < tlmTypeSize(type); ++i)
+    raw |= (uint32_t)p[i] << (8 * i);
+
+  switch (type) {
+    case TLM_INT8:
+      return (int8_t)raw;
+    case TLM_INT16:
+      return (int16_t)raw;
+    case TLM_INT32:
+      return (int32_t)raw;
+    default:
+      return (long)raw;
+  }
+}
+
+static void handleData(const tlm_frame_t *frame) {
+  channel_t *channel = &channels[frame->id];
+  size_t size = tlmTypeSize(channel->type);
+  uint8_t i;
+
+  if (!channel->valid) {
+    ++unknown;
+    return;
+  }
+  if (frame->length != channel->count * size) {
+    ++invalid;
+    return;
+  }
+
+  fprintf(channel->log, "%lu,%u", (unsigned long)frame->time, frame->sequence);
+  for (i = 0; i < channel->count; ++i)
+    fprintf(channel->log, ",%ld", readValue(&frame->payload[i * size], channel->type));
+  fputc('\n', channel->log);
+  ++channel->frames;
+}
+
+static void handleChunk(const uint8_t *data, size_t n) {
+  static int synchronized = 0;
+  static uint8_t sequence;
+  tlm_frame_t frame;
+
+  if (n == 0)
+    return;
+
+  if (!tlmDecodeFrame(data, n, &frame)) {
+    handleText(data, n);
+    return;
+  }
+
+  if (synchronized)
+    lost += (uint8_t)(frame.sequence - sequence - 1);
+  synchronized = 1;
+  sequence = frame.sequence;
+  ++frames;
+
+  if (frame.id == TLM_DESCRIPTION_ID)
+    handleDescription(&frame);
+  else
+    handleData(&frame);
+}
+
+/*
+ * Decodes a telemetry stream, e.g.
+ *   stty -F /dev/ttyUSB0 115200 raw -echo && ./tlmdecode /dev/ttyUSB0 logs
+ */
+int main(int argc, char *argv[]) {
+  FILE *input = stdin;
+  uint8_t chunk[4096];
+  size_t length = 0;
+  int c;
+  int i;
+
+  if (argc > 3 || (argc > 1 && strcmp(argv[1], "-h") == 0)) {
+    fprintf(stderr, "Usage: %s [input] [output directory]\n", argv[0]);
+    return 1;
+  }
+  if (argc > 1 && strcmp(argv[1], "-") != 0) {
+    input = fopen(argv[1], "rb");
+    if (input == NULL) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+  if (argc > 2)
+    directory = argv[2];
+
+  while ((c = fgetc(input)) != EOF) {
+    if (c == 0) {
+      handleChunk(chunk, length);
+      length = 0;
+    } else if (length < sizeof(chunk)) {
+      chunk[length++] = (uint8_t)c;
+    } else {
+      /* no delimiter for a long time, pass the text on */
+      handleText(chunk, length);
+      length = 0;
+      chunk[length++] = (uint8_t)c;
+    }
+  }
+  handleText(chunk, length);
+
+  fprintf(stderr, "%lu frames, %lu lost, %lu invalid, %lu of unknown channels\n", frames, lost, invalid, unknown);
+  for (i = 0; i < 256; ++i) {
+    if (channels[i].log != NULL) {
+      fprintf(stderr, "  %-12s %lu\n", channels[i].name, channels[i].frames);
+      fclose(channels[i].log);
+    }
+  }
+
+  return 0;
+}